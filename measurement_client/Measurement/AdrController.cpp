@@ -0,0 +1,657 @@
+//------------------------------------------------------------------------------
+//
+//	File:		AdrController.cpp
+//
+//	Abstract:	Adaptive Data Rate Control of the Radio Link
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "AdrController.h"
+#include "Airtime.h"
+#include "SweepCampaign.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+//
+//  GetDemodulationFloor
+//
+//  @brief: min. SNR of the SX1280 LoRa demodulator [dB], -2.5 dB at SF5 and
+//          2.5 dB less per SF step
+//
+//------------------------------------------------------------------------------
+
+static double
+GetDemodulationFloor(UINT8 spreadingFactor)
+{
+    return -7.5 - 2.5 * (spreadingFactor - WiMODLR_RADIO_CONFIG_SF7);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetBandwidthDb
+//
+//  @brief: noise bandwidth relative to 203.125 kHz [dB]
+//
+//------------------------------------------------------------------------------
+
+static double
+GetBandwidthDb(UINT8 bandwidth)
+{
+    return 10 * std::log10((double)AIRTIME_GetBandwidthHz(bandwidth) / AIRTIME_GetBandwidthHz(WiMODLR_RADIO_CONFIG_BW_203kHz));
+}
+
+//------------------------------------------------------------------------------
+//
+//  TAdrController - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TAdrController::TAdrController(TWiMODLRHCI& hci, TRadioSupervisor& supervisor, TSampleFanout& fanout)
+    : HCI(hci),
+      Supervisor(supervisor),
+      Fanout(fanout)
+{
+    Base            = TWiMODLR_RadioConfig();
+    Running         = false;
+    Follower        = false;
+    Step            = 0;
+    Power           = 0;
+    Sequence        = 0;
+    Pending         = false;
+    PendingStep     = 0;
+    PendingPower    = 0;
+    PendingReason   = "";
+    WindowCount     = 0;
+    SumSnr          = 0;
+    SumRssi         = 0;
+    Surplus         = 0;
+    RefSnr          = 0;
+    LastSnr         = 0;
+    LastPer         = 0;
+    Confirming      = false;
+    HasBaseline     = false;
+    BaseLRxCount    = 0;
+    PreviousStep    = 0;
+    PreviousPower   = 0;
+    HasAnnounce     = false;
+    Announced       = TWiMODLR_RadioConfig();
+    LastSequence    = 0;
+    HasSequence     = false;
+    Stats           = TAdrStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TAdrController::Start(const TAdrConfig& config)
+{
+    UINT8 status = 0;
+
+    if (HCI.GetRadioConfiguration(Base, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not read radio configuration" << std::endl;
+        return false;
+    }
+
+    Config   = config;
+    Running  = true;
+    Follower = false;
+    Stats    = TAdrStats();
+
+    Config.MinPower = std::min(Config.MinPower, Config.MaxPower);
+
+    BuildLadder();
+
+    // the ladder ahead of the samples
+    for (size_t i = 0; i < Ladder.size(); i++)
+    {
+        std::ostringstream comment;
+
+        comment << std::fixed << std::setprecision(1)
+                << "adr config=" << i + 1 << " " << TSweepCampaign::FormatRadio(GetRadio(i, Base.PowerLevel))
+                << " exchange=" << Ladder[i].AirtimeNs / 1e6 << " ms"
+                << " snr_min=" << Ladder[i].RequiredSnr << " dB";
+
+        Fanout.PublishComment(comment.str());
+    }
+
+    // the step of the module or the most robust one
+    size_t step = Ladder.size() - 1;
+
+    for (size_t i = 0; i < Ladder.size(); i++)
+    {
+        if (Ladder[i].SpreadingFactor == Base.SpreadingFactor && Ladder[i].Bandwidth == Base.Bandwidth)
+            step = i;
+    }
+
+    std::cout << "ADR: " << Ladder.size() << " steps, target per " << Config.TargetPer
+              << ", margin " << Config.MarginDb << " dB, hysteresis " << Config.HysteresisDb << " dB" << std::endl;
+
+    Step  = step;
+    Power = std::clamp(Base.PowerLevel, Config.MinPower, Config.MaxPower);
+
+    Switch(step, Power, "start");
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  StartFollower
+//
+//------------------------------------------------------------------------------
+
+bool
+TAdrController::StartFollower()
+{
+    UINT8 status = 0;
+
+    if (HCI.GetRadioConfiguration(Base, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not read radio configuration" << std::endl;
+        return false;
+    }
+
+    Running     = true;
+    Follower    = true;
+    HasAnnounce = false;
+    HasSequence = false;
+    Stats       = TAdrStats();
+
+    std::cout << "ADR follower: " << TSweepCampaign::FormatRadio(Base) << std::endl;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  BuildLadder
+//
+//  @brief: SF / bandwidth combinations by exchange time, a step is kept if
+//          it needs less SNR than every faster one
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::BuildLadder()
+{
+    UINT8 packetSize = Supervisor.GetTestConfig().PacketSize;
+
+    std::vector<TAdrStep> steps;
+
+    for (UINT8 sf = WiMODLR_RADIO_CONFIG_SF5; sf <= WiMODLR_RADIO_CONFIG_SF12; sf++)
+    {
+        for (UINT8 bw = WiMODLR_RADIO_CONFIG_BW_203kHz; bw <= std::min<UINT8>(Config.MaxBandwidth, WiMODLR_RADIO_CONFIG_BW_1625kHz); bw++)
+        {
+            TAdrStep step;
+
+            step.SpreadingFactor = sf;
+            step.Bandwidth       = bw;
+            step.AirtimeNs       = 2 * AIRTIME_GetLoRaNs(sf, bw, Base.ErrorCoding, packetSize);
+            step.RequiredSnr     = GetDemodulationFloor(sf) + GetBandwidthDb(bw);
+
+            steps.push_back(step);
+        }
+    }
+
+    std::sort(steps.begin(), steps.end(), [](const TAdrStep& a, const TAdrStep& b)
+    {
+        return a.AirtimeNs < b.AirtimeNs || (a.AirtimeNs == b.AirtimeNs && a.RequiredSnr < b.RequiredSnr);
+    });
+
+    Ladder.clear();
+
+    for (const TAdrStep& step : steps)
+    {
+        if (Ladder.empty() || step.RequiredSnr < Ladder.back().RequiredSnr)
+            Ladder.push_back(step);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetRadio
+//
+//------------------------------------------------------------------------------
+
+TWiMODLR_RadioConfig
+TAdrController::GetRadio(size_t step, UINT8 power) const
+{
+    TWiMODLR_RadioConfig radio = Base;
+
+    radio.SpreadingFactor = Ladder[step].SpreadingFactor;
+    radio.Bandwidth       = Ladder[step].Bandwidth;
+    radio.PowerLevel      = power;
+
+    return radio;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetMargin
+//
+//  @brief: SNR of the last window moved to a step and power, above the
+//          demodulation floor and the installation margin [dB]
+//
+//------------------------------------------------------------------------------
+
+double
+TAdrController::GetMargin(size_t step, int power) const
+{
+    return RefSnr + power - Ladder[step].RequiredSnr - Config.MarginDb;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::Poll()
+{
+    if (!Running)
+        return;
+
+    if (Follower)
+    {
+        if (!HasAnnounce)
+            return;
+
+        HasAnnounce = false;
+
+        UINT8 status = 0;
+
+        if (HCI.SetRadioConfiguration(Announced, WiMODLR_STORE_INTO_RAM, status) != WiMODLR_RESULT_OK
+            || status != DEVMGMT_STATUS_OK)
+        {
+            std::cerr << "Warning: Announced configuration not applied" << std::endl;
+            return;
+        }
+
+        Stats.Applied++;
+
+        std::cout << "ADR follow " << (int)LastSequence << ": " << TSweepCampaign::FormatRadio(Announced) << std::endl;
+        return;
+    }
+
+    if (Pending)
+    {
+        Pending = false;
+
+        Switch(PendingStep, PendingPower, PendingReason);
+        return;
+    }
+
+    // the peer missed the announcement, both ends go back
+    if (Confirming && TClock::now() >= Deadline)
+    {
+        Stats.Fallbacks++;
+
+        Switch(PreviousStep, PreviousPower, "fallback");
+
+        // the failed step is not tried again soon
+        Surplus = -4 * (int)Config.HoldWindows;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Switch
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::Switch(size_t step, UINT8 power, const char* reason)
+{
+    bool start    = !std::strcmp(reason, "start");
+    bool fallback = !std::strcmp(reason, "fallback");
+
+    TWiMODLR_RadioConfig radio = GetRadio(step, power);
+
+    if (!start)
+    {
+        Stats.Switches++;
+
+        if (step < Step)
+            Stats.Faster++;
+        else if (step > Step)
+            Stats.Slower++;
+
+        if (power != Power)
+            Stats.PowerChanges++;
+
+        if (!std::strcmp(reason, "per"))
+            Stats.PerSteps++;
+    }
+
+    std::ostringstream comment;
+
+    comment << std::fixed << std::setprecision(1)
+            << "adr switch config=" << step + 1 << " " << TSweepCampaign::FormatRadio(radio)
+            << " reason=" << reason;
+
+    if (!start)
+        comment << " snr=" << LastSnr << " per=" << std::setprecision(3) << LastPer;
+
+    PreviousStep  = Step;
+    PreviousPower = Power;
+    Step          = step;
+    Power         = power;
+
+    // indications of the old step are dropped by the handshake
+    Fanout.SetConfigId((UINT16)(step + 1));
+    Fanout.PublishComment(comment.str());
+
+    std::cout << "ADR " << comment.str().substr(4) << std::endl;
+
+    Sequence++;
+
+    if (!Supervisor.Reconfigure(radio, EncodeFrame(Sequence, radio), Config.AnnounceRepeats))
+        std::cerr << "Warning: ADR configuration not applied" << std::endl;
+
+    // a new window from the first indication of the step, indications
+    // during the switch were evaluated for the old one
+    Pending     = false;
+    WindowCount = 0;
+    SumSnr      = 0;
+    SumRssi     = 0;
+    Surplus     = 0;
+    Estimator.Reset();
+
+    // a fallback goes back to a configuration which worked
+    Confirming  = !start && !fallback;
+    HasBaseline = false;
+
+    UINT64 waitMs = std::max<UINT64>(Config.FallbackMs, ADR_FALLBACK_EXCHANGES * Ladder[step].AirtimeNs / 1000000);
+
+    Deadline = TClock::now() + std::chrono::milliseconds(waitMs);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::Stop()
+{
+    if (!Running)
+        return;
+
+    Running = false;
+
+    if (Follower)
+        return;
+
+    Supervisor.Stop();
+
+    UINT8 status = 0;
+
+    if (HCI.SetRadioConfiguration(Base, WiMODLR_STORE_INTO_RAM, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+        std::cerr << "Warning: Radio configuration not restored" << std::endl;
+
+    Fanout.SetConfigId(0);
+    Fanout.PublishComment("adr done " + FormatStats());
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TAdrController::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "switches=" << Stats.Switches
+         << " faster=" << Stats.Faster
+         << " slower=" << Stats.Slower
+         << " power=" << Stats.PowerChanges
+         << " per=" << Stats.PerSteps
+         << " fallbacks=" << Stats.Fallbacks;
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  EncodeFrame
+//
+//------------------------------------------------------------------------------
+
+std::vector<UINT8>
+TAdrController::EncodeFrame(UINT8 sequence, const TWiMODLR_RadioConfig& radio)
+{
+    return std::vector<UINT8> { 'A', 'D', 'R', sequence, radio.SpreadingFactor, radio.Bandwidth,
+                                radio.ErrorCoding, radio.PowerLevel };
+}
+
+//------------------------------------------------------------------------------
+//
+//  DecodeFrame
+//
+//  @brief: only the announced fields of radio are set
+//
+//------------------------------------------------------------------------------
+
+bool
+TAdrController::DecodeFrame(const UINT8* data, int length, UINT8& sequence, TWiMODLR_RadioConfig& radio)
+{
+    if (length != ADR_FRAME_SIZE || std::memcmp(data, "ADR", 3))
+        return false;
+
+    if (data[4] < WiMODLR_RADIO_CONFIG_SF5 || data[4] > WiMODLR_RADIO_CONFIG_SF12
+        || data[5] > WiMODLR_RADIO_CONFIG_BW_1625kHz
+        || data[6] < WiMODLR_RADIO_CONFIG_EC_4_5 || data[6] > WiMODLR_RADIO_CONFIG_EC_4_8)
+        return false;
+
+    sequence              = data[3];
+    radio.SpreadingFactor = data[4];
+    radio.Bandwidth       = data[5];
+    radio.ErrorCoding     = data[6];
+    radio.PowerLevel      = data[7];
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Evaluate
+//
+//  @brief: one decision per window, applied by Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::Evaluate()
+{
+    double snr   = SumSnr / WindowCount;
+    double rssi  = SumRssi / WindowCount;
+    double noise = -174 + 10 * std::log10((double)AIRTIME_GetBandwidthHz(Ladder[Step].Bandwidth)) + ADR_NOISE_FIGURE_DB;
+
+    // a strong signal is only seen in the RSSI
+    if (snr >= ADR_SNR_SATURATION_DB)
+        snr = std::max(snr, rssi - noise);
+
+    TPerEstimate uplink   = Estimator.GetUplink();
+    TPerEstimate downlink = Estimator.GetDownlink();
+
+    double per = std::max(uplink.Trials ? (double)uplink.Errors / uplink.Trials : 0.0,
+                          downlink.Trials ? (double)downlink.Errors / downlink.Trials : 0.0);
+
+    RefSnr  = snr + GetBandwidthDb(Ladder[Step].Bandwidth) - Power;
+    LastSnr = snr;
+    LastPer = per;
+
+    // no decision until the peer follows
+    if (Confirming)
+        return;
+
+    size_t      step   = Step;
+    int         power  = Power;
+    double      margin = GetMargin(step, power);
+    const char* reason = "margin";
+
+    if (margin < 0)
+    {
+        // more power first, then slower steps
+        while (GetMargin(step, power) < 0 && power < Config.MaxPower)
+            power = std::min<int>(power + ADR_POWER_STEP_DB, Config.MaxPower);
+
+        while (GetMargin(step, power) < 0 && step + 1 < Ladder.size())
+            step++;
+
+        reason  = "snr";
+        Surplus = 0;
+    }
+    else if (per > Config.TargetPer)
+    {
+        // losses with enough SNR (interference), one step slower
+        if (step + 1 < Ladder.size())
+            step++;
+        else
+            power = std::min<int>(power + ADR_POWER_STEP_DB, Config.MaxPower);
+
+        // a longer hold before the next faster step
+        reason  = "per";
+        Surplus = -(int)Config.HoldWindows;
+    }
+    else if (margin >= Config.HysteresisDb)
+    {
+        if (++Surplus < (int)Config.HoldWindows)
+            return;
+
+        // fastest step which keeps the hysteresis, then less power
+        while (step > 0 && GetMargin(step - 1, power) >= Config.HysteresisDb)
+            step--;
+
+        if (step == Step)
+        {
+            while (power - ADR_POWER_STEP_DB >= Config.MinPower
+                   && GetMargin(step, power - ADR_POWER_STEP_DB) >= Config.HysteresisDb)
+                power -= ADR_POWER_STEP_DB;
+        }
+
+        Surplus = 0;
+    }
+    else
+    {
+        Surplus = std::min(Surplus, 0);
+    }
+
+    if (step != Step || power != Power)
+    {
+        Pending       = true;
+        PendingStep   = step;
+        PendingPower  = (UINT8)power;
+        PendingReason = reason;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLinkTest_StatusInd
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status)
+{
+    if (Running && !Follower)
+    {
+        // a packet of the peer confirms the switch
+        if (Confirming)
+        {
+            if (!HasBaseline)
+            {
+                BaseLRxCount = status.LRxCount;
+                HasBaseline  = true;
+            }
+            else if (status.LRxCount != BaseLRxCount)
+            {
+                Confirming = false;
+            }
+        }
+
+        SumSnr  += std::min(status.LocalSNR, status.PeerSNR);
+        SumRssi += std::min(status.LocalRSSI, status.PeerRSSI);
+
+        Estimator.Add(status);
+
+        if (++WindowCount >= Config.WindowSize && !Pending)
+        {
+            Evaluate();
+
+            // the next window starts at this indication
+            WindowCount = 0;
+            SumSnr      = 0;
+            SumRssi     = 0;
+            Estimator.Reset();
+            Estimator.Add(status);
+        }
+    }
+
+    Supervisor.evRadioLinkTest_StatusInd(status);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_RxUMessage
+//
+//  @brief: follower, announcements are applied by Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TAdrController::evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg)
+{
+    if (!Running || !Follower || rxMsg.Length < DATALINK_MSG_HEADER_SIZE)
+        return;
+
+    // extended format: RSSI, SNR and time after the payload
+    int length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE
+                 - ((rxMsg.Payload[0] & 0x01) ? DATALINK_MSG_FOOTER_SIZE : 0);
+
+    TWiMODLR_RadioConfig radio = Base;
+    UINT8                sequence;
+
+    if (!DecodeFrame(&rxMsg.Payload[DATALINK_MSG_HEADER_SIZE], length, sequence, radio))
+        return;
+
+    // repeated announcement
+    if (HasSequence && sequence == LastSequence)
+        return;
+
+    Announced    = radio;
+    HasAnnounce  = true;
+    LastSequence = sequence;
+    HasSequence  = true;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+//
+//	File:		AdrController.h
+//
+//	Abstract:	Adaptive Data Rate Control of the Radio Link
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef ADRCONTROLLER_H
+#define ADRCONTROLLER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "SampleFanout.h"
+#include "RadioSupervisor.h"
+#include "PerInterval.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// switch announcement: "ADR", sequence, SF, bandwidth, coding rate, power
+#define ADR_FRAME_SIZE          8
+
+// noise figure of the receivers [dB]
+#define ADR_NOISE_FIGURE_DB     6
+
+// reported SNR saturates, above this the RSSI gives the margin [dB]
+#define ADR_SNR_SATURATION_DB   5
+
+// power step [dB]
+#define ADR_POWER_STEP_DB       3
+
+// the peer did not follow if none of this many exchanges arrive
+#define ADR_FALLBACK_EXCHANGES  10
+
+typedef struct
+{
+    // max. PER of either direction per window
+    double  TargetPer           = 0.1;
+
+    // SNR above the demodulation floor of a configuration [dB]
+    double  MarginDb            = 5;
+
+    // additional margin before a faster step or less power [dB]
+    double  HysteresisDb        = 3;
+
+    // indications per decision, windows with surplus margin before a
+    // faster step
+    UINT32  WindowSize          = 20;
+    UINT32  HoldWindows         = 3;
+
+    // fastest bandwidth of the ladder (WiMODLR_RADIO_CONFIG_BW_...)
+    UINT8   MaxBandwidth        = WiMODLR_RADIO_CONFIG_BW_1625kHz;
+
+    // power range [dBm], the SX1280 ends at 12.5 dBm
+    UINT8   MinPower            = 0;
+    UINT8   MaxPower            = 12;
+
+    // announcements per switch, min. time before falling back [ms]
+    UINT32  AnnounceRepeats     = 3;
+    UINT32  FallbackMs          = 5000;
+}TAdrConfig;
+
+typedef struct
+{
+    UINT32  Switches;
+    UINT32  Faster;
+    UINT32  Slower;
+    UINT32  PowerChanges;
+    UINT32  PerSteps;
+    UINT32  Fallbacks;
+
+    // announcements applied by a follower
+    UINT32  Applied;
+}TAdrStats;
+
+typedef struct
+{
+    UINT8   SpreadingFactor;
+    UINT8   Bandwidth;
+
+    // test exchange time on air [ns], demodulation floor at 203 kHz [dB]
+    UINT64  AirtimeNs;
+    double  RequiredSnr;
+}TAdrStep;
+
+//------------------------------------------------------------------------------
+//
+// TAdrController Class Declaration
+//
+// Leader: registered as HCI client in front of the supervisor. The SF /
+// bandwidth combinations form a ladder ordered by time on air (Airtime.h),
+// each step needs less SNR than the faster ones. Per window of indications
+// the worse direction of the radio link test gives SNR (RSSI above the
+// saturation of the reported SNR) and PER. The controller moves to the
+// fastest step whose margin exceeds MarginDb + HysteresisDb after
+// HoldWindows such windows and lowers the power once no faster step fits;
+// a margin below MarginDb raises the power first and then moves to slower
+// steps, a PER above the target with enough margin (interference) moves one
+// step slower at once.
+//
+// A switch is announced to the peer with unreliable radio messages in the
+// old configuration (TRadioSupervisor::Reconfigure), then applied on both
+// ends. Without a packet of the peer within ADR_FALLBACK_EXCHANGES
+// exchanges the previous configuration is announced and applied again.
+// Samples are tagged with the ladder step (CSV column "Config").
+//
+// Follower: the host of the peer module applies announced configurations
+// to RAM.
+//
+// Poll switches and must be called from the thread which drives the HCI.
+//
+//------------------------------------------------------------------------------
+
+class TAdrController : public TWiMODLRHCIClient
+{
+    public:
+                    TAdrController(TWiMODLRHCI& hci, TRadioSupervisor& supervisor, TSampleFanout& fanout);
+
+    // read the current configuration, build the ladder and apply the step
+    // closest to it (supervisor started before)
+    bool            Start(const TAdrConfig& config = TAdrConfig());
+
+    // peer host: apply announcements
+    bool            StartFollower();
+
+    void            Poll();
+
+    // stop the test and restore the configuration found at Start (RAM)
+    void            Stop();
+
+    const std::vector<TAdrStep>&    GetLadder() const { return Ladder; }
+    size_t          GetStep() const { return Step; }
+    UINT8           GetPower() const { return Power; }
+
+    TAdrStats       GetStats() const { return Stats; }
+
+    // "switches=.. faster=.. slower=.. power=.. per=.. fallbacks=.."
+    std::string     FormatStats() const;
+
+    // announcement frame and its parser
+    static std::vector<UINT8>   EncodeFrame(UINT8 sequence, const TWiMODLR_RadioConfig& radio);
+    static bool     DecodeFrame(const UINT8* data, int length, UINT8& sequence, TWiMODLR_RadioConfig& radio);
+
+    // HCI client interface, indications are forwarded to the supervisor
+    void            evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override;
+    void            evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override;
+
+    private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    void            BuildLadder();
+    double          GetMargin(size_t step, int power) const;
+    void            Evaluate();
+    void            Switch(size_t step, UINT8 power, const char* reason);
+    TWiMODLR_RadioConfig    GetRadio(size_t step, UINT8 power) const;
+
+    TWiMODLRHCI&        HCI;
+    TRadioSupervisor&   Supervisor;
+    TSampleFanout&      Fanout;
+
+    TAdrConfig              Config;
+    TWiMODLR_RadioConfig    Base;
+    std::vector<TAdrStep>   Ladder;
+    bool                    Running;
+    bool                    Follower;
+
+    size_t              Step;
+    UINT8               Power;
+    UINT8               Sequence;
+
+    // decision of the indication callback, applied by Poll
+    bool                Pending;
+    size_t              PendingStep;
+    UINT8               PendingPower;
+    const char*         PendingReason;
+
+    // current window: worse direction SNR / RSSI, PER from the counters
+    UINT32              WindowCount;
+    double              SumSnr;
+    double              SumRssi;
+    TLinkPerEstimator   Estimator;
+    int                 Surplus;
+
+    // SNR of the worse direction at 203 kHz and 0 dBm, last window
+    double              RefSnr;
+    double              LastSnr;
+    double              LastPer;
+
+    // switch not yet confirmed by a packet of the peer
+    bool                Confirming;
+    bool                HasBaseline;
+    UINT32              BaseLRxCount;
+    size_t              PreviousStep;
+    UINT8               PreviousPower;
+    TClock::time_point  Deadline;
+
+    // follower: configuration to apply
+    bool                HasAnnounce;
+    TWiMODLR_RadioConfig    Announced;
+    UINT8               LastSequence;
+    bool                HasSequence;
+
+    TAdrStats           Stats;
+};
+
+#endif // ADRCONTROLLER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+//
+//	File:		Airtime.cpp
+//
+//	Abstract:	Time on Air and Throughput Model of the Radio Configurations
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "Airtime.h"
+#include <iomanip>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  Reference Values
+//
+//  @brief: 15 byte payload: LoRa SF7 and SF12 (2 bits less per symbol) at
+//          203.125 kHz, SF5 at 1625 kHz, FLRC at the fastest rate with
+//          coding rate 1/2 and at the slowest uncoded
+//
+//------------------------------------------------------------------------------
+
+static_assert(AIRTIME_GetLoRaNs(WiMODLR_RADIO_CONFIG_SF7, WiMODLR_RADIO_CONFIG_BW_203kHz,
+                                WiMODLR_RADIO_CONFIG_EC_4_5, 15) == 28514461, "SF7 time on air");
+static_assert(AIRTIME_GetLoRaNs(WiMODLR_RADIO_CONFIG_SF12, WiMODLR_RADIO_CONFIG_BW_203kHz,
+                                WiMODLR_RADIO_CONFIG_EC_4_5, 15) == 710813538, "SF12 time on air");
+static_assert(AIRTIME_GetLoRaNs(WiMODLR_RADIO_CONFIG_SF5, WiMODLR_RADIO_CONFIG_BW_1625kHz,
+                                WiMODLR_RADIO_CONFIG_EC_4_5, 15) == 1127384, "SF5 time on air");
+static_assert(AIRTIME_GetFlrcNs(WiMODLR_RADIO_CONFIG_FLRC_1300kbps, WiMODLR_RADIO_CONFIG_FLRC_CR_1_2, 15) == 292307,
+              "FLRC 1300 kb/s time on air");
+static_assert(AIRTIME_GetFlrcNs(WiMODLR_RADIO_CONFIG_FLRC_260kbps, WiMODLR_RADIO_CONFIG_FLRC_CR_1, 15) == 830769,
+              "FLRC 260 kb/s time on air");
+
+//------------------------------------------------------------------------------
+//
+//  AIRTIME_Format
+//
+//------------------------------------------------------------------------------
+
+std::string
+AIRTIME_Format(const TWiMODLR_RadioConfig& radio, UINT8 payloadSize)
+{
+    std::ostringstream text;
+
+    text << std::fixed << std::setprecision(2)
+         << "airtime=" << AIRTIME_GetTimeOnAirNs(radio, payloadSize) / 1e6 << " ms"
+         << std::setprecision(1)
+         << " ceiling=" << AIRTIME_GetLinkTestRate(radio, payloadSize) << "/s"
+         << std::setprecision(0)
+         << " goodput=" << AIRTIME_GetGoodput(radio, payloadSize) << " bit/s";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  AIRTIME_PrintTable
+//
+//------------------------------------------------------------------------------
+
+void
+AIRTIME_PrintTable(std::ostream& out, UINT8 payloadSize)
+{
+    static const char* bandwidths[]  = { "203", "406", "812", "1625" };
+    static const char* bitRates[]    = { "1300", "1040", "650", "520", "325", "260" };
+    static const char* codingRates[] = { "1/2", "3/4", "1" };
+
+    out << "Time on air for " << (int)payloadSize << " byte payload (SX1280), bw in kHz for LoRa, bit rate in kb/s"
+        << " for FLRC" << std::endl
+        << std::setw(6) << "mod"
+        << std::setw(4) << "sf"
+        << std::setw(6) << "bw"
+        << std::setw(6) << "cr"
+        << std::setw(12) << "airtime ms"
+        << std::setw(10) << "pkts/s"
+        << std::setw(10) << "rlt/s"
+        << std::setw(12) << "bit/s" << std::endl;
+
+    TWiMODLR_RadioConfig radio = TWiMODLR_RadioConfig();
+
+    auto printRow = [&](const char* modulation, const std::string& sf, const char* bw, const std::string& cr)
+    {
+        out << std::fixed
+            << std::setw(6) << modulation
+            << std::setw(4) << sf
+            << std::setw(6) << bw
+            << std::setw(6) << cr
+            << std::setprecision(3)
+            << std::setw(12) << AIRTIME_GetTimeOnAirNs(radio, payloadSize) / 1e6
+            << std::setprecision(2)
+            << std::setw(10) << AIRTIME_GetPacketRate(radio, payloadSize)
+            << std::setw(10) << AIRTIME_GetLinkTestRate(radio, payloadSize)
+            << std::setprecision(0)
+            << std::setw(12) << AIRTIME_GetGoodput(radio, payloadSize) << std::endl;
+    };
+
+    radio.Modulation = WiMODLR_RADIO_CONFIG_MOD_LORA;
+
+    for (UINT8 sf = WiMODLR_RADIO_CONFIG_SF5; sf <= WiMODLR_RADIO_CONFIG_SF12; sf++)
+    {
+        for (UINT8 bw = WiMODLR_RADIO_CONFIG_BW_203kHz; bw <= WiMODLR_RADIO_CONFIG_BW_1625kHz; bw++)
+        {
+            for (UINT8 ec = WiMODLR_RADIO_CONFIG_EC_4_5; ec <= WiMODLR_RADIO_CONFIG_EC_4_8; ec++)
+            {
+                radio.SpreadingFactor = sf;
+                radio.Bandwidth       = bw;
+                radio.ErrorCoding     = ec;
+
+                printRow("lora", std::to_string(sf), bandwidths[bw], "4/" + std::to_string(ec + 4));
+            }
+        }
+    }
+
+    radio.Modulation = WiMODLR_RADIO_CONFIG_MOD_FLRC;
+
+    for (UINT8 rate = WiMODLR_RADIO_CONFIG_FLRC_1300kbps; rate <= WiMODLR_RADIO_CONFIG_FLRC_260kbps; rate++)
+    {
+        for (UINT8 cr = WiMODLR_RADIO_CONFIG_FLRC_CR_1_2; cr <= WiMODLR_RADIO_CONFIG_FLRC_CR_1; cr++)
+        {
+            radio.Bandwidth   = rate;
+            radio.ErrorCoding = cr;
+
+            printRow("flrc", "-", bitRates[rate], codingRates[cr]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
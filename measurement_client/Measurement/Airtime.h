@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+//
+//	File:		Airtime.h
+//
+//	Abstract:	Time on Air and Throughput Model of the Radio Configurations
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef AIRTIME_H
+#define AIRTIME_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include <ostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+// Time on air of the SX1280 in the iM282A (2.4 GHz) as given in its data
+// sheet. LoRa: 8 preamble symbols, explicit header, payload CRC, SF11 and
+// SF12 always with 2 bits less per symbol, bandwidths 203.125 to 1625 kHz.
+// FLRC: preamble and sync word uncoded, header, payload, CRC and the tail
+// of the convolutional code at the coding rate. All functions are
+// constexpr; times are truncated to whole ns from exact integer arithmetic.
+//
+// The HCI codes are the iM282A names of WiMODLRHCI.h, the iM880 names of
+// the same values (125 kHz, FSK, ...) describe a different radio.
+//
+// The payload length is the radio payload, e.g. PacketSize of the radio
+// link test. A radio link test exchange is one packet of the local module
+// and the answer of the peer, processing time is not included. Its rate is
+// the ceiling written next to the measured packet rate (# radio and # sweep
+// comments of the client).
+//
+//------------------------------------------------------------------------------
+
+#define AIRTIME_LORA_PREAMBLE_SYMBOLS   8
+#define AIRTIME_LORA_HEADER_BITS        20
+#define AIRTIME_LORA_CRC_BITS           16
+
+#define AIRTIME_FLRC_PREAMBLE_BITS      32
+#define AIRTIME_FLRC_SYNC_BITS          32
+#define AIRTIME_FLRC_HEADER_BITS        16
+#define AIRTIME_FLRC_CRC_BITS           16
+#define AIRTIME_FLRC_TAIL_BITS          6
+
+// WiMODLR_RADIO_CONFIG_BW_... to Hz, 203.125 kHz rounded down
+constexpr UINT32
+AIRTIME_GetBandwidthHz(UINT8 bandwidth)
+{
+    return 203125u << (bandwidth <= WiMODLR_RADIO_CONFIG_BW_1625kHz ? bandwidth : WiMODLR_RADIO_CONFIG_BW_1625kHz);
+}
+
+// WiMODLR_RADIO_CONFIG_FLRC_... to bit/s
+constexpr UINT32
+AIRTIME_GetFlrcBitRate(UINT8 bitRate)
+{
+    constexpr UINT32 rates[] = { 1300000, 1040000, 650000, 520000, 325000, 260000 };
+
+    return rates[bitRate <= WiMODLR_RADIO_CONFIG_FLRC_260kbps ? bitRate : WiMODLR_RADIO_CONFIG_FLRC_260kbps];
+}
+
+constexpr UINT64
+AIRTIME_GetSymbolNs(UINT8 spreadingFactor, UINT8 bandwidth)
+{
+    return (1000000000ull << spreadingFactor) / AIRTIME_GetBandwidthHz(bandwidth);
+}
+
+// symbols after the preamble and sync: header, payload and CRC
+constexpr UINT32
+AIRTIME_GetPayloadSymbols(UINT8 spreadingFactor, UINT8 errorCoding, UINT8 payloadSize)
+{
+    int codingRate = errorCoding < WiMODLR_RADIO_CONFIG_EC_4_5 ? WiMODLR_RADIO_CONFIG_EC_4_5
+                   : errorCoding > WiMODLR_RADIO_CONFIG_EC_4_8 ? WiMODLR_RADIO_CONFIG_EC_4_8 : errorCoding;
+    int numerator  = 8 * payloadSize + AIRTIME_LORA_CRC_BITS + AIRTIME_LORA_HEADER_BITS - 4 * spreadingFactor
+                     + (spreadingFactor >= WiMODLR_RADIO_CONFIG_SF7 ? 8 : 0);
+    int bitsPerRow = 4 * (spreadingFactor - (spreadingFactor >= WiMODLR_RADIO_CONFIG_SF11 ? 2 : 0));
+    int rows       = numerator > 0 ? (numerator + bitsPerRow - 1) / bitsPerRow : 0;
+
+    return (UINT32)(8 + rows * (codingRate + 4));
+}
+
+constexpr UINT64
+AIRTIME_GetLoRaNs(UINT8 spreadingFactor, UINT8 bandwidth, UINT8 errorCoding, UINT8 payloadSize)
+{
+    // preamble + 4.25 symbols sync (6.25 for SF5 and SF6), in quarters
+    UINT64 quarters = 4 * (AIRTIME_LORA_PREAMBLE_SYMBOLS + AIRTIME_GetPayloadSymbols(spreadingFactor, errorCoding, payloadSize))
+                      + (spreadingFactor < WiMODLR_RADIO_CONFIG_SF7 ? 25 : 17);
+
+    return quarters * (1000000000ull << spreadingFactor) / (4ull * AIRTIME_GetBandwidthHz(bandwidth));
+}
+
+// bits on air at the bit rate
+constexpr UINT32
+AIRTIME_GetFlrcBits(UINT8 errorCoding, UINT8 payloadSize)
+{
+    UINT32 bits = AIRTIME_FLRC_HEADER_BITS + 8 * payloadSize + AIRTIME_FLRC_CRC_BITS;
+
+    if (errorCoding == WiMODLR_RADIO_CONFIG_FLRC_CR_1_2)
+        bits = 2 * (bits + AIRTIME_FLRC_TAIL_BITS);
+    else if (errorCoding == WiMODLR_RADIO_CONFIG_FLRC_CR_3_4)
+        bits = (4 * (bits + AIRTIME_FLRC_TAIL_BITS) + 2) / 3;
+
+    return AIRTIME_FLRC_PREAMBLE_BITS + AIRTIME_FLRC_SYNC_BITS + bits;
+}
+
+constexpr UINT64
+AIRTIME_GetFlrcNs(UINT8 bitRate, UINT8 errorCoding, UINT8 payloadSize)
+{
+    return AIRTIME_GetFlrcBits(errorCoding, payloadSize) * 1000000000ull / AIRTIME_GetFlrcBitRate(bitRate);
+}
+
+// 0 for modulations without a model
+constexpr UINT64
+AIRTIME_GetTimeOnAirNs(const TWiMODLR_RadioConfig& radio, UINT8 payloadSize)
+{
+    if (radio.Modulation == WiMODLR_RADIO_CONFIG_MOD_FLRC)
+        return AIRTIME_GetFlrcNs(radio.Bandwidth, radio.ErrorCoding, payloadSize);
+
+    if (radio.Modulation != WiMODLR_RADIO_CONFIG_MOD_LORA)
+        return 0;
+
+    return AIRTIME_GetLoRaNs(radio.SpreadingFactor, radio.Bandwidth, radio.ErrorCoding, payloadSize);
+}
+
+// packets per second sent back to back
+constexpr double
+AIRTIME_GetPacketRate(const TWiMODLR_RadioConfig& radio, UINT8 payloadSize)
+{
+    UINT64 timeNs = AIRTIME_GetTimeOnAirNs(radio, payloadSize);
+
+    return timeNs ? 1e9 / (double)timeNs : 0;
+}
+
+// radio link test exchanges (local packet + answer) per second
+constexpr double
+AIRTIME_GetLinkTestRate(const TWiMODLR_RadioConfig& radio, UINT8 payloadSize)
+{
+    return AIRTIME_GetPacketRate(radio, payloadSize) / 2;
+}
+
+// payload bits per second sent back to back
+constexpr double
+AIRTIME_GetGoodput(const TWiMODLR_RadioConfig& radio, UINT8 payloadSize)
+{
+    return 8.0 * payloadSize * AIRTIME_GetPacketRate(radio, payloadSize);
+}
+
+// "airtime=28.51 ms ceiling=17.5/s goodput=4208 bit/s", ceiling = radio
+// link test exchanges
+std::string     AIRTIME_Format(const TWiMODLR_RadioConfig& radio, UINT8 payloadSize);
+
+// every LoRa and FLRC configuration for one payload size
+void            AIRTIME_PrintTable(std::ostream& out, UINT8 payloadSize);
+
+#endif // AIRTIME_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
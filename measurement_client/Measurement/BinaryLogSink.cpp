@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BinaryLogSink.cpp
+//
+//	Abstract:	Sample Sink writing compressed RLT Blocks
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "BinaryLogSink.h"
+
+//------------------------------------------------------------------------------
+//
+//  TBinaryLogSink - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TBinaryLogSink::TBinaryLogSink(int blockSamples)
+    : Encoder(blockSamples)
+{
+    FlushIntervalMs = BLOCK_WRITER_DEFAULT_FLUSH_MS;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TBinaryLogSink - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TBinaryLogSink::~TBinaryLogSink()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TBinaryLogSink::Open(const std::string& filename, const TBlockFileConfig& config)
+{
+    FlushIntervalMs = config.FlushIntervalMs;
+
+    return Writer.Open(filename, config);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+bool
+TBinaryLogSink::Close()
+{
+    if (!Writer.IsOpen())
+        return true;
+
+    bool result = FlushBlock();
+
+    return Writer.Close() && result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteSample
+//
+//------------------------------------------------------------------------------
+
+bool
+TBinaryLogSink::WriteSample(const TRLTSample& sample, const std::string& /* encoded */)
+{
+    if (!Writer.IsOpen())
+        return false;
+
+    if (!Encoder.Count())
+        FirstPending = std::chrono::steady_clock::now();
+
+    if (Encoder.Add(sample))
+        return FlushBlock();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: write partial block after the flush interval
+//
+//------------------------------------------------------------------------------
+
+void
+TBinaryLogSink::Poll()
+{
+    if (Encoder.Count() && FlushIntervalMs
+        && std::chrono::steady_clock::now() - FirstPending >= std::chrono::milliseconds(FlushIntervalMs))
+    {
+        FlushBlock();
+    }
+
+    Writer.Poll();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FlushBlock
+//
+//  @brief: encode pending samples and append the block
+//
+//------------------------------------------------------------------------------
+
+bool
+TBinaryLogSink::FlushBlock()
+{
+    if (!Encoder.Count())
+        return true;
+
+    Block.clear();
+    if (!Encoder.Flush(Block))
+        return false;
+
+    return Writer.Write((const char*)Block.data(), Block.size());
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BinaryLogSink.h
+//
+//	Abstract:	Sample Sink writing compressed RLT Blocks
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef BINARYLOGSINK_H
+#define BINARYLOGSINK_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleSink.h"
+#include "RLTCodec.h"
+#include "BlockFileWriter.h"
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// samples per block of the binary log
+#define BINARY_LOG_DEFAULT_SAMPLES  256
+
+//------------------------------------------------------------------------------
+//
+// TBinaryLogSink Class Declaration
+//
+// Samples are collected by a TRLTBlockEncoder, every full block is appended
+// through a TBlockFileWriter. A partial block is written as a block of its
+// own once the flush interval of the storage config elapsed, so the binary
+// log loses no more than the CSV log on power failure.
+//
+//------------------------------------------------------------------------------
+
+class TBinaryLogSink : public TSampleSink
+{
+    public:
+                    TBinaryLogSink(int blockSamples = BINARY_LOG_DEFAULT_SAMPLES);
+                    ~TBinaryLogSink();
+
+    bool            Open(const std::string& filename, const TBlockFileConfig& config = TBlockFileConfig());
+    bool            Close();
+
+    // submit writes through an event backend (0 = direct writes)
+    void            SetBackend(TEventBackend* backend) { Writer.SetBackend(backend); }
+
+    const TBlockFileStats&  GetStorageStats() const { return Writer.GetStats(); }
+
+    // sample sink interface
+    std::string     GetName() const override { return "binary"; }
+    bool            WriteSample(const TRLTSample& sample, const std::string& encoded) override;
+    void            Poll() override;
+
+    private:
+
+    bool            FlushBlock();
+
+    TRLTBlockEncoder    Encoder;
+    TBlockFileWriter    Writer;
+    UINT32              FlushIntervalMs;
+
+    std::vector<UINT8>  Block;
+
+    // reception of the first pending sample
+    std::chrono::steady_clock::time_point FirstPending;
+};
+
+#endif // BINARYLOGSINK_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,474 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BlockFileWriter.cpp
+//
+//	Abstract:	Coalescing Block Writer for SD Card Storage
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "BlockFileWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+//
+//  TBlockFileWriter - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TBlockFileWriter::TBlockFileWriter()
+{
+    Handle          = -1;
+    DirectHandle    = -1;
+    Buffer          = 0;
+    BufferUsed      = 0;
+    BufferFlushed   = 0;
+    BlockOffset     = 0;
+    PreallocatedEnd = 0;
+    PendingOffset   = 0;
+    PendingLength   = 0;
+    QueuedOffset    = 0;
+    QueuedLength    = 0;
+    Backend         = 0;
+
+    std::memset(&Stats, 0, sizeof(Stats));
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TBlockFileWriter - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TBlockFileWriter::~TBlockFileWriter()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: open file, continue at its end
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::Open(const std::string& filename, const TBlockFileConfig& config)
+{
+    if (IsOpen())
+        Close();
+
+    Config = config;
+
+    // block size must be a non-zero multiple of the alignment
+    Config.BlockSize = std::max<UINT32>(Config.BlockSize, BLOCK_WRITER_ALIGNMENT);
+    Config.BlockSize = (Config.BlockSize + BLOCK_WRITER_ALIGNMENT - 1) & ~(UINT32)(BLOCK_WRITER_ALIGNMENT - 1);
+
+    Handle = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (Handle < 0)
+    {
+        std::cerr << "Error: Could not open " << filename << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    Buffer = (char*)std::aligned_alloc(BLOCK_WRITER_ALIGNMENT, Config.BlockSize);
+    if (!Buffer)
+    {
+        Close();
+        return false;
+    }
+
+    // start at last aligned offset, keep already written tail in the buffer
+    struct stat info;
+    if (::fstat(Handle, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    BlockOffset = (UINT64)info.st_size & ~(UINT64)(BLOCK_WRITER_ALIGNMENT - 1);
+    BufferUsed  = (UINT32)((UINT64)info.st_size - BlockOffset);
+    BufferFlushed = BufferUsed;
+
+    if (BufferUsed && ::pread(Handle, Buffer, BufferUsed, BlockOffset) != (ssize_t)BufferUsed)
+    {
+        Close();
+        return false;
+    }
+
+    PreallocatedEnd = (UINT64)info.st_size;
+    PendingLength   = 0;
+    QueuedLength    = 0;
+
+    // optional direct I/O handle, silently fall back to buffered writes
+    if (Config.DirectIO)
+    {
+        #ifdef O_DIRECT
+        DirectHandle = ::open(filename.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+        #endif
+        if (DirectHandle < 0)
+            std::cerr << "Warning: O_DIRECT not available for " << filename << std::endl;
+    }
+
+    Preallocate(BlockOffset + Config.BlockSize);
+
+    LastFlush = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//  @brief: write remaining data, release unused preallocated extents
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::Close()
+{
+    bool result = false;
+
+    if (Handle >= 0)
+    {
+        result = Flush();
+
+        // queued writes must be completed before the file is truncated
+        if (Backend && !Backend->Drain())
+            result = false;
+
+        Stats.Syscalls += 2;
+        ::fdatasync(Handle);
+
+        // drop preallocated extents behind the logical end
+        if (::ftruncate(Handle, BlockOffset + BufferUsed) != 0)
+            result = false;
+
+        ::close(Handle);
+        Handle = -1;
+    }
+
+    if (DirectHandle >= 0)
+    {
+        ::close(DirectHandle);
+        DirectHandle = -1;
+    }
+
+    std::free(Buffer);
+    Buffer        = 0;
+    BufferUsed    = 0;
+    BufferFlushed = 0;
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Write
+//
+//  @brief: append data to block buffer
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::Write(const char* data, size_t length)
+{
+    if (!IsOpen())
+        return false;
+
+    while (length)
+    {
+        // buffer still full after a failed write, retry before appending
+        if (BufferUsed == Config.BlockSize && !WriteBlock())
+        {
+            Stats.DroppedBytes += length;
+            return false;
+        }
+
+        UINT32 chunk = (UINT32)std::min<size_t>(length, Config.BlockSize - BufferUsed);
+
+        std::memcpy(Buffer + BufferUsed, data, chunk);
+        BufferUsed += chunk;
+        data       += chunk;
+        length     -= chunk;
+    }
+
+    bool result = true;
+
+    // write full block right away
+    if (BufferUsed == Config.BlockSize)
+        result = WriteBlock();
+
+    return Poll() && result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: timed flush of partially filled block
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::Poll()
+{
+    if (!Config.FlushIntervalMs || !BufferUsed)
+        return true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - LastFlush).count() < Config.FlushIntervalMs)
+        return true;
+
+    return Flush();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Flush
+//
+//  @brief: write the unwritten part of the block through the buffered
+//          handle, starting at its first page not yet written
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::Flush()
+{
+    LastFlush = std::chrono::steady_clock::now();
+
+    if (!IsOpen() || BufferFlushed == BufferUsed)
+        return true;
+
+    UINT32 from   = GetWriteStart();
+    UINT32 length = BufferUsed - from;
+
+    if (Backend && DirectHandle < 0)
+    {
+        if (!QueueWrite(from, length))
+            return false;
+
+        BufferFlushed = BufferUsed;
+        Stats.PartialFlushes++;
+        return true;
+    }
+
+    Stats.Syscalls++;
+    auto    start   = std::chrono::steady_clock::now();
+    ssize_t written = ::pwrite(Handle, Buffer + from, length, BlockOffset + from);
+    auto    stop    = std::chrono::steady_clock::now();
+
+    Latency.Add(std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count());
+
+    if (written != (ssize_t)length)
+    {
+        Stats.WriteErrors++;
+        return false;
+    }
+
+    StartWriteback(BlockOffset + from, length);
+
+    BufferFlushed = BufferUsed;
+    Stats.PartialFlushes++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteBlock
+//
+//  @brief: write one full, aligned block, pages written by timed flushes
+//          are skipped
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::WriteBlock()
+{
+    Preallocate(BlockOffset + 2 * (UINT64)Config.BlockSize);
+
+    // aligned in the buffer and in the file, also for O_DIRECT
+    UINT32 from   = GetWriteStart();
+    UINT32 length = Config.BlockSize - from;
+
+    // queued, data is copied by the backend
+    if (Backend && DirectHandle < 0)
+    {
+        if (!QueueWrite(from, length))
+        {
+            Stats.WriteErrors++;
+            return false;
+        }
+
+        BlockOffset  += Config.BlockSize;
+        BufferUsed    = 0;
+        BufferFlushed = 0;
+        LastFlush     = std::chrono::steady_clock::now();
+
+        Stats.BytesWritten  += Config.BlockSize;
+        Stats.BlocksWritten++;
+
+        return true;
+    }
+
+    auto    start   = std::chrono::steady_clock::now();
+    ssize_t written = -1;
+
+    if (DirectHandle >= 0)
+    {
+        Stats.Syscalls++;
+        written = ::pwrite(DirectHandle, Buffer + from, length, BlockOffset + from);
+
+        // file system refused direct I/O, continue buffered
+        if (written < 0 && errno == EINVAL)
+        {
+            ::close(DirectHandle);
+            DirectHandle = -1;
+        }
+    }
+
+    bool buffered = DirectHandle < 0;
+    if (buffered)
+    {
+        Stats.Syscalls++;
+        written = ::pwrite(Handle, Buffer + from, length, BlockOffset + from);
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+
+    Latency.Add(std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count());
+
+    if (written != (ssize_t)length)
+    {
+        // keep data, retried on next write
+        Stats.WriteErrors++;
+        return false;
+    }
+
+    if (buffered)
+        StartWriteback(BlockOffset + from, length);
+
+    BlockOffset  += Config.BlockSize;
+    BufferUsed    = 0;
+    BufferFlushed = 0;
+    LastFlush     = stop;
+
+    Stats.BytesWritten  += Config.BlockSize;
+    Stats.BlocksWritten++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  QueueWrite
+//
+//  @brief: queue range of the buffer to the backend; the range queued
+//          before has normally been submitted by a Poll since, its
+//          writeback is started now
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::QueueWrite(UINT32 from, UINT32 length)
+{
+    if (!Backend->QueueWrite(Handle, Buffer + from, length, BlockOffset + from))
+        return false;
+
+    if (QueuedLength)
+        StartWriteback(QueuedOffset, QueuedLength);
+
+    QueuedOffset = BlockOffset + from;
+    QueuedLength = length;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Preallocate
+//
+//  @brief: reserve file extents ahead of the write position
+//
+//------------------------------------------------------------------------------
+
+bool
+TBlockFileWriter::Preallocate(UINT64 end)
+{
+    if (!Config.PreallocateSize || end <= PreallocatedEnd)
+        return true;
+
+    UINT64 newEnd = ((end + Config.PreallocateSize - 1) / Config.PreallocateSize) * Config.PreallocateSize;
+
+    Stats.Syscalls++;
+
+    #ifdef FALLOC_FL_KEEP_SIZE
+    // keep file size, readers only see written data
+    if (::fallocate(Handle, FALLOC_FL_KEEP_SIZE, PreallocatedEnd, newEnd - PreallocatedEnd) == 0)
+    {
+        PreallocatedEnd = newEnd;
+        return true;
+    }
+    #endif
+
+    // not supported by file system, don't try again
+    Config.PreallocateSize = 0;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  StartWriteback
+//
+//  @brief: start writeback of given range, wait for previous range and
+//          drop it from the page cache
+//
+//------------------------------------------------------------------------------
+
+void
+TBlockFileWriter::StartWriteback(UINT64 offset, UINT64 length)
+{
+    #ifdef SYNC_FILE_RANGE_WRITE
+    if (PendingLength)
+    {
+        Stats.Syscalls += 2;
+        ::sync_file_range(Handle, PendingOffset, PendingLength,
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+
+        ::posix_fadvise(Handle, PendingOffset, PendingLength, POSIX_FADV_DONTNEED);
+    }
+
+    Stats.Syscalls++;
+    ::sync_file_range(Handle, offset, length, SYNC_FILE_RANGE_WRITE);
+
+    PendingOffset = offset;
+    PendingLength = length;
+    #else
+    (void)offset;
+    (void)length;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BlockFileWriter.h
+//
+//	Abstract:	Coalescing Block Writer for SD Card Storage
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef BLOCKFILEWRITER_H
+#define BLOCKFILEWRITER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include "LatencyHistogram.h"
+#include "EventBackend.h"
+#include <string>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// alignment required for O_DIRECT on SD cards / ext4
+#define BLOCK_WRITER_ALIGNMENT          4096
+
+#define BLOCK_WRITER_DEFAULT_BLOCK      (64 * 1024)
+#define BLOCK_WRITER_DEFAULT_PREALLOC   (16 * 1024 * 1024)
+#define BLOCK_WRITER_DEFAULT_FLUSH_MS   5000
+
+typedef struct
+{
+    // coalescing block size, multiple of BLOCK_WRITER_ALIGNMENT
+    UINT32  BlockSize       = BLOCK_WRITER_DEFAULT_BLOCK;
+
+    // file extents are reserved in chunks of this size (0 = off)
+    UINT32  PreallocateSize = BLOCK_WRITER_DEFAULT_PREALLOC;
+
+    // write full blocks with O_DIRECT, bypassing the page cache
+    bool    DirectIO        = false;
+
+    // partially filled block is written after this time (0 = only on close)
+    UINT32  FlushIntervalMs = BLOCK_WRITER_DEFAULT_FLUSH_MS;
+}TBlockFileConfig;
+
+typedef struct
+{
+    UINT64  BytesWritten;
+    UINT64  BlocksWritten;
+    UINT64  PartialFlushes;
+    UINT64  WriteErrors;
+    UINT64  DroppedBytes;
+    // system calls issued by the writer itself
+    UINT64  Syscalls;
+}TBlockFileStats;
+
+//------------------------------------------------------------------------------
+//
+// TBlockFileWriter Class Declaration
+//
+// Appended data is collected in an aligned block buffer. Full blocks are
+// written with a single pwrite at an aligned file offset, writeback is
+// started with sync_file_range and the previous block is waited for, so
+// dirty pages never pile up into a burst. Timed flushes bound the data loss
+// window of a partially filled block: they write from the first page not
+// yet written, so only the partial tail page is written again, and the
+// full block later skips the pages flushed before.
+//
+// With an event backend attached, writes are queued to the backend instead
+// and submitted together with its next Poll; the writeback of each queued
+// range is started with the next one, when its write has been submitted.
+// The backend copies the data into unaligned buffers, so with O_DIRECT the
+// writer keeps writing itself and the backend is not used.
+//
+//------------------------------------------------------------------------------
+
+class TBlockFileWriter
+{
+    public:
+                    TBlockFileWriter();
+                    ~TBlockFileWriter();
+
+    // open file for appending, existing content is kept
+    bool            Open(const std::string& filename, const TBlockFileConfig& config = TBlockFileConfig());
+    bool            Close();
+    bool            IsOpen() const { return Handle >= 0; }
+
+    // append data, full blocks are written immediately
+    bool            Write(const char* data, size_t length);
+    bool            Write(const std::string& data) { return Write(data.data(), data.size()); }
+
+    // write partial block if flush interval elapsed (call periodically)
+    bool            Poll();
+
+    // write partial block now and start writeback
+    bool            Flush();
+
+    // queue writes to an event backend instead of writing directly (0 = off)
+    void            SetBackend(TEventBackend* backend) { Backend = backend; }
+
+    const TBlockFileStats&      GetStats() const { return Stats; }
+    const TLatencyHistogram&    GetLatency() const { return Latency; }
+
+    private:
+
+    bool            WriteBlock();
+
+    // queue range to the backend, start writeback of the range before
+    bool            QueueWrite(UINT32 from, UINT32 length);
+
+    // first byte of the buffer to write, the page with unwritten data
+    UINT32          GetWriteStart() const { return BufferFlushed & ~(UINT32)(BLOCK_WRITER_ALIGNMENT - 1); }
+    bool            Preallocate(UINT64 end);
+    void            StartWriteback(UINT64 offset, UINT64 length);
+
+    TBlockFileConfig    Config;
+    TBlockFileStats     Stats;
+
+    // write latency per pwrite [us]
+    TLatencyHistogram   Latency;
+
+    // optional event backend for batched writes, not used with O_DIRECT
+    TEventBackend*      Backend;
+
+    // range queued to the backend, writeback not started yet
+    UINT64          QueuedOffset;
+    UINT64          QueuedLength;
+
+    // buffered handle, used for partial blocks
+    int             Handle;
+
+    // O_DIRECT handle for full blocks, -1 if unavailable
+    int             DirectHandle;
+
+    // aligned block buffer, bytes already in the file
+    char*           Buffer;
+    UINT32          BufferUsed;
+    UINT32          BufferFlushed;
+
+    // file offset of Buffer[0], always block aligned
+    UINT64          BlockOffset;
+
+    // end of reserved file extents
+    UINT64          PreallocatedEnd;
+
+    // previous block, waited for before the next writeback is started
+    UINT64          PendingOffset;
+    UINT64          PendingLength;
+
+    std::chrono::steady_clock::time_point LastFlush;
+};
+
+#endif // BLOCKFILEWRITER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,338 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BoundedQueue.h
+//
+//	Abstract:	Bounded Producer / Consumer Queue with Overflow Policies
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+typedef enum
+{
+    // producer waits for free space, nothing is lost in the process
+    QUEUE_POLICY_BLOCK = 0,
+    // oldest queued item is discarded
+    QUEUE_POLICY_DROP_OLDEST,
+    // items are folded into one summary per interval
+    QUEUE_POLICY_COALESCE
+}TQueuePolicy;
+
+typedef struct
+{
+    // items offered by the producer
+    UINT64  Pushed;
+    // items and summaries taken by the consumer
+    UINT64  Popped;
+    // items discarded (drop-oldest, or pushed after close)
+    UINT64  Dropped;
+    // items folded into summaries
+    UINT64  Coalesced;
+    // summaries queued
+    UINT64  Summaries;
+    // pushes which had to wait (block) and total wait time
+    UINT64  Blocked;
+    UINT64  BlockedUs;
+    // max. fill level
+    UINT32  HighWater;
+}TQueueStats;
+
+static inline const char*
+QueuePolicyName(TQueuePolicy policy)
+{
+    switch (policy)
+    {
+        case QUEUE_POLICY_DROP_OLDEST:  return "drop-oldest";
+        case QUEUE_POLICY_COALESCE:     return "coalesce";
+        default:                        return "block";
+    }
+}
+
+static inline bool
+QueuePolicyFromName(const std::string& name, TQueuePolicy& policy)
+{
+    for (TQueuePolicy p : { QUEUE_POLICY_BLOCK, QUEUE_POLICY_DROP_OLDEST, QUEUE_POLICY_COALESCE })
+    {
+        if (name == QueuePolicyName(p))
+        {
+            policy = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+// TBoundedQueue Class Declaration
+//
+// Fixed capacity ring protected by a mutex. With the coalesce policy, items
+// arriving at a full queue are folded into a summary by the merge function.
+// The summary is closed after the coalesce interval and queued as soon as
+// there is room again; while the queue stays full it keeps growing, so no
+// item is lost. Items pushed later are folded into the open summary as well,
+// which keeps the order of items intact.
+//
+//------------------------------------------------------------------------------
+
+template <typename T>
+class TBoundedQueue
+{
+    public:
+
+    // fold item into summary
+    typedef void (*TMergeFunc)(T& summary, const T& item);
+
+                    TBoundedQueue(UINT32 capacity, TQueuePolicy policy = QUEUE_POLICY_BLOCK,
+                                  TMergeFunc merge = 0, UINT32 intervalMs = 1000)
+                    {
+                        // one spare slot for the summary queued on close
+                        Ring.resize(std::max<UINT32>(capacity, 1) + 1);
+
+                        Capacity    = std::max<UINT32>(capacity, 1);
+                        Policy      = policy;
+                        Merge       = merge;
+                        Interval    = std::chrono::milliseconds(intervalMs);
+                        Head        = 0;
+                        Count       = 0;
+                        HasSummary  = false;
+                        Closed      = false;
+
+                        Stats = TQueueStats();
+
+                        // coalescing needs a merge function
+                        if (Policy == QUEUE_POLICY_COALESCE && !Merge)
+                            Policy = QUEUE_POLICY_DROP_OLDEST;
+                    }
+
+    TQueuePolicy    GetPolicy() const { return Policy; }
+    UINT32          GetCapacity() const { return Capacity; }
+
+    //--------------------------------------------------------------------------
+    //  Push
+    //
+    //  @brief: add item, applies overflow policy, false after Close
+    //--------------------------------------------------------------------------
+
+    bool            Push(const T& item)
+                    {
+                        std::unique_lock<std::mutex> lock(Lock);
+
+                        if (Closed)
+                        {
+                            Stats.Dropped++;
+                            return false;
+                        }
+
+                        Stats.Pushed++;
+
+                        // coalescing in progress, later items must not overtake
+                        if (HasSummary)
+                        {
+                            Merge(Summary, item);
+                            Stats.Coalesced++;
+
+                            if (Count < Capacity && IsSummaryDue())
+                                QueueSummary();
+
+                            return true;
+                        }
+
+                        if (Count >= Capacity)
+                        {
+                            switch (Policy)
+                            {
+                                case QUEUE_POLICY_BLOCK:
+                                {
+                                    auto start = std::chrono::steady_clock::now();
+
+                                    Stats.Blocked++;
+                                    NotFull.wait(lock, [this] { return Count < Capacity || Closed; });
+
+                                    Stats.BlockedUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                                                            std::chrono::steady_clock::now() - start).count();
+                                    if (Closed)
+                                    {
+                                        Stats.Dropped++;
+                                        return false;
+                                    }
+                                    break;
+                                }
+
+                                case QUEUE_POLICY_DROP_OLDEST:
+                                    Head = (Head + 1) % Ring.size();
+                                    Count--;
+                                    Stats.Dropped++;
+                                    break;
+
+                                case QUEUE_POLICY_COALESCE:
+                                    Summary      = item;
+                                    SummaryStart = std::chrono::steady_clock::now();
+                                    HasSummary   = true;
+                                    Stats.Coalesced++;
+                                    return true;
+                            }
+                        }
+
+                        Enqueue(item);
+
+                        return true;
+                    }
+
+    //--------------------------------------------------------------------------
+    //  Pop
+    //
+    //  @brief: take oldest item, waits up to timeoutMs, false on timeout or
+    //          if the queue is closed and empty
+    //--------------------------------------------------------------------------
+
+    bool            Pop(T& item, int timeoutMs)
+                    {
+                        std::unique_lock<std::mutex> lock(Lock);
+
+                        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+                        while (true)
+                        {
+                            // producer idle, queue a due summary from here
+                            if (!Count && HasSummary && (Closed || IsSummaryDue()))
+                                QueueSummary();
+
+                            if (Count)
+                            {
+                                item = Ring[Head];
+                                Head = (Head + 1) % Ring.size();
+                                Count--;
+                                Stats.Popped++;
+
+                                if (HasSummary && IsSummaryDue())
+                                    QueueSummary();
+
+                                NotFull.notify_one();
+                                return true;
+                            }
+
+                            if (Closed)
+                                return false;
+
+                            auto now = std::chrono::steady_clock::now();
+                            if (now >= deadline)
+                                return false;
+
+                            auto wake = deadline;
+                            if (HasSummary && SummaryStart + Interval < wake)
+                                wake = SummaryStart + Interval;
+
+                            NotEmpty.wait_until(lock, wake);
+                        }
+                    }
+
+    //--------------------------------------------------------------------------
+    //  Close
+    //
+    //  @brief: reject further items, open summary is queued, queued items
+    //          are still delivered
+    //--------------------------------------------------------------------------
+
+    void            Close()
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        Closed = true;
+
+                        if (HasSummary)
+                            QueueSummary();
+
+                        NotEmpty.notify_all();
+                        NotFull.notify_all();
+                    }
+
+    bool            IsClosed()
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+                        return Closed && !Count && !HasSummary;
+                    }
+
+    TQueueStats     GetStats()
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+                        return Stats;
+                    }
+
+    private:
+
+    bool            IsSummaryDue() const
+                    {
+                        return std::chrono::steady_clock::now() - SummaryStart >= Interval;
+                    }
+
+    void            Enqueue(const T& item)
+                    {
+                        Ring[(Head + Count) % Ring.size()] = item;
+                        Count++;
+
+                        Stats.HighWater = std::max(Stats.HighWater, Count);
+
+                        NotEmpty.notify_one();
+                    }
+
+    void            QueueSummary()
+                    {
+                        HasSummary = false;
+                        Stats.Summaries++;
+
+                        Enqueue(Summary);
+                    }
+
+    std::mutex              Lock;
+    std::condition_variable NotEmpty;
+    std::condition_variable NotFull;
+
+    std::vector<T>  Ring;
+    UINT32          Capacity;
+    UINT32          Head;
+    UINT32          Count;
+
+    TQueuePolicy    Policy;
+    TMergeFunc      Merge;
+
+    // open summary of the coalesce policy
+    bool            HasSummary;
+    T               Summary;
+    std::chrono::steady_clock::duration     Interval;
+    std::chrono::steady_clock::time_point   SummaryStart;
+
+    bool            Closed;
+    TQueueStats     Stats;
+};
+
+#endif // BOUNDEDQUEUE_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,994 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BulkTransfer.cpp
+//
+//	Abstract:	Reliable Bulk Transfer over Unreliable Radio Messages
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "BulkTransfer.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "ErasureCode.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  TBulkTransfer - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TBulkTransfer::TBulkTransfer(TWiMODLRHCI& hci)
+    : HCI(hci)
+    , Link(hci)
+{
+    Client       = 0;
+    Sending      = false;
+    TxId         = 0;
+    NumFragments = 0;
+    NextNew      = 0;
+    TxBase       = 0;
+    InFlight     = 0;
+    SendOrder    = 0;
+    LossEstimate = 0;
+    Receiving    = false;
+    RxComplete   = false;
+    RxId         = 0;
+    RxCount      = 0;
+    RxNext       = 0;
+    RxUnacked    = 0;
+    RxGapNext    = 0;
+    AckPending   = false;
+    Stats        = TBulkStats();
+
+    Configure(TBulkConfig());
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Configure(const TBulkConfig& config)
+{
+    Config              = config;
+    Config.FragmentSize = std::clamp<UINT16>(Config.FragmentSize, 1, BULK_MAX_FRAGMENT_SIZE);
+    Config.Window       = std::clamp<UINT32>(Config.Window, 1, BULK_ACK_BITMAP_BITS + 1);
+
+    // a block waits for its parity before fast retransmit, it must fit
+    // the window
+    Config.FecBlock     = std::min(Config.FecBlock, Config.Window);
+
+    if (Config.FecBlock)
+    {
+        Config.FragmentSize = std::min<UINT16>(Config.FragmentSize, BULK_MAX_FEC_FRAGMENT_SIZE);
+        Config.FecMaxParity = std::clamp<UINT32>(Config.FecMaxParity, 1, BULK_MAX_PARITY);
+        Config.FecMinParity = std::min(Config.FecMinParity, Config.FecMaxParity);
+    }
+
+    Link.Configure(Config.Link);
+
+    LossEstimate = 0;
+
+    Srtt   = 0;
+    RttVar = 0;
+    Rto    = Config.InitialRtoMs;
+    HasRtt = false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Send
+//
+//------------------------------------------------------------------------------
+
+bool
+TBulkTransfer::Send(const std::vector<UINT8>& data)
+{
+    size_t count = std::max<size_t>(1, (data.size() + Config.FragmentSize - 1) / Config.FragmentSize);
+
+    if (Sending || count > BULK_MAX_FRAGMENTS)
+        return false;
+
+    TxId++;
+    TxData       = data;
+    NumFragments = (UINT16)count;
+    NextNew      = 0;
+    TxBase       = 0;
+    InFlight     = 0;
+    Sending      = true;
+
+    Fragments.assign(count, TFragment());
+    Blocks.clear();
+
+    for (size_t first = 0; Config.FecBlock && first < count; first += Config.FecBlock)
+        Blocks.push_back({ (UINT16)first, (UINT16)std::min<size_t>(Config.FecBlock, count - first), 0, 0, 0, TClock::time_point(), false });
+
+    Pump();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Cancel
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Cancel()
+{
+    Sending = false;
+    Link.Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Pump
+//
+//  @brief: one fragment waits on the host at a time, the data link keeps
+//          the module queue full; resent fragments first, then parity of
+//          completed blocks, new ones while the window and the
+//          acknowledgment bitmap allow
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Pump()
+{
+    while (Sending && Link.GetQueued() == 0)
+    {
+        int index = -1;
+
+        for (UINT16 i = TxBase; i < NextNew; i++)
+        {
+            if (Fragments[i].Lost && !Fragments[i].Acked)
+            {
+                index = i;
+                break;
+            }
+        }
+
+        if (index < 0 && Config.FecBlock)
+        {
+            TBlock* pending = 0;
+
+            for (size_t b = TxBase / Config.FecBlock; b < Blocks.size() && Blocks[b].First < NextNew; b++)
+            {
+                if (Blocks[b].Sent < Blocks[b].Rows)
+                {
+                    pending = &Blocks[b];
+                    break;
+                }
+            }
+
+            if (pending)
+            {
+                SendParity(*pending);
+                continue;
+            }
+        }
+
+        if (index < 0 && NextNew < NumFragments && InFlight < Config.Window
+            && NextNew - TxBase <= BULK_ACK_BITMAP_BITS)
+            index = NextNew++;
+
+        if (index < 0)
+            break;
+
+        SendFragment((UINT16)index);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetFragmentLength
+//
+//------------------------------------------------------------------------------
+
+size_t
+TBulkTransfer::GetFragmentLength(UINT16 index) const
+{
+    size_t offset = (size_t)index * Config.FragmentSize;
+
+    return std::min<size_t>(Config.FragmentSize, TxData.size() - std::min(offset, TxData.size()));
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendFragment
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::SendFragment(UINT16 index)
+{
+    size_t offset = (size_t)index * Config.FragmentSize;
+    size_t length = GetFragmentLength(index);
+
+    UINT8 frame[BULK_DATA_HEADER_SIZE + BULK_MAX_FRAGMENT_SIZE];
+
+    frame[0] = BULK_FRAME_DATA;
+    frame[1] = TxId;
+    HTON16(&frame[2], index);
+    HTON16(&frame[4], NumFragments);
+    std::copy(TxData.begin() + offset, TxData.begin() + offset + length, &frame[BULK_DATA_HEADER_SIZE]);
+
+    TFragment& fragment = Fragments[index];
+
+    if (fragment.Transmissions++)
+        Stats.Retransmissions++;
+
+    fragment.Sent  = TClock::now();
+    fragment.Order = ++SendOrder;
+    fragment.Lost  = false;
+
+    InFlight++;
+    Stats.Fragments++;
+
+    Link.Send(frame, (UINT16)(BULK_DATA_HEADER_SIZE + length));
+
+    // last fragment of a block sent the first time: parity for the loss
+    // rate seen so far
+    if (Config.FecBlock && fragment.Transmissions == 1)
+    {
+        TBlock& block = Blocks[index / Config.FecBlock];
+
+        if (index == block.First + block.Length - 1)
+        {
+            double loss   = std::min(LossEstimate, 0.9);
+            double losses = block.Length * loss / (1 - loss);
+            UINT32 rows   = (losses < BULK_FEC_MIN_LOSSES ? 0 : (UINT32)std::ceil(losses)) + Config.FecMinParity;
+
+            block.Rows = std::min(rows, Config.FecMaxParity);
+
+            // without parity the block is complete now
+            if (!block.Rows)
+            {
+                block.ParityOrder = fragment.Order;
+                block.ParitySent  = fragment.Sent;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendParity
+//
+//  @brief: next parity row of the block, the last fragment zero padded
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::SendParity(TBlock& block)
+{
+    UINT32 row         = block.Sent++;
+    size_t length      = GetFragmentLength(block.First);
+    size_t lastLength  = GetFragmentLength((UINT16)(block.First + block.Length - 1));
+
+    std::vector<UINT8>        padded(length, 0);
+    std::vector<const UINT8*> shards(block.Length);
+
+    for (UINT16 j = 0; j < block.Length; j++)
+        shards[j] = TxData.data() + (size_t)(block.First + j) * Config.FragmentSize;
+
+    if (lastLength < length)
+    {
+        std::copy(shards[block.Length - 1], shards[block.Length - 1] + lastLength, padded.begin());
+        shards[block.Length - 1] = padded.data();
+    }
+
+    UINT8 frame[BULK_PARITY_HEADER_SIZE + BULK_MAX_FEC_FRAGMENT_SIZE];
+
+    frame[0] = BULK_FRAME_PARITY;
+    frame[1] = TxId;
+    HTON16(&frame[2], block.First);
+    frame[4] = (UINT8)block.Length;
+    frame[5] = (UINT8)(row << 4 | block.Rows);
+    frame[6] = (UINT8)lastLength;
+
+    FEC_Encode(shards.data(), block.Length, length, row, &frame[BULK_PARITY_HEADER_SIZE]);
+
+    SendOrder++;
+
+    if (block.Sent == block.Rows)
+    {
+        block.ParityOrder = SendOrder;
+        block.ParitySent  = TClock::now();
+    }
+
+    Stats.ParityFragments++;
+
+    Link.Send(frame, (UINT16)(BULK_PARITY_HEADER_SIZE + length));
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_RxUMessage
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg)
+{
+    int length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE;
+
+    // extended format: RSSI, SNR and time stamp after the payload
+    if (rxMsg.Payload[0] & 0x01)
+        length -= DATALINK_MSG_FOOTER_SIZE;
+
+    if (length < 1)
+        return;
+
+    const UINT8* data = &rxMsg.Payload[DATALINK_MSG_HEADER_SIZE];
+
+    if (data[0] == BULK_FRAME_DATA)
+        OnData(data, length);
+    else if (data[0] == BULK_FRAME_PARITY)
+        OnParity(data, length);
+    else if (data[0] == BULK_FRAME_ACK)
+        OnAck(data, length);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageRsp
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::evRadioLink_TxUMessageRsp(UINT8 status)
+{
+    Link.evRadioLink_TxUMessageRsp(status);
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageInd
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::evRadioLink_TxUMessageInd(UINT8 status)
+{
+    Link.evRadioLink_TxUMessageInd(status);
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  OnData
+//
+//  @brief: receiver, store the fragment and acknowledge
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::OnData(const UINT8* data, int length)
+{
+    if (length < BULK_DATA_HEADER_SIZE)
+        return;
+
+    UINT8  id    = data[1];
+    UINT16 index = NTOH16(&data[2]);
+    UINT16 count = NTOH16(&data[4]);
+
+    // a new transfer replaces an incomplete one
+    if (!Receiving || id != RxId)
+    {
+        if (!count)
+            return;
+
+        Receiving  = true;
+        RxComplete = false;
+        RxId       = id;
+        RxCount    = count;
+        RxNext     = 0;
+        RxUnacked  = 0;
+        RxGapNext  = 0;
+        AckPending = false;
+
+        RxFragments.assign(count, std::vector<UINT8>());
+        RxPresent.assign(count, false);
+        RxRecovered.assign(count, false);
+        RxBlocks.clear();
+    }
+
+    if (count != RxCount || index >= RxCount)
+        return;
+
+    RxLast = TClock::now();
+
+    // our acknowledgment was lost
+    if (RxPresent[index])
+    {
+        Stats.Duplicates++;
+        SendAck();
+        return;
+    }
+
+    RxFragments[index].assign(data + BULK_DATA_HEADER_SIZE, data + length);
+    RxPresent[index] = true;
+    RxUnacked++;
+
+    // resent fragment completes the parity of its block
+    auto block = RxBlocks.upper_bound(index);
+
+    if (block != RxBlocks.begin() && index < (--block)->first + block->second.Length)
+        Recover(block->first, block->second);
+
+    if (Advance())
+        return;
+
+    // a new gap is reported at once, the sender resends after a few more
+    bool gap = index > RxNext && RxGapNext != RxNext;
+
+    if (gap || RxUnacked >= Config.AckEvery)
+    {
+        RxGapNext = index > RxNext ? RxNext : RxGapNext;
+        SendAck();
+    }
+    else if (!AckPending)
+    {
+        AckPending = true;
+        AckDue     = RxLast + std::chrono::milliseconds(Config.AckDelayMs);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  OnParity
+//
+//  @brief: receiver, keep the parity fragment until its block is complete,
+//          report the block after its last parity fragment
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::OnParity(const UINT8* data, int length)
+{
+    if (length < BULK_PARITY_HEADER_SIZE || !Receiving || data[1] != RxId)
+        return;
+
+    UINT16 first       = NTOH16(&data[2]);
+    UINT16 blockLength = data[4];
+    UINT32 row         = data[5] >> 4;
+    UINT32 rows        = data[5] & 0x0F;
+
+    if (RxComplete)
+    {
+        if (row + 1 == rows)
+            SendAck();
+        return;
+    }
+
+    if (!blockLength || first + blockLength > RxCount || row >= rows)
+        return;
+
+    RxLast = TClock::now();
+
+    TRxBlock& block = RxBlocks[first];
+
+    if (block.Parity.empty())
+    {
+        block.Length     = blockLength;
+        block.LastLength = data[6];
+        block.Rows       = rows;
+        block.Received   = 0;
+        block.Parity.resize(rows);
+        block.Present.assign(rows, false);
+    }
+
+    if (block.Rows != rows || block.Length != blockLength || block.Present[row])
+        return;
+
+    block.Parity[row].assign(data + BULK_PARITY_HEADER_SIZE, data + length);
+    block.Present[row] = true;
+    block.Received++;
+
+    Recover(first, block);
+
+    if (Advance())
+        return;
+
+    if (row + 1 == rows)
+    {
+        SendAck(first);
+
+        // nothing more to come for a complete block
+        if (std::all_of(RxPresent.begin() + first, RxPresent.begin() + first + blockLength, [](bool present) { return present; }))
+            RxBlocks.erase(first);
+    }
+    else if (++RxUnacked >= Config.AckEvery)
+        SendAck();
+    else if (!AckPending)
+    {
+        AckPending = true;
+        AckDue     = RxLast + std::chrono::milliseconds(Config.AckDelayMs);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Recover
+//
+//  @brief: restore the missing fragments of the block once as many parity
+//          fragments are there
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Recover(UINT16 first, TRxBlock& block)
+{
+    std::vector<const UINT8*> parity;
+    std::vector<UINT32>       rows;
+    size_t                    length = 0;
+
+    for (UINT32 row = 0; row < block.Rows; row++)
+    {
+        if (block.Present[row])
+        {
+            parity.push_back(block.Parity[row].data());
+            rows.push_back(row);
+            length = block.Parity[row].size();
+        }
+    }
+
+    bool   present[FEC_MAX_SHARDS];
+    UINT32 missing = 0;
+
+    for (UINT16 j = 0; j < block.Length; j++)
+    {
+        present[j] = RxPresent[first + j];
+        missing   += !present[j];
+
+        // fragments longer than the parity do not belong to it
+        if (present[j] && RxFragments[first + j].size() > length)
+            return;
+    }
+
+    if (!missing || parity.size() < missing)
+        return;
+
+    // zero padded copies, the restored ones get their length
+    std::vector<std::vector<UINT8>> shards(block.Length);
+    std::vector<UINT8*>             pointers(block.Length);
+
+    for (UINT16 j = 0; j < block.Length; j++)
+    {
+        shards[j] = RxFragments[first + j];
+        shards[j].resize(length, 0);
+        pointers[j] = shards[j].data();
+    }
+
+    if (!FEC_Decode(pointers.data(), present, block.Length, parity.data(), rows.data(), (UINT32)parity.size(), length))
+        return;
+
+    for (UINT16 j = 0; j < block.Length; j++)
+    {
+        if (present[j])
+            continue;
+
+        shards[j].resize(j + 1 == block.Length ? std::min<size_t>(block.LastLength, length) : length);
+
+        RxFragments[first + j] = std::move(shards[j]);
+        RxPresent[first + j]   = true;
+        RxRecovered[first + j] = true;
+        Stats.Recovered++;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Advance
+//
+//  @brief: next missing fragment, deliver a complete transfer
+//
+//------------------------------------------------------------------------------
+
+bool
+TBulkTransfer::Advance()
+{
+    while (RxNext < RxCount && RxPresent[RxNext])
+        RxNext++;
+
+    if (RxNext < RxCount)
+        return false;
+
+    RxComplete = true;
+    SendAck();
+
+    std::vector<UINT8> received;
+    for (std::vector<UINT8>& fragment : RxFragments)
+    {
+        received.insert(received.end(), fragment.begin(), fragment.end());
+        std::vector<UINT8>().swap(fragment);
+    }
+
+    RxBlocks.clear();
+    Stats.Received++;
+
+    if (Client)
+        Client->evBulkTransfer_Received(RxId, received);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendAck
+//
+//  @brief: with the report of a block: its fragments received as data or
+//          parity, restored ones not counted
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::SendAck(UINT16 reportFirst)
+{
+    UINT32 bitmap = 0;
+
+    for (UINT32 bit = 0; bit < BULK_ACK_BITMAP_BITS; bit++)
+    {
+        size_t index = (size_t)RxNext + 1 + bit;
+
+        if (index < RxCount && RxPresent[index])
+            bitmap |= 1u << bit;
+    }
+
+    UINT8  frame[BULK_ACK_REPORT_SIZE];
+    UINT16 length = BULK_ACK_SIZE;
+
+    frame[0] = BULK_FRAME_ACK;
+    frame[1] = RxId;
+    HTON16(&frame[2], RxNext);
+    HTON32(&frame[4], bitmap);
+
+    auto block = RxBlocks.find(reportFirst);
+
+    if (block != RxBlocks.end())
+    {
+        UINT32 received = block->second.Received;
+
+        for (UINT16 j = 0; j < block->second.Length; j++)
+            received += RxPresent[reportFirst + j] && !RxRecovered[reportFirst + j];
+
+        HTON16(&frame[BULK_ACK_SIZE], reportFirst);
+        frame[BULK_ACK_SIZE + 2] = (UINT8)received;
+        length = BULK_ACK_REPORT_SIZE;
+    }
+
+    Link.Send(frame, length);
+
+    AckPending = false;
+    RxUnacked  = 0;
+    Stats.AcksSent++;
+}
+
+//------------------------------------------------------------------------------
+//
+//  OnAck
+//
+//  @brief: sender, mark acknowledged fragments, RTT sample from the newest
+//          fragment sent once, resend fragments overtaken by DupThreshold
+//          acknowledged ones or missing in the report of their block
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::OnAck(const UINT8* data, int length)
+{
+    if (length < BULK_ACK_SIZE || !Sending || data[1] != TxId)
+        return;
+
+    UINT16 next   = std::min<UINT16>(NTOH16(&data[2]), NumFragments);
+    UINT32 bitmap = NTOH32(&data[4]);
+
+    Stats.AcksReceived++;
+
+    TClock::time_point now    = TClock::now();
+    TFragment*         newest = 0;
+
+    auto acknowledge = [&](UINT16 index)
+    {
+        TFragment& fragment = Fragments[index];
+
+        if (fragment.Acked || !fragment.Transmissions)
+            return;
+
+        fragment.Acked = true;
+
+        if (!fragment.Lost)
+            InFlight--;
+
+        if (fragment.Transmissions == 1 && (!newest || fragment.Order > newest->Order))
+            newest = &fragment;
+    };
+
+    for (UINT16 i = TxBase; i < next; i++)
+        acknowledge(i);
+
+    for (UINT32 bit = 0; bit < BULK_ACK_BITMAP_BITS; bit++)
+    {
+        size_t index = (size_t)next + 1 + bit;
+
+        if ((bitmap & (1u << bit)) && index < NextNew)
+            acknowledge((UINT16)index);
+    }
+
+    if (newest)
+        Sample(std::chrono::duration<double, std::milli>(now - newest->Sent).count());
+
+    while (TxBase < NumFragments && Fragments[TxBase].Acked)
+    {
+        TxBase++;
+
+        // block without parity acknowledged: a loss sample from the
+        // transmissions its fragments needed
+        if (Config.FecBlock && (TxBase % Config.FecBlock == 0 || TxBase == NumFragments))
+        {
+            TBlock& block = Blocks[(TxBase - 1) / Config.FecBlock];
+
+            if (!block.Rows && !block.Reported)
+            {
+                double transmissions = 0;
+
+                for (UINT16 i = block.First; i < block.First + block.Length; i++)
+                    transmissions += Fragments[i].Transmissions;
+
+                LossEstimate   = 0.75 * LossEstimate + 0.25 * (1 - block.Length / transmissions);
+                block.Reported = true;
+            }
+        }
+    }
+
+    if (TxBase == NumFragments)
+    {
+        Finish(true);
+        return;
+    }
+
+    // fragments and parity of the block the receiver got, the first
+    // report of a block is a loss sample
+    TBlock* reported = 0;
+
+    if (length >= BULK_ACK_REPORT_SIZE && Config.FecBlock)
+    {
+        UINT16 first = NTOH16(&data[BULK_ACK_SIZE]);
+        size_t b     = first / Config.FecBlock;
+
+        if (b < Blocks.size() && Blocks[b].First == first && Blocks[b].ParityOrder)
+        {
+            reported = &Blocks[b];
+
+            if (!reported->Reported)
+            {
+                double total = reported->Length + reported->Rows;
+                double loss  = 1 - std::min<double>(data[BULK_ACK_SIZE + 2], total) / total;
+
+                LossEstimate       = 0.75 * LossEstimate + 0.25 * loss;
+                reported->Reported = true;
+            }
+        }
+    }
+
+    for (UINT16 i = TxBase; i < NextNew; i++)
+    {
+        TFragment& fragment = Fragments[i];
+
+        if (fragment.Acked || fragment.Lost)
+            continue;
+
+        UINT64 after = fragment.Order;
+        bool   lost  = false;
+
+        if (Config.FecBlock)
+        {
+            TBlock& block = Blocks[i / Config.FecBlock];
+
+            // the parity may still restore it
+            if (!block.ParityOrder)
+                continue;
+
+            if (block.Rows)
+            {
+                lost  = &block == reported && fragment.Order < block.ParityOrder;
+                after = std::max(after, block.ParityOrder);
+            }
+        }
+
+        UINT32 later = 0;
+
+        for (UINT16 j = i + 1; j < NextNew && !lost; j++)
+        {
+            if (Fragments[j].Acked && Fragments[j].Order > after)
+                later++;
+        }
+
+        if (lost || later >= Config.DupThreshold)
+        {
+            if (fragment.Transmissions >= Config.MaxTransmissions)
+            {
+                Finish(false);
+                return;
+            }
+
+            fragment.Lost = true;
+            InFlight--;
+            Stats.FastRetransmits++;
+        }
+    }
+
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Sample
+//
+//  @brief: smoothed RTT and variance, RFC 6298
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Sample(double rttMs)
+{
+    if (!HasRtt)
+    {
+        Srtt   = rttMs;
+        RttVar = rttMs / 2;
+        HasRtt = true;
+    }
+    else
+    {
+        RttVar = 0.75 * RttVar + 0.25 * std::fabs(Srtt - rttMs);
+        Srtt   = 0.875 * Srtt + 0.125 * rttMs;
+    }
+
+    Rto = std::clamp(Srtt + 4 * RttVar, (double)Config.MinRtoMs, (double)Config.MaxRtoMs);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Finish
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Finish(bool success)
+{
+    Sending = false;
+
+    if (success)
+        Stats.Transfers++;
+    else
+    {
+        // fragments of the failed transfer are not sent any more
+        Stats.Failures++;
+        Link.Reset();
+    }
+
+    std::vector<UINT8>().swap(TxData);
+
+    if (Client)
+        Client->evBulkTransfer_Done(TxId, success);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: delayed acknowledgment, retransmit timer, stale receptions
+//
+//------------------------------------------------------------------------------
+
+void
+TBulkTransfer::Poll()
+{
+    Link.Poll();
+
+    TClock::time_point now = TClock::now();
+
+    if (AckPending && now >= AckDue)
+        SendAck();
+
+    if (Receiving && !RxComplete && now - RxLast >= std::chrono::milliseconds(Config.ReceiveTimeoutMs))
+    {
+        Receiving = false;
+        RxFragments.clear();
+        RxPresent.clear();
+        RxRecovered.clear();
+        RxBlocks.clear();
+    }
+
+    if (Sending)
+    {
+        auto rto     = std::chrono::duration<double, std::milli>(Rto);
+        bool expired = false;
+
+        for (UINT16 i = TxBase; i < NextNew; i++)
+        {
+            TFragment&         fragment = Fragments[i];
+            TClock::time_point sent     = fragment.Sent;
+
+            // the timer of a block starts after its parity
+            if (Config.FecBlock)
+            {
+                const TBlock& block = Blocks[i / Config.FecBlock];
+
+                if (!block.ParityOrder)
+                    continue;
+
+                if (block.Rows)
+                    sent = std::max(sent, block.ParitySent);
+            }
+
+            if (fragment.Acked || fragment.Lost || now - sent < rto)
+                continue;
+
+            if (fragment.Transmissions >= Config.MaxTransmissions)
+            {
+                Finish(false);
+                return;
+            }
+
+            fragment.Lost = true;
+            InFlight--;
+            expired = true;
+        }
+
+        // back off until the next RTT sample
+        if (expired)
+        {
+            Stats.Timeouts++;
+            Rto = std::min(2 * Rto, (double)Config.MaxRtoMs);
+        }
+    }
+
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TBulkTransfer::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "fragments=" << Stats.Fragments
+         << " retransmissions=" << Stats.Retransmissions
+         << " fast=" << Stats.FastRetransmits
+         << " timeouts=" << Stats.Timeouts
+         << " acks=" << Stats.AcksReceived
+         << " parity=" << Stats.ParityFragments
+         << std::fixed << std::setprecision(1)
+         << " loss=" << LossEstimate * 100 << "%"
+         << " srtt=" << Srtt << " ms"
+         << " rto=" << Rto << " ms";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,309 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BulkTransfer.h
+//
+//	Abstract:	Reliable Bulk Transfer over Unreliable Radio Messages
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef BULKTRANSFER_H
+#define BULKTRANSFER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "DataLinkSender.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// frame types, distinct from other users of the radio messages
+#define BULK_FRAME_DATA         0xB1
+#define BULK_FRAME_ACK          0xB2
+#define BULK_FRAME_PARITY       0xB3
+
+// data: type, transfer id, fragment, number of fragments, payload
+#define BULK_DATA_HEADER_SIZE   6
+
+// parity: type, transfer id, first fragment of the block, fragments in the
+// block, row (high nibble) and parity fragments of the block (low nibble),
+// length of the last fragment, parity over the fragments (zero padded)
+#define BULK_PARITY_HEADER_SIZE 7
+#define BULK_MAX_PARITY         15
+
+// expected losses per block below which no parity is sent, the rare loss
+// is left to the retransmissions
+#define BULK_FEC_MIN_LOSSES     0.2
+
+// ack: type, transfer id, next missing fragment, bitmap of the following;
+// after the last parity fragment of a block also its first fragment and
+// the data and parity fragments received of it
+#define BULK_ACK_SIZE           8
+#define BULK_ACK_REPORT_SIZE    11
+#define BULK_ACK_BITMAP_BITS    32
+
+#define BULK_MAX_FRAGMENT_SIZE  (DATALINK_MAX_PAYLOAD_SIZE - BULK_DATA_HEADER_SIZE)
+#define BULK_MAX_FEC_FRAGMENT_SIZE  (DATALINK_MAX_PAYLOAD_SIZE - BULK_PARITY_HEADER_SIZE)
+#define BULK_MAX_FRAGMENTS      0xFFFF
+
+typedef struct
+{
+    // peer and data link (MaxInFlight: Tx queue of the module)
+    TDataLinkConfig     Link;
+
+    // payload per fragment, at most BULK_MAX_FRAGMENT_SIZE
+    // (BULK_MAX_FEC_FRAGMENT_SIZE with forward error correction)
+    UINT16  FragmentSize        = BULK_MAX_FRAGMENT_SIZE;
+
+    // fragments sent and not acknowledged, at most the bitmap + 1
+    UINT32  Window              = 16;
+
+    // retransmit timer [ms]: before the first RTT sample, bounds
+    UINT32  InitialRtoMs        = 3000;
+    UINT32  MinRtoMs            = 100;
+    UINT32  MaxRtoMs            = 30000;
+
+    // fragments acknowledged after a missing one before it is resent
+    UINT32  DupThreshold        = 3;
+
+    // transmissions of one fragment before the transfer fails
+    UINT32  MaxTransmissions    = 10;
+
+    // receiver: acknowledge every n fragments, a gap or the last fragment
+    // at once, otherwise after the delay [ms]
+    UINT32  AckEvery            = 4;
+    UINT32  AckDelayMs          = 50;
+
+    // receiver: incomplete transfer dropped after this silence [ms]
+    UINT32  ReceiveTimeoutMs    = 60000;
+
+    // forward error correction: parity fragments after each block of
+    // FecBlock fragments (0 = off, at most Window), as many as the observed
+    // loss rate needs plus FecMinParity, at most FecMaxParity
+    UINT32  FecBlock            = 0;
+    UINT32  FecMinParity        = 0;
+    UINT32  FecMaxParity        = 8;
+}TBulkConfig;
+
+typedef struct
+{
+    // sender
+    UINT64  Transfers;
+    UINT64  Failures;
+    UINT64  Fragments;
+    UINT64  Retransmissions;
+    UINT64  FastRetransmits;
+    UINT64  Timeouts;
+    UINT64  AcksReceived;
+    UINT64  ParityFragments;
+
+    // receiver
+    UINT64  Received;
+    UINT64  Duplicates;
+    UINT64  AcksSent;
+
+    // fragments restored from parity fragments
+    UINT64  Recovered;
+}TBulkStats;
+
+//------------------------------------------------------------------------------
+//
+// TBulkTransferClient Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TBulkTransferClient
+{
+    public:
+    virtual             ~TBulkTransferClient() {}
+
+    // complete transfer of the peer
+    virtual void        evBulkTransfer_Received(UINT8 /* id */, const std::vector<UINT8>& /* data */) {}
+
+    // own transfer acknowledged completely or given up
+    virtual void        evBulkTransfer_Done(UINT8 /* id */, bool /* success */) {}
+};
+
+//------------------------------------------------------------------------------
+//
+// TBulkTransfer Class Declaration
+//
+// Selective repeat over unreliable radio messages. A transfer is split into
+// fragments which fit a radio message; up to Window fragments are in
+// flight. The receiver acknowledges the next missing fragment and a bitmap
+// of the 32 fragments after it (selective acknowledgment), every AckEvery
+// fragments, at once on a gap or the last fragment, else after AckDelayMs.
+// A fragment is resent once DupThreshold fragments sent after it are
+// acknowledged (fast retransmit) or when its retransmit timer expires; the
+// timer follows smoothed RTT and variance of fragments sent once (RFC 6298,
+// Karn), doubled on each expiry. Fragments go to the data link one at a
+// time (TDataLinkSender keeps the module queue full), so retransmissions
+// overtake new fragments.
+//
+// With FecBlock set, each block of fragments is followed by parity
+// fragments of a systematic Reed-Solomon code (ErasureCode.h): any
+// FecBlock of the data and parity fragments restore the block without a
+// retransmission. The receiver reports the fragments of the block it got
+// with the acknowledgment of the last parity fragment; the smoothed loss
+// rate of these reports sets the parity of the next blocks. Fragments the
+// parity could not restore are resent (hybrid ARQ), fast retransmit only
+// counts fragments sent after the parity of their block. While fewer than
+// BULK_FEC_MIN_LOSSES fragments per block are expected to get lost, blocks
+// go out without parity like plain ARQ; their transmissions per fragment
+// keep the loss rate up to date.
+//
+// Registered as HCI client of both hosts, each end can send and receive
+// (one outgoing transfer at a time). Poll runs the timers and must be
+// called from the thread which drives the HCI.
+//
+//------------------------------------------------------------------------------
+
+class TBulkTransfer : public TWiMODLRHCIClient
+{
+    public:
+                    TBulkTransfer(TWiMODLRHCI& hci);
+
+    void            Configure(const TBulkConfig& config);
+    void            RegisterClient(TBulkTransferClient* client) { Client = client; }
+
+    // start a transfer to the peer, false while one is running
+    bool            Send(const std::vector<UINT8>& data);
+
+    bool            IsSending() const { return Sending; }
+
+    // abort the outgoing transfer, clear the data link
+    void            Cancel();
+
+    void            Poll();
+
+    // smoothed RTT and retransmit timeout [ms]
+    double          GetSrtt() const { return Srtt; }
+    double          GetRto() const { return Rto; }
+
+    // smoothed loss rate of the blocks [0..1]
+    double          GetLossEstimate() const { return LossEstimate; }
+
+    TBulkStats      GetStats() const { return Stats; }
+    const TDataLinkSender&  GetLink() const { return Link; }
+
+    // "fragments=.. retransmissions=.. fast=.. timeouts=.. acks=.. parity=..
+    //  loss=..% srtt=.. ms rto=.. ms"
+    std::string     FormatStats() const;
+
+    // HCI client interface
+    void            evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override;
+    void            evRadioLink_TxUMessageRsp(UINT8 status) override;
+    void            evRadioLink_TxUMessageInd(UINT8 status) override;
+
+    private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    typedef struct
+    {
+        TClock::time_point  Sent;
+        UINT64              Order;
+        UINT32              Transmissions;
+        bool                Acked;
+        bool                Lost;
+    }TFragment;
+
+    // sender: parity of a block, decided with its last fragment
+    typedef struct
+    {
+        UINT16              First;
+        UINT16              Length;
+        UINT32              Rows;
+        UINT32              Sent;
+        UINT64              ParityOrder;
+        TClock::time_point  ParitySent;
+        bool                Reported;
+    }TBlock;
+
+    // receiver: parity fragments of a block
+    typedef struct
+    {
+        UINT16              Length;
+        UINT8               LastLength;
+        UINT32              Rows;
+        std::vector<std::vector<UINT8>> Parity;
+        std::vector<bool>   Present;
+        UINT32              Received;
+    }TRxBlock;
+
+    void            OnData(const UINT8* data, int length);
+    void            OnParity(const UINT8* data, int length);
+    void            OnAck(const UINT8* data, int length);
+    void            Pump();
+    size_t          GetFragmentLength(UINT16 index) const;
+    void            SendFragment(UINT16 index);
+    void            SendParity(TBlock& block);
+    void            SendAck(UINT16 reportFirst = BULK_MAX_FRAGMENTS);
+    void            Recover(UINT16 first, TRxBlock& block);
+    bool            Advance();
+    void            Finish(bool success);
+    void            Sample(double rttMs);
+
+    TWiMODLRHCI&        HCI;
+    TDataLinkSender     Link;
+    TBulkConfig         Config;
+    TBulkTransferClient*    Client;
+
+    // outgoing transfer
+    bool                Sending;
+    UINT8               TxId;
+    std::vector<UINT8>  TxData;
+    std::vector<TFragment>  Fragments;
+    UINT16              NumFragments;
+    UINT16              NextNew;
+    UINT16              TxBase;
+    UINT32              InFlight;
+    UINT64              SendOrder;
+    std::vector<TBlock> Blocks;
+    double              LossEstimate;
+
+    // RTT estimate [ms], no sample yet
+    double              Srtt;
+    double              RttVar;
+    double              Rto;
+    bool                HasRtt;
+
+    // incoming transfer
+    bool                Receiving;
+    bool                RxComplete;
+    UINT8               RxId;
+    UINT16              RxCount;
+    UINT16              RxNext;
+    std::vector<std::vector<UINT8>> RxFragments;
+    std::vector<bool>   RxPresent;
+    std::vector<bool>   RxRecovered;
+    std::map<UINT16, TRxBlock>  RxBlocks;
+    UINT32              RxUnacked;
+    UINT16              RxGapNext;
+    bool                AckPending;
+    TClock::time_point  AckDue;
+    TClock::time_point  RxLast;
+
+    TBulkStats          Stats;
+};
+
+#endif // BULKTRANSFER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,484 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ClockSync.cpp
+//
+//	Abstract:	Offset and Drift of the Module RTC against the Host Clock
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "ClockSync.h"
+#include "RLTSample.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+//------------------------------------------------------------------------------
+//
+//  CLOCK_RtcToSeconds
+//
+//------------------------------------------------------------------------------
+
+INT64
+CLOCK_RtcToSeconds(UINT32 rtcTime)
+{
+    std::tm time = std::tm();
+
+    time.tm_sec  = (int)(rtcTime & 0x3F);
+    time.tm_min  = (int)((rtcTime >> 6) & 0x3F);
+    time.tm_mon  = (int)((rtcTime >> 12) & 0x0F) - 1;
+    time.tm_hour = (int)((rtcTime >> 16) & 0x1F);
+    time.tm_mday = (int)((rtcTime >> 21) & 0x1F);
+    time.tm_year = (int)((rtcTime >> 26) & 0x3F) + 2000 - 1900;
+
+    return (INT64)::timegm(&time);
+}
+
+//------------------------------------------------------------------------------
+//
+//  CLOCK_SecondsToRtc
+//
+//------------------------------------------------------------------------------
+
+UINT32
+CLOCK_SecondsToRtc(INT64 seconds)
+{
+    std::time_t value = (std::time_t)seconds;
+    std::tm     time;
+
+    ::gmtime_r(&value, &time);
+
+    return (UINT32)time.tm_sec
+           | ((UINT32)time.tm_min << 6)
+           | ((UINT32)(time.tm_mon + 1) << 12)
+           | ((UINT32)time.tm_hour << 16)
+           | ((UINT32)time.tm_mday << 21)
+           | ((UINT32)(time.tm_year + 1900 - 2000) << 26);
+}
+
+//------------------------------------------------------------------------------
+//
+//  TClockSync - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TClockSync::TClockSync(TWiMODLRHCI& hci, TSampleFanout* fanout)
+    : HCI(hci)
+    , Fanout(fanout)
+    , Reader(0)
+{
+    Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetReader
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::SetReader(THCIReader* reader)
+{
+    Reader = reader;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::Configure(const TClockSyncConfig& config)
+{
+    Config = config;
+
+    Config.IntervalMs = std::max<UINT32>(1, Config.IntervalMs);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reset
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::Reset()
+{
+    Stats          = TClockSyncStats();
+    Valid          = false;
+    Lower          = 0;
+    Upper          = 0;
+    BoundsTimeUs   = 0;
+    DriftValid     = false;
+    DriftPpm       = 0;
+    DriftErrorPpm  = 0;
+    RoundTripUs    = 0;
+    NextUs         = 0;
+    LastExchangeUs = 0;
+    LastReportUs   = 0;
+
+    Samples.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Bounds
+//
+//  @brief: offset bounds moved to the given time by the drift, widened by
+//          its tolerance
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::Bounds(INT64 timeUs, INT64& lower, INT64& upper) const
+{
+    double elapsed = (double)(timeUs - BoundsTimeUs);
+    double shift   = DriftValid ? DriftPpm * elapsed / 1e6 : 0;
+    double bound   = DriftValid ? std::max(Config.DriftTolerancePpm, 3 * DriftErrorPpm) : Config.MaxDriftPpm;
+    double widen   = std::min(bound, Config.MaxDriftPpm) * std::fabs(elapsed) / 1e6;
+
+    lower = Lower + std::llround(shift - widen);
+    upper = Upper + std::llround(shift + widen);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetOffsetUs
+//
+//------------------------------------------------------------------------------
+
+INT64
+TClockSync::GetOffsetUs(INT64 monotonicUs) const
+{
+    if (!Valid)
+        return 0;
+
+    INT64 lower;
+    INT64 upper;
+
+    Bounds(monotonicUs, lower, upper);
+
+    return lower + (upper - lower) / 2;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetUncertaintyUs
+//
+//------------------------------------------------------------------------------
+
+INT64
+TClockSync::GetUncertaintyUs(INT64 monotonicUs) const
+{
+    if (!Valid)
+        return 0;
+
+    INT64 lower;
+    INT64 upper;
+
+    Bounds(monotonicUs, lower, upper);
+
+    return (upper - lower) / 2;
+}
+
+//------------------------------------------------------------------------------
+//
+//  IsLocked
+//
+//------------------------------------------------------------------------------
+
+bool
+TClockSync::IsLocked() const
+{
+    return Valid && Upper - Lower <= (INT64)Config.LockWidthUs;
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddExchange
+//
+//  @brief: the RTC showed its second at some time between request and
+//          response: second - response <= offset < second + 1 - request
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::AddExchange(INT64 requestUs, INT64 responseUs, INT64 rtcSeconds)
+{
+    INT64 roundTrip = responseUs - requestUs;
+
+    LastExchangeUs = responseUs;
+
+    if (roundTrip < 0 || roundTrip > (INT64)Config.MaxRoundTripUs)
+    {
+        Stats.Rejected++;
+        Schedule(responseUs + Config.IntervalMs * 1000ll);
+        return;
+    }
+
+    Stats.Exchanges++;
+
+    if (!Stats.MinRoundTripUs || (UINT64)roundTrip < Stats.MinRoundTripUs)
+        Stats.MinRoundTripUs = (UINT64)roundTrip;
+
+    RoundTripUs = RoundTripUs ? (7 * RoundTripUs + roundTrip) / 8 : roundTrip;
+
+    INT64 middle = requestUs + roundTrip / 2;
+    INT64 lower  = rtcSeconds * 1000000 - responseUs;
+    INT64 upper  = (rtcSeconds + 1) * 1000000 - requestUs;
+
+    if (Valid)
+    {
+        INT64 boundLower;
+        INT64 boundUpper;
+
+        Bounds(middle, boundLower, boundUpper);
+
+        // a wrong drift estimate first, then a step of the RTC
+        if ((lower > boundUpper || upper < boundLower) && DriftValid)
+        {
+            DriftValid = false;
+            Bounds(middle, boundLower, boundUpper);
+        }
+
+        if (lower > boundUpper || upper < boundLower)
+        {
+            Stats.Resyncs++;
+            Samples.clear();
+            DriftPpm     = 0;
+            LastReportUs = 0;
+        }
+        else
+        {
+            lower = std::max(lower, boundLower);
+            upper = std::min(upper, boundUpper);
+        }
+    }
+
+    Valid        = true;
+    Lower        = lower;
+    Upper        = upper;
+    BoundsTimeUs = middle;
+
+    if (upper - lower <= (INT64)Config.MaxSampleWidthUs)
+    {
+        Samples.push_back({ middle, lower + (upper - lower) / 2, std::max<INT64>(1, upper - lower) });
+
+        while (middle - Samples.front().TimeUs > Config.WindowS * 1000000ll)
+            Samples.pop_front();
+
+        EstimateDrift();
+    }
+
+    Schedule(responseUs + Config.IntervalMs * 1000ll);
+}
+
+//------------------------------------------------------------------------------
+//
+//  EstimateDrift
+//
+//  @brief: least squares slope of the offsets in the window, each weighted
+//          by the inverse variance of a uniform error over its width
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::EstimateDrift()
+{
+    if (Samples.size() < 4 || Samples.back().TimeUs - Samples.front().TimeUs < Config.MinDriftSpanS * 1000000ll)
+        return;
+
+    const TOffsetSample& first = Samples.front();
+
+    double sumW  = 0;
+    double sumX  = 0;
+    double sumY  = 0;
+    double sumXX = 0;
+    double sumXY = 0;
+
+    for (const TOffsetSample& sample : Samples)
+    {
+        double w = 12.0 / ((double)sample.WidthUs * sample.WidthUs);
+        double x = (double)(sample.TimeUs - first.TimeUs);
+        double y = (double)(sample.OffsetUs - first.OffsetUs);
+
+        sumW  += w;
+        sumX  += w * x;
+        sumY  += w * y;
+        sumXX += w * x * x;
+        sumXY += w * x * y;
+    }
+
+    double denominator = sumW * sumXX - sumX * sumX;
+
+    if (denominator <= 0)
+        return;
+
+    // the offsets of consecutive exchanges share their bounds, a short span
+    // can give a slope beyond any crystal
+    double drift = (sumW * sumXY - sumX * sumY) / denominator * 1e6;
+    double error = std::sqrt(sumW / denominator) * 1e6;
+
+    if (std::fabs(drift) + error > Config.MaxDriftPpm)
+    {
+        DriftValid = false;
+        return;
+    }
+
+    DriftPpm      = drift;
+    DriftErrorPpm = error;
+    DriftValid    = true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Schedule
+//
+//  @brief: with the offset known to a second the middle of the next
+//          exchange is placed on the predicted change of the RTC second,
+//          timed for the shortest round trip as only short ones narrow
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::Schedule(INT64 earliestUs)
+{
+    NextUs = earliestUs;
+
+    if (!Valid || Upper - Lower >= 1000000)
+        return;
+
+    INT64 offset = GetOffsetUs(earliestUs);
+    INT64 half   = (INT64)Stats.MinRoundTripUs / 2;
+    INT64 module = earliestUs + half + offset;
+    INT64 second = (module / 1000000 + 1) * 1000000;
+
+    NextUs = second - offset - half;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetWaitMs
+//
+//------------------------------------------------------------------------------
+
+int
+TClockSync::GetWaitMs(int maxMs) const
+{
+    INT64 waitUs = NextUs - RLT_GetMonotonicUs();
+
+    if (waitUs <= 0)
+        return 0;
+
+    return (int)std::min<INT64>(maxMs, waitUs / 1000);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: an exchange aimed at a second is waited for if close, skipped
+//          if too late to tell on which side it fell (unless the last
+//          exchange is too long ago); the reader is detached before the
+//          wait, so the request leaves at the aimed time
+//
+//------------------------------------------------------------------------------
+
+void
+TClockSync::Poll()
+{
+    INT64 now = RLT_GetMonotonicUs();
+
+    if (now < NextUs)
+    {
+        if (NextUs - now > CLOCK_MAX_SLEEP_MS * 1000)
+            return;
+    }
+    else if (IsLocked() && now - NextUs > GetUncertaintyUs(now)
+             && now - LastExchangeUs < CLOCK_FORCE_INTERVALS * Config.IntervalMs * 1000ll)
+    {
+        Schedule(now);
+        return;
+    }
+
+    // the HCI reads the response itself
+    bool detached = Reader && Reader->Detach();
+
+    now = RLT_GetMonotonicUs();
+
+    if (now < NextUs)
+        std::this_thread::sleep_for(std::chrono::microseconds(NextUs - now));
+
+    UINT32 rtcTime = 0;
+    UINT8  status  = 0;
+    INT64  request = RLT_GetMonotonicUs();
+
+    TWiMODLRResult result   = HCI.GetRTC(rtcTime, status);
+    INT64          response = HCI.GetRxTimeUs();
+
+    if (detached)
+        Reader->Reattach();
+
+    if (result != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+    {
+        Stats.Failed++;
+        LastExchangeUs = RLT_GetMonotonicUs();
+        Schedule(LastExchangeUs + Config.IntervalMs * 1000ll);
+        return;
+    }
+
+    AddExchange(request, response, CLOCK_RtcToSeconds(rtcTime));
+
+    // offset in the sinks, at once after a lock or resync
+    if (Fanout && IsLocked() && (!LastReportUs || LastExchangeUs - LastReportUs >= Config.ReportS * 1000000ll))
+    {
+        LastReportUs = LastExchangeUs;
+        Fanout->PublishComment("clock " + FormatState());
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatState
+//
+//------------------------------------------------------------------------------
+
+std::string
+TClockSync::FormatState() const
+{
+    INT64 monotonic = RLT_GetMonotonicUs();
+    INT64 wall      = RLT_MonotonicToTimeUs(monotonic);
+
+    std::ostringstream text;
+
+    text << "offset=" << monotonic + GetOffsetUs(monotonic) - wall << " us"
+         << " uncertainty=" << GetUncertaintyUs(monotonic) << " us"
+         << std::fixed << std::setprecision(2)
+         << " drift=" << (DriftValid ? DriftPpm : 0.0) << " ppm"
+         << " exchanges=" << Stats.Exchanges
+         << " rejected=" << Stats.Rejected
+         << " failed=" << Stats.Failed
+         << " resyncs=" << Stats.Resyncs
+         << " min_rtt=" << Stats.MinRoundTripUs << " us";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ClockSync.h
+//
+//	Abstract:	Offset and Drift of the Module RTC against the Host Clock
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "SampleFanout.h"
+#include "HCIReader.h"
+#include <string>
+#include <deque>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// an exchange ahead of the next second of the module by at most this is
+// waited for in Poll [ms]
+#define CLOCK_MAX_SLEEP_MS      20
+
+// exchange anyway after this many intervals without hitting a second
+#define CLOCK_FORCE_INTERVALS   4
+
+typedef struct
+{
+    // time between exchanges [ms]
+    UINT32          IntervalMs          = 1000;
+
+    // exchanges with a longer round trip are discarded [us]
+    UINT32          MaxRoundTripUs      = 20000;
+
+    // bound of the drift until it is estimated, tolerance afterwards (at
+    // least three standard errors of the estimate) [ppm]
+    double          MaxDriftPpm         = 100;
+    double          DriftTolerancePpm   = 2;
+
+    // offsets narrower than this enter the drift estimate weighted by
+    // their precision [us], which needs a span of at least MinDriftSpanS
+    // and covers at most WindowS
+    UINT32          MaxSampleWidthUs    = 20000;
+    UINT32          MinDriftSpanS       = 60;
+    UINT32          WindowS             = 900;
+
+    // locked with the offset known to this width [us], the bounds settle
+    // near the shortest round trip of the serial path
+    UINT32          LockWidthUs         = 10000;
+
+    // offset as comment to the sinks (fan-out only) [s]
+    UINT32          ReportS             = 60;
+}TClockSyncConfig;
+
+typedef struct
+{
+    // exchanges used, discarded for their round trip, failed requests
+    UINT64  Exchanges;
+    UINT64  Rejected;
+    UINT64  Failed;
+
+    // offsets outside of the bounds: RTC set or module reset
+    UINT64  Resyncs;
+
+    // shortest round trip [us]
+    UINT64  MinRoundTripUs;
+}TClockSyncStats;
+
+//------------------------------------------------------------------------------
+//
+// Helper Functions
+//
+//------------------------------------------------------------------------------
+
+// RTC of the module (bit fields, see TWiMODLRHCI::U32TimeToString) to
+// seconds since epoch as UTC and back
+INT64           CLOCK_RtcToSeconds(UINT32 rtcTime);
+UINT32          CLOCK_SecondsToRtc(INT64 seconds);
+
+//------------------------------------------------------------------------------
+//
+// TClockSync Class Declaration
+//
+// Estimates the RTC of the module as offset to the monotonic host clock
+// (TWiMODLRHCI::GetRxTimeUs) from periodic RTC requests. An exchange bounds
+// the offset: the RTC was read between the request and the read of the
+// response, so it showed its second somewhere in that window. The bounds
+// of all exchanges are intersected, widened by the drift since, which
+// favours the exchanges with the shortest round trips like the minimum
+// delay filter of NTP. Once the offset is known to a second, requests are
+// timed to the predicted change of the RTC second, each one halving the
+// bounds down to the round trip. Narrow offsets over a window give the
+// drift by a least squares fit. The offset relates the time stamps of
+// several nodes to their module clocks, it goes to the sinks once locked
+// and every ReportS after.
+//
+// Poll runs blocking HCI requests, never call it from within the dispatch.
+//
+//------------------------------------------------------------------------------
+
+class TClockSync
+{
+    public:
+                    TClockSync(TWiMODLRHCI& hci, TSampleFanout* fanout = 0);
+
+    void            Configure(const TClockSyncConfig& config);
+
+    // serial reads through an event backend: the reader is detached for
+    // each exchange
+    void            SetReader(THCIReader* reader);
+    void            Reset();
+
+    // next exchange when due
+    void            Poll();
+
+    // time until the next exchange, at most maxMs [ms]
+    int             GetWaitMs(int maxMs) const;
+
+    // one exchange: monotonic time of the request and of the read of the
+    // response [us], RTC in seconds since epoch
+    void            AddExchange(INT64 requestUs, INT64 responseUs, INT64 rtcSeconds);
+
+    // offset known to LockWidthUs
+    bool            IsLocked() const;
+    bool            HasDrift() const { return DriftValid; }
+    double          GetDriftPpm() const { return DriftPpm; }
+
+    // RTC - monotonic clock at a monotonic time and its uncertainty (half
+    // width of the bounds) [us]
+    INT64           GetOffsetUs(INT64 monotonicUs) const;
+    INT64           GetUncertaintyUs(INT64 monotonicUs) const;
+
+    // RTC time of a monotonic time stamp [us since epoch]
+    INT64           ToModuleUs(INT64 monotonicUs) const { return monotonicUs + GetOffsetUs(monotonicUs); }
+
+    TClockSyncStats GetStats() const { return Stats; }
+
+    // "offset=.. us uncertainty=.. us drift=.. ppm exchanges=.. ...", the
+    // offset of the RTC against the host wall clock
+    std::string     FormatState() const;
+
+    private:
+
+    void            Bounds(INT64 timeUs, INT64& lower, INT64& upper) const;
+    void            EstimateDrift();
+    void            Schedule(INT64 earliestUs);
+
+    typedef struct
+    {
+        INT64   TimeUs;
+        INT64   OffsetUs;
+        INT64   WidthUs;
+    }TOffsetSample;
+
+    TWiMODLRHCI&        HCI;
+    TSampleFanout*      Fanout;
+    THCIReader*         Reader;
+    TClockSyncConfig    Config;
+    TClockSyncStats     Stats;
+
+    // offset bounds at BoundsTimeUs
+    bool                Valid;
+    INT64               Lower;
+    INT64               Upper;
+    INT64               BoundsTimeUs;
+
+    bool                DriftValid;
+    double              DriftPpm;
+    double              DriftErrorPpm;
+
+    std::deque<TOffsetSample>   Samples;
+
+    INT64               RoundTripUs;
+    INT64               LastExchangeUs;
+    INT64               NextUs;
+    INT64               LastReportUs;
+};
+
+#endif // CLOCKSYNC_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,288 @@
+//------------------------------------------------------------------------------
+//
+//	File:		DataLinkSender.cpp
+//
+//	Abstract:	Pipelined Unreliable Radio Messages with Tx Queue Credits
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "DataLinkSender.h"
+#include <algorithm>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  TDataLinkSender - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TDataLinkSender::TDataLinkSender(TWiMODLRHCI& hci)
+    : HCI(hci)
+{
+    Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//------------------------------------------------------------------------------
+
+void
+TDataLinkSender::Configure(const TDataLinkConfig& config)
+{
+    Config  = config;
+    Credits = std::max<UINT32>(1, Config.MaxInFlight);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reset
+//
+//  @brief: a response or indication still on its way is ignored
+//
+//------------------------------------------------------------------------------
+
+void
+TDataLinkSender::Reset()
+{
+    Queue.clear();
+    Accepted.clear();
+
+    Awaiting = false;
+    Retrying = false;
+    Credits  = std::max<UINT32>(1, Config.MaxInFlight);
+    LastSent = TClock::now();
+
+    Stats = TDataLinkStats();
+    QueueLatency.Reset();
+    SendLatency.Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Send
+//
+//------------------------------------------------------------------------------
+
+bool
+TDataLinkSender::Send(const UINT8* data, UINT16 length)
+{
+    if (length > DATALINK_MAX_PAYLOAD_SIZE || (Config.MaxQueued && Queue.size() >= Config.MaxQueued))
+    {
+        Stats.Dropped++;
+        return false;
+    }
+
+    TPendingMessage pending;
+
+    pending.Message.resize(DATALINK_RADIO_HEADER_SIZE + length);
+    pending.Message[0] = Config.GroupAddress;
+    HTON16(&pending.Message[1], Config.DeviceAddress);
+    std::copy(data, data + length, pending.Message.begin() + DATALINK_RADIO_HEADER_SIZE);
+    pending.Queued = TClock::now();
+
+    Queue.push_back(std::move(pending));
+    Stats.Queued++;
+
+    Pump();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Pump
+//
+//  @brief: post the head of the queue if the serial link and a credit are
+//          free
+//
+//------------------------------------------------------------------------------
+
+void
+TDataLinkSender::Pump()
+{
+    if (Awaiting || Retrying || Queue.empty() || Accepted.size() >= Credits)
+        return;
+
+    std::vector<UINT8>& message = Queue.front().Message;
+
+    if (HCI.PostURadioMessage(message.data(), (UINT16)message.size()) != WiMODLR_RESULT_OK)
+    {
+        // serial port gone, the message is lost
+        Queue.pop_front();
+        Stats.TxErrors++;
+        return;
+    }
+
+    Awaiting   = true;
+    AwaitStart = TClock::now();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageRsp
+//
+//------------------------------------------------------------------------------
+
+void
+TDataLinkSender::evRadioLink_TxUMessageRsp(UINT8 status)
+{
+    // response to a request of someone else (blocking SendURadioMessage)
+    if (!Awaiting || Queue.empty())
+        return;
+
+    Awaiting = false;
+
+    TClock::time_point now = TClock::now();
+
+    switch (status)
+    {
+        case    DATALINK_STATUS_OK:
+                {
+                    TPendingMessage& pending = Queue.front();
+
+                    QueueLatency.Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(now - pending.Queued).count());
+
+                    if (Accepted.empty())
+                        LastSent = now;
+
+                    Accepted.push_back({ pending.Queued, (UINT16)(pending.Message.size() - DATALINK_RADIO_HEADER_SIZE) });
+                    Queue.pop_front();
+                    Stats.Accepted++;
+                }
+                break;
+
+        case    DATALINK_STATUS_QUEUE_FULL:
+        case    DATALINK_STATUS_DEVICE_BUSY:
+        case    DATALINK_STATUS_MEDIA_BUSY:
+                if (status == DATALINK_STATUS_QUEUE_FULL)
+                    Stats.QueueFull++;
+                else if (status == DATALINK_STATUS_DEVICE_BUSY)
+                    Stats.DeviceBusy++;
+                else
+                    Stats.MediaBusy++;
+
+                // the module holds no more than this, retried with the next
+                // sent indication
+                Credits = std::max<UINT32>(1, (UINT32)Accepted.size());
+
+                if (Accepted.empty())
+                {
+                    Retrying = true;
+                    RetryAt  = now + std::chrono::milliseconds(Config.RetryMs);
+                }
+                break;
+
+        default:
+                // wrong length, parameter or mode: retrying does not help
+                Queue.pop_front();
+                Stats.Rejected++;
+                break;
+    }
+
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageInd
+//
+//------------------------------------------------------------------------------
+
+void
+TDataLinkSender::evRadioLink_TxUMessageInd(UINT8 status)
+{
+    if (Accepted.empty())
+        return;
+
+    TClock::time_point now = TClock::now();
+
+    if (status == DATALINK_STATUS_OK)
+    {
+        Stats.Sent++;
+        Stats.SentBytes += Accepted.front().Length;
+
+        SendLatency.Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(now - Accepted.front().Queued).count());
+    }
+    else
+        Stats.TxErrors++;
+
+    Accepted.pop_front();
+    LastSent = now;
+
+    // the module ran dry with messages waiting, one credit more
+    if (Accepted.empty() && !Queue.empty() && Credits < Config.MaxInFlight)
+        Credits++;
+
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: lost responses and indications, retry after a rejection
+//
+//------------------------------------------------------------------------------
+
+void
+TDataLinkSender::Poll()
+{
+    TClock::time_point now = TClock::now();
+
+    if (Awaiting && now - AwaitStart >= std::chrono::milliseconds(Config.ResponseTimeoutMs))
+    {
+        // the message may have been accepted, sent again
+        Awaiting = false;
+        Stats.Timeouts++;
+    }
+
+    if (!Accepted.empty() && now - LastSent >= std::chrono::milliseconds(Config.SentTimeoutMs))
+    {
+        // the module lost its queue (reset), the credits are free again
+        Stats.Timeouts += Accepted.size();
+        Accepted.clear();
+    }
+
+    if (Retrying && now >= RetryAt)
+        Retrying = false;
+
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TDataLinkSender::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "sent=" << Stats.Sent
+         << " accepted=" << Stats.Accepted
+         << " queue_full=" << Stats.QueueFull
+         << " busy=" << Stats.DeviceBusy + Stats.MediaBusy
+         << " dropped=" << Stats.Dropped + Stats.Rejected + Stats.TxErrors
+         << " timeouts=" << Stats.Timeouts
+         << " credits=" << Credits;
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+//
+//	File:		DataLinkSender.h
+//
+//	Abstract:	Pipelined Unreliable Radio Messages with Tx Queue Credits
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef DATALINKSENDER_H
+#define DATALINKSENDER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "LatencyHistogram.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// radio packet of at most 255 bytes including the message header
+#define DATALINK_MAX_PAYLOAD_SIZE   (255 - DATALINK_MSG_HEADER_SIZE)
+
+typedef struct
+{
+    // destination of the messages
+    UINT8   GroupAddress        = 0x10;
+    UINT16  DeviceAddress       = 0x2222;
+
+    // messages accepted by the module before their sent indication
+    // (credits), lowered to the observed queue depth after a rejection
+    UINT32  MaxInFlight         = 8;
+
+    // messages waiting on the host, Send fails beyond (0 = unlimited)
+    UINT32  MaxQueued           = 256;
+
+    // retry after "busy" / "queue full" with nothing in flight [ms]
+    UINT32  RetryMs             = 20;
+
+    // no response, no sent indication for a message in flight [ms]
+    UINT32  ResponseTimeoutMs   = 1000;
+    UINT32  SentTimeoutMs       = 5000;
+}TDataLinkConfig;
+
+typedef struct
+{
+    // messages handed to Send, accepted by the module, sent on air
+    UINT64  Queued;
+    UINT64  Accepted;
+    UINT64  Sent;
+    UINT64  SentBytes;
+
+    // rejections which are retried
+    UINT64  QueueFull;
+    UINT64  DeviceBusy;
+    UINT64  MediaBusy;
+
+    // dropped: rejected for other reasons, host queue full, send errors
+    UINT64  Rejected;
+    UINT64  Dropped;
+    UINT64  TxErrors;
+
+    // missing responses / sent indications
+    UINT64  Timeouts;
+}TDataLinkStats;
+
+//------------------------------------------------------------------------------
+//
+// TDataLinkSender Class Declaration
+//
+// Keeps the Tx queue of the module filled instead of waiting for each
+// message: one send request is outstanding on the serial link at a time
+// (TWiMODLRHCI::PostURadioMessage), further requests follow the response
+// as long as fewer than MaxInFlight accepted messages wait for their sent
+// indication. A "queue full" or "busy" response keeps the message at the
+// head of the host queue, lowers the credits to the number of messages in
+// flight and retries after the next sent indication (or RetryMs if none is
+// in flight); a credit is added back whenever the module runs dry while
+// messages wait on the host. Host queueing latency (Send until accepted)
+// and send latency (Send until on air) are kept as histograms in us.
+//
+// Not registered itself: the HCI client in front (bench, transport) calls
+// the data link handlers, which post the next request at once. Poll
+// handles the timeouts, all calls from the thread which drives the HCI.
+//
+//------------------------------------------------------------------------------
+
+class TDataLinkSender : public TWiMODLRHCIClient
+{
+    public:
+                    TDataLinkSender(TWiMODLRHCI& hci);
+
+    void            Configure(const TDataLinkConfig& config);
+    const TDataLinkConfig&  GetConfig() const { return Config; }
+
+    // queue a message to the configured destination, false if it is too
+    // long or the host queue is full
+    bool            Send(const UINT8* data, UINT16 length);
+
+    void            Poll();
+
+    // queued on the host, in flight in the module
+    size_t          GetQueued() const { return Queue.size(); }
+    UINT32          GetInFlight() const { return (UINT32)Accepted.size(); }
+    UINT32          GetCredits() const { return Credits; }
+    bool            IsIdle() const { return Queue.empty() && !Awaiting && Accepted.empty(); }
+
+    // a message handed to Send now is posted at once
+    bool            IsReady() const { return Queue.empty() && !Awaiting && !Retrying && Accepted.size() < Credits; }
+
+    // drop queued messages, counters and credits start again
+    void            Reset();
+
+    TDataLinkStats  GetStats() const { return Stats; }
+    const TLatencyHistogram&    GetQueueLatency() const { return QueueLatency; }
+    const TLatencyHistogram&    GetSendLatency() const { return SendLatency; }
+
+    // "sent=.. accepted=.. queue_full=.. busy=.. dropped=.. credits=.."
+    std::string     FormatStats() const;
+
+    // HCI client interface, called by the registered client
+    void            evRadioLink_TxUMessageRsp(UINT8 status) override;
+    void            evRadioLink_TxUMessageInd(UINT8 status) override;
+
+    private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    typedef struct
+    {
+        std::vector<UINT8>  Message;
+        TClock::time_point  Queued;
+    }TPendingMessage;
+
+    typedef struct
+    {
+        TClock::time_point  Queued;
+        UINT16              Length;
+    }TInFlightMessage;
+
+    void            Pump();
+
+    TWiMODLRHCI&        HCI;
+    TDataLinkConfig     Config;
+
+    std::deque<TPendingMessage>     Queue;
+
+    // request posted, response outstanding
+    bool                Awaiting;
+    TClock::time_point  AwaitStart;
+
+    // accepted messages until their sent indication
+    std::deque<TInFlightMessage>    Accepted;
+    UINT32              Credits;
+    TClock::time_point  LastSent;
+
+    // rejected with nothing in flight
+    bool                Retrying;
+    TClock::time_point  RetryAt;
+
+    TDataLinkStats      Stats;
+    TLatencyHistogram   QueueLatency;
+    TLatencyHistogram   SendLatency;
+};
+
+#endif // DATALINKSENDER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
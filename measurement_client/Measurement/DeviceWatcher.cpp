@@ -0,0 +1,349 @@
+//------------------------------------------------------------------------------
+//
+//	File:		DeviceWatcher.cpp
+//
+//	Abstract:	Hotplug Detection of Serial Devices with inotify
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "DeviceWatcher.h"
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// links are created by udev with a rename
+#define DEVICE_WATCH_MASK   (IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF)
+
+//------------------------------------------------------------------------------
+//
+//  TDeviceWatcher - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TDeviceWatcher::TDeviceWatcher()
+{
+    Handle = -1;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TDeviceWatcher - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TDeviceWatcher::~TDeviceWatcher()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TDeviceWatcher::Open()
+{
+    Close();
+
+    Handle = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    return Handle >= 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::Close()
+{
+    if (Handle >= 0)
+        ::close(Handle);
+
+    Handle = -1;
+    Watches.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddDevice
+//
+//------------------------------------------------------------------------------
+
+std::string
+TDeviceWatcher::AddDevice(const std::string& port, TDeviceWatcherClient* client)
+{
+    TDevice device;
+
+    device.Port    = port == DEVICE_AUTO ? std::string() : port;
+    device.Client  = 0;
+    device.Present = false;
+
+    Devices.push_back(device);
+
+    // bind and take the current state without notification
+    Scan();
+
+    Devices.back().Client = client;
+
+    AddWatches();
+
+    return Devices.back().Port;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Attach
+//
+//------------------------------------------------------------------------------
+
+bool
+TDeviceWatcher::Attach(TEventBackend& backend)
+{
+    return Handle >= 0 && backend.AddReader(Handle, this);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Process
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::Process()
+{
+    if (Handle < 0)
+        return;
+
+    // aligned for struct inotify_event
+    alignas(struct inotify_event) UINT8 buffer[EVENT_READ_BUFFER_SIZE];
+
+    ssize_t length = ::read(Handle, buffer, sizeof(buffer));
+    if (length > 0)
+        HandleEvents(buffer, (int)length);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRead
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::evRead(int /* fd */, UINT8* data, int length)
+{
+    if (length > 0)
+        HandleEvents(data, length);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetComPorts
+//
+//  @brief: replaces TSerialDevice::GetComPorts (Qt), by-id names survive
+//          a re-enumeration of the adapter
+//
+//------------------------------------------------------------------------------
+
+int
+TDeviceWatcher::GetComPorts(std::vector<std::string>& portList)
+{
+    portList.clear();
+
+    DIR* directory = ::opendir(DEVICE_BY_ID_DIR);
+    if (!directory)
+        return 0;
+
+    // "/dev/" is prepended by TSerialDevice
+    std::string prefix = std::string(DEVICE_BY_ID_DIR).substr(5) + "/";
+
+    while (struct dirent* entry = ::readdir(directory))
+    {
+        if (entry->d_name[0] != '.')
+            portList.push_back(prefix + entry->d_name);
+    }
+
+    ::closedir(directory);
+
+    std::sort(portList.begin(), portList.end());
+
+    return (int)portList.size();
+}
+
+//------------------------------------------------------------------------------
+//
+//  HandleEvents
+//
+//  @brief: any change in a watched directory triggers a rescan
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::HandleEvents(const UINT8* data, int length)
+{
+    int offset = 0;
+
+    while (offset + (int)sizeof(struct inotify_event) <= length)
+    {
+        struct inotify_event event;
+        std::memcpy(&event, data + offset, sizeof(event));
+
+        // directory deleted, its parent is watched instead
+        if (event.mask & IN_IGNORED)
+            Watches.erase(event.wd);
+
+        offset += sizeof(event) + event.len;
+    }
+
+    AddWatches();
+    Scan();
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddWatches
+//
+//  @brief: watch the deepest existing directory of every port
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::AddWatches()
+{
+    if (Handle < 0)
+        return;
+
+    for (const TDevice& device : Devices)
+    {
+        std::string path = device.Port.empty() ? std::string(DEVICE_BY_ID_DIR) + "/" : GetPath(device.Port);
+
+        while (true)
+        {
+            size_t slash = path.rfind('/');
+            if (slash == std::string::npos || slash == 0)
+                break;
+
+            path.erase(slash);
+
+            struct stat info;
+            if (::stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+            {
+                AddWatch(path);
+                break;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddWatch
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::AddWatch(const std::string& directory)
+{
+    for (auto& watch : Watches)
+        if (watch.second == directory)
+            return;
+
+    int wd = ::inotify_add_watch(Handle, directory.c_str(), DEVICE_WATCH_MASK);
+    if (wd >= 0)
+        Watches[wd] = directory;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Scan
+//
+//  @brief: bind auto devices, notify clients of changes
+//
+//------------------------------------------------------------------------------
+
+void
+TDeviceWatcher::Scan()
+{
+    std::vector<std::string> ports;
+
+    for (TDevice& device : Devices)
+    {
+        if (device.Port.empty())
+        {
+            if (ports.empty())
+                GetComPorts(ports);
+
+            // first adapter not bound to another client
+            for (const std::string& port : ports)
+            {
+                bool used = false;
+                for (const TDevice& other : Devices)
+                    used = used || other.Port == port;
+
+                if (!used)
+                {
+                    device.Port = port;
+                    break;
+                }
+            }
+
+            if (device.Port.empty())
+                continue;
+        }
+
+        struct stat info;
+        bool present = ::stat(GetPath(device.Port).c_str(), &info) == 0;
+
+        if (present == device.Present)
+            continue;
+
+        device.Present = present;
+
+        if (!device.Client)
+            continue;
+
+        if (present)
+            device.Client->evDeviceAdded(device.Port);
+        else
+            device.Client->evDeviceRemoved(device.Port);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetPath
+//
+//------------------------------------------------------------------------------
+
+std::string
+TDeviceWatcher::GetPath(const std::string& port)
+{
+    return !port.empty() && port[0] == '/' ? port : "/dev/" + port;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
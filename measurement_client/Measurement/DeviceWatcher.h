@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+//
+//	File:		DeviceWatcher.h
+//
+//	Abstract:	Hotplug Detection of Serial Devices with inotify
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef DEVICEWATCHER_H
+#define DEVICEWATCHER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "EventBackend.h"
+#include <string>
+#include <vector>
+#include <map>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// stable names of USB serial adapters, created by udev
+#define DEVICE_BY_ID_DIR        "/dev/serial/by-id"
+
+// device name selecting the first adapter in DEVICE_BY_ID_DIR
+#define DEVICE_AUTO             "auto"
+
+//------------------------------------------------------------------------------
+//
+// TDeviceWatcherClient Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TDeviceWatcherClient
+{
+    public:
+                        TDeviceWatcherClient() {}
+    virtual             ~TDeviceWatcherClient() {}
+
+    // port name as passed to TWiMODLRHCI::Open
+    virtual void        evDeviceAdded(const std::string& /* port */) {}
+    virtual void        evDeviceRemoved(const std::string& /* port */) {}
+};
+
+//------------------------------------------------------------------------------
+//
+// TDeviceWatcher Class Declaration
+//
+// Watches the directories of the registered ports with inotify and reports
+// when a port appears or disappears. Ports are named like TSerialDevice
+// expects them: relative to /dev (e.g. "serial/by-id/usb-...-if00-port0")
+// or absolute. A by-id name stays the same when the adapter re-enumerates
+// as another ttyUSB<n>, udev (re)creates the link as soon as the device is
+// set up. Missing parent directories are watched through their parents.
+//
+// Events are read by the event backend (Attach) or by Process from the
+// legacy loop, clients are called from that thread. Through the backend a
+// replug is seen within milliseconds, the legacy loop calls Process once
+// per status indication wait and notices it within a second.
+//
+//------------------------------------------------------------------------------
+
+class TDeviceWatcher : public TEventClient
+{
+    public:
+                        TDeviceWatcher();
+                        ~TDeviceWatcher();
+
+    bool                Open();
+    void                Close();
+
+    // watch port for client, DEVICE_AUTO is bound to the first adapter found
+    // now or plugged in later; returns the port name (empty while unbound)
+    std::string         AddDevice(const std::string& port, TDeviceWatcherClient* client);
+
+    // read events through the backend
+    bool                Attach(TEventBackend& backend);
+
+    // non-blocking read of pending events, legacy loop
+    void                Process();
+
+    int                 GetHandle() const { return Handle; }
+
+    // ports in DEVICE_BY_ID_DIR, relative to /dev, sorted
+    static int          GetComPorts(std::vector<std::string>& portList);
+
+    // event backend interface
+    void                evRead(int fd, UINT8* data, int length) override;
+
+    private:
+
+    typedef struct
+    {
+        std::string             Port;
+        TDeviceWatcherClient*   Client;
+        bool                    Present;
+    }TDevice;
+
+    void                HandleEvents(const UINT8* data, int length);
+    void                AddWatches();
+    void                AddWatch(const std::string& directory);
+    void                Scan();
+
+    static std::string  GetPath(const std::string& port);
+
+    int                 Handle;
+
+    std::vector<TDevice>        Devices;
+
+    // watch descriptor -> directory
+    std::map<int, std::string>  Watches;
+};
+
+#endif // DEVICEWATCHER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ErasureCode.cpp
+//
+//	Abstract:	Systematic Reed-Solomon Erasure Code over GF(256)
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "ErasureCode.h"
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//
+//  GF(256) Tables
+//
+//  @brief: exponent table doubled, no modulo in the product
+//
+//------------------------------------------------------------------------------
+
+#define FEC_POLYNOMIAL  0x11D
+
+typedef struct
+{
+    UINT8   Exp[510];
+    UINT8   Log[256];
+}TGaloisTables;
+
+static const TGaloisTables&
+GetTables()
+{
+    static const TGaloisTables tables = []
+    {
+        TGaloisTables t = {};
+        UINT32 value = 1;
+
+        for (int i = 0; i < 255; i++)
+        {
+            t.Exp[i]       = (UINT8)value;
+            t.Exp[i + 255] = (UINT8)value;
+            t.Log[value]   = (UINT8)i;
+
+            value <<= 1;
+            if (value & 0x100)
+                value ^= FEC_POLYNOMIAL;
+        }
+        return t;
+    }();
+
+    return tables;
+}
+
+static inline UINT8
+Mul(const TGaloisTables& t, UINT8 a, UINT8 b)
+{
+    return a && b ? t.Exp[t.Log[a] + t.Log[b]] : 0;
+}
+
+static inline UINT8
+Inv(const TGaloisTables& t, UINT8 a)
+{
+    return t.Exp[255 - t.Log[a]];
+}
+
+// Cauchy matrix element of a parity row and a data column
+static inline UINT8
+Coefficient(const TGaloisTables& t, UINT32 numData, UINT32 row, UINT32 column)
+{
+    return Inv(t, (UINT8)((numData + row) ^ column));
+}
+
+// dst += c * src
+static void
+MulAdd(const TGaloisTables& t, UINT8* dst, const UINT8* src, UINT8 c, size_t length)
+{
+    if (!c)
+        return;
+
+    UINT32 logC = t.Log[c];
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (src[i])
+            dst[i] ^= t.Exp[t.Log[src[i]] + logC];
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  FEC_Encode
+//
+//------------------------------------------------------------------------------
+
+void
+FEC_Encode(const UINT8* const* data, UINT32 numData, size_t length, UINT32 row, UINT8* parity)
+{
+    const TGaloisTables& t = GetTables();
+
+    std::memset(parity, 0, length);
+
+    for (UINT32 column = 0; column < numData; column++)
+        MulAdd(t, parity, data[column], Coefficient(t, numData, row, column), length);
+}
+
+//------------------------------------------------------------------------------
+//
+//  FEC_Decode
+//
+//  @brief: subtract the present data shards from the parity shards, invert
+//          the Cauchy submatrix of the missing columns (Gauss-Jordan)
+//
+//------------------------------------------------------------------------------
+
+bool
+FEC_Decode(UINT8* const* data, const bool* present, UINT32 numData,
+           const UINT8* const* parity, const UINT32* rows, UINT32 numParity, size_t length)
+{
+    const TGaloisTables& t = GetTables();
+
+    std::vector<UINT32> missing;
+
+    for (UINT32 column = 0; column < numData; column++)
+    {
+        if (!present[column])
+            missing.push_back(column);
+    }
+
+    size_t n = missing.size();
+
+    if (!n)
+        return true;
+
+    if (numParity < n)
+        return false;
+
+    // parity of the missing shards only
+    std::vector<std::vector<UINT8>> rhs(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        rhs[i].assign(parity[i], parity[i] + length);
+
+        for (UINT32 column = 0; column < numData; column++)
+        {
+            if (present[column])
+                MulAdd(t, rhs[i].data(), data[column], Coefficient(t, numData, rows[i], column), length);
+        }
+    }
+
+    // [M | I] -> [I | M^-1]
+    std::vector<UINT8> matrix(n * 2 * n, 0);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+            matrix[i * 2 * n + j] = Coefficient(t, numData, rows[i], missing[j]);
+
+        matrix[i * 2 * n + n + i] = 1;
+    }
+
+    for (size_t col = 0; col < n; col++)
+    {
+        size_t pivot = col;
+
+        while (pivot < n && !matrix[pivot * 2 * n + col])
+            pivot++;
+
+        // duplicate rows
+        if (pivot == n)
+            return false;
+
+        if (pivot != col)
+        {
+            for (size_t j = 0; j < 2 * n; j++)
+                std::swap(matrix[pivot * 2 * n + j], matrix[col * 2 * n + j]);
+        }
+
+        UINT8* pivotRow = &matrix[col * 2 * n];
+        UINT8  scale    = Inv(t, pivotRow[col]);
+
+        for (size_t j = 0; j < 2 * n; j++)
+            pivotRow[j] = Mul(t, pivotRow[j], scale);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            UINT8 factor = matrix[i * 2 * n + col];
+
+            if (i != col && factor)
+                MulAdd(t, &matrix[i * 2 * n], pivotRow, factor, 2 * n);
+        }
+    }
+
+    for (size_t j = 0; j < n; j++)
+    {
+        UINT8* shard = data[missing[j]];
+
+        std::memset(shard, 0, length);
+
+        for (size_t i = 0; i < n; i++)
+            MulAdd(t, shard, rhs[i].data(), matrix[j * 2 * n + n + i], length);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ErasureCode.h
+//
+//	Abstract:	Systematic Reed-Solomon Erasure Code over GF(256)
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef ERASURECODE_H
+#define ERASURECODE_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+// A group of numData equally long data shards is protected by parity
+// shards; any numData of the data and parity shards restore the missing
+// data shards. Parity shard "row" is the row of a Cauchy matrix
+// (1 / (x_row + y_data), x_row = numData + row, y_data = 0 .. numData - 1)
+// over GF(2^8) with the polynomial 0x11D. Every square submatrix of a
+// Cauchy matrix is invertible, so each parity row is independent of the
+// others and the number of rows may differ from group to group.
+//
+//------------------------------------------------------------------------------
+
+// data and parity shards of a group
+#define FEC_MAX_SHARDS  256
+
+// parity shard row (numData + row < FEC_MAX_SHARDS) of the data shards
+void            FEC_Encode(const UINT8* const* data, UINT32 numData, size_t length, UINT32 row, UINT8* parity);
+
+// restore the data shards which are not present (buffers of length bytes)
+// from the parity shards of the given rows, false if fewer parity shards
+// than missing data shards
+bool            FEC_Decode(UINT8* const* data, const bool* present, UINT32 numData,
+                           const UINT8* const* parity, const UINT32* rows, UINT32 numParity, size_t length);
+
+#endif // ERASURECODE_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
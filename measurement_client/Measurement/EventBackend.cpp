@@ -0,0 +1,1063 @@
+//------------------------------------------------------------------------------
+//
+//	File:		EventBackend.cpp
+//
+//	Abstract:	Event Backends (io_uring / epoll) for Serial Reads and Log Writes
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "EventBackend.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+// timeouts passed to io_uring_enter require kernel 5.11 headers
+#if defined(IORING_FEAT_EXT_ARG) && defined(__NR_io_uring_setup)
+#define EVENT_HAVE_URING
+#endif
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define EPOLL_MAX_EVENTS        16
+
+// io_uring user data tags, lower bits hold reader index or write id
+#define URING_TAG_READ          (1ULL << 62)
+#define URING_TAG_POLL          (2ULL << 62)
+#define URING_TAG_CANCEL        (3ULL << 62)
+#define URING_TAG_MASK          (3ULL << 62)
+
+// attempts to collect cancelled reads before the ring is closed
+#define URING_CLOSE_RETRIES     10
+
+//------------------------------------------------------------------------------
+//
+//  TEventBackend - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TEventBackend::TEventBackend()
+{
+    std::memset(&Stats, 0, sizeof(Stats));
+
+    WakeHandle  = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    Outstanding = 0;
+    WakeCalls   = 0;
+    LoopThread  = std::thread::id();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TEventBackend - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TEventBackend::~TEventBackend()
+{
+    if (WakeHandle >= 0)
+        ::close(WakeHandle);
+}
+
+//------------------------------------------------------------------------------
+//
+//  QueueWrite
+//
+//  @brief: queue write, appended to previous write if contiguous; wakes
+//          the event loop if called from another thread
+//
+//------------------------------------------------------------------------------
+
+bool
+TEventBackend::QueueWrite(int fd, const void* data, UINT32 length, UINT64 offset)
+{
+    const UINT8* src = (const UINT8*)data;
+
+    {
+        std::lock_guard<std::mutex> lock(WriteLock);
+
+        if (!Queued.empty() && Queued.back().Handle == fd
+            && Queued.back().Offset + Queued.back().Data.size() == offset)
+        {
+            std::vector<UINT8>& last = Queued.back().Data;
+            last.insert(last.end(), src, src + length);
+        }
+        else
+        {
+            Queued.push_back({ fd, offset, std::vector<UINT8>(src, src + length) });
+            Outstanding++;
+        }
+    }
+
+    if (!IsLoopThread())
+    {
+        UINT64 one = 1;
+
+        WakeCalls++;
+        if (::write(WakeHandle, &one, sizeof(one)) != sizeof(one))
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Drain
+//
+//  @brief: flush directly on the event loop thread, otherwise wake the loop
+//          and wait until it has completed all writes
+//
+//------------------------------------------------------------------------------
+
+bool
+TEventBackend::Drain()
+{
+    if (IsLoopThread())
+        return Flush();
+
+    UINT64 one = 1;
+
+    WakeCalls++;
+    if (::write(WakeHandle, &one, sizeof(one)) != sizeof(one))
+        return false;
+
+    std::unique_lock<std::mutex> lock(WriteLock);
+
+    return WritesDone.wait_for(lock, std::chrono::milliseconds(EVENT_DRAIN_TIMEOUT_MS),
+                               [this] { return Outstanding == 0; });
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetStats
+//
+//------------------------------------------------------------------------------
+
+TEventStats
+TEventBackend::GetStats() const
+{
+    TEventStats stats = Stats;
+
+    // wake-ups issued by other threads
+    stats.Syscalls += WakeCalls;
+
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TakeWrites
+//
+//------------------------------------------------------------------------------
+
+void
+TEventBackend::TakeWrites(std::vector<TWrite>& writes)
+{
+    std::lock_guard<std::mutex> lock(WriteLock);
+
+    if (writes.empty())
+        writes.swap(Queued);
+    else
+    {
+        for (TWrite& write : Queued)
+            writes.push_back(std::move(write));
+    }
+
+    Queued.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  CompleteWrite
+//
+//------------------------------------------------------------------------------
+
+void
+TEventBackend::CompleteWrite(bool ok, size_t length)
+{
+    Stats.Writes++;
+
+    if (ok)
+        Stats.WriteBytes += length;
+    else
+        Stats.WriteErrors++;
+
+    std::lock_guard<std::mutex> lock(WriteLock);
+
+    if (Outstanding && !--Outstanding)
+        WritesDone.notify_all();
+}
+
+//------------------------------------------------------------------------------
+//
+//  IsLoopThread
+//
+//  @brief: true for the thread calling Poll, or any thread before the first
+//          Poll
+//
+//------------------------------------------------------------------------------
+
+bool
+TEventBackend::IsLoopThread() const
+{
+    std::thread::id loop = LoopThread;
+
+    return loop == std::thread::id() || loop == std::this_thread::get_id();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+//
+//  epoll Backend
+//
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  TEpollBackend - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TEpollBackend::TEpollBackend()
+{
+    Handle = -1;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TEpollBackend - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TEpollBackend::~TEpollBackend()
+{
+    Flush();
+
+    if (Handle >= 0)
+        ::close(Handle);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TEpollBackend::Open()
+{
+    Handle = ::epoll_create1(EPOLL_CLOEXEC);
+    if (Handle < 0 || WakeHandle < 0)
+        return false;
+
+    struct epoll_event event;
+
+    std::memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = WakeHandle;
+
+    return ::epoll_ctl(Handle, EPOLL_CTL_ADD, WakeHandle, &event) == 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddReader
+//
+//------------------------------------------------------------------------------
+
+bool
+TEpollBackend::AddReader(int fd, TEventClient* client)
+{
+    struct epoll_event event;
+
+    std::memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = fd;
+
+    Stats.Syscalls++;
+    if (::epoll_ctl(Handle, EPOLL_CTL_ADD, fd, &event) != 0)
+        return false;
+
+    Readers[fd] = client;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RemoveReader
+//
+//------------------------------------------------------------------------------
+
+bool
+TEpollBackend::RemoveReader(int fd)
+{
+    if (!Readers.erase(fd))
+        return false;
+
+    Stats.Syscalls++;
+    ::epoll_ctl(Handle, EPOLL_CTL_DEL, fd, 0);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+int
+TEpollBackend::Poll(int timeoutMs)
+{
+    EnterLoop();
+
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+
+    Stats.Syscalls++;
+    int numEvents = ::epoll_wait(Handle, events, EPOLL_MAX_EVENTS, timeoutMs);
+    if (numEvents < 0)
+        return errno == EINTR ? 0 : -1;
+
+    for (int i = 0; i < numEvents; i++)
+    {
+        int fd = events[i].data.fd;
+
+        // writes queued by another thread
+        if (fd == WakeHandle)
+        {
+            UINT64 count;
+
+            Stats.Syscalls++;
+            ssize_t numRead = ::read(WakeHandle, &count, sizeof(count));
+            (void)numRead;
+            continue;
+        }
+
+        auto reader = Readers.find(fd);
+        if (reader == Readers.end())
+            continue;
+
+        Stats.Syscalls++;
+        ssize_t numRxBytes = ::read(fd, Buffer, sizeof(Buffer));
+
+        if (numRxBytes < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+
+        Stats.Reads++;
+
+        TEventClient* client = reader->second;
+
+        // hangup or error, stop watching this fd
+        if (numRxBytes <= 0)
+            RemoveReader(fd);
+        else
+            Stats.ReadBytes += numRxBytes;
+
+        if (client)
+            client->evRead(fd, Buffer, (int)numRxBytes);
+    }
+
+    // writes of this round, one pwrite per contiguous range
+    Flush();
+
+    return numEvents;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Flush
+//
+//------------------------------------------------------------------------------
+
+bool
+TEpollBackend::Flush()
+{
+    bool result = true;
+
+    TakeWrites(Writes);
+
+    for (TWrite& write : Writes)
+    {
+        Stats.Syscalls++;
+        ssize_t written = ::pwrite(write.Handle, write.Data.data(), write.Data.size(), write.Offset);
+
+        bool ok = written == (ssize_t)write.Data.size();
+        if (!ok)
+            result = false;
+
+        CompleteWrite(ok, write.Data.size());
+    }
+
+    Writes.clear();
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+//
+//  io_uring Backend
+//
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  TUringBackend - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TUringBackend::TUringBackend()
+{
+    Handle      = -1;
+    SQRing      = MAP_FAILED;
+    CQRing      = MAP_FAILED;
+    SQEs        = MAP_FAILED;
+    SQRingSize  = 0;
+    CQRingSize  = 0;
+    SQEsSize    = 0;
+    SQHead      = 0;
+    SQTail      = 0;
+    SQMask      = 0;
+    SQArray     = 0;
+    SQEntries   = 0;
+    CQHead      = 0;
+    CQTail      = 0;
+    CQMask      = 0;
+    CQEs        = 0;
+    ToSubmit    = 0;
+    InFlight    = 0;
+    NextWriteID = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TUringBackend - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TUringBackend::~TUringBackend()
+{
+    if (Handle >= 0)
+    {
+        Flush();
+
+        // cancel reads in flight, the kernel must not write into released
+        // buffers after the ring is closed; the clients may be gone already
+        for (TReader* reader : Readers)
+        {
+            if (reader && reader->Active)
+            {
+                reader->Client = 0;
+                RemoveReader(reader->Handle);
+            }
+        }
+
+        for (int retry = 0; InFlight && retry < URING_CLOSE_RETRIES; retry++)
+        {
+            Enter(1, 100);
+            Reap();
+        }
+
+        ::close(Handle);
+    }
+
+    if (SQEs != MAP_FAILED)
+        ::munmap(SQEs, SQEsSize);
+
+    if (CQRing != MAP_FAILED && CQRing != SQRing)
+        ::munmap(CQRing, CQRingSize);
+
+    if (SQRing != MAP_FAILED)
+        ::munmap(SQRing, SQRingSize);
+
+    for (TReader* reader : Readers)
+        delete reader;
+}
+
+#ifdef EVENT_HAVE_URING
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: set up ring and map submission / completion queues
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::Open(UINT32 entries)
+{
+    struct io_uring_params params;
+
+    std::memset(&params, 0, sizeof(params));
+
+    Handle = (int)::syscall(__NR_io_uring_setup, entries, &params);
+    if (Handle < 0)
+        return false;
+
+    // timeouts are passed to io_uring_enter directly
+    if (!(params.features & IORING_FEAT_EXT_ARG))
+        return false;
+
+    SQRingSize = params.sq_off.array + params.sq_entries * sizeof(UINT32);
+    CQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        SQRingSize = CQRingSize = std::max(SQRingSize, CQRingSize);
+
+    SQRing = ::mmap(0, SQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Handle, IORING_OFF_SQ_RING);
+    if (SQRing == MAP_FAILED)
+        return false;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        CQRing = SQRing;
+    else
+    {
+        CQRing = ::mmap(0, CQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Handle, IORING_OFF_CQ_RING);
+        if (CQRing == MAP_FAILED)
+            return false;
+    }
+
+    SQEsSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    SQEs     = ::mmap(0, SQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Handle, IORING_OFF_SQES);
+    if (SQEs == MAP_FAILED)
+        return false;
+
+    UINT8* sq = (UINT8*)SQRing;
+    UINT8* cq = (UINT8*)CQRing;
+
+    SQHead    = (UINT32*)(sq + params.sq_off.head);
+    SQTail    = (UINT32*)(sq + params.sq_off.tail);
+    SQMask    = (UINT32*)(sq + params.sq_off.ring_mask);
+    SQArray   = (UINT32*)(sq + params.sq_off.array);
+    SQEntries = params.sq_entries;
+    CQHead    = (UINT32*)(cq + params.cq_off.head);
+    CQTail    = (UINT32*)(cq + params.cq_off.tail);
+    CQMask    = (UINT32*)(cq + params.cq_off.ring_mask);
+    CQEs      = cq + params.cq_off.cqes;
+
+    // wake-up from other threads queueing writes
+    return WakeHandle >= 0 && AddReader(WakeHandle, 0);
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddReader
+//
+//  @brief: register fd, first read is submitted with the next Poll
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::AddReader(int fd, TEventClient* client)
+{
+    TReader* reader = new TReader;
+
+    reader->Handle = fd;
+    reader->Active = true;
+    reader->Client = client;
+
+    // O_NONBLOCK would make io_uring return -EAGAIN instead of waiting for
+    // data, blocking reads are handled asynchronously by the ring
+    Stats.Syscalls += 2;
+    reader->Flags = ::fcntl(fd, F_GETFL);
+    if (reader->Flags < 0)
+    {
+        delete reader;
+        return false;
+    }
+    ::fcntl(fd, F_SETFL, reader->Flags & ~O_NONBLOCK);
+
+    Readers.push_back(reader);
+
+    return PrepareRead((UINT32)Readers.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RemoveReader
+//
+//  @brief: cancel read in flight, reader is released on its completion
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::RemoveReader(int fd)
+{
+    for (UINT32 index = 0; index < Readers.size(); index++)
+    {
+        TReader* reader = Readers[index];
+
+        if (!reader || !reader->Active || reader->Handle != fd)
+            continue;
+
+        reader->Active = false;
+
+        int flags = reader->Flags;
+
+        // the read or the poll in flight
+        for (UINT64 tag : { URING_TAG_READ, URING_TAG_POLL })
+        {
+            struct io_uring_sqe* sqe = (struct io_uring_sqe*)GetSQE();
+            if (sqe)
+            {
+                sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+                sqe->fd        = -1;
+                sqe->addr      = tag | index;
+                sqe->user_data = URING_TAG_CANCEL | index;
+            }
+        }
+
+        // the reader is released with its last completion, the caller may
+        // read the fd itself afterwards without losing bytes to the ring
+        for (int retry = 0; Readers[index] && retry < URING_CLOSE_RETRIES; retry++)
+        {
+            if (Enter(1, 100) < 0)
+                break;
+            Reap();
+        }
+
+        Stats.Syscalls++;
+        ::fcntl(fd, F_SETFL, flags);
+
+        return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrepareWrites
+//
+//  @brief: move queued writes into submission entries, buffers are kept
+//          until completion
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::PrepareWrites()
+{
+    std::vector<TWrite> queued;
+
+    TakeWrites(queued);
+
+    bool result = true;
+
+    for (TWrite& write : queued)
+    {
+        struct io_uring_sqe* sqe = (struct io_uring_sqe*)GetSQE();
+        if (!sqe)
+        {
+            CompleteWrite(false, write.Data.size());
+            result = false;
+            continue;
+        }
+
+        UINT64  id    = NextWriteID++ & ~URING_TAG_MASK;
+        TWrite& entry = Writes[id];
+
+        entry = std::move(write);
+
+        sqe->opcode    = IORING_OP_WRITE;
+        sqe->fd        = entry.Handle;
+        sqe->addr      = (UINT64)(uintptr_t)entry.Data.data();
+        sqe->len       = (UINT32)entry.Data.size();
+        sqe->off       = entry.Offset;
+        sqe->user_data = id;
+
+        InFlight++;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: dispatch available completions without a system call, otherwise
+//          submit prepared entries and wait in one io_uring_enter
+//
+//------------------------------------------------------------------------------
+
+int
+TUringBackend::Poll(int timeoutMs)
+{
+    EnterLoop();
+
+    // writes queued by the callbacks are submitted with the next enter
+    int handled = Reap();
+    PrepareWrites();
+
+    if (handled)
+        return handled;
+
+    if (Enter(1, timeoutMs) < 0)
+        return -1;
+
+    handled = Reap();
+    PrepareWrites();
+
+    return handled;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Flush
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::Flush()
+{
+    UINT64 errors = Stats.WriteErrors;
+
+    PrepareWrites();
+
+    while (!Writes.empty())
+    {
+        if (Enter(1, -1) < 0)
+            return false;
+
+        Reap();
+        PrepareWrites();
+    }
+
+    return Stats.WriteErrors == errors;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrepareRead
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::PrepareRead(UINT32 index)
+{
+    TReader* reader = Readers[index];
+
+    struct io_uring_sqe* sqe = (struct io_uring_sqe*)GetSQE();
+    if (!sqe)
+        return false;
+
+    sqe->opcode    = IORING_OP_READ;
+    sqe->fd        = reader->Handle;
+    sqe->addr      = (UINT64)(uintptr_t)reader->Buffer;
+    sqe->len       = sizeof(reader->Buffer);
+    sqe->off       = (UINT64)-1;
+    sqe->user_data = URING_TAG_READ | index;
+
+    InFlight++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PreparePoll
+//
+//  @brief: wait for readability, used if a read returned -EAGAIN because the
+//          fd was switched back to non-blocking
+//
+//------------------------------------------------------------------------------
+
+bool
+TUringBackend::PreparePoll(UINT32 index)
+{
+    struct io_uring_sqe* sqe = (struct io_uring_sqe*)GetSQE();
+    if (!sqe)
+        return false;
+
+    sqe->opcode         = IORING_OP_POLL_ADD;
+    sqe->fd             = Readers[index]->Handle;
+    sqe->poll32_events  = POLLIN;
+    sqe->user_data      = URING_TAG_POLL | index;
+
+    InFlight++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetSQE
+//
+//  @brief: get next free submission entry, the tail is published right
+//          away since the kernel only consumes entries on io_uring_enter
+//
+//------------------------------------------------------------------------------
+
+void*
+TUringBackend::GetSQE()
+{
+    UINT32 tail = *SQTail;
+
+    // submission queue full, submit without waiting
+    if (tail - __atomic_load_n(SQHead, __ATOMIC_ACQUIRE) >= SQEntries)
+    {
+        if (Enter(0, 0) < 0 || tail - __atomic_load_n(SQHead, __ATOMIC_ACQUIRE) >= SQEntries)
+            return 0;
+    }
+
+    UINT32 index = tail & *SQMask;
+
+    struct io_uring_sqe* sqe = &((struct io_uring_sqe*)SQEs)[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    SQArray[index] = index;
+
+    __atomic_store_n(SQTail, tail + 1, __ATOMIC_RELEASE);
+
+    ToSubmit++;
+
+    return sqe;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Enter
+//
+//  @brief: submit prepared entries, wait for minComplete completions
+//          (timeoutMs < 0 waits forever)
+//
+//------------------------------------------------------------------------------
+
+int
+TUringBackend::Enter(UINT32 minComplete, int timeoutMs)
+{
+    struct __kernel_timespec        timeout;
+    struct io_uring_getevents_arg   arg;
+
+    std::memset(&arg, 0, sizeof(arg));
+
+    UINT32  flags   = 0;
+    void*   argPtr  = 0;
+    size_t  argSize = 0;
+
+    if (minComplete)
+    {
+        flags |= IORING_ENTER_GETEVENTS;
+
+        if (timeoutMs >= 0)
+        {
+            timeout.tv_sec  = timeoutMs / 1000;
+            timeout.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts         = (UINT64)(uintptr_t)&timeout;
+
+            flags  |= IORING_ENTER_EXT_ARG;
+            argPtr  = &arg;
+            argSize = sizeof(arg);
+        }
+    }
+
+    Stats.Syscalls++;
+    int result = (int)::syscall(__NR_io_uring_enter, Handle, ToSubmit, minComplete, flags, argPtr, argSize);
+
+    if (result < 0)
+    {
+        // timeout or signal, not an error
+        if (errno == ETIME || errno == EINTR)
+            return 0;
+
+        return -1;
+    }
+
+    ToSubmit -= std::min<UINT32>(ToSubmit, (UINT32)result);
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reap
+//
+//  @brief: dispatch completions, re-arm reads
+//
+//------------------------------------------------------------------------------
+
+int
+TUringBackend::Reap()
+{
+    int     handled = 0;
+    UINT32  head    = *CQHead;
+
+    while (head != __atomic_load_n(CQTail, __ATOMIC_ACQUIRE))
+    {
+        struct io_uring_cqe* cqe = &((struct io_uring_cqe*)CQEs)[head & *CQMask];
+
+        UINT64  userData = cqe->user_data;
+        int     result   = cqe->res;
+
+        // release entry before callbacks may queue new work
+        __atomic_store_n(CQHead, ++head, __ATOMIC_RELEASE);
+
+        UINT64 tag = userData & URING_TAG_MASK;
+
+        if (tag == URING_TAG_CANCEL)
+            continue;
+
+        InFlight--;
+        handled++;
+
+        if (!tag)
+        {
+            // write completed
+            auto write = Writes.find(userData);
+            if (write == Writes.end())
+                continue;
+
+            size_t length = write->second.Data.size();
+
+            CompleteWrite(result == (int)length, length);
+
+            Writes.erase(write);
+            continue;
+        }
+
+        UINT32   index  = (UINT32)(userData & 0xFFFFFFFF);
+        TReader* reader = index < Readers.size() ? Readers[index] : 0;
+
+        if (!reader)
+            continue;
+
+        if (reader->Active && tag == URING_TAG_POLL)
+        {
+            // readable now
+            PrepareRead(index);
+            continue;
+        }
+
+        if (reader->Active && tag == URING_TAG_READ)
+        {
+            if (result == -EAGAIN)
+            {
+                PreparePoll(index);
+                continue;
+            }
+
+            if (result == -EINTR)
+            {
+                PrepareRead(index);
+                continue;
+            }
+
+            Stats.Reads++;
+
+            if (result > 0)
+                Stats.ReadBytes += result;
+            else
+                // hangup or error, read is not re-armed
+                reader->Active = false;
+
+            if (reader->Client)
+                reader->Client->evRead(reader->Handle, reader->Buffer, result);
+
+            if (reader->Active)
+            {
+                PrepareRead(index);
+                continue;
+            }
+        }
+
+        // completed before the cancellation, the bytes belong to the stream
+        if (tag == URING_TAG_READ && result > 0 && reader->Client)
+        {
+            Stats.Reads++;
+            Stats.ReadBytes += result;
+
+            reader->Client->evRead(reader->Handle, reader->Buffer, result);
+        }
+
+        // reader removed and nothing in flight anymore
+        delete reader;
+        Readers[index] = 0;
+    }
+
+    return handled;
+}
+
+#else
+
+//------------------------------------------------------------------------------
+//
+//  io_uring not available at build time
+//
+//------------------------------------------------------------------------------
+
+bool TUringBackend::Open(UINT32) { return false; }
+bool TUringBackend::AddReader(int, TEventClient*) { return false; }
+bool TUringBackend::RemoveReader(int) { return false; }
+int  TUringBackend::Poll(int) { return -1; }
+bool TUringBackend::Flush() { return true; }
+int  TUringBackend::Enter(UINT32, int) { return -1; }
+int  TUringBackend::Reap() { return 0; }
+
+#endif // EVENT_HAVE_URING
+
+//------------------------------------------------------------------------------
+//
+//  CreateEventBackend
+//
+//  @brief: create backend, io_uring falls back to epoll
+//
+//------------------------------------------------------------------------------
+
+TEventBackend*
+CreateEventBackend(TEventBackendType type)
+{
+    if (type == EVENT_BACKEND_URING)
+    {
+        TUringBackend* uring = new TUringBackend();
+        if (uring->Open())
+            return uring;
+
+        delete uring;
+
+        std::cerr << "Warning: io_uring not available, using epoll" << std::endl;
+    }
+
+    TEpollBackend* epoll = new TEpollBackend();
+    if (epoll->Open())
+        return epoll;
+
+    delete epoll;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
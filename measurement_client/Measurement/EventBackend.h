@@ -0,0 +1,296 @@
+//------------------------------------------------------------------------------
+//
+//	File:		EventBackend.h
+//
+//	Abstract:	Event Backends (io_uring / epoll) for Serial Reads and Log Writes
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef EVENTBACKEND_H
+#define EVENTBACKEND_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// read buffer per registered file descriptor
+#define EVENT_READ_BUFFER_SIZE      4096
+
+// io_uring submission queue entries
+#define EVENT_URING_ENTRIES         64
+
+// max. time a Drain from another thread waits for the event loop
+#define EVENT_DRAIN_TIMEOUT_MS      5000
+
+typedef enum
+{
+    EVENT_BACKEND_EPOLL = 0,
+    // falls back to epoll if io_uring is not available
+    EVENT_BACKEND_URING
+}TEventBackendType;
+
+typedef struct
+{
+    // system calls issued by the backend
+    UINT64  Syscalls;
+    UINT64  Reads;
+    UINT64  ReadBytes;
+    UINT64  Writes;
+    UINT64  WriteBytes;
+    UINT64  WriteErrors;
+}TEventStats;
+
+//------------------------------------------------------------------------------
+//
+// TEventClient Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TEventClient
+{
+    public:
+                        TEventClient() {}
+    virtual             ~TEventClient() {}
+
+    // data read from fd, length <= 0 on hangup or error
+    virtual void        evRead(int /* fd */, UINT8* /* data */, int /* length */) {}
+};
+
+//------------------------------------------------------------------------------
+//
+// TEventBackend Class Declaration
+//
+// Common interface of the event backends. Reads are performed by the backend
+// and passed to the registered client. Writes are copied and submitted in a
+// batch with the next Poll, so log sinks don't issue system calls on their
+// own. QueueWrite and Drain may be called from other threads (e.g. a sink
+// queue consumer), Poll wakes up and submits them.
+//
+//------------------------------------------------------------------------------
+
+class TEventBackend
+{
+    public:
+                        TEventBackend();
+    virtual             ~TEventBackend();
+
+    virtual const char* GetName() const = 0;
+
+    // register fd for reading, client is called from Poll
+    virtual bool        AddReader(int fd, TEventClient* client) = 0;
+
+    // no read of the fd is in flight on return, the bytes of a read that
+    // completed before are passed to the client; not from a callback
+    virtual bool        RemoveReader(int fd) = 0;
+
+    // queue positioned write, data is copied
+    bool                QueueWrite(int fd, const void* data, UINT32 length, UINT64 offset);
+
+    // queued writes are submitted without blocking the event loop thread
+    virtual bool        HasAsyncWrites() const { return false; }
+
+    // submit queued writes, wait for events, dispatch reads
+    // returns number of handled events or -1 on error
+    virtual int         Poll(int timeoutMs) = 0;
+
+    // wait until all queued writes are completed
+    bool                Drain();
+
+    TEventStats         GetStats() const;
+
+    protected:
+
+    typedef struct
+    {
+        int                 Handle;
+        UINT64              Offset;
+        std::vector<UINT8>  Data;
+    }TWrite;
+
+    // submit writes and wait for their completion, event loop thread only
+    virtual bool        Flush() = 0;
+
+    // move queued writes to the backend
+    void                TakeWrites(std::vector<TWrite>& writes);
+
+    // write completed (or failed)
+    void                CompleteWrite(bool ok, size_t length);
+
+    // mark calling thread as event loop thread
+    void                EnterLoop() { LoopThread = std::this_thread::get_id(); }
+    bool                IsLoopThread() const;
+
+    TEventStats         Stats;
+
+    // eventfd, signalled when writes are queued from another thread
+    int                 WakeHandle;
+
+    private:
+
+    mutable std::mutex      WriteLock;
+    std::condition_variable WritesDone;
+    std::vector<TWrite>     Queued;
+
+    // queued or in-flight writes
+    UINT64                  Outstanding;
+
+    std::atomic<UINT64>             WakeCalls;
+    std::atomic<std::thread::id>    LoopThread;
+};
+
+//------------------------------------------------------------------------------
+//
+// TEpollBackend Class Declaration
+//
+// Level triggered epoll, one read per ready fd. Queued writes with
+// contiguous offsets on the same fd are merged into one pwrite and written
+// after the reads of each Poll. The pwrites block the loop thread, writers
+// that must not delay the reads keep their own.
+//
+//------------------------------------------------------------------------------
+
+class TEpollBackend : public TEventBackend
+{
+    public:
+                        TEpollBackend();
+                        ~TEpollBackend();
+
+    bool                Open();
+
+    const char*         GetName() const override { return "epoll"; }
+
+    bool                AddReader(int fd, TEventClient* client) override;
+    bool                RemoveReader(int fd) override;
+    int                 Poll(int timeoutMs) override;
+
+    protected:
+
+    bool                Flush() override;
+
+    private:
+
+    int                 Handle;
+
+    std::map<int, TEventClient*> Readers;
+    std::vector<TWrite> Writes;
+    UINT8               Buffer[EVENT_READ_BUFFER_SIZE];
+};
+
+//------------------------------------------------------------------------------
+//
+// TUringBackend Class Declaration
+//
+// One read is kept in flight per registered fd, completed reads are re-armed
+// and queued writes are submitted together in a single io_uring_enter which
+// also waits for the next completion. The ring is set up with raw system
+// calls, liburing is not required.
+//
+//------------------------------------------------------------------------------
+
+class TUringBackend : public TEventBackend
+{
+    public:
+                        TUringBackend();
+                        ~TUringBackend();
+
+    // false if io_uring is not supported by kernel or headers
+    bool                Open(UINT32 entries = EVENT_URING_ENTRIES);
+
+    const char*         GetName() const override { return "io_uring"; }
+
+    bool                HasAsyncWrites() const override { return true; }
+
+    bool                AddReader(int fd, TEventClient* client) override;
+    bool                RemoveReader(int fd) override;
+    int                 Poll(int timeoutMs) override;
+
+    protected:
+
+    bool                Flush() override;
+
+    private:
+
+    typedef struct
+    {
+        int                 Handle;
+        int                 Flags;
+        bool                Active;
+        TEventClient*       Client;
+        UINT8               Buffer[EVENT_READ_BUFFER_SIZE];
+    }TReader;
+
+    bool                PrepareRead(UINT32 index);
+    bool                PreparePoll(UINT32 index);
+    bool                PrepareWrites();
+    void*               GetSQE();
+    int                 Enter(UINT32 minComplete, int timeoutMs);
+    int                 Reap();
+
+    int                 Handle;
+
+    // mapped rings
+    void*               SQRing;
+    void*               CQRing;
+    void*               SQEs;
+    size_t              SQRingSize;
+    size_t              CQRingSize;
+    size_t              SQEsSize;
+
+    UINT32*             SQHead;
+    UINT32*             SQTail;
+    UINT32*             SQMask;
+    UINT32*             SQArray;
+    UINT32              SQEntries;
+    UINT32*             CQHead;
+    UINT32*             CQTail;
+    UINT32*             CQMask;
+    void*               CQEs;
+
+    // prepared, not yet submitted entries
+    UINT32              ToSubmit;
+
+    // reads and writes in flight
+    UINT32              InFlight;
+
+    std::vector<TReader*> Readers;
+
+    // write buffers, kept until completion
+    std::map<UINT64, TWrite> Writes;
+    UINT64              NextWriteID;
+};
+
+//------------------------------------------------------------------------------
+//
+// Factory
+//
+//------------------------------------------------------------------------------
+
+// create and open backend, returns 0 on failure
+TEventBackend*  CreateEventBackend(TEventBackendType type);
+
+#endif // EVENTBACKEND_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HCIReader.h
+//
+//	Abstract:	Event Client passing Serial Data to the HCI Decoder
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef HCIREADER_H
+#define HCIREADER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "EventBackend.h"
+
+//------------------------------------------------------------------------------
+//
+// THCIReader Class Declaration
+//
+// Requests of the HCI read their responses themselves (WaitForResponse), the
+// serial handle must be taken off the backend around them: a read of the
+// backend would take the response away, io_uring also makes the handle
+// blocking. Detach and Reattach keep the state for all users of the reader.
+//
+//------------------------------------------------------------------------------
+
+class THCIReader : public TEventClient
+{
+    public:
+                        THCIReader(TWiMODLRHCI& hci) : HCI(hci), Backend(0), Attached(false), Closed(false) {}
+
+    // register serial handle of the HCI at the backend
+    bool                Attach(TEventBackend& backend)
+                        {
+                            Backend  = &backend;
+                            Attached = backend.AddReader(HCI.GetHandle(), this);
+                            return Attached;
+                        }
+
+    // serial handle off the backend for a request of the HCI, bytes read
+    // before are dispatched; false if it was not attached (or hung up), the
+    // caller must not reattach then
+    bool                Detach()
+                        {
+                            if (!Backend || !Attached)
+                                return false;
+
+                            Attached = false;
+
+                            // a hung up handle was dropped by the backend
+                            if (Closed)
+                                return false;
+
+                            Backend->RemoveReader(HCI.GetHandle());
+                            return true;
+                        }
+
+    // back to the backend after Detach
+    bool                Reattach() { return Backend && (Attached || Attach(*Backend)); }
+
+    bool                IsAttached() const { return Attached; }
+
+    // true after hangup / read error, e.g. device unplugged
+    bool                IsClosed() const { return Closed; }
+
+    // device reopened
+    void                Reset() { Closed = false; }
+
+    void                evRead(int /* fd */, UINT8* data, int length) override
+                        {
+                            if (length > 0)
+                                HCI.ProcessRxData(data, length);
+                            else
+                                Closed = true;
+                        }
+
+    private:
+
+    TWiMODLRHCI&        HCI;
+    TEventBackend*      Backend;
+    bool                Attached;
+    bool                Closed;
+};
+
+#endif // HCIREADER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,358 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HealthMonitor.cpp
+//
+//	Abstract:	Periodic System Status of the Radio Module as Time Series
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "HealthMonitor.h"
+#include "RLTSample.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  THealthMonitor - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+THealthMonitor::THealthMonitor(TWiMODLRHCI& hci, TSampleFanout* fanout)
+    : HCI(hci)
+    , Fanout(fanout)
+    , Reader(0)
+    , Stats()
+    , Step(HEALTH_STEP_DEVICE_INFO)
+    , NextUs(0)
+    , InfoUs(0)
+    , Known(false)
+    , Last()
+    , LastUptimeMs(0)
+    , Missing(0)
+    , MissingUs(0)
+{
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: create health file, the first requests read device and firmware
+//          information
+//
+//------------------------------------------------------------------------------
+
+bool
+THealthMonitor::Open(const std::string& filename, const TBlockFileConfig& storage, const THealthConfig& config)
+{
+    Config = config;
+    Config.IntervalMs = std::max<UINT32>(1, Config.IntervalMs);
+
+    if (!Writer.Open(filename, storage))
+        return false;
+
+    Writer.Write(HEALTH_CSV_HEADER "\n");
+
+    Step   = HEALTH_STEP_DEVICE_INFO;
+    NextUs = 0;
+
+    return Writer.Flush();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+bool
+THealthMonitor::Close()
+{
+    return Writer.Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetWaitMs
+//
+//------------------------------------------------------------------------------
+
+int
+THealthMonitor::GetWaitMs(int maxMs) const
+{
+    if (!IsOpen())
+        return maxMs;
+
+    INT64 waitUs = NextUs - RLT_GetMonotonicUs();
+
+    if (waitUs <= 0)
+        return 0;
+
+    return (int)std::min<INT64>(maxMs, (waitUs + 999) / 1000);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: one request per call: device and firmware information right
+//          after the start, a reset and every InfoIntervalS, the system
+//          status every IntervalMs
+//
+//------------------------------------------------------------------------------
+
+void
+THealthMonitor::Poll()
+{
+    if (!IsOpen())
+        return;
+
+    Writer.Poll();
+
+    INT64 now = RLT_GetMonotonicUs();
+
+    if (now < NextUs)
+        return;
+
+    // the HCI reads the response itself
+    bool  detached  = Reader && Reader->Detach();
+    INT64 requestUs = RLT_GetMonotonicUs();
+
+    switch (Step)
+    {
+        case    HEALTH_STEP_DEVICE_INFO:
+                RequestDeviceInfo(requestUs);
+                Step = HEALTH_STEP_FIRMWARE_INFO;
+                break;
+
+        case    HEALTH_STEP_FIRMWARE_INFO:
+                RequestFirmwareInfo(requestUs);
+                Step   = HEALTH_STEP_SYSTEM_STATUS;
+                InfoUs = now + Config.InfoIntervalS * 1000000ll;
+                break;
+
+        default:
+                RequestSystemStatus(requestUs);
+                NextUs = now + Config.IntervalMs * 1000ll;
+
+                if (Config.InfoIntervalS && now >= InfoUs)
+                    Step = HEALTH_STEP_DEVICE_INFO;
+                break;
+    }
+
+    if (detached)
+        Reader->Reattach();
+}
+
+//------------------------------------------------------------------------------
+//
+//  RequestDeviceInfo
+//
+//------------------------------------------------------------------------------
+
+void
+THealthMonitor::RequestDeviceInfo(INT64 requestUs)
+{
+    TWiMODLR_DeviceInfo info = TWiMODLR_DeviceInfo();
+    UINT8               status = 0;
+
+    TWiMODLRResult result = HCI.GetDeviceInfo(info, status);
+
+    if (!Complete(result, status, requestUs, "device info"))
+        return;
+
+    std::ostringstream text;
+
+    text << std::hex << std::setfill('0')
+         << "device type=0x" << std::setw(2) << (int)info.ModuleType
+         << " address=0x" << std::setw(4) << info.DeviceAddress
+         << " group=0x" << std::setw(2) << (int)info.GroupAddress
+         << " id=0x" << std::setw(8) << info.DeviceID;
+
+    Event(RLT_MonotonicToTimeUs(HCI.GetRxTimeUs()), text.str(), false);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RequestFirmwareInfo
+//
+//------------------------------------------------------------------------------
+
+void
+THealthMonitor::RequestFirmwareInfo(INT64 requestUs)
+{
+    TWiMODLR_FirmwareInfo info = TWiMODLR_FirmwareInfo();
+    UINT8                 status = 0;
+
+    TWiMODLRResult result = HCI.GetFirmwareInfo(info, status);
+
+    if (!Complete(result, status, requestUs, "firmware info"))
+        return;
+
+    std::ostringstream text;
+
+    text << "firmware " << (int)info.MajorVersion << "." << std::setfill('0') << std::setw(2) << (int)info.MinorVersion
+         << " build=" << info.BuildCount << " image=" << info.Image;
+
+    Event(RLT_MonotonicToTimeUs(HCI.GetRxTimeUs()), text.str(), false);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RequestSystemStatus
+//
+//  @brief: one row per response; uptime or counters going backwards are a
+//          reset of the module, device and firmware are read again
+//
+//------------------------------------------------------------------------------
+
+void
+THealthMonitor::RequestSystemStatus(INT64 requestUs)
+{
+    TWiMODLR_SystemStatus systemStatus = TWiMODLR_SystemStatus();
+    UINT8                 status = 0;
+
+    TWiMODLRResult result = HCI.GetSystemStatus(systemStatus, status);
+
+    if (!Complete(result, status, requestUs, "system status"))
+        return;
+
+    INT64  timeUs   = RLT_MonotonicToTimeUs(HCI.GetRxTimeUs());
+    UINT64 uptimeMs = (UINT64)systemStatus.SysTickCounter * systemStatus.SysTickResolution;
+
+    if (Known && (uptimeMs < LastUptimeMs
+                  || systemStatus.RxPackets < Last.RxPackets || systemStatus.TxPackets < Last.TxPackets))
+    {
+        Stats.Resets++;
+        Step = HEALTH_STEP_DEVICE_INFO;
+
+        Event(timeUs, "reset uptime " + std::to_string(LastUptimeMs) + " ms -> " + std::to_string(uptimeMs) + " ms", true);
+    }
+
+    Known        = true;
+    Last         = systemStatus;
+    LastUptimeMs = uptimeMs;
+
+    std::string rtc;
+    HCI.U32TimeToString(rtc, systemStatus.RtcTime);
+
+    std::ostringstream row;
+
+    row << RLT_FormatTime(timeUs) << ","
+        << uptimeMs << ","
+        << rtc << ","
+        << systemStatus.NvmStatus << ","
+        << systemStatus.SupplyVoltage << ","
+        << systemStatus.ExtraStatus << ","
+        << systemStatus.RxPackets << ","
+        << systemStatus.RxAddressMatch << ","
+        << systemStatus.RxCRCError << ","
+        << systemStatus.TxPackets << ","
+        << systemStatus.TxError << ","
+        << systemStatus.TxMediaBusy << ","
+        << HCI.GetRxTimeUs() - requestUs << "\n";
+
+    Writer.Write(row.str());
+}
+
+//------------------------------------------------------------------------------
+//
+//  Complete
+//
+//  @brief: the first request without response and the first response
+//          after them are reported
+//
+//------------------------------------------------------------------------------
+
+bool
+THealthMonitor::Complete(TWiMODLRResult result, UINT8 status, INT64 requestUs, const char* request)
+{
+    INT64 now = RLT_GetMonotonicUs();
+
+    Stats.Requests++;
+    Stats.MaxRoundTripUs = std::max<UINT64>(Stats.MaxRoundTripUs, (UINT64)(now - requestUs));
+
+    if (result != WiMODLR_RESULT_OK)
+    {
+        Stats.Failed++;
+
+        if (!Missing++)
+        {
+            MissingUs = requestUs;
+            Event(RLT_MonotonicToTimeUs(requestUs), std::string("no response to ") + request, true);
+        }
+        return false;
+    }
+
+    if (Missing)
+    {
+        Event(RLT_MonotonicToTimeUs(HCI.GetRxTimeUs()), "response after " + std::to_string(Missing) + " failed requests, "
+              + std::to_string((HCI.GetRxTimeUs() - MissingUs) / 1000) + " ms", true);
+        Missing = 0;
+    }
+
+    if (status != DEVMGMT_STATUS_OK)
+    {
+        Stats.Failed++;
+        Event(RLT_MonotonicToTimeUs(HCI.GetRxTimeUs()), std::string(request) + " status " + std::to_string(status), false);
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Event
+//
+//------------------------------------------------------------------------------
+
+void
+THealthMonitor::Event(INT64 timeUs, const std::string& text, bool publish)
+{
+    std::string line = RLT_FormatTime(timeUs) + " " + text;
+
+    Writer.Write("# " + line + "\n");
+    Writer.Flush();
+
+    std::cout << "Health: " << line << std::endl;
+
+    if (publish && Fanout)
+        Fanout->PublishComment("health " + line);
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+THealthMonitor::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "requests=" << Stats.Requests
+         << " failed=" << Stats.Failed
+         << " resets=" << Stats.Resets
+         << " max_rtt=" << Stats.MaxRoundTripUs << " us";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
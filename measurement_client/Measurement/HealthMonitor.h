@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HealthMonitor.h
+//
+//	Abstract:	Periodic System Status of the Radio Module as Time Series
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef HEALTHMONITOR_H
+#define HEALTHMONITOR_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "BlockFileWriter.h"
+#include "SampleFanout.h"
+#include "HCIReader.h"
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// CSV header of the health file, one row per system status
+#define HEALTH_CSV_HEADER   "Time,Uptime [ms],RTC,NVM,Supply [mV],Extra,Rx Packets,Rx Address Match,"\
+                            "Rx CRC Error,Tx Packets,Tx Error,Tx Media Busy,Round Trip [us]"
+
+typedef struct
+{
+    // system status request interval [ms]
+    UINT32  IntervalMs      = 10000;
+
+    // device and firmware information are read again after this, and
+    // after every reset [s]
+    UINT32  InfoIntervalS   = 3600;
+}THealthConfig;
+
+typedef struct
+{
+    // requests sent, without response or with an error status
+    UINT64  Requests;
+    UINT64  Failed;
+
+    // uptime or radio counters of the module went backwards
+    UINT64  Resets;
+
+    // longest request [us], the time the main loop was held up
+    UINT64  MaxRoundTripUs;
+}THealthStats;
+
+//------------------------------------------------------------------------------
+//
+// THealthMonitor Class Declaration
+//
+// Requests the system status of the module every IntervalMs from the main
+// loop, one request per Poll so status indications are dispatched in
+// between, and appends it to a CSV file of its own: uptime, RTC, NVM
+// state, supply voltage, extra status, Rx / Tx counters and the round trip
+// of the request. Device and firmware information (at the start, every
+// hour and after a reset), module resets (uptime or counters going
+// backwards) and requests without response are written as "# <time> ..."
+// comments; resets and lost responses also go to the sinks as
+// "# health ..." comments next to the gaps of the radio link test.
+//
+// Poll runs blocking HCI requests, never call it from within the dispatch.
+//
+//------------------------------------------------------------------------------
+
+class THealthMonitor
+{
+    public:
+                    THealthMonitor(TWiMODLRHCI& hci, TSampleFanout* fanout = 0);
+
+    // create health file with header
+    bool            Open(const std::string& filename, const TBlockFileConfig& storage,
+                         const THealthConfig& config = THealthConfig());
+    bool            Close();
+    bool            IsOpen() const { return Writer.IsOpen(); }
+
+    // serial reads through an event backend: the reader is detached for
+    // each request
+    void            SetReader(THCIReader* reader) { Reader = reader; }
+
+    // next request when due
+    void            Poll();
+
+    // time until the next request, at most maxMs [ms]
+    int             GetWaitMs(int maxMs) const;
+
+    const THealthStats& GetStats() const { return Stats; }
+
+    // "requests=.. failed=.. resets=.. max_rtt=.. us"
+    std::string     FormatStats() const;
+
+    private:
+
+    typedef enum
+    {
+        HEALTH_STEP_DEVICE_INFO,
+        HEALTH_STEP_FIRMWARE_INFO,
+        HEALTH_STEP_SYSTEM_STATUS
+    }THealthStep;
+
+    void            RequestDeviceInfo(INT64 requestUs);
+    void            RequestFirmwareInfo(INT64 requestUs);
+    void            RequestSystemStatus(INT64 requestUs);
+
+    // response received or not, counted and reported
+    bool            Complete(TWiMODLRResult result, UINT8 status, INT64 requestUs, const char* request);
+
+    // comment in the health file, optionally in the sinks
+    void            Event(INT64 timeUs, const std::string& text, bool publish);
+
+    TWiMODLRHCI&        HCI;
+    TSampleFanout*      Fanout;
+    THCIReader*         Reader;
+    THealthConfig       Config;
+    THealthStats        Stats;
+    TBlockFileWriter    Writer;
+
+    THealthStep         Step;
+    INT64               NextUs;
+    INT64               InfoUs;
+
+    // last system status, valid after the first response
+    bool                Known;
+    TWiMODLR_SystemStatus   Last;
+    UINT64              LastUptimeMs;
+
+    // requests without response in a row, since
+    UINT32              Missing;
+    INT64               MissingUs;
+};
+
+#endif // HEALTHMONITOR_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,521 @@
+//------------------------------------------------------------------------------
+//
+//	File:		IngestServer.cpp
+//
+//	Abstract:	Multi-Reactor TCP Server accepting Publisher Streams
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "IngestServer.h"
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+//------------------------------------------------------------------------------
+//
+//  TIngestReactor - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TIngestReactor::TIngestReactor(TIngestStore& store)
+    : Store(store)
+{
+    Listener    = -1;
+    EpollHandle = -1;
+    WakeHandle  = -1;
+    Port        = 0;
+    Cpu         = -1;
+    Running     = false;
+    Stats       = TIngestServerStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TIngestReactor - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TIngestReactor::~TIngestReactor()
+{
+    Stop();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestReactor::Start(UINT16 port, int cpu)
+{
+    if (Running)
+        return false;
+
+    Listener = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (Listener < 0)
+        return false;
+
+    int one = 1;
+    ::setsockopt(Listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+
+    socklen_t size = sizeof(addr);
+
+    if (::setsockopt(Listener, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0
+        || ::bind(Listener, (struct sockaddr*)&addr, sizeof(addr)) != 0
+        || ::listen(Listener, SOMAXCONN) != 0
+        || ::getsockname(Listener, (struct sockaddr*)&addr, &size) != 0)
+    {
+        Stop();
+        return false;
+    }
+
+    Port        = ntohs(addr.sin_port);
+    Cpu         = cpu;
+    EpollHandle = ::epoll_create1(EPOLL_CLOEXEC);
+    WakeHandle  = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+
+    if (EpollHandle < 0 || WakeHandle < 0)
+    {
+        Stop();
+        return false;
+    }
+
+    event.data.fd = Listener;
+    bool result   = ::epoll_ctl(EpollHandle, EPOLL_CTL_ADD, Listener, &event) == 0;
+
+    event.data.fd = WakeHandle;
+    result        = result && ::epoll_ctl(EpollHandle, EPOLL_CTL_ADD, WakeHandle, &event) == 0;
+
+    if (!result)
+    {
+        Stop();
+        return false;
+    }
+
+    Buffer.resize(INGEST_READ_BUFFER_SIZE);
+
+    Running = true;
+    Thread  = std::thread(&TIngestReactor::Run, this);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestReactor::Stop()
+{
+    if (Running)
+    {
+        Running = false;
+
+        UINT64 value = 1;
+        if (::write(WakeHandle, &value, sizeof(value)) < 0)
+        {
+            // the loop still wakes up within a second
+        }
+    }
+
+    if (Thread.joinable())
+        Thread.join();
+
+    while (!Connections.empty())
+        Disconnect(Connections.begin()->first);
+
+    if (Listener >= 0)
+        ::close(Listener);
+    if (EpollHandle >= 0)
+        ::close(EpollHandle);
+    if (WakeHandle >= 0)
+        ::close(WakeHandle);
+
+    Listener    = -1;
+    EpollHandle = -1;
+    WakeHandle  = -1;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetStats
+//
+//------------------------------------------------------------------------------
+
+TIngestServerStats
+TIngestReactor::GetStats()
+{
+    std::lock_guard<std::mutex> lock(StatsLock);
+
+    return Stats;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: event loop, ACKs are sent after the round's frames are synced
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestReactor::Run()
+{
+    if (Cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(Cpu, &cpus);
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+    }
+
+    struct epoll_event events[INGEST_MAX_EVENTS];
+    std::vector<int>   acks;
+
+    while (Running)
+    {
+        int count = ::epoll_wait(EpollHandle, events, INGEST_MAX_EVENTS, 1000);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0)
+            break;
+
+        std::lock_guard<std::mutex> lock(StatsLock);
+
+        acks.clear();
+
+        for (int i = 0; i < count; i++)
+        {
+            int handle = events[i].data.fd;
+
+            if (handle == WakeHandle)
+            {
+                UINT64 value;
+                if (::read(WakeHandle, &value, sizeof(value)) < 0)
+                {
+                    // nothing pending
+                }
+                continue;
+            }
+
+            if (handle == Listener)
+            {
+                Accept();
+                continue;
+            }
+
+            auto it = Connections.find(handle);
+            if (it == Connections.end())
+                continue;
+
+            TConnection& connection = it->second;
+            bool         pending    = connection.AckPending;
+            bool         result     = true;
+
+            if (events[i].events & EPOLLOUT)
+                result = Send(handle, connection);
+
+            if (result && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                result = Receive(handle, connection);
+
+            if (!result)
+                Disconnect(handle);
+            else if (connection.AckPending && !pending)
+                acks.push_back(handle);
+        }
+
+        // group commit: one sync per node and round
+        for (int handle : acks)
+        {
+            auto it = Connections.find(handle);
+            if (it == Connections.end())
+                continue;
+
+            TConnection& connection = it->second;
+
+            connection.AckPending = false;
+            Publish_AppendSequence(connection.Output, PUBLISH_MSG_ACK, connection.Node->Sync(Stats.Store));
+
+            if (!Send(handle, connection))
+                Disconnect(handle);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Accept
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestReactor::Accept()
+{
+    while (true)
+    {
+        int handle = ::accept4(Listener, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (handle < 0)
+            return;
+
+        int one = 1;
+        ::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        struct epoll_event event = {};
+        event.events  = EPOLLIN;
+        event.data.fd = handle;
+
+        if (::epoll_ctl(EpollHandle, EPOLL_CTL_ADD, handle, &event) != 0)
+        {
+            ::close(handle);
+            continue;
+        }
+
+        TConnection& connection = Connections[handle];
+        connection.AckPending   = false;
+        connection.WaitWritable = false;
+
+        Stats.Accepted++;
+        Stats.Connections++;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Receive
+//
+//  @brief: one read per event, level triggered epoll returns for the rest
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestReactor::Receive(int handle, TConnection& connection)
+{
+    ssize_t length = ::recv(handle, Buffer.data(), Buffer.size(), MSG_DONTWAIT);
+
+    if (length < 0 && (errno == EAGAIN || errno == EINTR))
+        return true;
+    if (length <= 0)
+        return false;
+
+    connection.Parser.Append(Buffer.data(), length);
+
+    UINT8        type;
+    const UINT8* body;
+    size_t       bodyLength;
+
+    while (connection.Parser.Next(type, body, bodyLength))
+    {
+        if (!Handle(handle, connection, type, body, bodyLength))
+        {
+            Stats.Rejected++;
+            return false;
+        }
+    }
+
+    if (connection.Parser.HasError())
+    {
+        Stats.Rejected++;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Handle
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestReactor::Handle(int handle, TConnection& connection, UINT8 type, const UINT8* body, size_t length)
+{
+    if (type == PUBLISH_MSG_HELLO)
+    {
+        if (connection.Node)
+            return false;
+
+        connection.Node = Store.GetNode(std::string((const char*)body, length));
+        if (!connection.Node)
+            return false;
+
+        Publish_AppendSequence(connection.Output, PUBLISH_MSG_RESUME, connection.Node->Sync(Stats.Store));
+        return Send(handle, connection);
+    }
+
+    if (type == PUBLISH_MSG_DATA && connection.Node && length > 8)
+    {
+        if (!connection.Node->Store(Publish_Get64(body), body + 8, length - 8, Stats.Store))
+            return false;
+
+        connection.AckPending = true;
+        return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Send
+//
+//  @brief: the rest is sent when the socket becomes writable again
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestReactor::Send(int handle, TConnection& connection)
+{
+    size_t sent = 0;
+
+    while (sent < connection.Output.size())
+    {
+        ssize_t length = ::send(handle, connection.Output.data() + sent, connection.Output.size() - sent,
+                                MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (length < 0 && errno == EINTR)
+            continue;
+        if (length < 0 && errno == EAGAIN)
+            break;
+        if (length <= 0)
+            return false;
+
+        sent += length;
+    }
+
+    bool waiting = sent < connection.Output.size();
+
+    connection.Output.erase(connection.Output.begin(), connection.Output.begin() + sent);
+
+    // write events only while replies are pending
+    if (waiting == connection.WaitWritable)
+        return true;
+
+    struct epoll_event event = {};
+    event.events  = waiting ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.fd = handle;
+
+    connection.WaitWritable = waiting;
+    return ::epoll_ctl(EpollHandle, EPOLL_CTL_MOD, handle, &event) == 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Disconnect
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestReactor::Disconnect(int handle)
+{
+    ::epoll_ctl(EpollHandle, EPOLL_CTL_DEL, handle, 0);
+    ::close(handle);
+
+    Connections.erase(handle);
+    Stats.Connections--;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestServer::Start(TIngestStore& store, UINT16 port, UINT32 reactors)
+{
+    Stop();
+
+    int cpus = (int)std::thread::hardware_concurrency();
+    if (cpus < 1)
+        cpus = 1;
+
+    if (!reactors)
+        reactors = cpus;
+
+    Port = port;
+
+    for (UINT32 i = 0; i < reactors; i++)
+    {
+        std::unique_ptr<TIngestReactor> reactor(new TIngestReactor(store));
+
+        // the first reactor resolves port 0, the others share its port
+        if (!reactor->Start(Port, (int)(i % cpus)))
+        {
+            Stop();
+            return false;
+        }
+
+        Port = reactor->GetPort();
+        Reactors.push_back(std::move(reactor));
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestServer::Stop()
+{
+    Reactors.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetStats
+//
+//------------------------------------------------------------------------------
+
+TIngestServerStats
+TIngestServer::GetStats()
+{
+    TIngestServerStats result = TIngestServerStats();
+
+    for (auto& reactor : Reactors)
+    {
+        TIngestServerStats stats = reactor->GetStats();
+
+        result.Accepted    += stats.Accepted;
+        result.Connections += stats.Connections;
+        result.Rejected    += stats.Rejected;
+
+        Ingest_AddStats(result.Store, stats.Store);
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+//
+//	File:		IngestServer.h
+//
+//	Abstract:	Multi-Reactor TCP Server accepting Publisher Streams
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef INGESTSERVER_H
+#define INGESTSERVER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "IngestStore.h"
+#include "PublishProtocol.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// events handled per epoll_wait
+#define INGEST_MAX_EVENTS           64
+
+// receive buffer per reactor
+#define INGEST_READ_BUFFER_SIZE     (64 * 1024)
+
+typedef struct
+{
+    // connections accepted / currently open
+    UINT64          Accepted;
+    UINT64          Connections;
+    // connections closed on protocol or storage errors
+    UINT64          Rejected;
+    TIngestStats    Store;
+}TIngestServerStats;
+
+//------------------------------------------------------------------------------
+//
+// TIngestReactor Class Declaration
+//
+// One thread with its own epoll instance and its own SO_REUSEPORT listener,
+// the kernel spreads new connections over the reactors. All frames received
+// in one epoll round are stored first, then every touched node is synced
+// once and the ACKs are sent (group commit). Frames are checked against
+// the CRCs of their RLT blocks before they reach the store, which drops the
+// samples a node already delivered by their sequence numbers.
+//
+//------------------------------------------------------------------------------
+
+class TIngestReactor
+{
+    public:
+                    TIngestReactor(TIngestStore& store);
+                    ~TIngestReactor();
+
+    // bind listener, start thread pinned to cpu (-1 = not pinned)
+    bool            Start(UINT16 port, int cpu);
+    void            Stop();
+
+    UINT16          GetPort() const { return Port; }
+
+    TIngestServerStats  GetStats();
+
+    private:
+
+    typedef struct
+    {
+        TPublishParser                  Parser;
+        std::shared_ptr<TIngestNode>    Node;
+        // unsent replies, socket buffer was full
+        std::vector<UINT8>              Output;
+        bool                            AckPending;
+        bool                            WaitWritable;
+    }TConnection;
+
+    void            Run();
+    void            Accept();
+    bool            Receive(int handle, TConnection& connection);
+    bool            Handle(int handle, TConnection& connection, UINT8 type, const UINT8* body, size_t length);
+    bool            Send(int handle, TConnection& connection);
+    void            Disconnect(int handle);
+
+    TIngestStore&   Store;
+
+    int             Listener;
+    int             EpollHandle;
+    int             WakeHandle;
+    UINT16          Port;
+    int             Cpu;
+
+    std::thread         Thread;
+    std::atomic<bool>   Running;
+
+    std::map<int, TConnection>  Connections;
+    std::vector<UINT8>          Buffer;
+
+    std::mutex          StatsLock;
+    TIngestServerStats  Stats;
+};
+
+//------------------------------------------------------------------------------
+//
+// TIngestServer Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TIngestServer
+{
+    public:
+                    TIngestServer() : Port(0) {}
+                    ~TIngestServer() { Stop(); }
+
+    // start reactors (0 = one per core) on port, port 0 picks a free one
+    bool            Start(TIngestStore& store, UINT16 port, UINT32 reactors = 0);
+    void            Stop();
+
+    UINT16          GetPort() const { return Port; }
+    size_t          GetNumReactors() const { return Reactors.size(); }
+
+    // sum of all reactors
+    TIngestServerStats  GetStats();
+
+    private:
+
+    UINT16          Port;
+
+    std::vector<std::unique_ptr<TIngestReactor>> Reactors;
+};
+
+#endif // INGESTSERVER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
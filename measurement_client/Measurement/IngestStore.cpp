@@ -0,0 +1,594 @@
+//------------------------------------------------------------------------------
+//
+//	File:		IngestStore.cpp
+//
+//	Abstract:	Deduplicating per Node / per Day Sample Storage of the Collector
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "IngestStore.h"
+#include "RLTCodec.h"
+#include "PublishProtocol.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define INGEST_DAY_US               (86400LL * 1000000LL)
+
+//------------------------------------------------------------------------------
+//
+//  Helper Functions
+//
+//------------------------------------------------------------------------------
+
+static bool
+ReadAt(int handle, UINT8* data, size_t length, UINT64 offset)
+{
+    while (length)
+    {
+        ssize_t result = ::pread(handle, data, length, offset);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            return false;
+
+        data   += result;
+        length -= result;
+        offset += result;
+    }
+    return true;
+}
+
+static bool
+WriteAt(int handle, const UINT8* data, size_t length, UINT64 offset)
+{
+    while (length)
+    {
+        ssize_t result = ::pwrite(handle, data, length, offset);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            return false;
+
+        data   += result;
+        length -= result;
+        offset += result;
+    }
+    return true;
+}
+
+// days since 1970-01-01 UTC
+static INT64
+DayOf(INT64 timeUs)
+{
+    return timeUs >= 0 ? timeUs / INGEST_DAY_US : -((-timeUs + INGEST_DAY_US - 1) / INGEST_DAY_US);
+}
+
+// "YYYY-MM-DD"
+static std::string
+DayName(INT64 day)
+{
+    time_t    time = (time_t)(day * 86400);
+    struct tm utc;
+    char      name[16];
+
+    ::gmtime_r(&time, &utc);
+    std::strftime(name, sizeof(name), "%Y-%m-%d", &utc);
+
+    return name;
+}
+
+// inverse of DayName, false if name is no day
+static bool
+DayFromName(const std::string& name, INT64& day)
+{
+    struct tm utc = {};
+
+    if (std::sscanf(name.c_str(), "%4d-%2d-%2d", &utc.tm_year, &utc.tm_mon, &utc.tm_mday) != 3)
+        return false;
+
+    utc.tm_year -= 1900;
+    utc.tm_mon  -= 1;
+
+    day = (INT64)::timegm(&utc) / 86400;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Ingest_IsValidNodeName
+//
+//------------------------------------------------------------------------------
+
+bool
+Ingest_IsValidNodeName(const std::string& name)
+{
+    if (name.empty() || name.size() > PUBLISH_MAX_NODE_NAME || name[0] == '.')
+        return false;
+
+    for (char c : name)
+        if (!std::isalnum((unsigned char)c) && c != '.' && c != '_' && c != '-')
+            return false;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Ingest_AddStats
+//
+//------------------------------------------------------------------------------
+
+void
+Ingest_AddStats(TIngestStats& dst, const TIngestStats& src)
+{
+    dst.Frames      += src.Frames;
+    dst.Samples     += src.Samples;
+    dst.Bytes       += src.Bytes;
+    dst.Duplicates  += src.Duplicates;
+    dst.Gaps        += src.Gaps;
+    dst.Invalid     += src.Invalid;
+    dst.WriteErrors += src.WriteErrors;
+    dst.Syncs       += src.Syncs;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TIngestNode - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TIngestNode::TIngestNode(const std::string& name)
+{
+    Name            = name;
+    SyncFiles       = true;
+    Day             = -1;
+    SegmentHandle   = -1;
+    IndexHandle     = -1;
+    SegmentSize     = 0;
+    IndexSize       = 0;
+    Dirty           = false;
+    Next            = 0;
+    Durable         = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TIngestNode - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TIngestNode::~TIngestNode()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: the next sequence is taken from the last block of the newest day
+//          which holds one
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestNode::Open(const std::string& directory, bool sync)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+
+    Directory = directory;
+    SyncFiles = sync;
+    Next      = 0;
+
+    DIR* dir = ::opendir(Directory.c_str());
+    if (!dir)
+        return false;
+
+    std::vector<INT64> days;
+
+    while (struct dirent* entry = ::readdir(dir))
+    {
+        std::string name   = entry->d_name;
+        size_t      suffix = name.size() - std::strlen(INGEST_INDEX_SUFFIX);
+        INT64       day;
+
+        if (name.size() > std::strlen(INGEST_INDEX_SUFFIX)
+            && name.compare(suffix, std::string::npos, INGEST_INDEX_SUFFIX) == 0
+            && DayFromName(name, day))
+            days.push_back(day);
+    }
+    ::closedir(dir);
+
+    std::sort(days.rbegin(), days.rend());
+
+    for (INT64 day : days)
+    {
+        if (!OpenDay(day))
+            return false;
+
+        if (IndexSize)
+        {
+            UINT8 entry[INGEST_INDEX_ENTRY_SIZE];
+
+            if (!ReadAt(IndexHandle, entry, sizeof(entry), IndexSize - sizeof(entry)))
+                return false;
+
+            Next = Publish_Get64(entry) + NTOH32(entry + 20);
+            break;
+        }
+    }
+
+    Durable = Next;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestNode::Close()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    CloseDay();
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetNext
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TIngestNode::GetNext()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    return Next;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Store
+//
+//  @brief: the block is written as received unless duplicates are cut off
+//          or it spans midnight, then the remaining samples are re-encoded
+//          per day
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestNode::Store(UINT64 sequence, const UINT8* block, size_t length, TIngestStats& stats)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    Samples.clear();
+
+    if (TRLTBlockDecoder::DecodeBlock(block, length, Samples) != length || Samples.empty())
+    {
+        stats.Invalid++;
+        return false;
+    }
+
+    stats.Frames++;
+    stats.Bytes += length;
+
+    size_t count = Samples.size();
+
+    if (sequence + count <= Next)
+    {
+        stats.Duplicates += count;
+        return true;
+    }
+
+    size_t begin = 0;
+
+    if (sequence < Next)
+    {
+        begin             = Next - sequence;
+        stats.Duplicates += begin;
+    }
+    else
+        stats.Gaps += sequence - Next;
+
+    while (begin < count)
+    {
+        INT64  day = DayOf(Samples[begin].TimeUs);
+        size_t end = begin + 1;
+
+        while (end < count && DayOf(Samples[end].TimeUs) == day)
+            end++;
+
+        if (day != Day && !OpenDay(day))
+        {
+            stats.WriteErrors++;
+            return false;
+        }
+
+        bool result;
+
+        if (begin == 0 && end == count)
+            result = Append(sequence, (UINT32)count, block, length);
+        else
+        {
+            Encoded.clear();
+            result = TRLTBlockEncoder::EncodeBlock(&Samples[begin], (int)(end - begin), Encoded)
+                     && Append(sequence + begin, (UINT32)(end - begin), Encoded.data(), Encoded.size());
+        }
+
+        if (!result)
+        {
+            stats.WriteErrors++;
+            return false;
+        }
+
+        stats.Samples += end - begin;
+        Next           = sequence + end;
+        begin          = end;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Sync
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TIngestNode::Sync(TIngestStats& stats)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (Dirty)
+    {
+        if (!SyncDay())
+        {
+            stats.WriteErrors++;
+            return Durable;
+        }
+        stats.Syncs++;
+    }
+
+    Durable = Next;
+    return Durable;
+}
+
+//------------------------------------------------------------------------------
+//
+//  OpenDay
+//
+//  @brief: open segment and index of a day, cut off torn entries and
+//          unindexed bytes left by a crash
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestNode::OpenDay(INT64 day)
+{
+    CloseDay();
+
+    std::string path = Directory + "/" + DayName(day);
+
+    SegmentHandle = ::open((path + INGEST_SEGMENT_SUFFIX).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    IndexHandle   = ::open((path + INGEST_INDEX_SUFFIX).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    struct stat segmentInfo;
+    struct stat indexInfo;
+
+    if (SegmentHandle < 0 || IndexHandle < 0
+        || ::fstat(SegmentHandle, &segmentInfo) != 0 || ::fstat(IndexHandle, &indexInfo) != 0)
+    {
+        CloseDay();
+        return false;
+    }
+
+    SegmentSize = segmentInfo.st_size;
+    IndexSize   = indexInfo.st_size - indexInfo.st_size % INGEST_INDEX_ENTRY_SIZE;
+
+    // the last indexed block must be complete and intact
+    UINT64             end = 0;
+    std::vector<UINT8> data;
+
+    while (IndexSize)
+    {
+        UINT8 entry[INGEST_INDEX_ENTRY_SIZE];
+
+        if (!ReadAt(IndexHandle, entry, sizeof(entry), IndexSize - sizeof(entry)))
+            break;
+
+        UINT64 offset = Publish_Get64(entry + 8);
+        UINT32 length = NTOH32(entry + 16);
+
+        data.resize(length);
+        Samples.clear();
+
+        if (offset + length <= SegmentSize
+            && ReadAt(SegmentHandle, data.data(), length, offset)
+            && TRLTBlockDecoder::DecodeBlock(data.data(), length, Samples) == length)
+        {
+            end = offset + length;
+            break;
+        }
+
+        IndexSize -= INGEST_INDEX_ENTRY_SIZE;
+    }
+
+    if ((SegmentSize != end && ::ftruncate(SegmentHandle, end) != 0)
+        || ((UINT64)indexInfo.st_size != IndexSize && ::ftruncate(IndexHandle, IndexSize) != 0))
+    {
+        CloseDay();
+        return false;
+    }
+
+    SegmentSize = end;
+    Day         = day;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  CloseDay
+//
+//------------------------------------------------------------------------------
+
+void
+TIngestNode::CloseDay()
+{
+    if (Dirty)
+        SyncDay();
+
+    if (SegmentHandle >= 0)
+        ::close(SegmentHandle);
+    if (IndexHandle >= 0)
+        ::close(IndexHandle);
+
+    SegmentHandle = -1;
+    IndexHandle   = -1;
+    Day           = -1;
+    Dirty         = false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SyncDay
+//
+//  @brief: segment first, an index entry must not become durable before
+//          its block
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestNode::SyncDay()
+{
+    if (SyncFiles && (::fdatasync(SegmentHandle) != 0 || ::fdatasync(IndexHandle) != 0))
+        return false;
+
+    Dirty = false;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Append
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestNode::Append(UINT64 sequence, UINT32 count, const UINT8* block, size_t length)
+{
+    UINT8 entry[INGEST_INDEX_ENTRY_SIZE];
+
+    Publish_Put64(entry, sequence);
+    Publish_Put64(entry + 8, SegmentSize);
+    HTON32(entry + 16, (UINT32)length);
+    HTON32(entry + 20, count);
+
+    if (!WriteAt(SegmentHandle, block, length, SegmentSize)
+        || !WriteAt(IndexHandle, entry, sizeof(entry), IndexSize))
+        return false;
+
+    SegmentSize += length;
+    IndexSize   += sizeof(entry);
+    Dirty        = true;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TIngestStore::Open(const std::string& directory, bool sync)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+
+    Directory = directory;
+    SyncFiles = sync;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetNode
+//
+//------------------------------------------------------------------------------
+
+std::shared_ptr<TIngestNode>
+TIngestStore::GetNode(const std::string& name)
+{
+    if (!Ingest_IsValidNodeName(name))
+        return 0;
+
+    std::lock_guard<std::mutex> lock(Lock);
+
+    auto it = Nodes.find(name);
+    if (it != Nodes.end())
+        return it->second;
+
+    std::shared_ptr<TIngestNode> node(new TIngestNode(name));
+
+    if (!node->Open(Directory + "/" + name, SyncFiles))
+        return 0;
+
+    Nodes[name] = node;
+    return node;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetNumNodes
+//
+//------------------------------------------------------------------------------
+
+size_t
+TIngestStore::GetNumNodes()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    return Nodes.size();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+//
+//	File:		IngestStore.h
+//
+//	Abstract:	Deduplicating per Node / per Day Sample Storage of the Collector
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef INGESTSTORE_H
+#define INGESTSTORE_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "RLTSample.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// index entry: sequence of the first sample, offset and length of the block
+// in the segment, sample count (little endian)
+#define INGEST_INDEX_ENTRY_SIZE     24
+
+#define INGEST_SEGMENT_SUFFIX       ".rltb"
+#define INGEST_INDEX_SUFFIX         ".idx"
+
+typedef struct
+{
+    UINT64  Frames;
+    UINT64  Samples;
+    UINT64  Bytes;
+    // samples received before, dropped
+    UINT64  Duplicates;
+    // samples never received (dropped by a full publisher spool)
+    UINT64  Gaps;
+    // frames which could not be decoded
+    UINT64  Invalid;
+    UINT64  WriteErrors;
+    UINT64  Syncs;
+}TIngestStats;
+
+// node names are used as directory names: 1..64 of [A-Za-z0-9._-], no
+// leading dot
+bool            Ingest_IsValidNodeName(const std::string& name);
+
+// add counters of src to dst
+void            Ingest_AddStats(TIngestStats& dst, const TIngestStats& src);
+
+//------------------------------------------------------------------------------
+//
+// TIngestNode Class Declaration
+//
+// Samples of one node go to "<node>/<YYYY-MM-DD>.rltb" (UTC day of the
+// sample time), a segment of plain RLT blocks readable like the files of
+// the binary sink. The sidecar "<YYYY-MM-DD>.idx" maps sample sequence
+// numbers to blocks and is the only place the sequence is kept: on open,
+// torn entries at the end of the newest index are removed, the segment is
+// cut behind the last indexed block and the next expected sequence is taken
+// from there. Store and Sync may be called from several reactors.
+//
+//------------------------------------------------------------------------------
+
+class TIngestNode
+{
+    public:
+                    TIngestNode(const std::string& name);
+                    ~TIngestNode();
+
+    // open / recover the node directory
+    bool            Open(const std::string& directory, bool sync);
+    void            Close();
+
+    const std::string&  GetName() const { return Name; }
+
+    // next expected sequence, includes samples not synced yet
+    UINT64          GetNext();
+
+    // store frame starting at sequence: already stored samples are dropped,
+    // the rest is appended to the segment(s) of its day; false if the block
+    // is invalid or could not be written, the connection should be closed
+    bool            Store(UINT64 sequence, const UINT8* block, size_t length, TIngestStats& stats);
+
+    // make stored samples durable, returns the next sequence which may be
+    // acknowledged
+    UINT64          Sync(TIngestStats& stats);
+
+    private:
+
+    bool            OpenDay(INT64 day);
+    void            CloseDay();
+    bool            SyncDay();
+    bool            Append(UINT64 sequence, UINT32 count, const UINT8* block, size_t length);
+
+    std::mutex      Lock;
+
+    std::string     Name;
+    std::string     Directory;
+    bool            SyncFiles;
+
+    // open day (days since 1970-01-01 UTC), -1 if none
+    INT64           Day;
+    int             SegmentHandle;
+    int             IndexHandle;
+    UINT64          SegmentSize;
+    UINT64          IndexSize;
+    bool            Dirty;
+
+    UINT64          Next;
+    UINT64          Durable;
+
+    std::vector<TRLTSample> Samples;
+    std::vector<UINT8>      Encoded;
+};
+
+//------------------------------------------------------------------------------
+//
+// TIngestStore Class Declaration
+//
+// Root directory with one sub directory per node. Nodes are opened on first
+// use and stay open.
+//
+//------------------------------------------------------------------------------
+
+class TIngestStore
+{
+    public:
+                    TIngestStore() : SyncFiles(true) {}
+
+    // create root directory, sync = fdatasync before acknowledging
+    bool            Open(const std::string& directory, bool sync = true);
+
+    // node by name, 0 if the name is invalid or the node can't be opened
+    std::shared_ptr<TIngestNode> GetNode(const std::string& name);
+
+    size_t          GetNumNodes();
+
+    private:
+
+    std::mutex      Lock;
+    std::string     Directory;
+    bool            SyncFiles;
+
+    std::map<std::string, std::shared_ptr<TIngestNode>> Nodes;
+};
+
+#endif // INGESTSTORE_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
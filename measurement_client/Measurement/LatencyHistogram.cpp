@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+//
+//	File:		LatencyHistogram.cpp
+//
+//	Abstract:	Log-Linear Latency Histogram with Percentiles
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  TLatencyHistogram - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TLatencyHistogram::TLatencyHistogram()
+{
+    Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reset
+//
+//  @brief: clear all buckets
+//
+//------------------------------------------------------------------------------
+
+void
+TLatencyHistogram::Reset()
+{
+    std::memset(Buckets, 0, sizeof(Buckets));
+
+    NumValues   = 0;
+    Sum         = 0;
+    MinValue    = ~0ULL;
+    MaxValue    = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  BucketIndex
+//
+//  @brief: values < 8 are exact, above 3 bits of mantissa are kept
+//
+//------------------------------------------------------------------------------
+
+int
+TLatencyHistogram::BucketIndex(UINT64 value)
+{
+    if (value < LATENCY_SUB_BUCKETS)
+        return (int)value;
+
+    int exponent = 63 - __builtin_clzll(value);
+    int sub      = (int)((value >> (exponent - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1));
+    int index    = (exponent - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS + sub;
+
+    return std::min(index, LATENCY_NUM_BUCKETS - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+//  BucketUpperBound
+//
+//  @brief: largest value mapped into the given bucket
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TLatencyHistogram::BucketUpperBound(int index)
+{
+    if (index < LATENCY_SUB_BUCKETS)
+        return (UINT64)index;
+
+    int     exponent = index / LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKET_BITS - 1;
+    int     sub      = index % LATENCY_SUB_BUCKETS;
+    int     shift    = exponent - LATENCY_SUB_BUCKET_BITS;
+    UINT64  lower    = (UINT64)(LATENCY_SUB_BUCKETS + sub) << shift;
+
+    return lower + (1ULL << shift) - 1;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Add
+//
+//  @brief: record one value
+//
+//------------------------------------------------------------------------------
+
+void
+TLatencyHistogram::Add(UINT64 value)
+{
+    Buckets[BucketIndex(value)]++;
+
+    NumValues++;
+    Sum        += value;
+    MinValue    = std::min(MinValue, value);
+    MaxValue    = std::max(MaxValue, value);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Merge
+//
+//  @brief: add all values of another histogram
+//
+//------------------------------------------------------------------------------
+
+void
+TLatencyHistogram::Merge(const TLatencyHistogram& other)
+{
+    for (int i = 0; i < LATENCY_NUM_BUCKETS; i++)
+        Buckets[i] += other.Buckets[i];
+
+    NumValues  += other.NumValues;
+    Sum        += other.Sum;
+    MinValue    = std::min(MinValue, other.MinValue);
+    MaxValue    = std::max(MaxValue, other.MaxValue);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Percentile
+//
+//  @brief: bucket upper bound at given rank, clipped to observed maximum
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TLatencyHistogram::Percentile(double percent) const
+{
+    if (NumValues == 0)
+        return 0;
+
+    percent = std::clamp(percent, 0.0, 100.0);
+
+    UINT64 rank = (UINT64)std::ceil(percent / 100.0 * (double)NumValues);
+    if (rank == 0)
+        rank = 1;
+
+    UINT64 count = 0;
+    for (int i = 0; i < LATENCY_NUM_BUCKETS; i++)
+    {
+        count += Buckets[i];
+        if (count >= rank)
+            return std::min(BucketUpperBound(i), MaxValue);
+    }
+    return MaxValue;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Summary
+//
+//  @brief: one line summary for logs
+//
+//------------------------------------------------------------------------------
+
+std::string
+TLatencyHistogram::Summary(const char* unit) const
+{
+    std::ostringstream oss;
+
+    oss << "n=" << NumValues
+        << " min=" << Min() << unit
+        << " p50=" << Percentile(50.0) << unit
+        << " p90=" << Percentile(90.0) << unit
+        << " p99=" << Percentile(99.0) << unit
+        << " p99.9=" << Percentile(99.9) << unit
+        << " max=" << Max() << unit;
+
+    return oss.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//
+//	File:		LatencyHistogram.h
+//
+//	Abstract:	Log-Linear Latency Histogram with Percentiles
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// each power of two range is split into 2^3 linear sub buckets (~12% width)
+#define LATENCY_SUB_BUCKET_BITS     3
+#define LATENCY_SUB_BUCKETS         (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_EXPONENT        40
+#define LATENCY_NUM_BUCKETS         ((LATENCY_MAX_EXPONENT + 1) * LATENCY_SUB_BUCKETS)
+
+//------------------------------------------------------------------------------
+//
+// TLatencyHistogram Class Declaration
+//
+// Values are unit-less, callers use microseconds by convention. The class is
+// not thread safe.
+//
+//------------------------------------------------------------------------------
+
+class TLatencyHistogram
+{
+    public:
+                    TLatencyHistogram();
+
+    void            Add(UINT64 value);
+    void            Merge(const TLatencyHistogram& other);
+    void            Reset();
+
+    UINT64          Count() const { return NumValues; }
+    UINT64          Min() const { return NumValues ? MinValue : 0; }
+    UINT64          Max() const { return MaxValue; }
+    double          Mean() const { return NumValues ? (double)Sum / NumValues : 0.0; }
+
+    // upper bound of the bucket containing the given percentile (0..100)
+    UINT64          Percentile(double percent) const;
+
+    // "n=.. min=.. p50=.. p90=.. p99=.. p99.9=.. max=.." with unit suffix
+    std::string     Summary(const char* unit = "us") const;
+
+    private:
+
+    static int      BucketIndex(UINT64 value);
+    static UINT64   BucketUpperBound(int index);
+
+    UINT64          Buckets[LATENCY_NUM_BUCKETS];
+    UINT64          NumValues;
+    UINT64          Sum;
+    UINT64          MinValue;
+    UINT64          MaxValue;
+};
+
+#endif // LATENCYHISTOGRAM_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
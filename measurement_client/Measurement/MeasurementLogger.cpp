@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+//
+//	File:		MeasurementLogger.cpp
+//
+//	Abstract:	Radio Link Test CSV Logger
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "MeasurementLogger.h"
+#include <iostream>
+
+//------------------------------------------------------------------------------
+//
+//  TMeasurementLogger - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TMeasurementLogger::TMeasurementLogger()
+{
+    LastStats = std::chrono::steady_clock::now();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: create CSV file, header and comment are written to the file
+//          right away so the file is valid from the beginning
+//
+//------------------------------------------------------------------------------
+
+bool
+TMeasurementLogger::Open(const std::string& filename, const std::string& comment, const TBlockFileConfig& config,
+                         const std::string& header)
+{
+    if (!Writer.Open(filename, config))
+        return false;
+
+    Writer.Write(header + "\n");
+    WriteComment(comment);
+
+    return Writer.Flush();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+bool
+TMeasurementLogger::Close()
+{
+    return Writer.Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteComment
+//
+//------------------------------------------------------------------------------
+
+void
+TMeasurementLogger::WriteComment(const std::string& comment)
+{
+    Writer.Write("# " + comment + "\n");
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrintStats
+//
+//------------------------------------------------------------------------------
+
+void
+TMeasurementLogger::PrintStats()
+{
+    const TBlockFileStats& stats = Writer.GetStats();
+
+    std::cout << "Storage: blocks=" << stats.BlocksWritten
+              << " partial flushes=" << stats.PartialFlushes
+              << " errors=" << stats.WriteErrors
+              << " write latency " << Writer.GetLatency().Summary() << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteSample
+//
+//  @brief: append one CSV row
+//
+//------------------------------------------------------------------------------
+
+bool
+TMeasurementLogger::WriteSample(const TRLTSample& sample, const std::string& row)
+{
+    if (sample.MergedCount > 1)
+    {
+        WriteComment("coalesced " + std::to_string(sample.MergedCount) + " samples "
+                     + RLT_FormatTime(sample.FirstTimeUs) + " - " + RLT_FormatTime(sample.TimeUs));
+    }
+
+    bool result = Writer.Write(row);
+    if (!result)
+        std::cerr << "Error: Could not write measurement" << std::endl;
+
+    // periodic latency report
+    auto now = std::chrono::steady_clock::now();
+    if (now - LastStats >= std::chrono::seconds(LOGGER_STATS_INTERVAL_S))
+    {
+        LastStats = now;
+        PrintStats();
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLinkTest_StatusInd
+//
+//  @brief: time stamp and log indication, replaces TWiMODLRHCI::writeDataToFile
+//
+//------------------------------------------------------------------------------
+
+void
+TMeasurementLogger::evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status)
+{
+    TRLTSample sample;
+
+    sample.TimeUs = RLT_GetTimeUs();
+    sample.Status = status;
+
+    WriteSample(sample, EncodeSample(SAMPLE_FORMAT_CSV, sample));
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
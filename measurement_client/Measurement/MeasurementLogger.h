@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+//
+//	File:		MeasurementLogger.h
+//
+//	Abstract:	Radio Link Test CSV Logger
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef MEASUREMENTLOGGER_H
+#define MEASUREMENTLOGGER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "RLTSample.h"
+#include "BlockFileWriter.h"
+#include "SampleSink.h"
+#include <string>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// interval for write latency reports on stdout
+#define LOGGER_STATS_INTERVAL_S     600
+
+//------------------------------------------------------------------------------
+//
+// TMeasurementLogger Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TMeasurementLogger : public TWiMODLRHCIClient, public TSampleSink
+{
+    public:
+                    TMeasurementLogger();
+
+    // create CSV file with header and comment line
+    bool            Open(const std::string& filename, const std::string& comment, const TBlockFileConfig& config,
+                         const std::string& header = RLT_CSV_HEADER);
+    bool            Close();
+
+    // write "# ..." comment line
+    void            WriteComment(const std::string& comment) override;
+
+    // append CSV row, coalesced summaries are preceded by a comment
+    bool            WriteSample(const TRLTSample& sample, const std::string& row) override;
+
+    // sample sink interface
+    std::string     GetName() const override { return "csv"; }
+    TSampleFormat   GetFormat() const override { return SAMPLE_FORMAT_CSV; }
+    void            Poll() override { Writer.Poll(); }
+
+    // print write statistics and latency percentiles
+    void            PrintStats();
+
+    // submit log writes through an event backend (0 = direct writes)
+    void            SetBackend(TEventBackend* backend) { Writer.SetBackend(backend); }
+
+    const TBlockFileStats&  GetStorageStats() const { return Writer.GetStats(); }
+
+    // HCI client interface
+    void            evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override;
+
+    private:
+
+    TBlockFileWriter    Writer;
+
+    std::chrono::steady_clock::time_point LastStats;
+};
+
+#endif // MEASUREMENTLOGGER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
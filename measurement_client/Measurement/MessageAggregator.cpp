@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+//
+//	File:		MessageAggregator.cpp
+//
+//	Abstract:	Aggregation of Small Messages into Radio Frames
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "MessageAggregator.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  TMessageAggregator - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TMessageAggregator::TMessageAggregator(TWiMODLRHCI& hci)
+    : Link(hci)
+{
+    Client        = 0;
+    FrameMessages = 0;
+    Stats         = TAggregatorStats();
+
+    Configure(TAggregatorConfig());
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::Configure(const TAggregatorConfig& config)
+{
+    Config              = config;
+    Config.MaxFrameSize = std::clamp<UINT32>(Config.MaxFrameSize, AGGREGATE_HEADER_SIZE + AGGREGATE_RECORD_HEADER_SIZE + 1,
+                                             DATALINK_MAX_PAYLOAD_SIZE);
+
+    Link.Configure(Config.Link);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Send
+//
+//------------------------------------------------------------------------------
+
+bool
+TMessageAggregator::Send(const UINT8* data, UINT16 length)
+{
+    if (length > Config.MaxFrameSize - AGGREGATE_HEADER_SIZE - AGGREGATE_RECORD_HEADER_SIZE)
+    {
+        Stats.Dropped++;
+        return false;
+    }
+
+    // does not fit any more
+    if (FrameMessages && Frame.size() + AGGREGATE_RECORD_HEADER_SIZE + length > Config.MaxFrameSize)
+    {
+        Stats.FlushFull++;
+        Flush();
+    }
+
+    if (!FrameMessages)
+    {
+        Frame.assign(1, AGGREGATE_FRAME_TYPE);
+        FrameStart = TClock::now();
+    }
+
+    Frame.push_back((UINT8)length);
+    Frame.insert(Frame.end(), data, data + length);
+    FrameMessages++;
+    Stats.Messages++;
+
+    if (!Config.FlushDelayUs)
+        Flush();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Flush
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::Flush()
+{
+    if (!FrameMessages)
+        return;
+
+    if (Link.Send(Frame.data(), (UINT16)Frame.size()))
+    {
+        Stats.Frames++;
+        Stats.FrameBytes   += Frame.size();
+        Stats.MessagesSent += FrameMessages;
+    }
+    else
+        Stats.Dropped += FrameMessages;
+
+    FrameMessages = 0;
+    Frame.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::Poll()
+{
+    Link.Poll();
+    FlushDue();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FlushDue
+//
+//  @brief: a frame past its deadline waits while frames wait on the host
+//          anyway, it takes further messages until the data link has room
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::FlushDue()
+{
+    if (FrameMessages && !Link.GetQueued() && TClock::now() - FrameStart >= std::chrono::microseconds(Config.FlushDelayUs))
+    {
+        Stats.FlushDeadline++;
+        Flush();
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_RxUMessage
+//
+//  @brief: split the frame, a record beyond its end ends it
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg)
+{
+    int length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE;
+
+    // extended format: RSSI, SNR and time stamp after the payload
+    if (rxMsg.Payload[0] & 0x01)
+        length -= DATALINK_MSG_FOOTER_SIZE;
+
+    const UINT8* data = &rxMsg.Payload[DATALINK_MSG_HEADER_SIZE];
+
+    if (length < AGGREGATE_HEADER_SIZE || data[0] != AGGREGATE_FRAME_TYPE)
+        return;
+
+    Stats.FramesReceived++;
+
+    for (int offset = AGGREGATE_HEADER_SIZE; offset < length; )
+    {
+        UINT16 size = data[offset];
+
+        if (offset + AGGREGATE_RECORD_HEADER_SIZE + size > length)
+        {
+            Stats.Malformed++;
+            break;
+        }
+
+        Stats.MessagesReceived++;
+
+        if (Client)
+            Client->evAggregator_Message(&data[offset + AGGREGATE_RECORD_HEADER_SIZE], size);
+
+        offset += AGGREGATE_RECORD_HEADER_SIZE + size;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageRsp
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::evRadioLink_TxUMessageRsp(UINT8 status)
+{
+    Link.evRadioLink_TxUMessageRsp(status);
+    FlushDue();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageInd
+//
+//------------------------------------------------------------------------------
+
+void
+TMessageAggregator::evRadioLink_TxUMessageInd(UINT8 status)
+{
+    Link.evRadioLink_TxUMessageInd(status);
+    FlushDue();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TMessageAggregator::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "messages=" << Stats.Messages
+         << " frames=" << Stats.Frames
+         << std::fixed << std::setprecision(1)
+         << " per_frame=" << (Stats.Frames ? (double)Stats.MessagesSent / Stats.Frames : 0.0)
+         << " full=" << Stats.FlushFull
+         << " deadline=" << Stats.FlushDeadline
+         << " dropped=" << Stats.Dropped
+         << " received=" << Stats.MessagesReceived;
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+//
+//	File:		MessageAggregator.h
+//
+//	Abstract:	Aggregation of Small Messages into Radio Frames
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef MESSAGEAGGREGATOR_H
+#define MESSAGEAGGREGATOR_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "DataLinkSender.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// frame: type, then records of length (1 byte) and message
+#define AGGREGATE_FRAME_TYPE        0xA1
+#define AGGREGATE_HEADER_SIZE       1
+#define AGGREGATE_RECORD_HEADER_SIZE    1
+
+#define AGGREGATE_MAX_MESSAGE_SIZE  (DATALINK_MAX_PAYLOAD_SIZE - AGGREGATE_HEADER_SIZE - AGGREGATE_RECORD_HEADER_SIZE)
+
+typedef struct
+{
+    // peer and data link
+    TDataLinkConfig     Link;
+
+    // radio payload per frame, at most DATALINK_MAX_PAYLOAD_SIZE
+    UINT32  MaxFrameSize        = DATALINK_MAX_PAYLOAD_SIZE;
+
+    // the first message of a frame waits at most this long for more [us],
+    // 0 = each message in a frame of its own
+    UINT32  FlushDelayUs        = 50000;
+}TAggregatorConfig;
+
+typedef struct
+{
+    // sender: messages packed, messages and frames handed to the data link
+    // (flushed full or by deadline), messages too long or not taken by the
+    // data link
+    UINT64  Messages;
+    UINT64  MessagesSent;
+    UINT64  Frames;
+    UINT64  FrameBytes;
+    UINT64  FlushFull;
+    UINT64  FlushDeadline;
+    UINT64  Dropped;
+
+    // receiver
+    UINT64  FramesReceived;
+    UINT64  MessagesReceived;
+    UINT64  Malformed;
+}TAggregatorStats;
+
+//------------------------------------------------------------------------------
+//
+// TAggregatorClient Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TAggregatorClient
+{
+    public:
+    virtual             ~TAggregatorClient() {}
+
+    // one message of a received frame
+    virtual void        evAggregator_Message(const UINT8* /* data */, UINT16 /* length */) {}
+};
+
+//------------------------------------------------------------------------------
+//
+// TMessageAggregator Class Declaration
+//
+// Packs application messages into one radio frame until the next one does
+// not fit (MaxFrameSize) or the first one has waited FlushDelayUs, so the
+// preamble, header and HCI round trip of a radio message are paid once per
+// frame. While frames wait on the host for the module queue, a frame past
+// its deadline stays open and keeps filling: it would not leave earlier.
+// Frames go out through the pipelined data link; the receiving end splits
+// them and hands each message to its client.
+//
+// Registered as HCI client of both hosts; Poll sends frames whose flush
+// deadline passed and must be called from the thread which drives the HCI,
+// at least as often as the deadline requires.
+//
+//------------------------------------------------------------------------------
+
+class TMessageAggregator : public TWiMODLRHCIClient
+{
+    public:
+                    TMessageAggregator(TWiMODLRHCI& hci);
+
+    void            Configure(const TAggregatorConfig& config);
+    void            RegisterClient(TAggregatorClient* client) { Client = client; }
+
+    // add a message to the open frame, false if it is too long or the
+    // data link queue is full
+    bool            Send(const UINT8* data, UINT16 length);
+
+    // hand the open frame to the data link now
+    void            Flush();
+
+    void            Poll();
+
+    // messages in the open frame
+    UINT32          GetPending() const { return FrameMessages; }
+
+    TAggregatorStats    GetStats() const { return Stats; }
+    TDataLinkSender&    GetLink() { return Link; }
+
+    // "messages=.. frames=.. per_frame=.. full=.. deadline=.. received=.."
+    std::string     FormatStats() const;
+
+    // HCI client interface
+    void            evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override;
+    void            evRadioLink_TxUMessageRsp(UINT8 status) override;
+    void            evRadioLink_TxUMessageInd(UINT8 status) override;
+
+    private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    void            FlushDue();
+
+    TDataLinkSender     Link;
+    TAggregatorConfig   Config;
+    TAggregatorClient*  Client;
+
+    // open frame, time of its first message
+    std::vector<UINT8>  Frame;
+    UINT32              FrameMessages;
+    TClock::time_point  FrameStart;
+
+    TAggregatorStats    Stats;
+};
+
+#endif // MESSAGEAGGREGATOR_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
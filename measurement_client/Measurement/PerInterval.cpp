@@ -0,0 +1,387 @@
+//------------------------------------------------------------------------------
+//
+//	File:		PerInterval.cpp
+//
+//	Abstract:	Confidence Intervals of the Packet Error Rate
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "PerInterval.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// bisection steps of the quantile searches (2^-60 resolution)
+#define PER_BISECTION_STEPS     60
+
+// continued fraction of the incomplete beta function
+#define PER_BETA_MAX_TERMS      300
+#define PER_BETA_EPSILON        1e-12
+
+//------------------------------------------------------------------------------
+//
+//  NormalQuantile
+//
+//  @brief: z with P(Z <= z) = p, bisection on erfc
+//
+//------------------------------------------------------------------------------
+
+static double
+NormalQuantile(double p)
+{
+    double low  = -40;
+    double high = 40;
+
+    for (int i = 0; i < PER_BISECTION_STEPS; i++)
+    {
+        double mid = 0.5 * (low + high);
+
+        if (0.5 * std::erfc(-mid / std::sqrt(2.0)) < p)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    return 0.5 * (low + high);
+}
+
+//------------------------------------------------------------------------------
+//
+//  BetaContinuedFraction
+//
+//  @brief: modified Lentz evaluation
+//
+//------------------------------------------------------------------------------
+
+static double
+BetaContinuedFraction(double a, double b, double x)
+{
+    const double tiny = 1e-300;
+
+    double c = 1;
+    double d = 1 - (a + b) * x / (a + 1);
+
+    d = std::fabs(d) < tiny ? 1 / tiny : 1 / d;
+
+    double h = d;
+
+    for (int m = 1; m <= PER_BETA_MAX_TERMS; m++)
+    {
+        // even step
+        double numerator = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+
+        d = 1 + numerator * d;
+        c = 1 + numerator / c;
+        d = std::fabs(d) < tiny ? 1 / tiny : 1 / d;
+        c = std::fabs(c) < tiny ? tiny : c;
+        h *= d * c;
+
+        // odd step
+        numerator = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+
+        d = 1 + numerator * d;
+        c = 1 + numerator / c;
+        d = std::fabs(d) < tiny ? 1 / tiny : 1 / d;
+        c = std::fabs(c) < tiny ? tiny : c;
+
+        double delta = d * c;
+        h *= delta;
+
+        if (std::fabs(delta - 1) < PER_BETA_EPSILON)
+            break;
+    }
+
+    return h;
+}
+
+//------------------------------------------------------------------------------
+//
+//  IncompleteBeta
+//
+//  @brief: regularized incomplete beta function I_x(a, b)
+//
+//------------------------------------------------------------------------------
+
+static double
+IncompleteBeta(double a, double b, double x)
+{
+    if (x <= 0)
+        return 0;
+
+    if (x >= 1)
+        return 1;
+
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b)
+                            + a * std::log(x) + b * std::log1p(-x));
+
+    // the continued fraction converges fast below the mean
+    if (x < (a + 1) / (a + b + 2))
+        return front * BetaContinuedFraction(a, b, x) / a;
+
+    return 1 - front * BetaContinuedFraction(b, a, 1 - x) / b;
+}
+
+//------------------------------------------------------------------------------
+//
+//  BetaQuantile
+//
+//------------------------------------------------------------------------------
+
+static double
+BetaQuantile(double p, double a, double b)
+{
+    double low  = 0;
+    double high = 1;
+
+    for (int i = 0; i < PER_BISECTION_STEPS; i++)
+    {
+        double mid = 0.5 * (low + high);
+
+        if (IncompleteBeta(a, b, mid) < p)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    return 0.5 * (low + high);
+}
+
+//------------------------------------------------------------------------------
+//
+//  PER_GetInterval
+//
+//------------------------------------------------------------------------------
+
+void
+PER_GetInterval(TPerIntervalMethod method, double confidence, TPerEstimate& estimate)
+{
+    estimate.Lower = 0;
+    estimate.Upper = 1;
+
+    if (!estimate.Trials)
+        return;
+
+    double n     = (double)estimate.Trials;
+    double x     = (double)std::min(estimate.Errors, estimate.Trials);
+    double alpha = 1 - confidence;
+
+    if (method == PER_INTERVAL_CLOPPER_PEARSON)
+    {
+        if (x > 0)
+            estimate.Lower = BetaQuantile(alpha / 2, x, n - x + 1);
+
+        if (x < n)
+            estimate.Upper = BetaQuantile(1 - alpha / 2, x + 1, n - x);
+
+        return;
+    }
+
+    double z      = NormalQuantile(1 - alpha / 2);
+    double p      = x / n;
+    double z2     = z * z;
+    double denom  = 1 + z2 / n;
+    double center = (p + z2 / (2 * n)) / denom;
+    double half   = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / denom;
+
+    estimate.Lower = std::max(0.0, center - half);
+    estimate.Upper = std::min(1.0, center + half);
+}
+
+//------------------------------------------------------------------------------
+//
+//  PER_MethodFromName
+//
+//------------------------------------------------------------------------------
+
+bool
+PER_MethodFromName(const std::string& name, TPerIntervalMethod& method)
+{
+    if (name == "wilson")
+        method = PER_INTERVAL_WILSON;
+    else if (name == "clopper-pearson")
+        method = PER_INTERVAL_CLOPPER_PEARSON;
+    else
+        return false;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PER_MethodName
+//
+//------------------------------------------------------------------------------
+
+const char*
+PER_MethodName(TPerIntervalMethod method)
+{
+    return method == PER_INTERVAL_CLOPPER_PEARSON ? "clopper-pearson" : "wilson";
+}
+
+//------------------------------------------------------------------------------
+//
+//  TLinkPerEstimator - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TLinkPerEstimator::TLinkPerEstimator(TPerIntervalMethod method, double confidence)
+{
+    Method     = method;
+    Confidence = confidence;
+    HasBase    = false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetMethod
+//
+//------------------------------------------------------------------------------
+
+void
+TLinkPerEstimator::SetMethod(TPerIntervalMethod method, double confidence)
+{
+    Method     = method;
+    Confidence = confidence;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reset
+//
+//------------------------------------------------------------------------------
+
+void
+TLinkPerEstimator::Reset()
+{
+    HasBase = false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Add
+//
+//------------------------------------------------------------------------------
+
+void
+TLinkPerEstimator::Add(const TWiMODLR_RadioLinkTestStatus& status)
+{
+    if (!HasBase)
+    {
+        Base    = status;
+        HasBase = true;
+    }
+
+    Last = status;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetUplink
+//
+//------------------------------------------------------------------------------
+
+TPerEstimate
+TLinkPerEstimator::GetUplink() const
+{
+    return GetEstimate(Last.LTxCount, Last.PRxCount, Base.LTxCount, Base.PRxCount);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetDownlink
+//
+//------------------------------------------------------------------------------
+
+TPerEstimate
+TLinkPerEstimator::GetDownlink() const
+{
+    return GetEstimate(Last.PTxCount, Last.LRxCount, Base.PTxCount, Base.LRxCount);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetEstimate
+//
+//  @brief: a packet still in flight counts as error until it is reported
+//
+//------------------------------------------------------------------------------
+
+TPerEstimate
+TLinkPerEstimator::GetEstimate(UINT32 sent, UINT32 received, UINT32 sentBase, UINT32 receivedBase) const
+{
+    TPerEstimate estimate = TPerEstimate();
+
+    if (HasBase)
+    {
+        UINT32 numSent     = sent - sentBase;
+        UINT32 numReceived = received - receivedBase;
+
+        estimate.Trials = numSent;
+        estimate.Errors = numSent > numReceived ? numSent - numReceived : 0;
+    }
+
+    PER_GetInterval(Method, Confidence, estimate);
+
+    return estimate;
+}
+
+//------------------------------------------------------------------------------
+//
+//  IsConverged
+//
+//------------------------------------------------------------------------------
+
+bool
+TLinkPerEstimator::IsConverged(double maxWidth, UINT64 minTrials) const
+{
+    TPerEstimate uplink   = GetUplink();
+    TPerEstimate downlink = GetDownlink();
+
+    return uplink.Trials >= minTrials && downlink.Trials >= minTrials
+           && uplink.Upper - uplink.Lower <= maxWidth
+           && downlink.Upper - downlink.Lower <= maxWidth;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Format
+//
+//------------------------------------------------------------------------------
+
+std::string
+TLinkPerEstimator::Format() const
+{
+    TPerEstimate uplink   = GetUplink();
+    TPerEstimate downlink = GetDownlink();
+
+    char buffer[160];
+
+    std::snprintf(buffer, sizeof(buffer),
+                  "uplink per=%.4f [%.4f,%.4f] n=%llu downlink per=%.4f [%.4f,%.4f] n=%llu",
+                  uplink.Trials ? (double)uplink.Errors / uplink.Trials : 0.0, uplink.Lower, uplink.Upper,
+                  (unsigned long long)uplink.Trials,
+                  downlink.Trials ? (double)downlink.Errors / downlink.Trials : 0.0, downlink.Lower, downlink.Upper,
+                  (unsigned long long)downlink.Trials);
+
+    return std::string(buffer);
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
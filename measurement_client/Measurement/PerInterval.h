@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+//
+//	File:		PerInterval.h
+//
+//	Abstract:	Confidence Intervals of the Packet Error Rate
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef PERINTERVAL_H
+#define PERINTERVAL_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+typedef enum
+{
+    // score interval, closed form, close to nominal coverage
+    PER_INTERVAL_WILSON = 0,
+    // exact binomial interval (beta quantiles), conservative
+    PER_INTERVAL_CLOPPER_PEARSON
+}TPerIntervalMethod;
+
+typedef struct
+{
+    UINT64  Trials;
+    UINT64  Errors;
+
+    // two sided interval of the error rate
+    double  Lower;
+    double  Upper;
+}TPerEstimate;
+
+// two sided interval for errors out of trials, [0, 1] without trials
+void            PER_GetInterval(TPerIntervalMethod method, double confidence, TPerEstimate& estimate);
+
+// "wilson", "clopper-pearson"
+bool            PER_MethodFromName(const std::string& name, TPerIntervalMethod& method);
+const char*     PER_MethodName(TPerIntervalMethod method);
+
+//------------------------------------------------------------------------------
+//
+// TLinkPerEstimator Class Declaration
+//
+// Uplink and downlink PER of a radio link test from the accumulated
+// counters of the status indications (TWiMODLRHCI): uplink = packets sent
+// by the local module and not received by the peer, downlink = packets
+// sent by the peer and not received locally. Counted from the first
+// indication after Reset.
+//
+//------------------------------------------------------------------------------
+
+class TLinkPerEstimator
+{
+    public:
+                    TLinkPerEstimator(TPerIntervalMethod method = PER_INTERVAL_WILSON, double confidence = 0.95);
+
+    void            SetMethod(TPerIntervalMethod method, double confidence);
+
+    // next indication is the baseline
+    void            Reset();
+
+    void            Add(const TWiMODLR_RadioLinkTestStatus& status);
+
+    TPerEstimate    GetUplink() const;
+    TPerEstimate    GetDownlink() const;
+
+    // both intervals at most maxWidth wide, at least minTrials each
+    bool            IsConverged(double maxWidth, UINT64 minTrials) const;
+
+    // "uplink per=.. [..,..] n=.. downlink per=.. [..,..] n=.."
+    std::string     Format() const;
+
+    private:
+
+    TPerEstimate    GetEstimate(UINT32 sent, UINT32 received, UINT32 sentBase, UINT32 receivedBase) const;
+
+    TPerIntervalMethod  Method;
+    double              Confidence;
+
+    bool                            HasBase;
+    TWiMODLR_RadioLinkTestStatus    Base;
+    TWiMODLR_RadioLinkTestStatus    Last;
+};
+
+#endif // PERINTERVAL_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
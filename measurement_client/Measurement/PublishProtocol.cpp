@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//
+//	File:		PublishProtocol.cpp
+//
+//	Abstract:	Messages between Sample Publisher and Collector
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "PublishProtocol.h"
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+//------------------------------------------------------------------------------
+//
+//  Publish_Put64 / Publish_Get64
+//
+//------------------------------------------------------------------------------
+
+void
+Publish_Put64(UINT8* dst, UINT64 value)
+{
+    HTON32(dst,     (UINT32)value);
+    HTON32(dst + 4, (UINT32)(value >> 32));
+}
+
+UINT64
+Publish_Get64(const UINT8* src)
+{
+    return (UINT64)NTOH32(src) | ((UINT64)NTOH32(src + 4) << 32);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Publish_AppendMessage
+//
+//------------------------------------------------------------------------------
+
+void
+Publish_AppendMessage(std::vector<UINT8>& dst, UINT8 type, const UINT8* body, size_t length)
+{
+    size_t offset = dst.size();
+
+    dst.resize(offset + PUBLISH_HEADER_SIZE + length);
+
+    UINT8* ptr = &dst[offset];
+
+    HTON32(ptr, PUBLISH_MAGIC);
+    ptr[4] = type;
+    ptr[5] = PUBLISH_VERSION;
+    ptr[6] = 0;
+    ptr[7] = 0;
+    HTON32(ptr + 8, (UINT32)length);
+
+    for (size_t i = 0; i < length; i++)
+        ptr[PUBLISH_HEADER_SIZE + i] = body[i];
+}
+
+//------------------------------------------------------------------------------
+//
+//  Publish_AppendSequence
+//
+//------------------------------------------------------------------------------
+
+void
+Publish_AppendSequence(std::vector<UINT8>& dst, UINT8 type, UINT64 sequence)
+{
+    UINT8 body[8];
+
+    Publish_Put64(body, sequence);
+    Publish_AppendMessage(dst, type, body, sizeof(body));
+}
+
+//------------------------------------------------------------------------------
+//
+//  Publish_SendAll
+//
+//------------------------------------------------------------------------------
+
+bool
+Publish_SendAll(int handle, const UINT8* data, size_t length)
+{
+    while (length)
+    {
+        ssize_t sent = ::send(handle, data, length, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+
+        data   += sent;
+        length -= sent;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Append
+//
+//------------------------------------------------------------------------------
+
+void
+TPublishParser::Append(const UINT8* data, size_t length)
+{
+    // drop consumed messages before growing the buffer
+    if (Offset)
+    {
+        Buffer.erase(Buffer.begin(), Buffer.begin() + Offset);
+        Offset = 0;
+    }
+
+    Buffer.insert(Buffer.end(), data, data + length);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Next
+//
+//------------------------------------------------------------------------------
+
+bool
+TPublishParser::Next(UINT8& type, const UINT8*& body, size_t& length)
+{
+    if (Error || Buffer.size() - Offset < PUBLISH_HEADER_SIZE)
+        return false;
+
+    const UINT8* ptr = &Buffer[Offset];
+
+    UINT32 bodyLength = NTOH32(ptr + 8);
+
+    if (NTOH32(ptr) != PUBLISH_MAGIC || ptr[5] != PUBLISH_VERSION || bodyLength > PUBLISH_MAX_BODY)
+    {
+        Error = true;
+        return false;
+    }
+
+    if (Buffer.size() - Offset < PUBLISH_HEADER_SIZE + bodyLength)
+        return false;
+
+    type    = ptr[4];
+    body    = ptr + PUBLISH_HEADER_SIZE;
+    length  = bodyLength;
+    Offset += PUBLISH_HEADER_SIZE + bodyLength;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
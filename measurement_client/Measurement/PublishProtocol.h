@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//
+//	File:		PublishProtocol.h
+//
+//	Abstract:	Messages between Sample Publisher and Collector
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef PUBLISHPROTOCOL_H
+#define PUBLISHPROTOCOL_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+// Every message starts with a header: magic "RLTP", type, version, 2 bytes
+// reserved and the body length (all fields little endian).
+//
+//  HELLO   publisher -> collector: node name
+//  RESUME  collector -> publisher: next expected sequence number of the node
+//  DATA    publisher -> collector: sequence number of the first sample and
+//          one RLT block (RLTCodec) holding consecutive samples
+//  ACK     collector -> publisher: next expected sequence number, all
+//          samples before are stored
+//
+// After a reconnect the publisher continues at the RESUME sequence, samples
+// acknowledged before are never sent twice.
+//
+//------------------------------------------------------------------------------
+
+#define PUBLISH_MAGIC               0x50544C52
+#define PUBLISH_VERSION             1
+#define PUBLISH_HEADER_SIZE         12
+
+// body limits
+#define PUBLISH_MAX_NODE_NAME       64
+#define PUBLISH_MAX_BODY            (1024 * 1024)
+
+// default collector port
+#define PUBLISH_DEFAULT_PORT        "7412"
+
+typedef enum
+{
+    PUBLISH_MSG_HELLO = 1,
+    PUBLISH_MSG_RESUME,
+    PUBLISH_MSG_DATA,
+    PUBLISH_MSG_ACK
+}TPublishMsgType;
+
+//------------------------------------------------------------------------------
+//
+// Helper Functions
+//
+//------------------------------------------------------------------------------
+
+// append one message with header to dst
+void            Publish_AppendMessage(std::vector<UINT8>& dst, UINT8 type, const UINT8* body, size_t length);
+
+// append RESUME / ACK message
+void            Publish_AppendSequence(std::vector<UINT8>& dst, UINT8 type, UINT64 sequence);
+
+// little endian 64 bit access
+void            Publish_Put64(UINT8* dst, UINT64 value);
+UINT64          Publish_Get64(const UINT8* src);
+
+// write all bytes to a (blocking) socket, false on error / timeout
+bool            Publish_SendAll(int handle, const UINT8* data, size_t length);
+
+//------------------------------------------------------------------------------
+//
+// TPublishParser Class Declaration
+//
+// Reassembles messages from a byte stream.
+//
+//------------------------------------------------------------------------------
+
+class TPublishParser
+{
+    public:
+                    TPublishParser() : Offset(0), Error(false) {}
+
+    // append received bytes
+    void            Append(const UINT8* data, size_t length);
+
+    // next complete message, body points into the parser until the next
+    // Append, false if incomplete or on protocol error (see HasError)
+    bool            Next(UINT8& type, const UINT8*& body, size_t& length);
+
+    // bad magic / version / length, the connection should be closed
+    bool            HasError() const { return Error; }
+
+    void            Reset() { Buffer.clear(); Offset = 0; Error = false; }
+
+    private:
+
+    std::vector<UINT8>  Buffer;
+    size_t              Offset;
+    bool                Error;
+};
+
+#endif // PUBLISHPROTOCOL_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,718 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RLTCodec.cpp
+//
+//	Abstract:	Columnar Block Codec for Radio Link Test Samples
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "RLTCodec.h"
+#include "../WiMODLR/CRC16.h"
+#include <algorithm>
+#include <numeric>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// bits used to store the significant bit count of a XOR value
+#define RLT_XOR_LEN_BITS_16     4
+#define RLT_XOR_LEN_BITS_8      3
+
+// CRC16 is calculated in chunks, the CRC16 API takes 16 bit lengths only
+#define RLT_CRC_CHUNK_SIZE      32768
+
+//------------------------------------------------------------------------------
+//
+//  Bit Stream Helpers (MSB first)
+//
+//------------------------------------------------------------------------------
+
+class TBitWriter
+{
+    public:
+                    TBitWriter(std::vector<UINT8>& dst) : Dst(dst), Acc(0), NumBits(0) {}
+
+    void            Write(UINT64 value, int bits)
+    {
+        // split wide values, accumulator keeps < 8 pending bits
+        if (bits > 32)
+        {
+            Write(value >> 32, bits - 32);
+            value &= 0xFFFFFFFF;
+            bits   = 32;
+        }
+
+        Acc      = (Acc << bits) | (value & ((1ULL << bits) - 1));
+        NumBits += bits;
+
+        while (NumBits >= 8)
+        {
+            NumBits -= 8;
+            Dst.push_back((UINT8)(Acc >> NumBits));
+        }
+        Acc &= (1ULL << NumBits) - 1;
+    }
+
+    void            Finish()
+    {
+        // pad last byte with zero bits
+        if (NumBits)
+            Dst.push_back((UINT8)(Acc << (8 - NumBits)));
+
+        Acc     = 0;
+        NumBits = 0;
+    }
+
+    private:
+    std::vector<UINT8>& Dst;
+    UINT64          Acc;
+    int             NumBits;
+};
+
+class TBitReader
+{
+    public:
+                    TBitReader(const UINT8* data, size_t length) : Data(data), NumBits(length * 8), BitPos(0) {}
+
+    bool            Read(int bits, UINT64& value)
+    {
+        if (BitPos + (size_t)bits > NumBits)
+            return false;
+
+        value = 0;
+        while (bits > 0)
+        {
+            int     avail = 8 - (int)(BitPos & 7);
+            int     take  = std::min(avail, bits);
+            UINT8   byte  = Data[BitPos >> 3];
+
+            value   = (value << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+            BitPos += take;
+            bits   -= take;
+        }
+        return true;
+    }
+
+    private:
+    const UINT8*    Data;
+    size_t          NumBits;
+    size_t          BitPos;
+};
+
+//------------------------------------------------------------------------------
+//
+//  Varint / Zigzag Helpers
+//
+//------------------------------------------------------------------------------
+
+static inline UINT64
+ZigZagEncode(INT64 value)
+{
+    return ((UINT64)value << 1) ^ (UINT64)(value >> 63);
+}
+
+static inline INT64
+ZigZagDecode(UINT64 value)
+{
+    return (INT64)(value >> 1) ^ -(INT64)(value & 1);
+}
+
+static void
+WriteVarint(std::vector<UINT8>& dst, UINT64 value)
+{
+    while (value >= 0x80)
+    {
+        dst.push_back((UINT8)(value | 0x80));
+        value >>= 7;
+    }
+    dst.push_back((UINT8)value);
+}
+
+static bool
+ReadVarint(const UINT8*& ptr, const UINT8* end, UINT64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (ptr >= end)
+            return false;
+
+        UINT8 byte = *ptr++;
+        value |= (UINT64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static void
+Put64(UINT8* dst, INT64 value)
+{
+    HTON32(dst,     (UINT32)(UINT64)value);
+    HTON32(dst + 4, (UINT32)((UINT64)value >> 32));
+}
+
+static INT64
+Get64(const UINT8* src)
+{
+    return (INT64)((UINT64)NTOH32(src) | ((UINT64)NTOH32(src + 4) << 32));
+}
+
+static UINT16
+CalcCRC(const UINT8* data, size_t length)
+{
+    UINT16 crc = CRC16_INIT_VALUE;
+
+    while (length)
+    {
+        UINT16 chunk = (UINT16)std::min(length, (size_t)RLT_CRC_CHUNK_SIZE);
+
+        crc     = CRC16_Calc((UINT8*)data, chunk, crc);
+        data   += chunk;
+        length -= chunk;
+    }
+    return ~crc;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Column Encoders
+//
+//------------------------------------------------------------------------------
+
+static void
+EncodeTimeColumn(const TRLTSample* samples, int count, std::vector<UINT8>& column)
+{
+    // common time unit of all deltas, e.g. 1000us for millisecond stamps
+    UINT64 scale = 0;
+    for (int i = 1; i < count; i++)
+    {
+        INT64 delta = samples[i].TimeUs - samples[i - 1].TimeUs;
+        scale = std::gcd(scale, (UINT64)(delta < 0 ? -delta : delta));
+    }
+    if (scale == 0)
+        scale = 1;
+
+    WriteVarint(column, scale);
+
+    TBitWriter  bits(column);
+    INT64       prevDelta = 0;
+
+    for (int i = 1; i < count; i++)
+    {
+        INT64  delta = (samples[i].TimeUs - samples[i - 1].TimeUs) / (INT64)scale;
+        UINT64 dod   = ZigZagEncode(delta - prevDelta);
+
+        prevDelta = delta;
+
+        if (dod == 0)
+        {
+            bits.Write(0x0, 1);
+        }
+        else if (dod < (1 << 7))
+        {
+            bits.Write(0x2, 2);
+            bits.Write(dod, 7);
+        }
+        else if (dod < (1 << 9))
+        {
+            bits.Write(0x6, 3);
+            bits.Write(dod, 9);
+        }
+        else if (dod < (1 << 12))
+        {
+            bits.Write(0xE, 4);
+            bits.Write(dod, 12);
+        }
+        else
+        {
+            bits.Write(0xF, 4);
+            bits.Write(dod, 64);
+        }
+    }
+    bits.Finish();
+}
+
+static void
+EncodeCounterColumn(const UINT32* values, size_t stride, int count, std::vector<UINT8>& column)
+{
+    INT64 prev = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        INT64 value = *(const UINT32*)((const UINT8*)values + i * stride);
+
+        WriteVarint(column, ZigZagEncode(value - prev));
+        prev = value;
+    }
+}
+
+template <typename T>
+static void
+EncodeXorColumn(const T* values, size_t stride, int count, int lenBits, std::vector<UINT8>& column)
+{
+    TBitWriter  bits(column);
+    UINT32      prev = 0;
+    UINT32      mask = (1u << (8 * sizeof(T))) - 1;
+
+    for (int i = 0; i < count; i++)
+    {
+        UINT32 value = (UINT32)*(const T*)((const UINT8*)values + i * stride) & mask;
+        UINT32 diff  = value ^ prev;
+
+        prev = value;
+
+        if (diff == 0)
+        {
+            bits.Write(0, 1);
+        }
+        else
+        {
+            int len = 32 - __builtin_clz(diff);
+
+            bits.Write(1, 1);
+            bits.Write(len - 1, lenBits);
+            bits.Write(diff, len);
+        }
+    }
+    bits.Finish();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Column Decoders
+//
+//------------------------------------------------------------------------------
+
+static bool
+DecodeTimeColumn(const UINT8* ptr, const UINT8* end, INT64 firstTime, TRLTSample* samples, int count)
+{
+    UINT64 scale;
+    if (!ReadVarint(ptr, end, scale) || scale == 0)
+        return false;
+
+    TBitReader  bits(ptr, end - ptr);
+    INT64       prevDelta = 0;
+
+    samples[0].TimeUs = firstTime;
+
+    for (int i = 1; i < count; i++)
+    {
+        UINT64 flag;
+        UINT64 dod = 0;
+        int    width = 0;
+
+        if (!bits.Read(1, flag))
+            return false;
+
+        // walk the prefix code: 0, 10, 110, 1110, 1111
+        if (flag)
+        {
+            static const int widths[] = { 7, 9, 12, 64 };
+
+            for (int level = 0; level < 4; level++)
+            {
+                if (level == 3)
+                {
+                    width = widths[level];
+                    break;
+                }
+                if (!bits.Read(1, flag))
+                    return false;
+
+                if (!flag)
+                {
+                    width = widths[level];
+                    break;
+                }
+            }
+            if (!bits.Read(width, dod))
+                return false;
+        }
+
+        INT64 delta = prevDelta + ZigZagDecode(dod);
+        prevDelta = delta;
+
+        samples[i].TimeUs = samples[i - 1].TimeUs + delta * (INT64)scale;
+    }
+    return true;
+}
+
+static bool
+DecodeCounterColumn(const UINT8* ptr, const UINT8* end, UINT32* values, size_t stride, int count)
+{
+    INT64 prev = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        UINT64 zz;
+        if (!ReadVarint(ptr, end, zz))
+            return false;
+
+        prev += ZigZagDecode(zz);
+        *(UINT32*)((UINT8*)values + i * stride) = (UINT32)prev;
+    }
+    return true;
+}
+
+template <typename T>
+static bool
+DecodeXorColumn(const UINT8* ptr, const UINT8* end, T* values, size_t stride, int count, int lenBits)
+{
+    TBitReader  bits(ptr, end - ptr);
+    UINT32      prev = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        UINT64 flag;
+        if (!bits.Read(1, flag))
+            return false;
+
+        if (flag)
+        {
+            UINT64 len, diff;
+            if (!bits.Read(lenBits, len) || !bits.Read((int)len + 1, diff))
+                return false;
+
+            prev ^= (UINT32)diff;
+        }
+        *(T*)((UINT8*)values + i * stride) = (T)prev;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TRLTBlockEncoder - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TRLTBlockEncoder::TRLTBlockEncoder(int blockSamples)
+{
+    // limit to header field size
+    BlockSamples = std::clamp(blockSamples, 1, RLT_BLOCK_MAX_SAMPLES);
+
+    Pending.reserve(BlockSamples);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Add
+//
+//  @brief: queue sample for the next block
+//
+//------------------------------------------------------------------------------
+
+bool
+TRLTBlockEncoder::Add(const TRLTSample& sample)
+{
+    Pending.push_back(sample);
+
+    return (int)Pending.size() >= BlockSamples;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Flush
+//
+//  @brief: encode pending samples into one block
+//
+//------------------------------------------------------------------------------
+
+bool
+TRLTBlockEncoder::Flush(std::vector<UINT8>& dst)
+{
+    if (Pending.empty())
+        return false;
+
+    bool result = EncodeBlock(Pending.data(), (int)Pending.size(), dst);
+
+    Pending.clear();
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  EncodeBlock
+//
+//  @brief: encode samples as self-contained block (header + columns)
+//
+//------------------------------------------------------------------------------
+
+bool
+TRLTBlockEncoder::EncodeBlock(const TRLTSample* samples, int count, std::vector<UINT8>& dst)
+{
+    if (!samples || count <= 0 || count > RLT_BLOCK_MAX_SAMPLES)
+        return false;
+
+    size_t headerOffset = dst.size();
+
+    // reserve header, filled in after payload is known
+    dst.resize(headerOffset + RLT_BLOCK_HEADER_SIZE);
+
+    size_t payloadOffset = dst.size();
+
+    std::vector<UINT8> column;
+    column.reserve(count * 4);
+
+    const TWiMODLR_RadioLinkTestStatus* status = &samples[0].Status;
+    const size_t stride = sizeof(TRLTSample);
+
+    // append column with length prefix
+    auto appendColumn = [&]()
+    {
+        WriteVarint(dst, column.size());
+        dst.insert(dst.end(), column.begin(), column.end());
+        column.clear();
+    };
+
+    EncodeTimeColumn(samples, count, column);
+    appendColumn();
+
+    EncodeXorColumn(&status->TestStatus, stride, count, RLT_XOR_LEN_BITS_8, column);
+    appendColumn();
+
+    EncodeCounterColumn(&status->LTxCount, stride, count, column);
+    appendColumn();
+    EncodeCounterColumn(&status->LRxCount, stride, count, column);
+    appendColumn();
+    EncodeCounterColumn(&status->PTxCount, stride, count, column);
+    appendColumn();
+    EncodeCounterColumn(&status->PRxCount, stride, count, column);
+    appendColumn();
+
+    EncodeXorColumn(&status->LocalRSSI, stride, count, RLT_XOR_LEN_BITS_16, column);
+    appendColumn();
+    EncodeXorColumn(&status->PeerRSSI, stride, count, RLT_XOR_LEN_BITS_16, column);
+    appendColumn();
+
+    EncodeXorColumn(&status->LocalSNR, stride, count, RLT_XOR_LEN_BITS_8, column);
+    appendColumn();
+    EncodeXorColumn(&status->PeerSNR, stride, count, RLT_XOR_LEN_BITS_8, column);
+    appendColumn();
+
+    // fill in header
+    UINT32 payloadLength = (UINT32)(dst.size() - payloadOffset);
+    UINT8* ptr = &dst[headerOffset];
+
+    HTON32(ptr, RLT_BLOCK_MAGIC);
+    ptr[4] = RLT_BLOCK_VERSION;
+    ptr[5] = 0;
+    HTON16(ptr + 6, (UINT16)count);
+    Put64(ptr + 8, samples[0].TimeUs);
+    Put64(ptr + 16, samples[count - 1].TimeUs);
+    HTON32(ptr + 24, payloadLength);
+    HTON16(ptr + 28, CalcCRC(&dst[payloadOffset], payloadLength));
+    HTON16(ptr + 30, CalcCRC(ptr, RLT_BLOCK_HEADER_SIZE - 2));
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ReadHeader
+//
+//  @brief: check magic, version and header CRC
+//
+//------------------------------------------------------------------------------
+
+bool
+TRLTBlockDecoder::ReadHeader(const UINT8* data, size_t length, TRLTBlockInfo& info)
+{
+    if (!data || length < RLT_BLOCK_HEADER_SIZE)
+        return false;
+
+    if (NTOH32(data) != RLT_BLOCK_MAGIC || data[4] != RLT_BLOCK_VERSION)
+        return false;
+
+    if (NTOH16(data + 30) != CalcCRC(data, RLT_BLOCK_HEADER_SIZE - 2))
+        return false;
+
+    info.NumSamples     = NTOH16(data + 6);
+    info.FirstTimeUs    = Get64(data + 8);
+    info.LastTimeUs     = Get64(data + 16);
+    info.PayloadLength  = NTOH32(data + 24);
+
+    return info.NumSamples > 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  DecodeBlock
+//
+//  @brief: decode one complete block
+//
+//------------------------------------------------------------------------------
+
+size_t
+TRLTBlockDecoder::DecodeBlock(const UINT8* data, size_t length, std::vector<TRLTSample>& samples)
+{
+    TRLTBlockInfo info;
+
+    if (!ReadHeader(data, length, info))
+        return 0;
+
+    size_t blockLength = RLT_BLOCK_HEADER_SIZE + (size_t)info.PayloadLength;
+    if (blockLength > length)
+        return 0;
+
+    const UINT8* ptr = data + RLT_BLOCK_HEADER_SIZE;
+    const UINT8* end = ptr + info.PayloadLength;
+
+    if (NTOH16(data + 28) != CalcCRC(ptr, info.PayloadLength))
+        return 0;
+
+    size_t      first  = samples.size();
+    int         count  = info.NumSamples;
+    samples.resize(first + count);
+
+    TRLTSample*                     dst    = &samples[first];
+    TWiMODLR_RadioLinkTestStatus*   status = &dst->Status;
+    const size_t                    stride = sizeof(TRLTSample);
+
+    // iterate over length prefixed columns
+    int  columnIndex = 0;
+    bool ok          = true;
+
+    while (ok && columnIndex < 10)
+    {
+        UINT64 columnLength;
+        if (!ReadVarint(ptr, end, columnLength) || columnLength > (UINT64)(end - ptr))
+        {
+            ok = false;
+            break;
+        }
+
+        const UINT8* columnEnd = ptr + columnLength;
+
+        switch (columnIndex)
+        {
+            case 0: ok = DecodeTimeColumn(ptr, columnEnd, info.FirstTimeUs, dst, count); break;
+            case 1: ok = DecodeXorColumn(ptr, columnEnd, &status->TestStatus, stride, count, RLT_XOR_LEN_BITS_8); break;
+            case 2: ok = DecodeCounterColumn(ptr, columnEnd, &status->LTxCount, stride, count); break;
+            case 3: ok = DecodeCounterColumn(ptr, columnEnd, &status->LRxCount, stride, count); break;
+            case 4: ok = DecodeCounterColumn(ptr, columnEnd, &status->PTxCount, stride, count); break;
+            case 5: ok = DecodeCounterColumn(ptr, columnEnd, &status->PRxCount, stride, count); break;
+            case 6: ok = DecodeXorColumn(ptr, columnEnd, &status->LocalRSSI, stride, count, RLT_XOR_LEN_BITS_16); break;
+            case 7: ok = DecodeXorColumn(ptr, columnEnd, &status->PeerRSSI, stride, count, RLT_XOR_LEN_BITS_16); break;
+            case 8: ok = DecodeXorColumn(ptr, columnEnd, &status->LocalSNR, stride, count, RLT_XOR_LEN_BITS_8); break;
+            case 9: ok = DecodeXorColumn(ptr, columnEnd, &status->PeerSNR, stride, count, RLT_XOR_LEN_BITS_8); break;
+        }
+
+        ptr = columnEnd;
+        columnIndex++;
+    }
+
+    // consistency check against header
+    if (!ok || dst[count - 1].TimeUs != info.LastTimeUs)
+    {
+        samples.resize(first);
+        return 0;
+    }
+
+    return blockLength;
+}
+
+//------------------------------------------------------------------------------
+//
+//  DecodeSegment
+//
+//  @brief: decode consecutive blocks, resync on next magic after errors
+//
+//------------------------------------------------------------------------------
+
+size_t
+TRLTBlockDecoder::DecodeSegment(const UINT8* data, size_t length, std::vector<TRLTSample>& samples)
+{
+    size_t offset    = 0;
+    size_t numBlocks = 0;
+
+    while (offset + RLT_BLOCK_HEADER_SIZE <= length)
+    {
+        size_t consumed = DecodeBlock(data + offset, length - offset, samples);
+        if (consumed)
+        {
+            offset += consumed;
+            numBlocks++;
+        }
+        else
+        {
+            // skip corrupt data byte by byte until next valid header
+            offset++;
+        }
+    }
+    return numBlocks;
+}
+
+//------------------------------------------------------------------------------
+//
+//  BuildIndex
+//
+//  @brief: collect block headers as seek points
+//
+//------------------------------------------------------------------------------
+
+void
+TRLTBlockDecoder::BuildIndex(const UINT8* data, size_t length, std::vector<TRLTSeekPoint>& index)
+{
+    size_t offset = 0;
+
+    index.clear();
+
+    while (offset + RLT_BLOCK_HEADER_SIZE <= length)
+    {
+        TRLTSeekPoint point;
+
+        if (ReadHeader(data + offset, length - offset, point.Info)
+            && offset + RLT_BLOCK_HEADER_SIZE + point.Info.PayloadLength <= length)
+        {
+            point.Offset = offset;
+            index.push_back(point);
+
+            // skip payload without decoding
+            offset += RLT_BLOCK_HEADER_SIZE + point.Info.PayloadLength;
+        }
+        else
+        {
+            offset++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Seek
+//
+//  @brief: binary search on block end times
+//
+//------------------------------------------------------------------------------
+
+size_t
+TRLTBlockDecoder::Seek(const std::vector<TRLTSeekPoint>& index, INT64 timeUs)
+{
+    auto it = std::lower_bound(index.begin(), index.end(), timeUs,
+                               [](const TRLTSeekPoint& point, INT64 time)
+                               {
+                                   return point.Info.LastTimeUs < time;
+                               });
+
+    return (size_t)(it - index.begin());
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RLTCodec.h
+//
+//	Abstract:	Columnar Block Codec for Radio Link Test Samples
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef RLTCODEC_H
+#define RLTCODEC_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "RLTSample.h"
+#include <vector>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// block header: magic "RLTB", version, sample count, time range, payload
+// length, payload CRC16 and header CRC16 (all fields little endian)
+#define RLT_BLOCK_MAGIC             0x42544C52
+#define RLT_BLOCK_VERSION           1
+#define RLT_BLOCK_HEADER_SIZE       32
+
+// samples per block, every block is a seek point
+#define RLT_BLOCK_DEFAULT_SAMPLES   1024
+#define RLT_BLOCK_MAX_SAMPLES       65535
+
+//------------------------------------------------------------------------------
+//
+// Block Information
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    UINT16  NumSamples;
+    INT64   FirstTimeUs;
+    INT64   LastTimeUs;
+    UINT32  PayloadLength;
+}TRLTBlockInfo;
+
+typedef struct
+{
+    // byte offset of block header within the segment
+    UINT64          Offset;
+
+    // header content
+    TRLTBlockInfo   Info;
+}TRLTSeekPoint;
+
+//------------------------------------------------------------------------------
+//
+// TRLTBlockEncoder Class Declaration
+//
+// Block payload columns (each prefixed with its byte length as varint):
+//  - time:         gcd scale + delta-of-delta, Gorilla style bit buckets
+//  - test status:  XOR with previous value, bit packed
+//  - 4 counters:   delta, zigzag varint
+//  - 2 RSSI:       XOR with previous value, bit packed
+//  - 2 SNR:        XOR with previous value, bit packed
+//
+//------------------------------------------------------------------------------
+
+class TRLTBlockEncoder
+{
+    public:
+                    TRLTBlockEncoder(int blockSamples = RLT_BLOCK_DEFAULT_SAMPLES);
+
+    // add sample, returns true if the block is full and should be flushed
+    bool            Add(const TRLTSample& sample);
+
+    // number of pending samples
+    int             Count() const { return (int)Pending.size(); }
+
+    // encode pending samples as one block and append it to dst
+    bool            Flush(std::vector<UINT8>& dst);
+
+    // encode a sample range as one block, without touching pending samples
+    static bool     EncodeBlock(const TRLTSample* samples, int count, std::vector<UINT8>& dst);
+
+    private:
+
+    std::vector<TRLTSample> Pending;
+
+    int             BlockSamples;
+};
+
+//------------------------------------------------------------------------------
+//
+// TRLTBlockDecoder Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TRLTBlockDecoder
+{
+    public:
+
+    // verify and parse a block header
+    static bool     ReadHeader(const UINT8* data, size_t length, TRLTBlockInfo& info);
+
+    // decode one block, samples are appended, returns consumed bytes or 0
+    static size_t   DecodeBlock(const UINT8* data, size_t length, std::vector<TRLTSample>& samples);
+
+    // decode all valid blocks of a segment, corrupt bytes are skipped
+    static size_t   DecodeSegment(const UINT8* data, size_t length, std::vector<TRLTSample>& samples);
+
+    // collect seek points of all valid blocks in a segment
+    static void     BuildIndex(const UINT8* data, size_t length, std::vector<TRLTSeekPoint>& index);
+
+    // index of first block with samples at or after timeUs (index.size() if none)
+    static size_t   Seek(const std::vector<TRLTSeekPoint>& index, INT64 timeUs);
+};
+
+#endif // RLTCODEC_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
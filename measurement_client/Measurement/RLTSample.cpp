@@ -0,0 +1,354 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RLTSample.cpp
+//
+//	Abstract:	Timestamped Radio Link Test Sample and CSV Helpers
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "RLTSample.h"
+#include "../WiMODLR/CRC16.h"
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+//------------------------------------------------------------------------------
+//
+//  RLT_GetTimeUs
+//
+//  @brief: return current wall-clock time in microseconds
+//
+//------------------------------------------------------------------------------
+
+INT64
+RLT_GetTimeUs()
+{
+    auto now = std::chrono::system_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_GetMonotonicUs
+//
+//------------------------------------------------------------------------------
+
+INT64
+RLT_GetMonotonicUs()
+{
+    auto now = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_MonotonicToTimeUs
+//
+//------------------------------------------------------------------------------
+
+INT64
+RLT_MonotonicToTimeUs(INT64 monotonicUs)
+{
+    INT64 monotonic = RLT_GetMonotonicUs();
+    INT64 wall      = RLT_GetTimeUs();
+
+    return wall - (monotonic - monotonicUs);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_FormatTime
+//
+//  @brief: same format as TWiMODLRHCI::getCurrentDateTimeISO
+//
+//------------------------------------------------------------------------------
+
+std::string
+RLT_FormatTime(INT64 timeUs)
+{
+    std::time_t seconds = (std::time_t)(timeUs / 1000000);
+    int         millis  = (int)((timeUs / 1000) % 1000);
+
+    // negative times are not expected, keep the fraction positive anyway
+    if (millis < 0)
+    {
+        seconds -= 1;
+        millis  += 1000;
+    }
+
+    std::tm tm;
+    localtime_r(&seconds, &tm);
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%03d",
+                  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                  tm.tm_hour, tm.tm_min, tm.tm_sec, millis);
+
+    return std::string(buffer);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_ParseTime
+//
+//  @brief: parse "YYYY-MM-DDTHH:MM:SS.mmm" with optional "Z" or "+HH:MM"
+//
+//------------------------------------------------------------------------------
+
+bool
+RLT_ParseTime(const std::string& timeString, INT64& timeUs)
+{
+    std::tm tm = {};
+    int     fraction = 0;
+    int     consumed = 0;
+
+    if (std::sscanf(timeString.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d%n",
+                    &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &consumed) != 6)
+    {
+        return false;
+    }
+
+    const char* ptr = timeString.c_str() + consumed;
+
+    // optional fraction, scaled to microseconds
+    if (*ptr == '.')
+    {
+        int digits = 0;
+        ptr++;
+        while (*ptr >= '0' && *ptr <= '9')
+        {
+            if (digits < 6)
+            {
+                fraction = fraction * 10 + (*ptr - '0');
+                digits++;
+            }
+            ptr++;
+        }
+        while (digits++ < 6)
+            fraction *= 10;
+    }
+
+    tm.tm_year -= 1900;
+    tm.tm_mon  -= 1;
+
+    std::time_t seconds;
+
+    // optional UTC offset
+    if (*ptr == 'Z' || *ptr == '+' || *ptr == '-')
+    {
+        int offset = 0;
+        if (*ptr != 'Z')
+        {
+            int hours = 0, minutes = 0;
+            if (std::sscanf(ptr + 1, "%2d:%2d", &hours, &minutes) != 2)
+                return false;
+
+            offset = (hours * 60 + minutes) * 60;
+            if (*ptr == '-')
+                offset = -offset;
+        }
+        seconds = timegm(&tm) - offset;
+    }
+    else
+    {
+        // local time like getCurrentDateTimeISO
+        tm.tm_isdst = -1;
+        seconds = std::mktime(&tm);
+    }
+
+    timeUs = (INT64)seconds * 1000000 + fraction;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_FormatCsvRow
+//
+//  @brief: same column order as RLT_CSV_HEADER
+//
+//------------------------------------------------------------------------------
+
+std::string
+RLT_FormatCsvRow(const TRLTSample& sample)
+{
+    const TWiMODLR_RadioLinkTestStatus& data = sample.Status;
+
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), ",%u,%u,%u,%u,%d,%d,%d,%d",
+                  (unsigned)data.LTxCount, (unsigned)data.LRxCount,
+                  (unsigned)data.PTxCount, (unsigned)data.PRxCount,
+                  (int)data.LocalRSSI, (int)data.PeerRSSI,
+                  (int)data.LocalSNR, (int)data.PeerSNR);
+
+    if (sample.ConfigId)
+        return RLT_FormatTime(sample.TimeUs) + buffer + "," + std::to_string(sample.ConfigId);
+
+    return RLT_FormatTime(sample.TimeUs) + buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_ParseCsvRow
+//
+//  @brief: parse a data row written by RLT_FormatCsvRow / writeDataToFile
+//
+//------------------------------------------------------------------------------
+
+bool
+RLT_ParseCsvRow(const std::string& line, TRLTSample& sample)
+{
+    // skip empty lines and comments
+    if (line.empty() || line[0] == '#')
+        return false;
+
+    size_t comma = line.find(',');
+    if (comma == std::string::npos)
+        return false;
+
+    // header row fails here
+    if (!RLT_ParseTime(line.substr(0, comma), sample.TimeUs))
+        return false;
+
+    long        values[8];
+    const char* ptr = line.c_str() + comma;
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (*ptr != ',')
+            return false;
+
+        char* end;
+        values[i] = std::strtol(ptr + 1, &end, 10);
+        if (end == ptr + 1)
+            return false;
+
+        ptr = end;
+    }
+
+    TWiMODLR_RadioLinkTestStatus& data = sample.Status;
+
+    data.TestStatus = 0;
+    data.LTxCount   = (UINT32)values[0];
+    data.LRxCount   = (UINT32)values[1];
+    data.PTxCount   = (UINT32)values[2];
+    data.PRxCount   = (UINT32)values[3];
+    data.LocalRSSI  = (INT16)values[4];
+    data.PeerRSSI   = (INT16)values[5];
+    data.LocalSNR   = (INT8)values[6];
+    data.PeerSNR    = (INT8)values[7];
+
+    // optional configuration id of a sweep campaign
+    sample.ConfigId = *ptr == ',' ? (UINT16)std::strtol(ptr + 1, 0, 10) : 0;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_EncodeRecord
+//
+//------------------------------------------------------------------------------
+
+void
+RLT_EncodeRecord(const TRLTSample& sample, UINT8* dst)
+{
+    const TWiMODLR_RadioLinkTestStatus& data = sample.Status;
+
+    UINT8* ptr = dst;
+
+    HTON16(ptr, RLT_RECORD_MAGIC);                  ptr += 2;
+    *ptr++ = RLT_RECORD_VERSION;
+    *ptr++ = data.TestStatus;
+    HTON32(ptr, (UINT32)(UINT64)sample.TimeUs);     ptr += 4;
+    HTON32(ptr, (UINT32)((UINT64)sample.TimeUs >> 32)); ptr += 4;
+    HTON32(ptr, sample.MergedCount);                ptr += 4;
+    HTON32(ptr, data.LTxCount);                     ptr += 4;
+    HTON32(ptr, data.LRxCount);                     ptr += 4;
+    HTON32(ptr, data.PTxCount);                     ptr += 4;
+    HTON32(ptr, data.PRxCount);                     ptr += 4;
+    HTON16(ptr, (UINT16)data.LocalRSSI);            ptr += 2;
+    HTON16(ptr, (UINT16)data.PeerRSSI);             ptr += 2;
+    *ptr++ = (UINT8)data.LocalSNR;
+    *ptr++ = (UINT8)data.PeerSNR;
+
+    UINT16 crc16 = ~CRC16_Calc(dst, (UINT16)(ptr - dst), CRC16_INIT_VALUE);
+
+    HTON16(ptr, crc16);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_DecodeRecord
+//
+//------------------------------------------------------------------------------
+
+bool
+RLT_DecodeRecord(const UINT8* src, size_t length, TRLTSample& sample)
+{
+    if (length < RLT_RECORD_SIZE
+        || NTOH16(src) != RLT_RECORD_MAGIC
+        || src[2] != RLT_RECORD_VERSION
+        || !CRC16_Check((UINT8*)src, RLT_RECORD_SIZE, CRC16_INIT_VALUE))
+        return false;
+
+    TWiMODLR_RadioLinkTestStatus& data = sample.Status;
+
+    const UINT8* ptr = src + 3;
+
+    data.TestStatus     = *ptr++;
+    sample.TimeUs       = (INT64)((UINT64)NTOH32(ptr) | ((UINT64)NTOH32(ptr + 4) << 32)); ptr += 8;
+    sample.MergedCount  = NTOH32(ptr);          ptr += 4;
+    sample.FirstTimeUs  = 0;
+    sample.ConfigId     = 0;
+    data.LTxCount       = NTOH32(ptr);          ptr += 4;
+    data.LRxCount       = NTOH32(ptr);          ptr += 4;
+    data.PTxCount       = NTOH32(ptr);          ptr += 4;
+    data.PRxCount       = NTOH32(ptr);          ptr += 4;
+    data.LocalRSSI      = (INT16)NTOH16(ptr);   ptr += 2;
+    data.PeerRSSI       = (INT16)NTOH16(ptr);   ptr += 2;
+    data.LocalSNR       = (INT8)*ptr++;
+    data.PeerSNR        = (INT8)*ptr++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RLT_MergeSample
+//
+//  @brief: the summary keeps the time of its first indication and takes
+//          status and time of the newest one; the counters accumulate, so
+//          packet error rates remain exact over the coalesced interval
+//
+//------------------------------------------------------------------------------
+
+void
+RLT_MergeSample(TRLTSample& summary, const TRLTSample& sample)
+{
+    if (!summary.FirstTimeUs)
+        summary.FirstTimeUs = summary.TimeUs;
+
+    summary.TimeUs       = sample.TimeUs;
+    summary.Status       = sample.Status;
+    summary.ConfigId     = sample.ConfigId;
+    summary.MergedCount += sample.MergedCount;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RLTSample.h
+//
+//	Abstract:	Timestamped Radio Link Test Sample and CSV Helpers
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef RLTSAMPLE_H
+#define RLTSAMPLE_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include <string>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// CSV header line as written by the measurement client
+#define RLT_CSV_HEADER  "Time,Local Tx Count,Local Rx Count,Peer Tx Count,Peer Rx Count,"\
+                        "Local RSSI [dBm],Peer RSSI [dBm],Local SNR [dB],Peer SNR [dB]"
+
+// CSV header of a sweep campaign, rows end with the configuration id
+#define RLT_CSV_HEADER_CONFIG   RLT_CSV_HEADER ",Config"
+
+// fixed size binary record for streaming sinks: magic "RL", version, test
+// status, time, merged count, 4 counters, 2 RSSI, 2 SNR and CRC16 over the
+// preceding bytes (all fields little endian)
+#define RLT_RECORD_MAGIC    0x4C52
+#define RLT_RECORD_VERSION  1
+#define RLT_RECORD_SIZE     40
+
+//------------------------------------------------------------------------------
+//
+// Radio Link Test Sample
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    // host wall-clock time of reception [us since epoch]
+    INT64                           TimeUs = 0;
+
+    // status with accumulated packet counters
+    TWiMODLR_RadioLinkTestStatus    Status;
+
+    // number of indications represented, > 1 for a coalesced summary
+    UINT32                          MergedCount = 1;
+
+    // reception time of the first coalesced indication
+    INT64                           FirstTimeUs = 0;
+
+    // radio configuration of a sweep campaign (TSweepCampaign), 0 outside
+    // of campaigns; CSV only, binary records carry no configuration
+    UINT16                          ConfigId = 0;
+}TRLTSample;
+
+//------------------------------------------------------------------------------
+//
+// Helper Functions
+//
+//------------------------------------------------------------------------------
+
+// current wall-clock time [us since epoch]
+INT64           RLT_GetTimeUs();
+
+// current monotonic time [us], the clock of TWiMODLRHCI::GetRxTimeUs
+INT64           RLT_GetMonotonicUs();
+
+// wall-clock time of a monotonic time stamp, at the current difference of
+// the clocks
+INT64           RLT_MonotonicToTimeUs(INT64 monotonicUs);
+
+// convert time to local ISO 8601 string with milliseconds (CSV time column)
+std::string     RLT_FormatTime(INT64 timeUs);
+
+// convert local ISO 8601 string back to time, returns false on format error
+bool            RLT_ParseTime(const std::string& timeString, INT64& timeUs);
+
+// format one CSV data row (without line end), the configuration id is
+// appended as last column if set
+std::string     RLT_FormatCsvRow(const TRLTSample& sample);
+
+// parse one CSV data row, returns false for header, comments and bad rows
+bool            RLT_ParseCsvRow(const std::string& line, TRLTSample& sample);
+
+// encode sample as binary record, dst must hold RLT_RECORD_SIZE bytes
+void            RLT_EncodeRecord(const TRLTSample& sample, UINT8* dst);
+
+// decode and verify binary record, returns false on bad magic / CRC
+bool            RLT_DecodeRecord(const UINT8* src, size_t length, TRLTSample& sample);
+
+// fold sample into a summary (counters are accumulated, so the newest
+// status is kept), used by the coalescing sample queue
+void            RLT_MergeSample(TRLTSample& summary, const TRLTSample& sample);
+
+#endif // RLTSAMPLE_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
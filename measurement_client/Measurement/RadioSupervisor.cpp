@@ -0,0 +1,633 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RadioSupervisor.cpp
+//
+//	Abstract:	Stall Detection and Recovery of the Radio Link Test
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "RadioSupervisor.h"
+#include "RLTSample.h"
+#include "Airtime.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+//------------------------------------------------------------------------------
+//
+//  TRadioSupervisor - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TRadioSupervisor::TRadioSupervisor(TWiMODLRHCI& hci, TSampleFanout& fanout)
+    : HCI(hci),
+      Fanout(fanout)
+{
+    Backend         = 0;
+    Reader          = 0;
+    Test            = TWiMODLR_RadioLinkTestConfig();
+    Enabled         = false;
+    FirstSample     = false;
+    Radio           = TWiMODLR_RadioConfig();
+    HasRadio        = false;
+    State           = SUPERVISOR_RUNNING;
+    MeanIntervalMs  = 0;
+    LastSampleUs    = 0;
+    GapStartUs      = 0;
+    LastLTxCount    = 0;
+    SameLTxCount    = 0;
+    StallPending    = false;
+    SkipInterval    = false;
+    DevicePresent   = true;
+    Replugged       = false;
+    RetryMs         = 0;
+    Stats           = TSupervisorStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//  @brief: supervise the test the caller starts next
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::Start(const std::string& comPort, const TWiMODLR_RadioLinkTestConfig& test,
+                        const TSupervisorConfig& config)
+{
+    ComPort         = comPort;
+    Test            = test;
+    Config          = config;
+    Enabled         = true;
+    State           = SUPERVISOR_RUNNING;
+    StartTime       = TClock::now();
+    FirstSample     = false;
+    LastIndication  = StartTime;
+    MeanIntervalMs  = 0;
+    SameLTxCount    = 0;
+    StallPending    = false;
+    RetryMs         = Config.RetryMinMs;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetEventBackend
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::SetEventBackend(TEventBackend* backend, THCIReader* reader)
+{
+    // attached by the caller
+    Backend  = backend;
+    Reader   = reader;
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TRadioSupervisor::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "stalls=" << Stats.Stalls
+         << " recoveries=" << Stats.Recoveries
+         << " attempts=" << Stats.Attempts
+         << " handshake failures=" << Stats.HandshakeFailures
+         << " reopens=" << Stats.Reopens
+         << " mttr=" << (Stats.Recoveries ? Stats.TotalRecoveryMs / Stats.Recoveries : 0) << " ms"
+         << " max=" << Stats.MaxRecoveryMs << " ms";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLinkTest_StatusInd
+//
+//  @brief: track indication rate and Tx progress, complete a recovery with
+//          the first indication of the restarted test
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status)
+{
+    if (!Enabled)
+    {
+        Fanout.evRadioLinkTest_StatusInd(status);
+        return;
+    }
+
+    TClock::time_point now = TClock::now();
+    INT64 nowUs = RLT_GetTimeUs();
+
+    if (!FirstSample)
+    {
+        FirstSample         = true;
+        Stats.FirstSampleMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - StartTime).count();
+
+        std::cout << "First sample after " << Stats.FirstSampleMs << " ms" << std::endl;
+    }
+
+    if (State == SUPERVISOR_RUNNING && LastSampleUs && !SkipInterval)
+    {
+        // mean indication interval, only while the test runs undisturbed
+        double interval = std::chrono::duration<double, std::milli>(now - LastIndication).count();
+
+        MeanIntervalMs = MeanIntervalMs > 0 ? 0.875 * MeanIntervalMs + 0.125 * interval : interval;
+    }
+
+    if (State == SUPERVISOR_RESTARTED)
+    {
+        UINT64 recoveryMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - DetectTime).count();
+
+        Stats.Recoveries++;
+        Stats.TotalRecoveryMs += recoveryMs;
+        Stats.LastRecoveryMs   = recoveryMs;
+        Stats.MaxRecoveryMs    = std::max(Stats.MaxRecoveryMs, recoveryMs);
+
+        // gap marker, written by every sink before the first new sample
+        std::ostringstream gap;
+        gap << "gap " << RLT_FormatTime(GapStartUs) << " - " << RLT_FormatTime(nowUs)
+            << " reason=" << Reason << " actions=" << Actions << " recovery=" << recoveryMs << " ms";
+
+        Fanout.PublishComment(gap.str());
+
+        std::cout << "Radio link test recovered: " << gap.str() << std::endl;
+
+        State        = SUPERVISOR_RUNNING;
+        SameLTxCount = 0;
+        RetryMs      = Config.RetryMinMs;
+    }
+    else if (State == SUPERVISOR_RUNNING && LastSampleUs)
+    {
+        // indications arrive, but the module no longer transmits
+        SameLTxCount = status.LTxCount == LastLTxCount ? SameLTxCount + 1 : 0;
+
+        if (Config.StallIndications && SameLTxCount >= Config.StallIndications)
+            StallPending = true;
+    }
+
+    LastIndication = now;
+    LastSampleUs   = nowUs;
+    LastLTxCount   = status.LTxCount;
+    SkipInterval   = false;
+
+    Fanout.evRadioLinkTest_StatusInd(status);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evDeviceAdded
+//
+//  @brief: (re)plugged adapter, reopened with the next Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::evDeviceAdded(const std::string& port)
+{
+    if (!Enabled || !Config.AutoRecover)
+        return;
+
+    ComPort       = port;
+    DevicePresent = true;
+    Replugged     = true;
+
+    // next attempt right away
+    NextAttempt   = TClock::now();
+    RetryMs       = Config.RetryMinMs;
+}
+
+//------------------------------------------------------------------------------
+//
+//  evDeviceRemoved
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::evDeviceRemoved(const std::string& port)
+{
+    if (Enabled && port == ComPort)
+        DevicePresent = false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::Poll()
+{
+    if (!Enabled || !Config.AutoRecover)
+        return;
+
+    TClock::time_point now = TClock::now();
+
+    if (State == SUPERVISOR_RUNNING)
+    {
+        if (!DevicePresent)
+            Detect("removed");
+        else if (Replugged)
+            Detect("replugged");
+        else if (Reader && Reader->IsClosed())
+            Detect("hangup");
+        else if (StallPending)
+            Detect("ltx-stalled");
+        else if (now - LastIndication > std::chrono::milliseconds(GetTimeoutMs()))
+            Detect("no-indication");
+
+        // first attempt right away
+        if (State == SUPERVISOR_RUNNING)
+            return;
+    }
+
+    if (State == SUPERVISOR_RESTARTED)
+    {
+        // restarted test does not report either, or the adapter was replaced
+        if (now - RestartTime <= std::chrono::milliseconds(GetTimeoutMs())
+            && !(Reader && Reader->IsClosed()) && DevicePresent && !Replugged)
+            return;
+
+        State       = SUPERVISOR_RECOVERING;
+        NextAttempt = now;
+    }
+
+    if (TClock::now() < NextAttempt)
+        return;
+
+    if (Recover())
+    {
+        RestartTime = TClock::now();
+        return;
+    }
+
+    // exponential backoff between failed attempts
+    NextAttempt = TClock::now() + std::chrono::milliseconds(RetryMs);
+    RetryMs     = std::min(2 * RetryMs, Config.RetryMaxMs);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reconfigure
+//
+//  @brief: during a recovery the configuration is applied with the restart
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Reconfigure(const TWiMODLR_RadioConfig& radio, const std::vector<UINT8>& announce, UINT32 repeats)
+{
+    TWiMODLR_RadioConfig current = Radio;
+    bool                 known   = HasRadio;
+
+    Radio    = radio;
+    HasRadio = true;
+
+    if (State == SUPERVISOR_RECOVERING)
+        return true;
+
+    Detach();
+
+    UINT8 status = 0;
+
+    bool result = HCI.PrepareRadioLinkTest(status, Config.ReadyTimeoutMs) == WiMODLR_RESULT_OK;
+
+    // the time on air of the announcement depends on the configuration in use
+    if (result && repeats && !announce.empty())
+    {
+        if (!known && (HCI.GetRadioConfiguration(current, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK))
+            current = radio;
+
+        // announced at the higher power of both configurations, a switch
+        // to more power is often due to a link at its edge
+        if (radio.PowerLevel > current.PowerLevel)
+        {
+            current.PowerLevel = radio.PowerLevel;
+
+            if (HCI.SetRadioConfiguration(current, WiMODLR_STORE_INTO_RAM, status) != WiMODLR_RESULT_OK)
+                std::cerr << "Warning: Announcement power not applied" << std::endl;
+        }
+
+        if (!Announce(current, announce, repeats))
+            std::cerr << "Warning: Announcement not sent" << std::endl;
+    }
+
+    result = result && Configure();
+
+    if (result)
+    {
+        HCI.ResetRadioLinkTestBaseline();
+
+        result = HCI.StartRadioLinkTest(Test, status) == WiMODLR_RESULT_OK && status == RLT_STATUS_OK;
+    }
+
+    result = Attach() && result;
+
+    // stopped on purpose, the indication rate depends on the radio
+    // configuration and is learned again
+    LastIndication = TClock::now();
+    MeanIntervalMs = 0;
+    SkipInterval   = true;
+    SameLTxCount   = 0;
+    StallPending   = false;
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Announce
+//
+//  @brief: unreliable radio messages to the peer of the test, each one is
+//          on air before the next request (the configuration must not
+//          change while one is queued)
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Announce(const TWiMODLR_RadioConfig& current, const std::vector<UINT8>& data, UINT32 repeats)
+{
+    std::vector<UINT8> message(DATALINK_RADIO_HEADER_SIZE + data.size());
+
+    message[0] = Test.GroupAddress;
+    HTON16(&message[1], Test.DeviceAddress);
+    std::copy(data.begin(), data.end(), message.begin() + DATALINK_RADIO_HEADER_SIZE);
+
+    UINT64 airtimeNs = AIRTIME_GetTimeOnAirNs(current, (UINT8)std::min<size_t>(255, data.size() + DATALINK_MSG_HEADER_SIZE));
+
+    UINT32 sent = 0;
+
+    for (UINT32 i = 0; i < repeats; i++)
+    {
+        UINT8 status = 0;
+
+        if (HCI.SendURadioMessage(message.data(), (UINT16)message.size(), status) == WiMODLR_RESULT_OK
+            && status == DATALINK_STATUS_OK)
+            sent++;
+
+        std::this_thread::sleep_for(std::chrono::nanoseconds(airtimeNs) + std::chrono::milliseconds(SUPERVISOR_ANNOUNCE_GUARD_MS));
+    }
+
+    return sent > 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::Stop()
+{
+    Enabled = false;
+
+    Detach();
+
+    UINT8 status;
+    HCI.StopRadioLinkTest(status);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetTimeoutMs
+//
+//  @brief: multiple of the mean indication interval, max. until known
+//
+//------------------------------------------------------------------------------
+
+UINT32
+TRadioSupervisor::GetTimeoutMs() const
+{
+    if (MeanIntervalMs <= 0)
+        return Config.MaxTimeoutMs;
+
+    double timeout = SUPERVISOR_STALL_INTERVALS * MeanIntervalMs;
+
+    return (UINT32)std::clamp<double>(timeout, Config.MinTimeoutMs, Config.MaxTimeoutMs);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Detect
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::Detect(const std::string& reason)
+{
+    Stats.Stalls++;
+
+    State        = SUPERVISOR_RECOVERING;
+    GapStartUs   = LastSampleUs;
+    Reason       = reason;
+    Actions.clear();
+    DetectTime   = TClock::now();
+    NextAttempt  = DetectTime;
+    RetryMs      = Config.RetryMinMs;
+    StallPending = false;
+    SameLTxCount = 0;
+
+    std::cout << "Radio link test stalled: " << reason << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Recover
+//
+//  @brief: readiness handshake, reopen if the module does not answer,
+//          restart the test
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Recover()
+{
+    Stats.Attempts++;
+
+    // the HCI reads itself while waiting for responses
+    Detach();
+
+    bool hangup = Reader && Reader->IsClosed();
+
+    // the adapter is gone, release the port until the watcher reports it
+    if (!DevicePresent)
+    {
+        HCI.Close();
+        return false;
+    }
+
+    // no handshake through a dead handle, the handshake also stops a
+    // stuck test
+    if (hangup || Replugged || !Handshake())
+    {
+        if (!Reopen() || !Handshake())
+            return false;
+    }
+
+    if (!Configure())
+        return false;
+
+    UINT8 status = 0;
+
+    HCI.ResetRadioLinkTestBaseline();
+
+    AddAction("restart");
+
+    // the first indication may arrive together with the start response
+    State = SUPERVISOR_RESTARTED;
+
+    if (HCI.StartRadioLinkTest(Test, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+    {
+        State = SUPERVISOR_RECOVERING;
+        return false;
+    }
+
+    Stats.Restarts++;
+
+    if (!Attach())
+    {
+        State = SUPERVISOR_RECOVERING;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Handshake
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Handshake()
+{
+    AddAction("handshake");
+
+    UINT8 status;
+
+    if (HCI.PrepareRadioLinkTest(status, Config.ReadyTimeoutMs) == WiMODLR_RESULT_OK)
+        return true;
+
+    Stats.HandshakeFailures++;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//  @brief: apply the radio configuration of Reconfigure (RAM, no flash wear)
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Configure()
+{
+    if (!HasRadio)
+        return true;
+
+    if (State != SUPERVISOR_RUNNING)
+        AddAction("configure");
+
+    UINT8 status = 0;
+
+    return HCI.SetRadioConfiguration(Radio, WiMODLR_STORE_INTO_RAM, status) == WiMODLR_RESULT_OK
+           && status == DEVMGMT_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reopen
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Reopen()
+{
+    AddAction("reopen");
+
+    Stats.Reopens++;
+
+    HCI.Close();
+
+    // Open takes a non-const reference
+    std::string comPort = ComPort;
+    if (!HCI.Open(comPort))
+        return false;
+
+    if (Reader)
+        Reader->Reset();
+
+    Replugged = false;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddAction
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::AddAction(const char* action)
+{
+    if (Actions.find(action) == std::string::npos)
+        Actions += Actions.empty() ? action : std::string(",") + action;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Detach
+//
+//------------------------------------------------------------------------------
+
+void
+TRadioSupervisor::Detach()
+{
+    if (Reader)
+        Reader->Detach();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Attach
+//
+//------------------------------------------------------------------------------
+
+bool
+TRadioSupervisor::Attach()
+{
+    if (!Backend || !Reader || Reader->IsAttached())
+        return true;
+
+    return Reader->Attach(*Backend);
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RadioSupervisor.h
+//
+//	Abstract:	Stall Detection and Recovery of the Radio Link Test
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef RADIOSUPERVISOR_H
+#define RADIOSUPERVISOR_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "SampleFanout.h"
+#include "EventBackend.h"
+#include "HCIReader.h"
+#include "DeviceWatcher.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// a stall is detected after this many mean indication intervals without
+// an indication, bounded by the configured min. / max. timeout
+#define SUPERVISOR_STALL_INTERVALS  8
+
+// pause after the time on air of an announcement [ms]
+#define SUPERVISOR_ANNOUNCE_GUARD_MS    10
+
+typedef struct
+{
+    // false: only report the time to the first sample
+    bool            AutoRecover         = true;
+
+    // bounds of the adaptive detection timeout [ms]
+    UINT32          MinTimeoutMs        = 2000;
+    UINT32          MaxTimeoutMs        = 30000;
+
+    // indications in a row without advancing local Tx counter
+    UINT32          StallIndications    = 10;
+
+    // readiness handshake before the port is reopened [ms]
+    UINT32          ReadyTimeoutMs      = 2000;
+
+    // delay between failed recovery attempts, doubled up to the max. [ms]
+    UINT32          RetryMinMs          = 200;
+    UINT32          RetryMaxMs          = 10000;
+}TSupervisorConfig;
+
+typedef struct
+{
+    UINT64  Stalls;
+    UINT64  Recoveries;
+    UINT64  Attempts;
+    UINT64  HandshakeFailures;
+    UINT64  Reopens;
+    UINT64  Restarts;
+
+    // Start until the first indication [ms]
+    UINT64  FirstSampleMs;
+
+    // detection until the first indication of the restarted test [ms]
+    UINT64  TotalRecoveryMs;
+    UINT64  MaxRecoveryMs;
+    UINT64  LastRecoveryMs;
+}TSupervisorStats;
+
+//------------------------------------------------------------------------------
+//
+// TRadioSupervisor Class Declaration
+//
+// Registered as HCI client in front of the fan-out. A stall is a missing
+// status indication (timeout adapts to the observed indication rate), a
+// local Tx counter which no longer advances or a hangup of the serial port.
+// Recovery: readiness handshake (TWiMODLRHCI::PrepareRadioLinkTest), reopen
+// the serial port if the module does not answer (or hung up), then restart
+// the radio link test with its original configuration and the radio
+// configuration of the last Reconfigure; failed attempts are repeated with
+// an increasing delay. The accumulated counters continue across the restart
+// and a "# gap <last sample> - <first new sample> reason=.. actions=..
+// recovery=.. ms" marker is written to the sinks before the first new
+// sample.
+//
+// Registered at a TDeviceWatcher, a removed adapter is detected at once and
+// a replugged one is reopened as soon as its port reappears, possibly under
+// a new name.
+//
+// Poll runs the recovery and must be called from the thread which drives
+// the HCI (main loop).
+//
+//------------------------------------------------------------------------------
+
+class TRadioSupervisor : public TWiMODLRHCIClient, public TDeviceWatcherClient
+{
+    public:
+                    TRadioSupervisor(TWiMODLRHCI& hci, TSampleFanout& fanout);
+
+    // port to reopen and test to restart, called before the caller starts
+    // the test: the time to the first sample is counted from here
+    void            Start(const std::string& comPort, const TWiMODLR_RadioLinkTestConfig& test,
+                          const TSupervisorConfig& config = TSupervisorConfig());
+
+    // serial reads through an event backend: the reader is detached while
+    // the supervisor talks to the module and reattached after a reopen
+    void            SetEventBackend(TEventBackend* backend, THCIReader* reader);
+
+    // check for stalls and run due recovery attempts
+    void            Poll();
+
+    // stop the test, apply the radio configuration (RAM) and restart the
+    // test; applied again by every later recovery, a module reset falls
+    // back to the configuration in NVM. An announcement is sent repeats
+    // times to the peer of the test with the old configuration (at the
+    // higher power of both) before the new one is applied (not during a
+    // recovery).
+    bool            Reconfigure(const TWiMODLR_RadioConfig& radio,
+                                const std::vector<UINT8>& announce = std::vector<UINT8>(), UINT32 repeats = 0);
+
+    // stop supervision and the test
+    void            Stop();
+
+    bool            IsRecovering() const { return State != SUPERVISOR_RUNNING; }
+
+    TSupervisorStats    GetStats() const { return Stats; }
+
+    // test given to Start
+    const TWiMODLR_RadioLinkTestConfig&  GetTestConfig() const { return Test; }
+
+    // "stalls=.. recoveries=.. mttr=.. ms ..."
+    std::string     FormatStats() const;
+
+    // HCI client interface, indications are forwarded to the fan-out
+    void            evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override;
+
+    // device watcher interface
+    void            evDeviceAdded(const std::string& port) override;
+    void            evDeviceRemoved(const std::string& port) override;
+
+    private:
+
+    typedef enum
+    {
+        SUPERVISOR_RUNNING = 0,
+        // recovery attempts until the test is restarted
+        SUPERVISOR_RECOVERING,
+        // restarted, waiting for the first indication
+        SUPERVISOR_RESTARTED
+    }TState;
+
+    typedef std::chrono::steady_clock TClock;
+
+    UINT32          GetTimeoutMs() const;
+    void            Detect(const std::string& reason);
+    bool            Recover();
+    bool            Handshake();
+    bool            Configure();
+    bool            Announce(const TWiMODLR_RadioConfig& current, const std::vector<UINT8>& data, UINT32 repeats);
+    bool            Reopen();
+    void            AddAction(const char* action);
+    void            Detach();
+    bool            Attach();
+
+    TWiMODLRHCI&        HCI;
+    TSampleFanout&      Fanout;
+    TEventBackend*      Backend;
+    THCIReader*         Reader;
+
+    std::string                     ComPort;
+    TWiMODLR_RadioLinkTestConfig    Test;
+    TSupervisorConfig               Config;
+    bool                            Enabled;
+    TClock::time_point              StartTime;
+    bool                            FirstSample;
+
+    // radio configuration set by Reconfigure
+    TWiMODLR_RadioConfig            Radio;
+    bool                            HasRadio;
+
+    // adapter state reported by the device watcher
+    bool                DevicePresent;
+    bool                Replugged;
+
+    TState              State;
+    std::string         Reason;
+    std::string         Actions;
+
+    // last indication, mean interval between indications [ms]
+    TClock::time_point  LastIndication;
+    double              MeanIntervalMs;
+    INT64               LastSampleUs;
+    UINT32              LastLTxCount;
+    UINT32              SameLTxCount;
+    bool                StallPending;
+
+    // no interval across a reconfiguration
+    bool                SkipInterval;
+
+    // last sample before the stall
+    INT64               GapStartUs;
+    TClock::time_point  DetectTime;
+    TClock::time_point  NextAttempt;
+    TClock::time_point  RestartTime;
+    UINT32              RetryMs;
+
+    TSupervisorStats    Stats;
+};
+
+#endif // RADIOSUPERVISOR_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
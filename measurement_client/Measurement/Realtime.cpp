@@ -0,0 +1,404 @@
+//------------------------------------------------------------------------------
+//
+//	File:		Realtime.cpp
+//
+//	Abstract:	Real-Time Mode of the Serial Reader and Wakeup Jitter Probe
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "Realtime.h"
+#include "RLTSample.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+//
+//  Section Helper Functions
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  RT_GetIsolatedCpu
+//
+//  @brief: list format of the kernel, e.g. "2-3" or "1,3"
+//
+//------------------------------------------------------------------------------
+
+int
+RT_GetIsolatedCpu()
+{
+    std::ifstream file("/sys/devices/system/cpu/isolated");
+    int           cpu = -1;
+
+    if (file >> cpu && cpu >= 0)
+        return cpu;
+
+    return std::max(0, (int)std::thread::hardware_concurrency() - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+//  RT_SetThread
+//
+//------------------------------------------------------------------------------
+
+bool
+RT_SetThread(int cpu, int priority)
+{
+    bool result = true;
+
+    if (cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+
+        int error = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+        if (error)
+        {
+            std::cerr << "Warning: Could not pin thread to core " << cpu << ": " << std::strerror(error) << std::endl;
+            result = false;
+        }
+    }
+
+    if (priority > 0)
+    {
+        struct sched_param param = sched_param();
+        param.sched_priority = std::clamp(priority, ::sched_get_priority_min(SCHED_FIFO),
+                                          ::sched_get_priority_max(SCHED_FIFO));
+
+        int error = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param);
+        if (error)
+        {
+            std::cerr << "Warning: Could not set SCHED_FIFO priority " << param.sched_priority << ": "
+                      << std::strerror(error) << std::endl;
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrefaultStack
+//
+//  @brief: touch every page of the next stack KiB, they stay mapped (and
+//          locked) after the return
+//
+//------------------------------------------------------------------------------
+
+static void __attribute__((noinline))
+PrefaultStack(UINT32 kib)
+{
+    volatile UINT8* stack = (volatile UINT8*)alloca(kib * 1024);
+    long            page  = ::sysconf(_SC_PAGESIZE);
+
+    for (UINT32 i = 0; i < kib * 1024; i += page)
+        stack[i] = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrefaultHeap
+//
+//  @brief: the heap is neither trimmed nor are large blocks mapped of their
+//          own, so the touched pages are reused by later allocations
+//          instead of being faulted in from the loop
+//
+//------------------------------------------------------------------------------
+
+static bool
+PrefaultHeap(UINT32 kib)
+{
+    if (!::mallopt(M_TRIM_THRESHOLD, -1) || !::mallopt(M_MMAP_MAX, 0))
+        return false;
+
+    UINT8* heap = (UINT8*)std::malloc(kib * 1024);
+    if (!heap)
+        return false;
+
+    long page = ::sysconf(_SC_PAGESIZE);
+
+    for (UINT32 i = 0; i < kib * 1024; i += page)
+        ((volatile UINT8*)heap)[i] = 0;
+
+    std::free(heap);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RT_Enter
+//
+//  @brief: the memory is locked on fault where available, so the stacks of
+//          the other threads are not locked in full
+//
+//------------------------------------------------------------------------------
+
+bool
+RT_Enter(const TRealtimeConfig& config)
+{
+    bool result = RT_SetThread(config.Cpu, config.Priority);
+
+    if (config.LockMemory)
+    {
+#ifdef MCL_ONFAULT
+        int flags = MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT;
+#else
+        int flags = MCL_CURRENT | MCL_FUTURE;
+#endif
+        if (::mlockall(flags) < 0)
+        {
+            std::cerr << "Warning: Could not lock memory: " << std::strerror(errno) << std::endl;
+            result = false;
+        }
+
+        PrefaultStack(config.PrefaultStackKiB);
+
+        if (!PrefaultHeap(config.PrefaultHeapKiB))
+        {
+            std::cerr << "Warning: Could not prefault " << config.PrefaultHeapKiB << " KiB heap" << std::endl;
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RT_FormatConfig
+//
+//------------------------------------------------------------------------------
+
+std::string
+RT_FormatConfig(const TRealtimeConfig& config)
+{
+    std::ostringstream text;
+
+    text << "cpu=";
+    if (config.Cpu >= 0)
+        text << config.Cpu;
+    else
+        text << "any";
+
+    text << " fifo=" << config.Priority
+         << " mlock=" << (config.LockMemory ? "on" : "off");
+
+    if (config.LockMemory)
+        text << " prefault=" << config.PrefaultStackKiB << "/" << config.PrefaultHeapKiB << " KiB";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Section TJitterProbe
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  TJitterProbe - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TJitterProbe::TJitterProbe(TSampleFanout* fanout)
+    : Fanout(fanout)
+    , Running(false)
+    , Overruns(0)
+    , ReportUs(0)
+{
+}
+
+//------------------------------------------------------------------------------
+//
+//  TJitterProbe - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TJitterProbe::~TJitterProbe()
+{
+    Stop();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TJitterProbe::Start(const TRealtimeConfig& config)
+{
+    if (Running || !config.JitterIntervalUs)
+        return false;
+
+    Config = config;
+
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        Interval.Reset();
+        Total.Reset();
+    }
+
+    Overruns = 0;
+    ReportUs = RLT_GetMonotonicUs() + Config.ReportS * 1000000ll;
+    Running  = true;
+    Thread   = std::thread(&TJitterProbe::Run, this);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//  @brief: returns within one wakeup period
+//
+//------------------------------------------------------------------------------
+
+void
+TJitterProbe::Stop()
+{
+    Running = false;
+
+    if (Thread.joinable())
+        Thread.join();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TJitterProbe::Poll()
+{
+    if (!Running || !Config.ReportS)
+        return;
+
+    INT64 now = RLT_GetMonotonicUs();
+
+    if (now < ReportUs)
+        return;
+
+    ReportUs = now + Config.ReportS * 1000000ll;
+
+    std::string text = "jitter period=" + std::to_string(Config.JitterIntervalUs) + " us "
+                       + TakeInterval().Summary() + " overruns=" + std::to_string(Overruns);
+
+    std::cout << "Realtime: " << text << std::endl;
+
+    if (Fanout)
+        Fanout->PublishComment(text);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetTotal
+//
+//------------------------------------------------------------------------------
+
+TLatencyHistogram
+TJitterProbe::GetTotal() const
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    return Total;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TakeInterval
+//
+//------------------------------------------------------------------------------
+
+TLatencyHistogram
+TJitterProbe::TakeInterval()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    TLatencyHistogram interval = Interval;
+
+    Interval.Reset();
+    return interval;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: absolute wakeup times, a late wakeup does not shift the later
+//          ones; after a delay of a whole period the missed periods are
+//          skipped and counted
+//
+//------------------------------------------------------------------------------
+
+void
+TJitterProbe::Run()
+{
+    RT_SetThread(Config.Cpu, Config.Priority ? std::min(Config.Priority + 1, 99) : 0);
+
+    INT64           periodNs = Config.JitterIntervalUs * 1000ll;
+    struct timespec next;
+
+    ::clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (Running)
+    {
+        INT64 nextNs = next.tv_sec * 1000000000ll + next.tv_nsec + periodNs;
+
+        next.tv_sec  = nextNs / 1000000000ll;
+        next.tv_nsec = nextNs % 1000000000ll;
+
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, 0) == EINTR)
+            ;
+
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        INT64 delayNs = (now.tv_sec * 1000000000ll + now.tv_nsec) - nextNs;
+
+        {
+            std::lock_guard<std::mutex> lock(Lock);
+
+            Interval.Add((UINT64)std::max<INT64>(0, delayNs / 1000));
+            Total.Add((UINT64)std::max<INT64>(0, delayNs / 1000));
+        }
+
+        if (delayNs >= periodNs)
+        {
+            Overruns += delayNs / periodNs;
+            next      = now;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
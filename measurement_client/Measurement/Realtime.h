@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//
+//	File:		Realtime.h
+//
+//	Abstract:	Real-Time Mode of the Serial Reader and Wakeup Jitter Probe
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include "LatencyHistogram.h"
+#include "SampleFanout.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+// Real-time mode applies to the serial reader only: right before its loop
+// the reading thread pins itself to an isolated core (isolcpus=), switches
+// to SCHED_FIFO below the threaded interrupt handlers and prefaults its
+// stack and heap. Memory is locked with MCL_ONFAULT, so the stacks of the
+// other threads are not locked in full; sink and publisher threads keep the
+// default scheduling. The reader must sleep in an event backend, the legacy
+// loops poll the serial port and would never give the core away. Steps
+// that need root or CAP_SYS_NICE / CAP_IPC_LOCK and are not permitted are
+// reported as warnings, the measurement goes on.
+//
+//------------------------------------------------------------------------------
+
+// SCHED_FIFO priority of the reader, below the threaded interrupt handlers
+// (50) which deliver the serial data
+#define RT_DEFAULT_PRIORITY     49
+
+// wakeup period of the jitter probe in real-time mode [us]
+#define RT_DEFAULT_JITTER_US    1000
+
+typedef struct
+{
+    // core of the serial reader, -1 keeps the affinity
+    int             Cpu                 = -1;
+
+    // SCHED_FIFO priority (1..99), 0 keeps SCHED_OTHER
+    int             Priority            = 0;
+
+    // lock pages of the process as they are touched, prefault the stack and
+    // heap of the reader before the loop [KiB]
+    bool            LockMemory          = false;
+    UINT32          PrefaultStackKiB    = 256;
+    UINT32          PrefaultHeapKiB     = 8192;
+
+    // wakeup period of the jitter probe, 0 = off [us]
+    UINT32          JitterIntervalUs    = 0;
+
+    // jitter of the last interval as comment to the sinks [s]
+    UINT32          ReportS             = 60;
+}TRealtimeConfig;
+
+//------------------------------------------------------------------------------
+//
+// Helper Functions
+//
+//------------------------------------------------------------------------------
+
+// first core of /sys/devices/system/cpu/isolated (isolcpus=), the last
+// core without
+int             RT_GetIsolatedCpu();
+
+// core and scheduling class of the calling thread, -1 / 0 keep them
+bool            RT_SetThread(int cpu, int priority);
+
+// calling thread to the configured core and priority, memory locked and
+// prefaulted; every step is tried, false if one of them failed (reported)
+bool            RT_Enter(const TRealtimeConfig& config);
+
+// "cpu=.. fifo=.. mlock=.." as set by the configuration
+std::string     RT_FormatConfig(const TRealtimeConfig& config);
+
+//------------------------------------------------------------------------------
+//
+// TJitterProbe Class Declaration
+//
+// Thread sleeping to absolute wakeup times every JitterIntervalUs on the
+// core of the reader, one priority above it, like cyclictest: the delay of
+// each wakeup is the scheduling latency a status indication sees on its way
+// to the reader, without the work of the reader itself. The delays of the
+// last ReportS go to the sinks as "# jitter ..." comment, next to the
+// samples they disturb. Without real-time mode the probe runs as a normal
+// thread and measures the noise of the default scheduling.
+//
+//------------------------------------------------------------------------------
+
+class TJitterProbe
+{
+    public:
+                    TJitterProbe(TSampleFanout* fanout = 0);
+                    ~TJitterProbe();
+
+    bool            Start(const TRealtimeConfig& config);
+    void            Stop();
+    bool            IsRunning() const { return Running; }
+
+    // report when due, from the main loop
+    void            Poll();
+
+    // wakeup delays since the start [us]
+    TLatencyHistogram   GetTotal() const;
+
+    // wakeup delays since the last call, next interval starts empty [us]
+    TLatencyHistogram   TakeInterval();
+
+    // periods skipped because a wakeup was later than a whole period
+    UINT64          GetOverruns() const { return Overruns; }
+
+    private:
+
+    void            Run();
+
+    TSampleFanout*      Fanout;
+    TRealtimeConfig     Config;
+
+    std::thread         Thread;
+    std::atomic<bool>   Running;
+    std::atomic<UINT64> Overruns;
+
+    mutable std::mutex  Lock;
+    TLatencyHistogram   Interval;
+    TLatencyHistogram   Total;
+
+    // monotonic time of the next report [us]
+    INT64               ReportUs;
+};
+
+#endif // REALTIME_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
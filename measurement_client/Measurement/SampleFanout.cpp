@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleFanout.cpp
+//
+//	Abstract:	Distribution of Radio Link Test Samples to multiple Sinks
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleFanout.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+//
+//  TSampleFanout - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TSampleFanout::TSampleFanout()
+{
+    for (int i = 0; i < SAMPLE_FORMAT_NUM; i++)
+        UsedFormats[i] = false;
+
+    Running      = false;
+    ConfigId     = 0;
+    ReceiveClock = 0;
+    LastReport   = std::chrono::steady_clock::now();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TSampleFanout - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TSampleFanout::~TSampleFanout()
+{
+    Stop();
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddSink
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleFanout::AddSink(TSampleSink& sink, UINT32 capacity, TQueuePolicy policy, UINT32 coalesceMs)
+{
+    if (Running)
+        return false;
+
+    Queues.emplace_back(new TSampleQueue(sink, capacity, policy, coalesceMs));
+    LastStats.push_back(TSinkStats());
+
+    UsedFormats[sink.GetFormat()] = true;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleFanout::Start()
+{
+    if (Running)
+        return false;
+
+    for (auto& queue : Queues)
+        queue->Start();
+
+    Running    = true;
+    LastReport = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleFanout::Stop()
+{
+    if (!Running)
+        return;
+
+    for (auto& queue : Queues)
+        queue->Stop();
+
+    Running = false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrintStats
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleFanout::PrintStats()
+{
+    auto   now     = std::chrono::steady_clock::now();
+    double seconds = std::max(1e-3, std::chrono::duration<double>(now - LastReport).count());
+
+    LastReport = now;
+
+    for (size_t i = 0; i < Queues.size(); i++)
+    {
+        TSampleQueue& queue = *Queues[i];
+        TSinkStats    stats = queue.GetSinkStats();
+        TSinkStats&   last  = LastStats[i];
+
+        UINT64 samples = stats.Samples - last.Samples;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Sink " << queue.GetSink().GetName() << ":"
+                  << " " << samples / seconds << " samples/s";
+
+        // encoded bytes are not known for sinks encoding themselves
+        if (queue.GetSink().GetFormat() != SAMPLE_FORMAT_NONE)
+            std::cout << " " << (stats.Bytes - last.Bytes) / seconds / 1024.0 << " KiB/s";
+
+        std::cout << " busy=" << (stats.BusyUs - last.BusyUs) / 1e4 / seconds << "%"
+                  << " max_write_us=" << stats.MaxWriteUs
+                  << " errors=" << stats.Errors
+                  << " " << queue.FormatStats() << std::endl;
+
+        last = stats;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleFanout::Poll()
+{
+    if (std::chrono::steady_clock::now() - LastReport >= std::chrono::seconds(FANOUT_STATS_INTERVAL_S))
+        PrintStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Publish
+//
+//  @brief: encode once per used format, queue to all sinks
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleFanout::Publish(const TRLTSample& sample)
+{
+    std::shared_ptr<const std::string> encoded[SAMPLE_FORMAT_NUM];
+
+    for (int format = SAMPLE_FORMAT_NONE + 1; format < SAMPLE_FORMAT_NUM; format++)
+    {
+        if (UsedFormats[format])
+            encoded[format] = std::make_shared<const std::string>(EncodeSample((TSampleFormat)format, sample));
+    }
+
+    TSampleFrame frame;
+
+    frame.Sample = sample;
+
+    for (auto& queue : Queues)
+    {
+        frame.Encoded = encoded[queue->GetSink().GetFormat()];
+        queue->Push(frame);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  PublishComment
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleFanout::PublishComment(const std::string& comment)
+{
+    TSampleFrame frame;
+
+    frame.Sample.MergedCount = 0;
+    frame.Comment            = std::make_shared<const std::string>(comment);
+
+    for (auto& queue : Queues)
+        queue->Push(frame);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLinkTest_StatusInd
+//
+//  @brief: time stamp on reception, queueing delay is not part of the time;
+//          with a receive clock neither the decoding and dispatch delay
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleFanout::evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status)
+{
+    TRLTSample sample;
+
+    sample.TimeUs   = ReceiveClock ? RLT_MonotonicToTimeUs(ReceiveClock->GetRxTimeUs()) : RLT_GetTimeUs();
+    sample.Status   = status;
+    sample.ConfigId = ConfigId;
+
+    Publish(sample);
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleFanout.h
+//
+//	Abstract:	Distribution of Radio Link Test Samples to multiple Sinks
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SAMPLEFANOUT_H
+#define SAMPLEFANOUT_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "SampleQueue.h"
+#include <vector>
+#include <memory>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// interval for sink throughput reports on stdout
+#define FANOUT_STATS_INTERVAL_S     600
+
+//------------------------------------------------------------------------------
+//
+// TSampleFanout Class Declaration
+//
+// Registered as HCI client. Status indications are time stamped on
+// reception and encoded once per format requested by any sink; the frames
+// share the encoded data and are queued to every sink. Each sink has its
+// own queue and writer thread, so a slow sink cannot stall the others.
+//
+//------------------------------------------------------------------------------
+
+class TSampleFanout : public TWiMODLRHCIClient
+{
+    public:
+                    TSampleFanout();
+                    ~TSampleFanout();
+
+    // add sink before Start, the sink must outlive the fan-out
+    bool            AddSink(TSampleSink& sink, UINT32 capacity = SAMPLE_QUEUE_DEFAULT_SIZE,
+                            TQueuePolicy policy = QUEUE_POLICY_BLOCK,
+                            UINT32 coalesceMs = SAMPLE_QUEUE_COALESCE_MS);
+
+    // start / stop writer threads, Stop delivers all queued samples
+    bool            Start();
+    void            Stop();
+
+    int             GetNumSinks() const { return (int)Queues.size(); }
+    TSampleQueue&   GetQueue(int index) { return *Queues[index]; }
+
+    // print samples/s, bytes/s and queue counters per sink since last call
+    void            PrintStats();
+
+    // print stats every FANOUT_STATS_INTERVAL_S (call periodically)
+    void            Poll();
+
+    // queue an already time stamped sample
+    void            Publish(const TRLTSample& sample);
+
+    // queue an annotation, written in order with the samples
+    void            PublishComment(const std::string& comment);
+
+    // configuration id of following indications (sweep campaign)
+    void            SetConfigId(UINT16 configId) { ConfigId = configId; }
+
+    // indications are time stamped with the read time of their bytes
+    // instead of the dispatch time, so dispatch jitter does not enter the
+    // time stamps; the binary formats keep their microseconds
+    void            SetReceiveClock(const TWiMODLRHCI* hci) { ReceiveClock = hci; }
+
+    // HCI client interface
+    void            evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override;
+
+    private:
+
+    std::vector<std::unique_ptr<TSampleQueue>>  Queues;
+
+    // formats requested by at least one sink
+    bool            UsedFormats[SAMPLE_FORMAT_NUM];
+
+    bool            Running;
+
+    UINT16          ConfigId;
+
+    const TWiMODLRHCI*  ReceiveClock;
+
+    // counters of the last report, for rates
+    std::vector<TSinkStats>                 LastStats;
+    std::chrono::steady_clock::time_point   LastReport;
+};
+
+#endif // SAMPLEFANOUT_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleQueue.cpp
+//
+//	Abstract:	Bounded Queue and Writer Thread of one Sample Sink
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleQueue.h"
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  TSampleQueue - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TSampleQueue::TSampleQueue(TSampleSink& sink, UINT32 capacity, TQueuePolicy policy, UINT32 coalesceMs)
+    : Sink(sink),
+      Queue(capacity, policy, MergeFrame, coalesceMs)
+{
+    SinkStats    = TSinkStats();
+    Running      = false;
+    ReportedLoss = 0;
+    LastReport   = std::chrono::steady_clock::now();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TSampleQueue - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TSampleQueue::~TSampleQueue()
+{
+    Stop();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleQueue::Start()
+{
+    if (Running)
+        return false;
+
+    Running = true;
+    Thread  = std::thread(&TSampleQueue::Run, this);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//  @brief: close queue, wait until the consumer has delivered all samples
+//          and write final counters
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleQueue::Stop()
+{
+    if (!Running)
+        return;
+
+    Queue.Close();
+
+    if (Thread.joinable())
+        Thread.join();
+
+    Running = false;
+
+    ReportStats(true);
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TSampleQueue::FormatStats()
+{
+    TQueueStats stats = Queue.GetStats();
+
+    std::ostringstream text;
+
+    text << "policy="       << QueuePolicyName(Queue.GetPolicy())
+         << " capacity="    << Queue.GetCapacity()
+         << " pushed="      << stats.Pushed
+         << " dropped="     << stats.Dropped
+         << " coalesced="   << stats.Coalesced
+         << " summaries="   << stats.Summaries
+         << " blocked="     << stats.Blocked
+         << " blocked_us="  << stats.BlockedUs
+         << " high_water="  << stats.HighWater;
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetSinkStats
+//
+//------------------------------------------------------------------------------
+
+TSinkStats
+TSampleQueue::GetSinkStats()
+{
+    std::lock_guard<std::mutex> lock(StatsLock);
+
+    return SinkStats;
+}
+
+//------------------------------------------------------------------------------
+//
+//  MergeFrame
+//
+//  @brief: coalesce samples, the shared encoding no longer matches;
+//          annotations are kept and joined
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleQueue::MergeFrame(TSampleFrame& summary, const TSampleFrame& frame)
+{
+    if (frame.Comment)
+    {
+        summary.Comment = summary.Comment ? std::make_shared<const std::string>(*summary.Comment + "; " + *frame.Comment)
+                                          : frame.Comment;
+    }
+
+    // annotation only
+    if (!frame.Sample.MergedCount)
+        return;
+
+    if (!summary.Sample.MergedCount)
+    {
+        summary.Sample  = frame.Sample;
+        summary.Encoded = frame.Encoded;
+        return;
+    }
+
+    RLT_MergeSample(summary.Sample, frame.Sample);
+
+    summary.Encoded.reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: consumer thread
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleQueue::Run()
+{
+    TSampleFrame frame;
+
+    while (true)
+    {
+        if (Queue.Pop(frame, 100))
+            Write(frame);
+        else if (Queue.IsClosed())
+            break;
+
+        Sink.Poll();
+
+        ReportStats(false);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Write
+//
+//  @brief: pass frame to the sink, summaries are encoded here
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleQueue::Write(const TSampleFrame& frame)
+{
+    if (frame.Comment)
+        Sink.WriteComment(*frame.Comment);
+
+    if (!frame.Sample.MergedCount)
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    bool   result;
+    size_t length;
+
+    if (frame.Encoded || Sink.GetFormat() == SAMPLE_FORMAT_NONE)
+    {
+        static const std::string empty;
+
+        const std::string& encoded = frame.Encoded ? *frame.Encoded : empty;
+
+        result = Sink.WriteSample(frame.Sample, encoded);
+        length = encoded.size();
+    }
+    else
+    {
+        std::string encoded = EncodeSample(Sink.GetFormat(), frame.Sample);
+
+        result = Sink.WriteSample(frame.Sample, encoded);
+        length = encoded.size();
+    }
+
+    UINT64 us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(StatsLock);
+
+    SinkStats.Samples++;
+    SinkStats.Bytes     += length;
+    SinkStats.BusyUs    += us;
+    SinkStats.MaxWriteUs = std::max(SinkStats.MaxWriteUs, us);
+
+    if (!result)
+        SinkStats.Errors++;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ReportStats
+//
+//  @brief: comment in the sink if samples were dropped or coalesced since
+//          the last report, rate limited
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleQueue::ReportStats(bool force)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    if (!force && now - LastReport < std::chrono::milliseconds(SAMPLE_QUEUE_REPORT_MS))
+        return;
+
+    TQueueStats stats = Queue.GetStats();
+    UINT64      loss  = stats.Dropped + stats.Coalesced;
+
+    if (!force && loss == ReportedLoss)
+        return;
+
+    LastReport   = now;
+    ReportedLoss = loss;
+
+    Sink.WriteComment("queue " + FormatStats());
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleQueue.h
+//
+//	Abstract:	Bounded Queue and Writer Thread of one Sample Sink
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SAMPLEQUEUE_H
+#define SAMPLEQUEUE_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "BoundedQueue.h"
+#include "SampleSink.h"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// default number of queued samples
+#define SAMPLE_QUEUE_DEFAULT_SIZE       4096
+
+// default coalesce interval
+#define SAMPLE_QUEUE_COALESCE_MS        1000
+
+// min. interval of queue counter comments in the sink
+#define SAMPLE_QUEUE_REPORT_MS          1000
+
+// sink throughput counters
+typedef struct
+{
+    // samples passed to the sink, failed writes
+    UINT64  Samples;
+    UINT64  Errors;
+    // encoded bytes passed to the sink
+    UINT64  Bytes;
+    // time spent in the sink, total and max. per sample
+    UINT64  BusyUs;
+    UINT64  MaxWriteUs;
+}TSinkStats;
+
+//------------------------------------------------------------------------------
+//
+// TSampleQueue Class Declaration
+//
+// Samples are queued by the producer (see TSampleFanout), a consumer thread
+// passes them to the sink. A stalled sink (e.g. SD card write latency) no
+// longer delays the serial reader; the overflow policy decides what happens
+// if the queue runs full. Changed drop / coalesce counters are written to
+// the sink as comments, so every gap in the log is accounted for.
+//
+// The packet counters of the status indications are accumulated, so a
+// coalesced summary keeps the counters of its newest sample and loses no
+// packet; the comment before it names the folded samples and their time
+// span. Counter comments are rate limited to one per report interval.
+//
+//------------------------------------------------------------------------------
+
+class TSampleQueue
+{
+    public:
+                    TSampleQueue(TSampleSink& sink, UINT32 capacity = SAMPLE_QUEUE_DEFAULT_SIZE,
+                                 TQueuePolicy policy = QUEUE_POLICY_BLOCK,
+                                 UINT32 coalesceMs = SAMPLE_QUEUE_COALESCE_MS);
+                    ~TSampleQueue();
+
+    // start / stop consumer thread, Stop delivers all queued samples
+    bool            Start();
+    void            Stop();
+
+    // queue frame, frame.Encoded must be in the format of the sink or null
+    bool            Push(const TSampleFrame& frame) { return Queue.Push(frame); }
+
+    TSampleSink&    GetSink() { return Sink; }
+    TQueueStats     GetStats() { return Queue.GetStats(); }
+    TSinkStats      GetSinkStats();
+
+    // queue counters as "key=value" list
+    std::string     FormatStats();
+
+    private:
+
+    void            Run();
+    void            Write(const TSampleFrame& frame);
+    void            ReportStats(bool force);
+
+    static void     MergeFrame(TSampleFrame& summary, const TSampleFrame& frame);
+
+    TSampleSink&            Sink;
+    TBoundedQueue<TSampleFrame> Queue;
+
+    std::mutex              StatsLock;
+    TSinkStats              SinkStats;
+
+    std::thread             Thread;
+    std::atomic<bool>       Running;
+
+    // counters of the last report
+    UINT64                  ReportedLoss;
+    std::chrono::steady_clock::time_point LastReport;
+};
+
+#endif // SAMPLEQUEUE_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
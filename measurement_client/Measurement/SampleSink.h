@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleSink.h
+//
+//	Abstract:	Consumer Interface for Radio Link Test Samples
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SAMPLESINK_H
+#define SAMPLESINK_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "RLTSample.h"
+#include <string>
+#include <memory>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+typedef enum
+{
+    // decoded sample only, the sink encodes itself
+    SAMPLE_FORMAT_NONE = 0,
+    // CSV row including line end
+    SAMPLE_FORMAT_CSV,
+    // fixed size binary record (RLT_RECORD_SIZE)
+    SAMPLE_FORMAT_RECORD,
+
+    SAMPLE_FORMAT_NUM
+}TSampleFormat;
+
+// sample with its encoding, shared by all sinks of the same format; an
+// annotation (e.g. gap marker) is written before the sample, a frame with
+// Sample.MergedCount == 0 carries the annotation only
+typedef struct
+{
+    TRLTSample                          Sample;
+    std::shared_ptr<const std::string>  Encoded;
+    std::shared_ptr<const std::string>  Comment;
+}TSampleFrame;
+
+static inline std::string
+EncodeSample(TSampleFormat format, const TRLTSample& sample)
+{
+    switch (format)
+    {
+        case SAMPLE_FORMAT_CSV:
+            return RLT_FormatCsvRow(sample) + "\n";
+
+        case SAMPLE_FORMAT_RECORD:
+        {
+            std::string record(RLT_RECORD_SIZE, '\0');
+            RLT_EncodeRecord(sample, (UINT8*)&record[0]);
+            return record;
+        }
+
+        default:
+            return std::string();
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+// TSampleSink Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TSampleSink
+{
+    public:
+    virtual         ~TSampleSink() {}
+
+    // sink name for statistics
+    virtual std::string     GetName() const = 0;
+
+    // encoding passed to WriteSample
+    virtual TSampleFormat   GetFormat() const { return SAMPLE_FORMAT_NONE; }
+
+    // store one time stamped sample (or coalesced summary), encoded holds
+    // the sample in GetFormat() encoding
+    virtual bool    WriteSample(const TRLTSample& sample, const std::string& encoded) = 0;
+
+    // annotation, e.g. queue statistics
+    virtual void    WriteComment(const std::string& comment) { (void)comment; }
+
+    // called periodically while idle, e.g. for timed flushes
+    virtual void    Poll() {}
+};
+
+#endif // SAMPLESINK_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,574 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleSpool.cpp
+//
+//	Abstract:	On-Disk Queue of Sample Frames awaiting Acknowledgement
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleSpool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// frames larger than this are treated as corrupt
+#define SPOOL_MAX_FRAME_SIZE        (1024 * 1024)
+
+#define SPOOL_SUFFIX                ".spool"
+
+//------------------------------------------------------------------------------
+//
+//  Helper Functions
+//
+//------------------------------------------------------------------------------
+
+static bool
+ReadAt(int handle, UINT8* data, size_t length, UINT64 offset)
+{
+    while (length)
+    {
+        ssize_t result = ::pread(handle, data, length, offset);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            return false;
+
+        data   += result;
+        length -= result;
+        offset += result;
+    }
+    return true;
+}
+
+static void
+ParseFrameHeader(const UINT8* header, UINT32& length, UINT64& sequence, UINT32& count)
+{
+    length   = NTOH32(header);
+    sequence = (UINT64)NTOH32(header + 4) | ((UINT64)NTOH32(header + 8) << 32);
+    count    = NTOH32(header + 12);
+}
+
+//------------------------------------------------------------------------------
+//
+//  TSampleSpool - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TSampleSpool::TSampleSpool()
+{
+    SegmentSize     = SPOOL_DEFAULT_SEGMENT_SIZE;
+    MaxSize         = SPOOL_DEFAULT_MAX_SIZE;
+    Sync            = true;
+    Handle          = -1;
+    NextSequence    = 0;
+    Acknowledged    = 0;
+    CursorSegment   = 0;
+    CursorOffset    = 0;
+    CursorSequence  = 0;
+    Stats           = TSpoolStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TSampleSpool - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TSampleSpool::~TSampleSpool()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::Open(const std::string& directory, UINT64 segmentSize, UINT64 maxSize, bool sync)
+{
+    Close();
+
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+
+    Directory   = directory;
+    SegmentSize = segmentSize;
+    MaxSize     = maxSize;
+    Sync        = sync;
+
+    // acknowledged sequence of the last run
+    Acknowledged = 0;
+
+    FILE* file = std::fopen((Directory + "/acked").c_str(), "r");
+    if (file)
+    {
+        unsigned long long value;
+        if (std::fscanf(file, "%llu", &value) == 1)
+            Acknowledged = value;
+        std::fclose(file);
+    }
+
+    // existing segments, sorted by sequence
+    DIR* dir = ::opendir(Directory.c_str());
+    if (!dir)
+        return false;
+
+    Segments.clear();
+
+    while (struct dirent* entry = ::readdir(dir))
+    {
+        std::string name = entry->d_name;
+        size_t      suffix = name.size() - std::strlen(SPOOL_SUFFIX);
+
+        if (name.size() <= std::strlen(SPOOL_SUFFIX) || name.compare(suffix, std::string::npos, SPOOL_SUFFIX) != 0)
+            continue;
+
+        struct stat info;
+        if (::stat((Directory + "/" + name).c_str(), &info) != 0)
+            continue;
+
+        TSpoolSegment segment;
+
+        segment.FirstSequence = std::strtoull(name.c_str(), 0, 16);
+        segment.Size          = info.st_size;
+
+        Segments.push_back(segment);
+    }
+    ::closedir(dir);
+
+    std::sort(Segments.begin(), Segments.end(),
+              [](const TSpoolSegment& a, const TSpoolSegment& b) { return a.FirstSequence < b.FirstSequence; });
+
+    NextSequence = Acknowledged;
+
+    if (!Segments.empty())
+    {
+        if (!RecoverSegment(Segments.back()))
+            return false;
+
+        Handle = ::open(SegmentPath(Segments.back().FirstSequence).c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (Handle < 0)
+            return false;
+    }
+
+    CursorSegment  = 0;
+    CursorOffset   = 0;
+    CursorSequence = 0;
+
+    RemoveSegments();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleSpool::Close()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (Handle >= 0)
+    {
+        ::close(Handle);
+        Handle = -1;
+    }
+    Segments.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  SegmentPath
+//
+//------------------------------------------------------------------------------
+
+std::string
+TSampleSpool::SegmentPath(UINT64 firstSequence) const
+{
+    char name[32];
+
+    std::snprintf(name, sizeof(name), "%016llx" SPOOL_SUFFIX, (unsigned long long)firstSequence);
+
+    return Directory + "/" + name;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RecoverSegment
+//
+//  @brief: find the end of the last segment, cut off incomplete frames
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::RecoverSegment(TSpoolSegment& segment)
+{
+    std::string path   = SegmentPath(segment.FirstSequence);
+    int         handle = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (handle < 0)
+        return false;
+
+    UINT64 offset = 0;
+    UINT64 end    = segment.FirstSequence;
+
+    while (offset + SPOOL_FRAME_HEADER_SIZE <= segment.Size)
+    {
+        UINT8  header[SPOOL_FRAME_HEADER_SIZE];
+        UINT32 length, count;
+        UINT64 sequence;
+
+        if (!ReadAt(handle, header, sizeof(header), offset))
+            break;
+
+        ParseFrameHeader(header, length, sequence, count);
+
+        // sequence numbers grow within a segment
+        if (!length || length > SPOOL_MAX_FRAME_SIZE || !count || sequence < end
+            || offset + SPOOL_FRAME_HEADER_SIZE + length > segment.Size)
+            break;
+
+        end     = sequence + count;
+        offset += SPOOL_FRAME_HEADER_SIZE + length;
+    }
+
+    NextSequence = std::max(NextSequence, end);
+
+    bool result = true;
+    if (offset != segment.Size)
+    {
+        result       = ::ftruncate(handle, offset) == 0;
+        segment.Size = offset;
+    }
+
+    ::close(handle);
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  OpenSegment
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::OpenSegment(UINT64 firstSequence)
+{
+    if (Handle >= 0)
+    {
+        ::close(Handle);
+        Handle = -1;
+    }
+
+    Handle = ::open(SegmentPath(firstSequence).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (Handle < 0)
+        return false;
+
+    TSpoolSegment segment;
+
+    segment.FirstSequence = firstSequence;
+    segment.Size          = 0;
+
+    Segments.push_back(segment);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Append
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::Append(const UINT8* data, size_t length, UINT32 count)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (Directory.empty() || !length || length > SPOOL_MAX_FRAME_SIZE || !count)
+        return false;
+
+    if (Handle < 0 || Segments.empty() || Segments.back().Size >= SegmentSize)
+    {
+        if (!OpenSegment(NextSequence))
+        {
+            Stats.WriteErrors++;
+            return false;
+        }
+    }
+
+    std::vector<UINT8> frame(SPOOL_FRAME_HEADER_SIZE + length);
+
+    HTON32(&frame[0],  (UINT32)length);
+    HTON32(&frame[4],  (UINT32)NextSequence);
+    HTON32(&frame[8],  (UINT32)(NextSequence >> 32));
+    HTON32(&frame[12], count);
+    std::memcpy(&frame[SPOOL_FRAME_HEADER_SIZE], data, length);
+
+    TSpoolSegment& segment = Segments.back();
+
+    ssize_t written = ::write(Handle, frame.data(), frame.size());
+    if (written != (ssize_t)frame.size() || (Sync && ::fdatasync(Handle) != 0))
+    {
+        // keep the segment parseable
+        if (::ftruncate(Handle, segment.Size) != 0)
+            Handle = -1;
+
+        Stats.WriteErrors++;
+        return false;
+    }
+
+    segment.Size += frame.size();
+    NextSequence += count;
+
+    Stats.FramesWritten++;
+    Stats.BytesWritten += frame.size();
+
+    // size limit, the oldest data is given up first
+    UINT64 size = 0;
+    for (const TSpoolSegment& entry : Segments)
+        size += entry.Size;
+
+    while (size > MaxSize && Segments.size() > 1)
+    {
+        UINT64 first = std::max(Acknowledged, Segments[0].FirstSequence);
+        UINT64 next  = Segments[1].FirstSequence;
+
+        if (next > first)
+            Stats.DroppedSamples += next - first;
+
+        size -= Segments[0].Size;
+        ::unlink(SegmentPath(Segments[0].FirstSequence).c_str());
+        Segments.erase(Segments.begin());
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetNextSequence / GetAcknowledged / GetSize / GetStats
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TSampleSpool::GetNextSequence()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+    return NextSequence;
+}
+
+UINT64
+TSampleSpool::GetAcknowledged()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+    return Acknowledged;
+}
+
+UINT64
+TSampleSpool::GetSize()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    UINT64 size = 0;
+    for (const TSpoolSegment& segment : Segments)
+        size += segment.Size;
+
+    return size;
+}
+
+TSpoolStats
+TSampleSpool::GetStats()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+    return Stats;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Acknowledge
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::Acknowledge(UINT64 sequence)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (sequence <= Acknowledged)
+        return true;
+
+    Acknowledged = sequence;
+
+    // collector knows more samples than spooled (spool lost), continue
+    // after them to keep sequence numbers unique
+    if (Acknowledged > NextSequence)
+    {
+        NextSequence = Acknowledged;
+
+        // segment names must stay ordered by sequence
+        if (Handle >= 0)
+        {
+            ::close(Handle);
+            Handle = -1;
+        }
+    }
+
+    bool result = WriteAcknowledged();
+
+    RemoveSegments();
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteAcknowledged
+//
+//  @brief: replace "acked" file atomically
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::WriteAcknowledged()
+{
+    std::string path = Directory + "/acked";
+    std::string temp = path + ".tmp";
+
+    int handle = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (handle < 0)
+        return false;
+
+    std::string text = std::to_string(Acknowledged) + "\n";
+
+    bool result = ::write(handle, text.data(), text.size()) == (ssize_t)text.size()
+                  && (!Sync || ::fdatasync(handle) == 0);
+
+    ::close(handle);
+
+    return result && ::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RemoveSegments
+//
+//  @brief: remove segments followed by an acknowledged one, the segment
+//          being appended to is kept
+//
+//------------------------------------------------------------------------------
+
+void
+TSampleSpool::RemoveSegments()
+{
+    while (Segments.size() > 1 && Segments[1].FirstSequence <= Acknowledged)
+    {
+        ::unlink(SegmentPath(Segments[0].FirstSequence).c_str());
+        Segments.erase(Segments.begin());
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  ReadFrame
+//
+//------------------------------------------------------------------------------
+
+bool
+TSampleSpool::ReadFrame(UINT64 sequence, UINT64& firstSequence, UINT32& count, std::vector<UINT8>& data)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (sequence >= NextSequence || Segments.empty())
+        return false;
+
+    // last segment starting at or before sequence
+    size_t index = 0;
+    while (index + 1 < Segments.size() && Segments[index + 1].FirstSequence <= sequence)
+        index++;
+
+    for (; index < Segments.size(); index++)
+    {
+        const TSpoolSegment& segment = Segments[index];
+
+        int handle = ::open(SegmentPath(segment.FirstSequence).c_str(), O_RDONLY | O_CLOEXEC);
+        if (handle < 0)
+            continue;
+
+        // continue at the cached position when reading sequentially
+        UINT64 offset = 0;
+        if (CursorSegment == segment.FirstSequence && CursorSequence <= sequence && CursorOffset <= segment.Size)
+            offset = CursorOffset;
+
+        while (offset + SPOOL_FRAME_HEADER_SIZE <= segment.Size)
+        {
+            UINT8  header[SPOOL_FRAME_HEADER_SIZE];
+            UINT32 length;
+            UINT64 frameSequence;
+
+            if (!ReadAt(handle, header, sizeof(header), offset))
+                break;
+
+            ParseFrameHeader(header, length, frameSequence, count);
+
+            UINT64 next = offset + SPOOL_FRAME_HEADER_SIZE + length;
+
+            if (frameSequence + count > sequence)
+            {
+                data.resize(length);
+
+                bool result = ReadAt(handle, data.data(), length, offset + SPOOL_FRAME_HEADER_SIZE);
+                ::close(handle);
+
+                if (!result)
+                    return false;
+
+                firstSequence  = frameSequence;
+                CursorSegment  = segment.FirstSequence;
+                CursorOffset   = next;
+                CursorSequence = frameSequence + count;
+
+                return true;
+            }
+
+            offset = next;
+        }
+
+        ::close(handle);
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
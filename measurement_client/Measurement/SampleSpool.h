@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SampleSpool.h
+//
+//	Abstract:	On-Disk Queue of Sample Frames awaiting Acknowledgement
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SAMPLESPOOL_H
+#define SAMPLESPOOL_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include <string>
+#include <vector>
+#include <mutex>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+#define SPOOL_DEFAULT_SEGMENT_SIZE  (4 * 1024 * 1024)
+#define SPOOL_DEFAULT_MAX_SIZE      (512ULL * 1024 * 1024)
+
+// frame header: body length, sequence of the first sample, sample count
+#define SPOOL_FRAME_HEADER_SIZE     16
+
+typedef struct
+{
+    // sequence number of the first sample, part of the file name
+    UINT64          FirstSequence;
+    UINT64          Size;
+}TSpoolSegment;
+
+typedef struct
+{
+    UINT64  FramesWritten;
+    UINT64  BytesWritten;
+    UINT64  WriteErrors;
+    // samples removed unacknowledged because the spool was full
+    UINT64  DroppedSamples;
+}TSpoolStats;
+
+//------------------------------------------------------------------------------
+//
+// TSampleSpool Class Declaration
+//
+// Frames are appended to segment files "<first sequence>.spool" in the spool
+// directory. The next expected sequence reported by the collector is kept
+// in the file "acked"; segments which are completely acknowledged are
+// removed. Sequence numbers continue across restarts. If the spool exceeds
+// its size limit, the oldest segment is dropped and counted. The class is
+// thread safe, one thread appends while another one reads and acknowledges.
+//
+//------------------------------------------------------------------------------
+
+class TSampleSpool
+{
+    public:
+                    TSampleSpool();
+                    ~TSampleSpool();
+
+    // open / create spool directory, a partially written frame at the end
+    // of the last segment (power failure) is cut off
+    bool            Open(const std::string& directory, UINT64 segmentSize = SPOOL_DEFAULT_SEGMENT_SIZE,
+                         UINT64 maxSize = SPOOL_DEFAULT_MAX_SIZE, bool sync = true);
+    void            Close();
+
+    // append frame of count samples, numbered from GetNextSequence()
+    bool            Append(const UINT8* data, size_t length, UINT32 count);
+
+    // sequence number of the next appended sample
+    UINT64          GetNextSequence();
+
+    // all samples before are acknowledged
+    UINT64          GetAcknowledged();
+
+    // store acknowledged sequence, removes segments no longer needed; a
+    // sequence beyond the spool content (collector ahead) moves the next
+    // sequence as well
+    bool            Acknowledge(UINT64 sequence);
+
+    // read the frame holding sequence, or the first one after it (samples
+    // were dropped); false if no such frame is spooled yet
+    bool            ReadFrame(UINT64 sequence, UINT64& firstSequence, UINT32& count, std::vector<UINT8>& data);
+
+    // bytes in all segments
+    UINT64          GetSize();
+
+    TSpoolStats     GetStats();
+
+    private:
+
+    std::string     SegmentPath(UINT64 firstSequence) const;
+    bool            OpenSegment(UINT64 firstSequence);
+    bool            RecoverSegment(TSpoolSegment& segment);
+    bool            WriteAcknowledged();
+    void            RemoveSegments();
+
+    std::mutex      Lock;
+
+    std::string     Directory;
+    UINT64          SegmentSize;
+    UINT64          MaxSize;
+    bool            Sync;
+
+    std::vector<TSpoolSegment>  Segments;
+
+    // append handle of the last segment
+    int             Handle;
+
+    UINT64          NextSequence;
+    UINT64          Acknowledged;
+
+    // read position cache: segment, offset and sequence of the next frame
+    UINT64          CursorSegment;
+    UINT64          CursorOffset;
+    UINT64          CursorSequence;
+
+    TSpoolStats     Stats;
+};
+
+#endif // SAMPLESPOOL_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,471 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ShmRing.cpp
+//
+//	Abstract:	Seqlock protected Shared Memory Ring of Radio Link Test Samples
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "ShmRing.h"
+#include <cstring>
+#include <new>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+//------------------------------------------------------------------------------
+//
+//  Helper Functions
+//
+//------------------------------------------------------------------------------
+
+// slots start at the next cache line after the header
+static size_t
+SlotOffset()
+{
+    return (sizeof(TShmRingHeader) + 63) & ~(size_t)63;
+}
+
+// create (with mode, regardless of the umask) or open an object, mapped
+// read-only unless writable is set
+static void*
+MapObject(const std::string& name, size_t size, bool create, bool writable, mode_t mode = 0644)
+{
+    std::string path = "/" + name;
+
+    int handle;
+    if (create)
+    {
+        // a fresh object, readers of a previous run keep their old mapping
+        ::shm_unlink(path.c_str());
+        handle = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+        if (handle >= 0 && (::fchmod(handle, mode) != 0 || ::ftruncate(handle, size) != 0))
+        {
+            ::close(handle);
+            ::shm_unlink(path.c_str());
+            return 0;
+        }
+    }
+    else
+        handle = ::shm_open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC, 0);
+
+    if (handle < 0)
+        return 0;
+
+    void* map = ::mmap(0, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, handle, 0);
+    ::close(handle);
+
+    return map == MAP_FAILED ? 0 : map;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TShmRingWriter - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TShmRingWriter::TShmRingWriter()
+{
+    Header      = 0;
+    Slots       = 0;
+    MapSize     = 0;
+    Notify      = 0;
+    WriteIndex  = 0;
+    NumSlots    = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TShmRingWriter - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TShmRingWriter::~TShmRingWriter()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TShmRingWriter::Open(const std::string& name, UINT32 numSlots)
+{
+    Close();
+
+    UINT32 slots = 1;
+    while (slots < numSlots && slots < 0x80000000)
+        slots <<= 1;
+
+    size_t size = SlotOffset() + (size_t)slots * sizeof(TShmRingSlot);
+
+    void* map = MapObject(name, size, true, true);
+    if (!map)
+        return false;
+
+    // readers of every user wait on it
+    void* notify = MapObject(name + SHM_RING_NOTIFY_SUFFIX, sizeof(TShmRingNotify), true, true, 0666);
+    if (!notify)
+    {
+        ::munmap(map, size);
+        ::shm_unlink(("/" + name).c_str());
+        return false;
+    }
+
+    Name       = name;
+    MapSize    = size;
+    Header     = new (map) TShmRingHeader;
+    Slots      = (TShmRingSlot*)((UINT8*)map + SlotOffset());
+    Notify     = new (notify) TShmRingNotify;
+    WriteIndex = 0;
+    NumSlots   = slots;
+
+    for (UINT32 i = 0; i < slots; i++)
+        new (&Slots[i]) TShmRingSlot;
+
+    Header->Version     = SHM_RING_VERSION;
+    Header->NumSlots    = slots;
+    Header->SlotSize    = sizeof(TShmRingSlot);
+    Header->WriterPid   = ::getpid();
+    Header->WriteIndex.store(0);
+    Notify->Notify.store(0);
+    Notify->Waiters.store(0);
+
+    // readers accept the ring once the magic is visible
+    std::atomic_thread_fence(std::memory_order_release);
+    Header->Magic       = SHM_RING_MAGIC;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TShmRingWriter::Close(bool unlink)
+{
+    if (!Header)
+        return;
+
+    ::munmap(Header, MapSize);
+    ::munmap(Notify, sizeof(TShmRingNotify));
+
+    if (unlink)
+    {
+        ::shm_unlink(("/" + Name).c_str());
+        ::shm_unlink(("/" + Name + SHM_RING_NOTIFY_SUFFIX).c_str());
+    }
+
+    Header = 0;
+    Slots  = 0;
+    Notify = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Write
+//
+//  @brief: seqlock write of the slot, then publish the new write index;
+//          index and slot count come from the writer, not the mapping
+//
+//------------------------------------------------------------------------------
+
+void
+TShmRingWriter::Write(const UINT8* record)
+{
+    UINT64        index = WriteIndex++;
+    TShmRingSlot& slot  = Slots[index & (NumSlots - 1)];
+
+    slot.Sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(slot.Record, record, RLT_RECORD_SIZE);
+
+    slot.Sequence.store(2 * index + 2, std::memory_order_release);
+    Header->WriteIndex.store(index + 1, std::memory_order_release);
+
+    // wake waiting readers, pairs with Waiters / Notify in TShmRingReader::Wait
+    Notify->Notify.fetch_add(1, std::memory_order_seq_cst);
+    if (Notify->Waiters.load(std::memory_order_seq_cst))
+        ::syscall(SYS_futex, &Notify->Notify, FUTEX_WAKE, INT32_MAX, 0, 0, 0);
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteSample
+//
+//------------------------------------------------------------------------------
+
+bool
+TShmRingWriter::WriteSample(const TRLTSample& /* sample */, const std::string& record)
+{
+    if (!Header || record.size() != RLT_RECORD_SIZE)
+        return false;
+
+    Write((const UINT8*)record.data());
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TShmRingReader - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TShmRingReader::TShmRingReader()
+{
+    Header      = 0;
+    Slots       = 0;
+    MapSize     = 0;
+    Notify      = 0;
+    NumSlots    = 0;
+    ReadIndex   = 0;
+    Lost        = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TShmRingReader - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TShmRingReader::~TShmRingReader()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TShmRingReader::Open(const std::string& name, bool fromOldest)
+{
+    Close();
+
+    // map header first to learn the ring size
+    void* map = MapObject(name, SlotOffset(), false, false);
+    if (!map)
+        return false;
+
+    TShmRingHeader* header = (TShmRingHeader*)map;
+
+    bool   valid = header->Magic == SHM_RING_MAGIC
+                && header->Version == SHM_RING_VERSION
+                && header->SlotSize == sizeof(TShmRingSlot)
+                && header->NumSlots && !(header->NumSlots & (header->NumSlots - 1));
+    UINT32 slots = header->NumSlots;
+    size_t size  = SlotOffset() + (size_t)slots * sizeof(TShmRingSlot);
+
+    ::munmap(map, SlotOffset());
+
+    if (!valid)
+        return false;
+
+    map = MapObject(name, size, false, false);
+    if (!map)
+        return false;
+
+    MapSize  = size;
+    NumSlots = slots;
+    Header   = (TShmRingHeader*)map;
+    Slots    = (TShmRingSlot*)((UINT8*)map + SlotOffset());
+    Notify   = (TShmRingNotify*)MapObject(name + SHM_RING_NOTIFY_SUFFIX, sizeof(TShmRingNotify), false, true);
+    Lost     = 0;
+
+    UINT64 writeIndex = Header->WriteIndex.load(std::memory_order_acquire);
+
+    ReadIndex = writeIndex;
+    if (fromOldest)
+        ReadIndex = writeIndex > NumSlots ? writeIndex - NumSlots : 0;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TShmRingReader::Close()
+{
+    if (!Header)
+        return;
+
+    ::munmap(Header, MapSize);
+
+    if (Notify)
+        ::munmap(Notify, sizeof(TShmRingNotify));
+
+    Header = 0;
+    Slots  = 0;
+    Notify = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetBacklog
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TShmRingReader::GetBacklog() const
+{
+    if (!Header)
+        return 0;
+
+    return Header->WriteIndex.load(std::memory_order_acquire) - ReadIndex;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Read
+//
+//  @brief: seqlock read, slots overwritten during the copy are skipped
+//          and counted as lost
+//
+//------------------------------------------------------------------------------
+
+bool
+TShmRingReader::Read(TRLTSample& sample)
+{
+    if (!Header)
+        return false;
+
+    UINT32 numSlots = NumSlots;
+
+    while (true)
+    {
+        UINT64 writeIndex = Header->WriteIndex.load(std::memory_order_acquire);
+
+        if (ReadIndex >= writeIndex)
+            return false;
+
+        // lapped by the writer
+        if (writeIndex - ReadIndex > numSlots)
+        {
+            Lost     += writeIndex - numSlots - ReadIndex;
+            ReadIndex = writeIndex - numSlots;
+        }
+
+        TShmRingSlot& slot     = Slots[ReadIndex & (numSlots - 1)];
+        UINT64        expected = 2 * ReadIndex + 2;
+
+        UINT8  record[RLT_RECORD_SIZE];
+        UINT64 before = slot.Sequence.load(std::memory_order_acquire);
+
+        std::memcpy(record, slot.Record, RLT_RECORD_SIZE);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        UINT64 after = slot.Sequence.load(std::memory_order_relaxed);
+
+        ReadIndex++;
+
+        if (before != expected || after != expected || !RLT_DecodeRecord(record, RLT_RECORD_SIZE, sample))
+        {
+            Lost++;
+            continue;
+        }
+
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Wait
+//
+//------------------------------------------------------------------------------
+
+bool
+TShmRingReader::Wait(TRLTSample& sample, int timeoutMs)
+{
+    if (Read(sample))
+        return true;
+
+    if (!Header)
+        return false;
+
+    struct timespec deadline;
+    ::clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec  += timeoutMs / 1000;
+    deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    if (Notify)
+        Notify->Waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    bool result = false;
+    while (true)
+    {
+        UINT32 notify = Notify ? Notify->Notify.load(std::memory_order_seq_cst) : 0;
+
+        if (Read(sample))
+        {
+            result = true;
+            break;
+        }
+
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        struct timespec timeout;
+        timeout.tv_sec  = deadline.tv_sec - now.tv_sec;
+        timeout.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (timeout.tv_nsec < 0)
+        {
+            timeout.tv_sec--;
+            timeout.tv_nsec += 1000000000L;
+        }
+        if (timeout.tv_sec < 0)
+            break;
+
+        // returns at once if the writer published after the load above;
+        // without the wakeup object poll every millisecond
+        if (Notify)
+            ::syscall(SYS_futex, &Notify->Notify, FUTEX_WAIT, notify, &timeout, 0, 0);
+        else
+        {
+            struct timespec pause = { 0, 1000000L };
+            ::nanosleep(&pause, 0);
+        }
+    }
+
+    if (Notify)
+        Notify->Waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
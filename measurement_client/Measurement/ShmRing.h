@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ShmRing.h
+//
+//	Abstract:	Seqlock protected Shared Memory Ring of Radio Link Test Samples
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SHMRING_H
+#define SHMRING_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleSink.h"
+#include <atomic>
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// object name below /dev/shm
+#define SHM_RING_DEFAULT_NAME       "rlt_measurement"
+
+// number of slots, power of two
+#define SHM_RING_DEFAULT_SLOTS      4096
+
+// wakeup object next to the ring: /dev/shm/<name>.notify
+#define SHM_RING_NOTIFY_SUFFIX      ".notify"
+
+#define SHM_RING_MAGIC              0x474E5252
+#define SHM_RING_VERSION            2
+
+// slot: sequence word and one binary record (RLT_RECORD_SIZE)
+typedef struct
+{
+    // 2 * index + 1 while written, 2 * index + 2 when complete
+    std::atomic<UINT64>     Sequence;
+    UINT8                   Record[RLT_RECORD_SIZE];
+}TShmRingSlot;
+
+// header, followed by the slots; written by the writer only, readers map
+// it read-only
+typedef struct
+{
+    UINT32                  Magic;
+    UINT32                  Version;
+    UINT32                  NumSlots;
+    UINT32                  SlotSize;
+    INT32                   WriterPid;
+    UINT32                  Reserved;
+
+    // index of the next sample to be written
+    alignas(64) std::atomic<UINT64> WriteIndex;
+}TShmRingHeader;
+
+// wakeup object, writable by the readers
+typedef struct
+{
+    // futex word incremented per sample, readers waiting on it
+    alignas(64) std::atomic<UINT32> Notify;
+    std::atomic<UINT32>     Waiters;
+}TShmRingNotify;
+
+//------------------------------------------------------------------------------
+//
+// TShmRingWriter Class Declaration
+//
+// Single writer. The writer never waits for readers: a slot is overwritten
+// after NumSlots further samples, a reader which falls behind detects this
+// through the slot sequence and skips ahead. Readers waiting for new data
+// are woken through a futex, the writer only issues the system call if a
+// reader is actually waiting.
+//
+// The ring is mapped read-only by the readers (mode 0644, readers of other
+// users can attach), write index and slot count are kept in the writer, so
+// nothing a reader does sends the writer out of bounds. The futex word and
+// the waiter count are in a small object of their own which every user may
+// write (0666); a faulty reader there can only cost or miss wakeups.
+//
+//------------------------------------------------------------------------------
+
+class TShmRingWriter : public TSampleSink
+{
+    public:
+                    TShmRingWriter();
+                    ~TShmRingWriter();
+
+    // create (or replace) /dev/shm/<name>, numSlots is rounded up to a
+    // power of two
+    bool            Open(const std::string& name = SHM_RING_DEFAULT_NAME, UINT32 numSlots = SHM_RING_DEFAULT_SLOTS);
+
+    // unmap, the object is removed as well if unlink is set
+    void            Close(bool unlink = true);
+
+    // publish one encoded record
+    void            Write(const UINT8* record);
+
+    // sample sink interface
+    std::string     GetName() const override { return "shm:" + Name; }
+    TSampleFormat   GetFormat() const override { return SAMPLE_FORMAT_RECORD; }
+    bool            WriteSample(const TRLTSample& sample, const std::string& record) override;
+
+    private:
+
+    std::string     Name;
+    TShmRingHeader* Header;
+    TShmRingSlot*   Slots;
+    size_t          MapSize;
+    TShmRingNotify* Notify;
+
+    // private copies, the mapping is never read back
+    UINT64          WriteIndex;
+    UINT32          NumSlots;
+};
+
+//------------------------------------------------------------------------------
+//
+// TShmRingReader Class Declaration
+//
+// Follows the writer from the current write index. Any number of readers
+// can attach with read access to the ring; without write access to the
+// wakeup object Wait polls instead of sleeping on the futex.
+//
+//------------------------------------------------------------------------------
+
+class TShmRingReader
+{
+    public:
+                    TShmRingReader();
+                    ~TShmRingReader();
+
+    // attach to /dev/shm/<name>, reading starts with the next sample
+    // (or the oldest one still in the ring if fromOldest is set)
+    bool            Open(const std::string& name = SHM_RING_DEFAULT_NAME, bool fromOldest = false);
+    void            Close();
+
+    // next sample, false if none available
+    bool            Read(TRLTSample& sample);
+
+    // next sample, waits up to timeoutMs for the writer; while a reader
+    // sleeps here each sample costs the writer a futex wake, readers which
+    // poll Read periodically cost the writer nothing
+    bool            Wait(TRLTSample& sample, int timeoutMs);
+
+    // samples overwritten before they could be read
+    UINT64          GetLost() const { return Lost; }
+
+    // samples the reader is behind the writer
+    UINT64          GetBacklog() const;
+
+    private:
+
+    TShmRingHeader* Header;
+    TShmRingSlot*   Slots;
+    size_t          MapSize;
+    TShmRingNotify* Notify;
+
+    // slot count as read at Open
+    UINT32          NumSlots;
+
+    UINT64          ReadIndex;
+    UINT64          Lost;
+};
+
+#endif // SHMRING_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,375 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SnifferCapture.cpp
+//
+//	Abstract:	Packet Capture in Sniffer Mode with Extended Rx Metadata
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SnifferCapture.h"
+#include "RLTSample.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  SNIFF_DecodeIndication
+//
+//  @brief: format byte, the addresses of a message, the packet and with
+//          bit 0 of the format the footer: RSSI, SNR, Rx time
+//
+//------------------------------------------------------------------------------
+
+bool
+SNIFF_DecodeIndication(UINT8 type, const TWiMODLR_HCIMessage& rxMsg, TSnifferRecord& record)
+{
+    int header = type == SNIFF_TYPE_MESSAGE ? DATALINK_MSG_HEADER_SIZE : SNIFF_FORMAT_SIZE;
+    int length = rxMsg.Length - header;
+
+    if (length < 0)
+        return false;
+
+    UINT8 format = rxMsg.Payload[0];
+
+    record.Type   = type;
+    record.Flags  = 0;
+    record.TimeUs = RLT_GetTimeUs();
+    record.RxTime = 0;
+    record.Rssi   = 0;
+    record.Snr    = 0;
+
+    if (format & 0x01)
+    {
+        length -= DATALINK_MSG_FOOTER_SIZE;
+
+        if (length < 0)
+            return false;
+
+        const UINT8* footer = &rxMsg.Payload[header + length];
+
+        record.Flags  = SNIFF_FLAG_EXTENDED;
+        record.Rssi   = (INT16)NTOH16(footer);
+        record.Snr    = (INT8)footer[2];
+        record.RxTime = NTOH32(&footer[3]);
+    }
+
+    // addresses stay in front of the payload of a message
+    const UINT8* frame = &rxMsg.Payload[SNIFF_FORMAT_SIZE];
+
+    record.Frame.assign(frame, frame + header - SNIFF_FORMAT_SIZE + length);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SNIFF_EncodeRecord
+//
+//------------------------------------------------------------------------------
+
+void
+SNIFF_EncodeRecord(const TSnifferRecord& record, std::vector<UINT8>& dst)
+{
+    size_t offset = dst.size();
+    size_t size   = SNIFF_RECORD_HEADER_SIZE + record.Frame.size();
+
+    dst.resize(offset + size);
+
+    UINT8* ptr = &dst[offset];
+
+    HTON16(ptr, SNIFF_RECORD_MAGIC);                       ptr += 2;
+    HTON16(ptr, (UINT16)size);                             ptr += 2;
+    *ptr++ = record.Type;
+    *ptr++ = record.Flags;
+    HTON32(ptr, (UINT32)(UINT64)record.TimeUs);            ptr += 4;
+    HTON32(ptr, (UINT32)((UINT64)record.TimeUs >> 32));    ptr += 4;
+    HTON32(ptr, record.RxTime);                            ptr += 4;
+    HTON16(ptr, (UINT16)record.Rssi);                      ptr += 2;
+    *ptr++ = (UINT8)record.Snr;
+
+    std::copy(record.Frame.begin(), record.Frame.end(), ptr);
+}
+
+//------------------------------------------------------------------------------
+//
+//  SNIFF_DecodeRecord
+//
+//------------------------------------------------------------------------------
+
+size_t
+SNIFF_DecodeRecord(const UINT8* src, size_t length, TSnifferRecord& record)
+{
+    if (length < SNIFF_RECORD_HEADER_SIZE || NTOH16(src) != SNIFF_RECORD_MAGIC)
+        return 0;
+
+    size_t size = NTOH16(&src[2]);
+
+    if (size < SNIFF_RECORD_HEADER_SIZE || size > length)
+        return 0;
+
+    record.Type   = src[4];
+    record.Flags  = src[5];
+    record.TimeUs = (INT64)((UINT64)NTOH32(&src[6]) | ((UINT64)NTOH32(&src[10]) << 32));
+    record.RxTime = NTOH32(&src[14]);
+    record.Rssi   = (INT16)NTOH16(&src[18]);
+    record.Snr    = (INT8)src[20];
+    record.Frame.assign(src + SNIFF_RECORD_HEADER_SIZE, src + size);
+
+    return size;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TSnifferCapture - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TSnifferCapture::TSnifferCapture()
+{
+    Running = false;
+    Stats   = TSnifferStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  TSnifferCapture - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TSnifferCapture::~TSnifferCapture()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetSnifferMode
+//
+//------------------------------------------------------------------------------
+
+void
+TSnifferCapture::SetSnifferMode(TWiMODLR_RadioConfig& radio)
+{
+    radio.RadioMode     = WiMODLR_RADIO_CONFIG_RM_SNIFFER;
+    radio.RxControl     = WiMODLR_RADIO_CONFIG_RX_ON;
+    radio.RadioOptions |= WiMODLR_RADIO_CONFIG_OPT_EXTENDED;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TSnifferCapture::Open(const std::string& filename, const TBlockFileConfig& config, UINT32 queueSize, TQueuePolicy policy)
+{
+    if (Running || !Writer.Open(filename, config))
+        return false;
+
+    // records cannot be merged, coalescing drops the oldest instead
+    Queue.reset(new TBoundedQueue<std::vector<UINT8>>(queueSize, policy));
+
+    {
+        std::lock_guard<std::mutex> lock(StatsLock);
+        Stats = TSnifferStats();
+    }
+
+    Running = true;
+    Thread  = std::thread(&TSnifferCapture::Run, this);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+bool
+TSnifferCapture::Close()
+{
+    if (!Running)
+        return true;
+
+    Queue->Close();
+
+    if (Thread.joinable())
+        Thread.join();
+
+    Running = false;
+
+    return Writer.Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: writer thread, queued records to the file until closed
+//
+//------------------------------------------------------------------------------
+
+void
+TSnifferCapture::Run()
+{
+    std::vector<UINT8> record;
+
+    while (true)
+    {
+        if (Queue->Pop(record, 100))
+        {
+            bool result = Writer.Write((const char*)record.data(), record.size());
+
+            std::lock_guard<std::mutex> lock(StatsLock);
+
+            if (result)
+                Stats.Bytes += record.size();
+            else
+                Stats.WriteErrors++;
+        }
+        else if (Queue->IsClosed())
+            break;
+
+        Writer.Poll();
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Capture
+//
+//------------------------------------------------------------------------------
+
+void
+TSnifferCapture::Capture(UINT8 type, const TWiMODLR_HCIMessage& rxMsg)
+{
+    bool decoded = SNIFF_DecodeIndication(type, rxMsg, Record);
+
+    {
+        std::lock_guard<std::mutex> lock(StatsLock);
+
+        if (!decoded)
+        {
+            Stats.Malformed++;
+            return;
+        }
+
+        if (type == SNIFF_TYPE_MESSAGE)
+            Stats.Messages++;
+        else
+            Stats.RawPackets++;
+
+        if (Record.Flags & SNIFF_FLAG_EXTENDED)
+            Stats.Extended++;
+    }
+
+    if (!Running)
+    {
+        std::lock_guard<std::mutex> lock(StatsLock);
+        Stats.Dropped++;
+        return;
+    }
+
+    Encoded.clear();
+    SNIFF_EncodeRecord(Record, Encoded);
+
+    // a rejected record is counted by the queue
+    Queue->Push(Encoded);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_RxUMessage
+//
+//------------------------------------------------------------------------------
+
+void
+TSnifferCapture::evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg)
+{
+    Capture(SNIFF_TYPE_MESSAGE, rxMsg);
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_RxRawMessage
+//
+//------------------------------------------------------------------------------
+
+void
+TSnifferCapture::evRadioLink_RxRawMessage(const TWiMODLR_HCIMessage& rxMsg)
+{
+    Capture(SNIFF_TYPE_RAW, rxMsg);
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetStats
+//
+//------------------------------------------------------------------------------
+
+TSnifferStats
+TSnifferCapture::GetStats()
+{
+    std::lock_guard<std::mutex> lock(StatsLock);
+
+    TSnifferStats stats = Stats;
+
+    // overwritten by the drop-oldest policy or pushed after close
+    if (Queue)
+        stats.Dropped += Queue->GetStats().Dropped;
+
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetQueueStats
+//
+//------------------------------------------------------------------------------
+
+TQueueStats
+TSnifferCapture::GetQueueStats()
+{
+    return Queue ? Queue->GetStats() : TQueueStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TSnifferCapture::FormatStats()
+{
+    TSnifferStats stats = GetStats();
+    TQueueStats   queue = GetQueueStats();
+
+    std::ostringstream text;
+
+    text << "messages=" << stats.Messages
+         << " raw=" << stats.RawPackets
+         << " extended=" << stats.Extended
+         << " malformed=" << stats.Malformed
+         << " dropped=" << stats.Dropped
+         << " bytes=" << stats.Bytes
+         << " high_water=" << queue.HighWater;
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SnifferCapture.h
+//
+//	Abstract:	Packet Capture in Sniffer Mode with Extended Rx Metadata
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SNIFFERCAPTURE_H
+#define SNIFFERCAPTURE_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "BlockFileWriter.h"
+#include "BoundedQueue.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// record: magic "SN", record length, type, flags, host time [us since
+// epoch], device Rx time (RTC format), RSSI [dBm], SNR [dB], then the frame
+// (all fields little endian)
+#define SNIFF_RECORD_MAGIC          0x4E53
+#define SNIFF_RECORD_HEADER_SIZE    21
+
+// frame of an unreliable message: destination and source address, payload;
+// of a raw packet: the radio bytes
+#define SNIFF_TYPE_MESSAGE          0
+#define SNIFF_TYPE_RAW              1
+
+// RSSI, SNR and Rx time valid (extended output format of the module)
+#define SNIFF_FLAG_EXTENDED         0x01
+
+// indication payload: format, [destination, source,] packet, [footer]
+#define SNIFF_FORMAT_SIZE           1
+#define SNIFF_ADDRESS_SIZE          (DATALINK_MSG_HEADER_SIZE - SNIFF_FORMAT_SIZE)
+
+#define SNIFF_DEFAULT_QUEUE         16384
+
+typedef struct
+{
+    UINT8               Type = SNIFF_TYPE_MESSAGE;
+    UINT8               Flags = 0;
+    INT64               TimeUs = 0;
+    UINT32              RxTime = 0;
+    INT16               Rssi = 0;
+    INT8                Snr = 0;
+    std::vector<UINT8>  Frame;
+}TSnifferRecord;
+
+typedef struct
+{
+    // indications decoded per type, with extended metadata, rejected
+    UINT64  Messages;
+    UINT64  RawPackets;
+    UINT64  Extended;
+    UINT64  Malformed;
+
+    // records lost before the file (queue closed or full)
+    UINT64  Dropped;
+
+    // record bytes written, write errors
+    UINT64  Bytes;
+    UINT64  WriteErrors;
+}TSnifferStats;
+
+//------------------------------------------------------------------------------
+//
+// Helper Functions
+//
+//------------------------------------------------------------------------------
+
+// decode a received message / raw packet indication, false if too short
+bool            SNIFF_DecodeIndication(UINT8 type, const TWiMODLR_HCIMessage& rxMsg, TSnifferRecord& record);
+
+// append the record to dst
+void            SNIFF_EncodeRecord(const TSnifferRecord& record, std::vector<UINT8>& dst);
+
+// decode the record at src, returns its size or 0 (bad magic, truncated)
+size_t          SNIFF_DecodeRecord(const UINT8* src, size_t length, TSnifferRecord& record);
+
+//------------------------------------------------------------------------------
+//
+// TSnifferCapture Class Declaration
+//
+// Records every message and raw packet indication of a module in sniffer
+// mode (WiMODLR_RADIO_CONFIG_RM_SNIFFER) with the RSSI, SNR and Rx time of
+// the extended output format. The HCI thread only decodes and queues the
+// encoded records; a writer thread appends them to the file through the
+// coalescing block writer, so storage latency never reaches the serial
+// reader. With the block policy (default) and a queue of a few seconds at
+// the maximum packet rate nothing is dropped. The sniffer configuration is
+// applied to RAM only, frames are kept as received with their addresses.
+//
+// Registered as HCI client, or called by the client in front.
+//
+//------------------------------------------------------------------------------
+
+class TSnifferCapture : public TWiMODLRHCIClient
+{
+    public:
+                    TSnifferCapture();
+                    ~TSnifferCapture();
+
+    bool            Open(const std::string& filename, const TBlockFileConfig& config = TBlockFileConfig(),
+                         UINT32 queueSize = SNIFF_DEFAULT_QUEUE, TQueuePolicy policy = QUEUE_POLICY_BLOCK);
+
+    // write all queued records, close the file
+    bool            Close();
+
+    // sniffer mode, receiver on, extended output in the configuration
+    static void     SetSnifferMode(TWiMODLR_RadioConfig& radio);
+
+    TSnifferStats   GetStats();
+    TQueueStats     GetQueueStats();
+
+    // "messages=.. raw=.. extended=.. malformed=.. dropped=.. bytes=.. high_water=.."
+    std::string     FormatStats();
+
+    // HCI client interface
+    void            evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override;
+    void            evRadioLink_RxRawMessage(const TWiMODLR_HCIMessage& rxMsg) override;
+
+    private:
+
+    void            Capture(UINT8 type, const TWiMODLR_HCIMessage& rxMsg);
+    void            Run();
+
+    TBlockFileWriter    Writer;
+
+    std::unique_ptr<TBoundedQueue<std::vector<UINT8>>>  Queue;
+
+    std::thread         Thread;
+    std::atomic<bool>   Running;
+
+    std::mutex          StatsLock;
+    TSnifferStats       Stats;
+
+    // reused by the HCI thread
+    TSnifferRecord      Record;
+    std::vector<UINT8>  Encoded;
+};
+
+#endif // SNIFFERCAPTURE_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+//
+//	File:		StdoutSink.h
+//
+//	Abstract:	Sample Sink printing CSV Rows on stdout
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef STDOUTSINK_H
+#define STDOUTSINK_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleSink.h"
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+//
+// TStdoutSink Class Declaration
+//
+// Replaces the print_res debug output of TWiMODLRHCI, rows use the CSV
+// format shared with the file logger.
+//
+//------------------------------------------------------------------------------
+
+class TStdoutSink : public TSampleSink
+{
+    public:
+
+    std::string     GetName() const override { return "stdout"; }
+    TSampleFormat   GetFormat() const override { return SAMPLE_FORMAT_CSV; }
+
+    bool            WriteSample(const TRLTSample& /* sample */, const std::string& row) override
+                    {
+                        bool result = std::fwrite(row.data(), 1, row.size(), stdout) == row.size();
+                        return std::fflush(stdout) == 0 && result;
+                    }
+
+    void            WriteComment(const std::string& comment) override
+                    {
+                        std::printf("# %s\n", comment.c_str());
+                        std::fflush(stdout);
+                    }
+};
+
+#endif // STDOUTSINK_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
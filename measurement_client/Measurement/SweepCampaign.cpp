@@ -0,0 +1,556 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SweepCampaign.cpp
+//
+//	Abstract:	Radio Parameter Sweep Campaigns
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SweepCampaign.h"
+#include "AdrController.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+//
+//  Grid Parameters
+//
+//------------------------------------------------------------------------------
+
+static const char* SweepKeys[] = { "sf", "bw", "cr", "power", 0 };
+
+// LoRa bandwidths of the iM282A [kHz, rounded down], index =
+// WiMODLR_RADIO_CONFIG_BW_...
+static const long SweepBandwidths[] = { 203, 406, 812, 1625 };
+
+#define SWEEP_NUM_BANDWIDTHS    (sizeof(SweepBandwidths) / sizeof(SweepBandwidths[0]))
+
+//------------------------------------------------------------------------------
+//
+//  SetParameter
+//
+//  @brief: set one grid value, returns false if out of range
+//
+//------------------------------------------------------------------------------
+
+static bool
+SetParameter(const std::string& key, const std::string& value, TWiMODLR_RadioConfig& radio)
+{
+    // coding rate as "4/5" or "5"
+    std::string number = key == "cr" && !value.compare(0, 2, "4/") ? value.substr(2) : value;
+
+    char* end;
+    long  n = std::strtol(number.c_str(), &end, 10);
+
+    if (number.empty() || *end)
+        return false;
+
+    if (key == "sf")
+    {
+        if (n < WiMODLR_RADIO_CONFIG_SF5 || n > WiMODLR_RADIO_CONFIG_SF12)
+            return false;
+
+        radio.SpreadingFactor = (UINT8)n;
+        return true;
+    }
+
+    if (key == "bw")
+    {
+        for (UINT8 code = 0; code < SWEEP_NUM_BANDWIDTHS; code++)
+        {
+            if (SweepBandwidths[code] == n)
+            {
+                radio.Bandwidth = code;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (key == "cr")
+    {
+        if (n < 5 || n > 8)
+            return false;
+
+        radio.ErrorCoding = (UINT8)(WiMODLR_RADIO_CONFIG_EC_4_5 + n - 5);
+        return true;
+    }
+
+    // power level [dBm]
+    if (n < 5 || n > 20)
+        return false;
+
+    radio.PowerLevel = (UINT8)n;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TSweepCampaign - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TSweepCampaign::TSweepCampaign(TWiMODLRHCI& hci, TRadioSupervisor& supervisor, TSampleFanout& fanout)
+    : HCI(hci),
+      Supervisor(supervisor),
+      Fanout(fanout)
+{
+    Base            = TWiMODLR_RadioConfig();
+    Current         = 0;
+    Running         = false;
+    Done            = false;
+    Announce        = false;
+    Sequence        = 0;
+    Waiting         = false;
+    Converged       = false;
+    HasIndication   = false;
+    Stats           = TSweepStats();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ParseGrid
+//
+//  @brief: "key=value,value;key=..." (';' or blanks between parameters),
+//          the first parameter changes slowest
+//
+//------------------------------------------------------------------------------
+
+bool
+TSweepCampaign::ParseGrid(const std::string& grid, const TWiMODLR_RadioConfig& base,
+                          std::vector<TSweepPoint>& points, std::string& error)
+{
+    std::string text = grid;
+    std::replace(text.begin(), text.end(), ';', ' ');
+
+    std::vector<TWiMODLR_RadioConfig> radios(1, base);
+
+    std::istringstream parameters(text);
+    std::string        parameter;
+
+    while (parameters >> parameter)
+    {
+        size_t      equal = parameter.find('=');
+        std::string key   = parameter.substr(0, equal);
+
+        bool known = false;
+        for (int i = 0; SweepKeys[i]; i++)
+            known = known || key == SweepKeys[i];
+
+        if (equal == std::string::npos || !known)
+        {
+            error = "unknown parameter " + parameter;
+            return false;
+        }
+
+        std::vector<TWiMODLR_RadioConfig> expanded;
+
+        for (const TWiMODLR_RadioConfig& radio : radios)
+        {
+            std::istringstream values(parameter.substr(equal + 1));
+            std::string        value;
+            int                count = 0;
+
+            while (std::getline(values, value, ','))
+            {
+                TWiMODLR_RadioConfig point = radio;
+
+                if (!SetParameter(key, value, point))
+                {
+                    error = "bad value " + key + "=" + value;
+                    return false;
+                }
+
+                expanded.push_back(point);
+                count++;
+            }
+
+            if (!count)
+            {
+                error = "no values for " + key;
+                return false;
+            }
+        }
+
+        radios.swap(expanded);
+
+        if (radios.size() > 0xFFFF)
+        {
+            error = "too many points";
+            return false;
+        }
+    }
+
+    if (text.find('=') == std::string::npos)
+    {
+        error = "empty grid";
+        return false;
+    }
+
+    points.clear();
+
+    for (size_t i = 0; i < radios.size(); i++)
+    {
+        TSweepPoint point;
+
+        point.Id    = (UINT16)(i + 1);
+        point.Radio = radios[i];
+
+        points.push_back(point);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatRadio
+//
+//  @brief: grid syntax, so a point can be repeated with --sweep
+//
+//------------------------------------------------------------------------------
+
+std::string
+TSweepCampaign::FormatRadio(const TWiMODLR_RadioConfig& radio)
+{
+    std::ostringstream text;
+
+    text << "sf=" << (int)radio.SpreadingFactor
+         << " bw=" << (radio.Bandwidth < SWEEP_NUM_BANDWIDTHS ? SweepBandwidths[radio.Bandwidth] : -1)
+         << " cr=4/" << std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 5 - WiMODLR_RADIO_CONFIG_EC_4_5
+         << " power=" << (int)radio.PowerLevel;
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  IsLocalGrid
+//
+//------------------------------------------------------------------------------
+
+bool
+TSweepCampaign::IsLocalGrid(const std::vector<TSweepPoint>& points)
+{
+    for (const TSweepPoint& point : points)
+    {
+        if (point.Radio.SpreadingFactor != points.front().Radio.SpreadingFactor
+            || point.Radio.Bandwidth != points.front().Radio.Bandwidth
+            || point.Radio.ErrorCoding != points.front().Radio.ErrorCoding)
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+TSweepCampaign::Start(const std::string& grid, const TSweepConfig& config)
+{
+    UINT8 status = 0;
+
+    if (HCI.GetRadioConfiguration(Base, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not read radio configuration" << std::endl;
+        return false;
+    }
+
+    std::string error;
+
+    if (!ParseGrid(grid, Base, Points, error))
+    {
+        std::cerr << "Error: Sweep grid: " << error << std::endl;
+        return false;
+    }
+
+    Config    = config;
+    Running   = true;
+    Done      = false;
+    Announce  = Config.AnnounceRepeats && !IsLocalGrid(Points);
+    Stats     = TSweepStats();
+
+    Config.SegmentS = std::max<UINT32>(1, Config.SegmentS);
+    Estimator.SetMethod(Config.Method, Config.Confidence);
+
+    // the configurations ahead of the samples
+    Fanout.PublishComment("sweep base " + FormatRadio(Base));
+
+    // time on air of the test packets, the ceiling of the packet rate
+    UINT8 packetSize = Supervisor.GetTestConfig().PacketSize;
+
+    for (const TSweepPoint& point : Points)
+        Fanout.PublishComment("sweep config=" + std::to_string(point.Id) + " " + FormatRadio(point.Radio)
+                              + " " + AIRTIME_Format(point.Radio, packetSize));
+
+    std::cout << "Sweep: " << Points.size() << " configurations, " << Config.SegmentS << " s each";
+
+    if (Config.MaxWidth > 0)
+        std::cout << ", early stop at " << PER_MethodName(Config.Method) << " interval width " << Config.MaxWidth;
+
+    if (Announce)
+        std::cout << ", announced to the peer";
+
+    std::cout << std::endl;
+
+    SegmentEnd = TClock::now() + std::chrono::seconds(Config.SegmentS);
+
+    Apply(0);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//------------------------------------------------------------------------------
+
+void
+TSweepCampaign::Poll()
+{
+    if (!Running)
+        return;
+
+    TClock::time_point now = TClock::now();
+
+    if (now < SegmentEnd && !Converged)
+        return;
+
+    Finish(now);
+
+    if (Current + 1 < Points.size())
+    {
+        Apply(Current + 1);
+        return;
+    }
+
+    Stop();
+
+    Done = true;
+
+    std::cout << "Sweep done: " << FormatStats() << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Finish
+//
+//  @brief: end of the current point; a fixed schedule is kept without
+//          early stop, a slow switch does not shift the following segments;
+//          an early stop does, the peer follows the announcements
+//
+//------------------------------------------------------------------------------
+
+void
+TSweepCampaign::Finish(TClock::time_point now)
+{
+    std::string comment = "sweep end config=" + std::to_string(Points[Current].Id);
+
+    if (Converged && now < SegmentEnd)
+    {
+        Stats.EarlyStops++;
+        Stats.SavedMs += std::chrono::duration_cast<std::chrono::milliseconds>(SegmentEnd - now).count();
+
+        SegmentEnd = now;
+        comment   += " converged";
+    }
+
+    SegmentEnd += std::chrono::seconds(Config.SegmentS);
+
+    comment += " " + Estimator.Format();
+
+    // test packets sent by the local module against the airtime limit
+    double seconds = std::chrono::duration<double>(LastIndication - PointStart).count();
+
+    if (!Waiting && seconds > 0)
+    {
+        char rate[64];
+
+        std::snprintf(rate, sizeof(rate), " rate=%.2f/s ceiling=%.2f/s", Estimator.GetUplink().Trials / seconds,
+                      AIRTIME_GetLinkTestRate(Points[Current].Radio, Supervisor.GetTestConfig().PacketSize));
+
+        comment += rate;
+    }
+
+    Fanout.PublishComment(comment);
+
+    std::cout << "Sweep " << comment.substr(6) << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+TSweepCampaign::Stop()
+{
+    if (!Running)
+        return;
+
+    Running = false;
+
+    // the peer goes back as well, the test is stopped right after
+    bool restored = Announce && Reconfigure(Base);
+
+    Supervisor.Stop();
+
+    UINT8 status = 0;
+
+    if (!restored
+        && (HCI.SetRadioConfiguration(Base, WiMODLR_STORE_INTO_RAM, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK))
+        std::cerr << "Warning: Radio configuration not restored" << std::endl;
+
+    Fanout.SetConfigId(0);
+    Fanout.PublishComment("sweep done " + FormatStats());
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TSweepCampaign::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << "points=" << Stats.Points
+         << " failures=" << Stats.Failures
+         << " early=" << Stats.EarlyStops
+         << " saved=" << Stats.SavedMs / 1000 << " s"
+         << " dead mean=" << (Stats.Switches ? Stats.TotalDeadMs / Stats.Switches : 0) << " ms"
+         << " max=" << Stats.MaxDeadMs << " ms";
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLinkTest_StatusInd
+//
+//  @brief: the first sample of a point completes the switch
+//
+//------------------------------------------------------------------------------
+
+void
+TSweepCampaign::evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status)
+{
+    TClock::time_point now = TClock::now();
+
+    if (Running && Waiting)
+    {
+        std::string comment = "sweep start config=" + std::to_string(Points[Current].Id);
+
+        if (HasIndication)
+        {
+            UINT64 deadMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - LastIndication).count();
+
+            Stats.Switches++;
+            Stats.TotalDeadMs += deadMs;
+            Stats.LastDeadMs   = deadMs;
+            Stats.MaxDeadMs    = std::max(Stats.MaxDeadMs, deadMs);
+
+            comment += " dead=" + std::to_string(deadMs) + " ms";
+        }
+
+        // written before the first sample of the point
+        Fanout.PublishComment(comment);
+
+        Waiting    = false;
+        PointStart = now;
+    }
+
+    LastIndication = now;
+    HasIndication  = true;
+
+    if (Running)
+    {
+        Estimator.Add(status);
+
+        if (Config.MaxWidth > 0 && !Converged)
+            Converged = Estimator.IsConverged(Config.MaxWidth, Config.MinPackets);
+    }
+
+    Supervisor.evRadioLinkTest_StatusInd(status);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Apply
+//
+//  @brief: indications of the old point are dropped by the handshake, all
+//          following ones carry the new id
+//
+//------------------------------------------------------------------------------
+
+void
+TSweepCampaign::Apply(size_t index)
+{
+    const TSweepPoint& point = Points[index];
+
+    Current   = index;
+    Waiting   = true;
+    Converged = false;
+
+    // PER of the new point from its first indication
+    Estimator.Reset();
+
+    Stats.Points++;
+
+    Fanout.SetConfigId(point.Id);
+
+    std::cout << "Sweep config " << point.Id << "/" << Points.size() << ": " << FormatRadio(point.Radio) << std::endl;
+
+    if (!Reconfigure(point.Radio))
+    {
+        Stats.Failures++;
+
+        Fanout.PublishComment("sweep config=" + std::to_string(point.Id) + " failed");
+
+        std::cerr << "Warning: Sweep config " << point.Id << " not applied" << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reconfigure
+//
+//  @brief: through the supervisor, announced to the peer first if the grid
+//          changes parameters of both ends
+//
+//------------------------------------------------------------------------------
+
+bool
+TSweepCampaign::Reconfigure(const TWiMODLR_RadioConfig& radio)
+{
+    if (!Announce)
+        return Supervisor.Reconfigure(radio);
+
+    return Supervisor.Reconfigure(radio, TAdrController::EncodeFrame(Sequence++, radio), Config.AnnounceRepeats);
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SweepCampaign.h
+//
+//	Abstract:	Radio Parameter Sweep Campaigns
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef SWEEPCAMPAIGN_H
+#define SWEEPCAMPAIGN_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "SampleFanout.h"
+#include "RadioSupervisor.h"
+#include "PerInterval.h"
+#include "Airtime.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// default radio link test segment per configuration [s]
+#define SWEEP_DEFAULT_SEGMENT_S     300
+
+// default announcements to the peer per switch
+#define SWEEP_DEFAULT_ANNOUNCE      3
+
+typedef struct
+{
+    // radio link test segment per point [s], upper bound with early stop
+    UINT32              SegmentS    = SWEEP_DEFAULT_SEGMENT_S;
+
+    // early stop: a point ends as soon as the confidence intervals of
+    // uplink and downlink PER are at most MaxWidth wide (0 = off)
+    double              MaxWidth    = 0;
+    TPerIntervalMethod  Method      = PER_INTERVAL_WILSON;
+    double              Confidence  = 0.95;
+
+    // packets per direction before a point may end early
+    UINT32              MinPackets  = 100;
+
+    // announcements per switch if the grid changes SF, bandwidth or coding
+    // rate, 0 = the peer is configured by hand
+    UINT32              AnnounceRepeats = SWEEP_DEFAULT_ANNOUNCE;
+}TSweepConfig;
+
+typedef struct
+{
+    // 1..number of points, CSV column "Config"
+    UINT16                  Id;
+    TWiMODLR_RadioConfig    Radio;
+}TSweepPoint;
+
+typedef struct
+{
+    // configurations started, reconfigurations which failed
+    UINT32  Points;
+    UINT32  Failures;
+
+    // points ended by the PER intervals, segment time left over [ms]
+    UINT32  EarlyStops;
+    UINT64  SavedMs;
+
+    // last sample of a configuration until the first of the next [ms]
+    UINT32  Switches;
+    UINT64  TotalDeadMs;
+    UINT64  MaxDeadMs;
+    UINT64  LastDeadMs;
+}TSweepStats;
+
+//------------------------------------------------------------------------------
+//
+// TSweepCampaign Class Declaration
+//
+// Runs one radio link test segment per point of a parameter grid, e.g.
+// "sf=7,9,12;bw=203,406;cr=4/5,4/8;power=14,20" (every combination, the
+// last parameter changes fastest, parameters not listed keep the value
+// found in the module). Points are applied to RAM through the supervisor
+// (TRadioSupervisor::Reconfigure), the NVM configuration is left alone.
+// Every sample is tagged with the id of its point; the points with their
+// time on air (Airtime.h), the dead time of each switch (last sample of the
+// previous point until the first of the next: stop, drain, configure,
+// start) and the measured packet rate against the ceiling of the point are
+// written as comments. Binary records carry no id, only sinks with comments
+// see the segment boundaries. After a module reset the supervisor applies
+// the point of the current segment again.
+//
+// SF, bandwidth and coding rate must match on both ends. A grid which
+// changes them announces every point to the peer before it is applied, in
+// the ADR frame format (TAdrController::EncodeFrame) and the old
+// configuration, and the host of the peer applies it with --adr-follow; the
+// peer takes the power of the point as well. The end of the campaign
+// announces the base configuration. A grid of local parameters only
+// (power) leaves the peer alone.
+//
+// With early stopping a point ends once the Wilson or Clopper-Pearson
+// intervals of uplink and downlink PER (TLinkPerEstimator) are narrow
+// enough, the next point starts right away and the following segments move
+// forward; the segment length stays the upper bound. The end of every
+// point is written with both intervals, their sample counts and whether
+// it converged. Otherwise the segments follow a fixed schedule from Start.
+// Without announcements a peer configured by hand could only keep the
+// schedule, early stopping is then limited to grids of local parameters.
+//
+// Registered as HCI client in front of the supervisor, Poll switches the
+// points and must be called from the thread which drives the HCI.
+//
+//------------------------------------------------------------------------------
+
+class TSweepCampaign : public TWiMODLRHCIClient
+{
+    public:
+                    TSweepCampaign(TWiMODLRHCI& hci, TRadioSupervisor& supervisor, TSampleFanout& fanout);
+
+    // expand grid, parameters not listed are taken from base
+    static bool     ParseGrid(const std::string& grid, const TWiMODLR_RadioConfig& base,
+                              std::vector<TSweepPoint>& points, std::string& error);
+
+    // "sf=9 bw=203 cr=4/5 power=14"
+    static std::string  FormatRadio(const TWiMODLR_RadioConfig& radio);
+
+    // all points share SF, bandwidth and coding rate, the peer needs not
+    // follow
+    static bool     IsLocalGrid(const std::vector<TSweepPoint>& points);
+
+    // read the current configuration as base, apply the first point and
+    // start the test (supervisor started before)
+    bool            Start(const std::string& grid, const TSweepConfig& config = TSweepConfig());
+
+    // switch to the next point at the end of a segment or once the PER
+    // of the point is known precisely enough
+    void            Poll();
+
+    // all segments done, the test is stopped
+    bool            IsDone() const { return Done; }
+
+    // stop the test and restore the configuration found at Start (RAM)
+    void            Stop();
+
+    TSweepStats     GetStats() const { return Stats; }
+
+    // "points=.. failures=.. early=.. saved=.. s dead mean=.. ms max=.. ms"
+    std::string     FormatStats() const;
+
+    // HCI client interface, indications are forwarded to the supervisor
+    void            evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override;
+
+    private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    void            Apply(size_t index);
+    void            Finish(TClock::time_point now);
+    bool            Reconfigure(const TWiMODLR_RadioConfig& radio);
+
+    TWiMODLRHCI&        HCI;
+    TRadioSupervisor&   Supervisor;
+    TSampleFanout&      Fanout;
+
+    TWiMODLR_RadioConfig        Base;
+    std::vector<TSweepPoint>    Points;
+    size_t                      Current;
+    TSweepConfig                Config;
+    bool                        Running;
+    bool                        Done;
+
+    // points are announced to the peer, sequence of the next announcement
+    bool                        Announce;
+    UINT8                       Sequence;
+
+    // end of the current segment, an early stop shifts the schedule
+    TClock::time_point  SegmentEnd;
+
+    // PER of the current point
+    TLinkPerEstimator   Estimator;
+    bool                Converged;
+
+    // waiting for the first sample of the current point
+    bool                Waiting;
+    TClock::time_point  PointStart;
+    TClock::time_point  LastIndication;
+    bool                HasIndication;
+
+    TSweepStats         Stats;
+};
+
+#endif // SWEEPCAMPAIGN_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,534 @@
+//------------------------------------------------------------------------------
+//
+//	File:		TcpPublisher.cpp
+//
+//	Abstract:	Store-and-Forward Sample Sink publishing to a Collector
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "TcpPublisher.h"
+#include "RLTCodec.h"
+#include <algorithm>
+#include <deque>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// connect and RESUME timeout
+#define PUBLISHER_CONNECT_TIMEOUT_MS    5000
+
+// a blocked send gives up the connection after this time
+#define PUBLISHER_SEND_TIMEOUT_S        10
+
+//------------------------------------------------------------------------------
+//
+//  TTcpPublisher - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TTcpPublisher::TTcpPublisher()
+{
+    Running         = false;
+    Connected       = false;
+    WakeHandle      = -1;
+    FramesSent      = 0;
+    SamplesSent     = 0;
+    BytesSent       = 0;
+    Connects        = 0;
+    ConnectErrors   = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TTcpPublisher - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TTcpPublisher::~TTcpPublisher()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//------------------------------------------------------------------------------
+
+bool
+TTcpPublisher::Open(const TPublisherConfig& config)
+{
+    if (Running)
+        return false;
+
+    Config = config;
+    Config.BatchSamples = std::min<UINT32>(std::max<UINT32>(Config.BatchSamples, 1), RLT_BLOCK_MAX_SAMPLES);
+    Config.Window       = std::max<UINT32>(Config.Window, 1);
+
+    if (Config.Node.empty() || Config.Node.size() > PUBLISH_MAX_NODE_NAME)
+        return false;
+
+    if (!Spool.Open(Config.SpoolDir, Config.SegmentSize, Config.MaxSpoolSize, Config.SyncSpool))
+        return false;
+
+    WakeHandle = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (WakeHandle < 0)
+        return false;
+
+    Running = true;
+    Thread  = std::thread(&TTcpPublisher::Run, this);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TTcpPublisher::Close(UINT32 drainMs)
+{
+    if (!Running)
+        return;
+
+    FlushBatch();
+
+    // give the collector the chance to acknowledge everything
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(drainMs);
+    while (Spool.GetAcknowledged() < Spool.GetNextSequence() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    Running = false;
+    Wake();
+
+    if (Thread.joinable())
+        Thread.join();
+
+    ::close(WakeHandle);
+    WakeHandle = -1;
+
+    Spool.Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetStats
+//
+//------------------------------------------------------------------------------
+
+TPublisherStats
+TTcpPublisher::GetStats()
+{
+    TPublisherStats stats;
+    TSpoolStats     spool = Spool.GetStats();
+
+    stats.FramesSent        = FramesSent;
+    stats.SamplesSent       = SamplesSent;
+    stats.BytesSent         = BytesSent;
+    stats.Connects          = Connects;
+    stats.ConnectErrors     = ConnectErrors;
+    stats.Acknowledged      = Spool.GetAcknowledged();
+    stats.NextSequence      = Spool.GetNextSequence();
+    stats.SpoolSize         = Spool.GetSize();
+    stats.DroppedSamples    = spool.DroppedSamples;
+
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteSample
+//
+//------------------------------------------------------------------------------
+
+bool
+TTcpPublisher::WriteSample(const TRLTSample& sample, const std::string& /* encoded */)
+{
+    if (Batch.empty())
+        BatchStart = std::chrono::steady_clock::now();
+
+    Batch.push_back(sample);
+
+    if (Batch.size() >= Config.BatchSamples)
+        return FlushBatch();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: spool a partial batch after the flush latency
+//
+//------------------------------------------------------------------------------
+
+void
+TTcpPublisher::Poll()
+{
+    if (!Batch.empty()
+        && std::chrono::steady_clock::now() - BatchStart >= std::chrono::milliseconds(Config.FlushLatencyMs))
+    {
+        FlushBatch();
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  FlushBatch
+//
+//  @brief: encode batch as one block and append it to the spool
+//
+//------------------------------------------------------------------------------
+
+bool
+TTcpPublisher::FlushBatch()
+{
+    if (Batch.empty())
+        return true;
+
+    Block.clear();
+
+    bool result = TRLTBlockEncoder::EncodeBlock(Batch.data(), (int)Batch.size(), Block)
+                  && Spool.Append(Block.data(), Block.size(), (UINT32)Batch.size());
+
+    Batch.clear();
+    Wake();
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Wake
+//
+//------------------------------------------------------------------------------
+
+void
+TTcpPublisher::Wake()
+{
+    UINT64 value = 1;
+
+    if (WakeHandle >= 0 && ::write(WakeHandle, &value, sizeof(value)) < 0)
+    {
+        // counter overflow only, the thread is awake anyway
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: network thread, (re)connect with exponential backoff
+//
+//------------------------------------------------------------------------------
+
+void
+TTcpPublisher::Run()
+{
+    UINT32 backoffMs = Config.ReconnectMinMs;
+
+    while (Running)
+    {
+        int    handle;
+        UINT64 resume;
+
+        if (!Connect(handle, resume))
+        {
+            ConnectErrors++;
+
+            auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoffMs);
+            while (Running && std::chrono::steady_clock::now() < until)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            backoffMs = std::min(backoffMs * 2, Config.ReconnectMaxMs);
+            continue;
+        }
+
+        backoffMs = Config.ReconnectMinMs;
+        Connects++;
+
+        // everything before resume is stored by the collector
+        Spool.Acknowledge(resume);
+
+        Connected = true;
+        Serve(handle, resume);
+        Connected = false;
+
+        ::close(handle);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Connect
+//
+//  @brief: connect, send HELLO and wait for RESUME
+//
+//------------------------------------------------------------------------------
+
+bool
+TTcpPublisher::Connect(int& handle, UINT64& resume)
+{
+    struct addrinfo  hints = {};
+    struct addrinfo* result;
+
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (::getaddrinfo(Config.Host.c_str(), Config.Port.c_str(), &hints, &result) != 0)
+        return false;
+
+    handle = -1;
+
+    for (struct addrinfo* addr = result; addr && handle < 0; addr = addr->ai_next)
+    {
+        handle = ::socket(addr->ai_family, addr->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addr->ai_protocol);
+        if (handle < 0)
+            continue;
+
+        // non-blocking connect to bound the time on a dead uplink
+        int error = 0;
+        if (::connect(handle, addr->ai_addr, addr->ai_addrlen) != 0)
+        {
+            error = errno;
+            if (error == EINPROGRESS)
+            {
+                struct pollfd fds = { handle, POLLOUT, 0 };
+                socklen_t     size = sizeof(error);
+
+                if (::poll(&fds, 1, PUBLISHER_CONNECT_TIMEOUT_MS) != 1
+                    || ::getsockopt(handle, SOL_SOCKET, SO_ERROR, &error, &size) != 0)
+                    error = ETIMEDOUT;
+            }
+        }
+
+        if (error)
+        {
+            ::close(handle);
+            handle = -1;
+        }
+    }
+
+    ::freeaddrinfo(result);
+
+    if (handle < 0)
+        return false;
+
+    // blocking sends with timeout from here on
+    ::fcntl(handle, F_SETFL, ::fcntl(handle, F_GETFL) & ~O_NONBLOCK);
+
+    struct timeval timeout = { PUBLISHER_SEND_TIMEOUT_S, 0 };
+    int            noDelay = 1;
+
+    ::setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    std::vector<UINT8> hello;
+    Publish_AppendMessage(hello, PUBLISH_MSG_HELLO, (const UINT8*)Config.Node.data(), Config.Node.size());
+
+    if (Publish_SendAll(handle, hello.data(), hello.size()))
+    {
+        TPublishParser parser;
+        auto           deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(PUBLISHER_CONNECT_TIMEOUT_MS);
+
+        while (Running && !parser.HasError())
+        {
+            int waitMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                            deadline - std::chrono::steady_clock::now()).count();
+
+            struct pollfd fds = { handle, POLLIN, 0 };
+            if (waitMs <= 0 || ::poll(&fds, 1, waitMs) != 1)
+                break;
+
+            UINT8   buffer[256];
+            ssize_t length = ::recv(handle, buffer, sizeof(buffer), 0);
+            if (length <= 0)
+                break;
+
+            parser.Append(buffer, length);
+
+            UINT8        type;
+            const UINT8* body;
+            size_t       bodyLength;
+
+            // RESUME is the first message of the collector
+            if (parser.Next(type, body, bodyLength))
+            {
+                if (type != PUBLISH_MSG_RESUME || bodyLength != 8)
+                    break;
+
+                resume = Publish_Get64(body);
+                return true;
+            }
+        }
+    }
+
+    ::close(handle);
+    handle = -1;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Serve
+//
+//  @brief: send spooled frames within the window, process ACKs; returns
+//          on connection loss or stop
+//
+//------------------------------------------------------------------------------
+
+bool
+TTcpPublisher::Serve(int handle, UINT64 sequence)
+{
+    TPublishParser      parser;
+    std::deque<UINT64>  inflight;
+
+    while (Running)
+    {
+        // fill the window
+        while (inflight.size() < Config.Window)
+        {
+            UINT64 next = sequence;
+            if (!SendFrame(handle, next))
+                return false;
+            if (next == sequence)
+                break;
+
+            sequence = next;
+            inflight.push_back(sequence);
+        }
+
+        struct pollfd fds[2] = { { handle, POLLIN, 0 }, { WakeHandle, POLLIN, 0 } };
+
+        if (::poll(fds, 2, 1000) < 0 && errno != EINTR)
+            return false;
+
+        if (fds[1].revents & POLLIN)
+        {
+            UINT64 value;
+            if (::read(WakeHandle, &value, sizeof(value)) < 0)
+            {
+                // already cleared by an earlier read
+            }
+        }
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            UINT8   buffer[1024];
+            ssize_t length = ::recv(handle, buffer, sizeof(buffer), 0);
+            if (length <= 0)
+                return false;
+
+            parser.Append(buffer, length);
+
+            UINT8        type;
+            const UINT8* body;
+            size_t       bodyLength;
+
+            while (parser.Next(type, body, bodyLength))
+            {
+                if (type != PUBLISH_MSG_ACK || bodyLength != 8)
+                    continue;
+
+                UINT64 acked = Publish_Get64(body);
+
+                Spool.Acknowledge(acked);
+
+                while (!inflight.empty() && inflight.front() <= acked)
+                    inflight.pop_front();
+            }
+
+            if (parser.HasError())
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendFrame
+//
+//  @brief: send the spooled frame holding sequence, sequence is advanced
+//          behind it; unchanged if nothing is spooled, false on error
+//
+//------------------------------------------------------------------------------
+
+bool
+TTcpPublisher::SendFrame(int handle, UINT64& sequence)
+{
+    UINT64             first;
+    UINT32             count;
+    std::vector<UINT8> block;
+
+    if (!Spool.ReadFrame(sequence, first, count, block))
+        return true;
+
+    // resume point inside the frame, send the remaining samples only
+    if (first < sequence)
+    {
+        std::vector<TRLTSample> samples;
+
+        if (!TRLTBlockDecoder::DecodeBlock(block.data(), block.size(), samples) || samples.size() != count)
+            return false;
+
+        samples.erase(samples.begin(), samples.begin() + (sequence - first));
+
+        block.clear();
+        if (!TRLTBlockEncoder::EncodeBlock(samples.data(), (int)samples.size(), block))
+            return false;
+
+        count = (UINT32)samples.size();
+        first = sequence;
+    }
+
+    std::vector<UINT8> message;
+    std::vector<UINT8> body(8 + block.size());
+
+    Publish_Put64(body.data(), first);
+    std::copy(block.begin(), block.end(), body.begin() + 8);
+    Publish_AppendMessage(message, PUBLISH_MSG_DATA, body.data(), body.size());
+
+    if (!Publish_SendAll(handle, message.data(), message.size()))
+        return false;
+
+    FramesSent++;
+    SamplesSent += count;
+    BytesSent   += message.size();
+
+    sequence = first + count;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//
+//	File:		TcpPublisher.h
+//
+//	Abstract:	Store-and-Forward Sample Sink publishing to a Collector
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef TCPPUBLISHER_H
+#define TCPPUBLISHER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleSink.h"
+#include "SampleSpool.h"
+#include "PublishProtocol.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    // collector address
+    std::string     Host;
+    std::string     Port            = PUBLISH_DEFAULT_PORT;
+
+    // node name sent to the collector
+    std::string     Node;
+
+    // spool directory, created if missing
+    std::string     SpoolDir;
+
+    // samples per frame and max. time a sample waits for its frame [ms]
+    UINT32          BatchSamples    = 64;
+    UINT32          FlushLatencyMs  = 1000;
+
+    // frames sent ahead of the acknowledgements
+    UINT32          Window          = 16;
+
+    // spool segment size and limit, fdatasync per frame
+    UINT64          SegmentSize     = SPOOL_DEFAULT_SEGMENT_SIZE;
+    UINT64          MaxSpoolSize    = SPOOL_DEFAULT_MAX_SIZE;
+    bool            SyncSpool       = true;
+
+    // reconnect backoff [ms], doubled per failed attempt up to the max.
+    UINT32          ReconnectMinMs  = 500;
+    UINT32          ReconnectMaxMs  = 30000;
+}TPublisherConfig;
+
+typedef struct
+{
+    UINT64  FramesSent;
+    UINT64  SamplesSent;
+    UINT64  BytesSent;
+    UINT64  Connects;
+    UINT64  ConnectErrors;
+    // next sequence acknowledged by the collector
+    UINT64  Acknowledged;
+    UINT64  NextSequence;
+    UINT64  SpoolSize;
+    UINT64  DroppedSamples;
+}TPublisherStats;
+
+//------------------------------------------------------------------------------
+//
+// TTcpPublisher Class Declaration
+//
+// Samples are batched into RLT blocks (RLTCodec) and appended to the spool
+// first, then sent by a network thread. The collector acknowledges stored
+// samples, acknowledged frames are removed from the spool. After a
+// reconnect the collector reports its next expected sequence and the
+// publisher continues from the spool at exactly this sample, also after a
+// restart of the client: samples are numbered continuously, so nothing is
+// lost or sent twice. A partial batch is sent after the flush latency.
+//
+//------------------------------------------------------------------------------
+
+class TTcpPublisher : public TSampleSink
+{
+    public:
+                    TTcpPublisher();
+                    ~TTcpPublisher();
+
+    // open spool and start network thread
+    bool            Open(const TPublisherConfig& config);
+
+    // spool pending batch, wait up to drainMs for outstanding
+    // acknowledgements, stop network thread; the spool is kept
+    void            Close(UINT32 drainMs = 0);
+
+    bool            IsConnected() const { return Connected; }
+
+    TPublisherStats GetStats();
+
+    // sample sink interface
+    std::string     GetName() const override { return "tcp:" + Config.Host + ":" + Config.Port; }
+    bool            WriteSample(const TRLTSample& sample, const std::string& encoded) override;
+    void            Poll() override;
+
+    private:
+
+    bool            FlushBatch();
+
+    // network thread
+    void            Run();
+    bool            Connect(int& handle, UINT64& resume);
+    bool            Serve(int handle, UINT64 sequence);
+    bool            SendFrame(int handle, UINT64& sequence);
+    void            Wake();
+
+    TPublisherConfig    Config;
+    TSampleSpool        Spool;
+
+    // batch of the sink thread
+    std::vector<TRLTSample> Batch;
+    std::vector<UINT8>      Block;
+    std::chrono::steady_clock::time_point BatchStart;
+
+    std::thread         Thread;
+    std::atomic<bool>   Running;
+    std::atomic<bool>   Connected;
+
+    // eventfd, new frame spooled or stop requested
+    int                 WakeHandle;
+
+    std::atomic<UINT64> FramesSent;
+    std::atomic<UINT64> SamplesSent;
+    std::atomic<UINT64> BytesSent;
+    std::atomic<UINT64> Connects;
+    std::atomic<UINT64> ConnectErrors;
+};
+
+#endif // TCPPUBLISHER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
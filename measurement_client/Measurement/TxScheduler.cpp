@@ -0,0 +1,471 @@
+//------------------------------------------------------------------------------
+//
+//	File:		TxScheduler.cpp
+//
+//	Abstract:	Priority Classes and Deficit Round Robin for Radio Messages
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "TxScheduler.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+//
+//  Section Data
+//
+//------------------------------------------------------------------------------
+
+static const char* ClassNames[TXSCHED_NUM_CLASSES] = { "control", "interactive", "bulk" };
+
+//------------------------------------------------------------------------------
+//
+//  TTxScheduler - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TTxScheduler::TTxScheduler(TWiMODLRHCI& hci)
+    : Link(hci)
+{
+    Client    = 0;
+    InCommand = false;
+
+    Configure(TTxSchedulerConfig());
+    Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::Configure(const TTxSchedulerConfig& config)
+{
+    Config = config;
+
+    Link.Configure(Config.Link);
+}
+
+//------------------------------------------------------------------------------
+//
+//  AddFlow
+//
+//------------------------------------------------------------------------------
+
+bool
+TTxScheduler::AddFlow(UINT8 flow, UINT8 txClass, UINT32 quantum)
+{
+    if (txClass >= TXSCHED_NUM_CLASSES || !quantum)
+        return false;
+
+    // a flow moved to another class leaves the round of the old one
+    for (std::deque<UINT8>& active : Active)
+        active.erase(std::remove(active.begin(), active.end(), flow), active.end());
+
+    TFlow& entry = Flows[flow];
+
+    entry.Class     = txClass;
+    entry.Quantum   = quantum;
+    entry.Deficit   = 0;
+    entry.InRound   = false;
+    entry.SentBytes = 0;
+
+    if (!entry.Queue.empty())
+        Active[txClass].push_back(flow);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reset
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::Reset()
+{
+    for (auto& entry : Flows)
+    {
+        entry.second.Queue.clear();
+        entry.second.Deficit   = 0;
+        entry.second.InRound   = false;
+        entry.second.SentBytes = 0;
+    }
+
+    for (int i = 0; i < TXSCHED_NUM_CLASSES; i++)
+    {
+        Active[i].clear();
+        ClassStats[i] = TTxClassStats();
+        Latency[i].Reset();
+    }
+
+    Posted.clear();
+    InModule.clear();
+    Commands.clear();
+    CommandLatency.Reset();
+
+    Link.Reset();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Send
+//
+//------------------------------------------------------------------------------
+
+bool
+TTxScheduler::Send(UINT8 flow, const UINT8* data, UINT16 length)
+{
+    auto entry = Flows.find(flow);
+
+    if (entry == Flows.end())
+        return false;
+
+    TFlow&         target = entry->second;
+    TTxClassStats& stats  = ClassStats[target.Class];
+
+    stats.Queued++;
+
+    if (length > DATALINK_MAX_PAYLOAD_SIZE || (Config.FlowQueued && target.Queue.size() >= Config.FlowQueued))
+    {
+        stats.Dropped++;
+        return false;
+    }
+
+    if (target.Queue.empty())
+        Active[target.Class].push_back(flow);
+
+    target.Queue.push_back({ std::vector<UINT8>(data, data + length), TClock::now() });
+
+    Pump();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RequestCommand
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::RequestCommand(UINT32 tag, bool drain)
+{
+    Commands.push_back({ tag, drain, TClock::now() });
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetQueued
+//
+//------------------------------------------------------------------------------
+
+size_t
+TTxScheduler::GetQueued(UINT8 flow) const
+{
+    auto entry = Flows.find(flow);
+
+    return entry == Flows.end() ? 0 : entry->second.Queue.size();
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetFlowBytes
+//
+//  @brief: payload of the flow sent on air
+//
+//------------------------------------------------------------------------------
+
+UINT64
+TTxScheduler::GetFlowBytes(UINT8 flow) const
+{
+    auto entry = Flows.find(flow);
+
+    return entry == Flows.end() ? 0 : entry->second.SentBytes;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetClassInFlight
+//
+//  @brief: messages of the class handed to the data link, not yet on air
+//
+//------------------------------------------------------------------------------
+
+UINT32
+TTxScheduler::GetClassInFlight(UINT8 txClass) const
+{
+    UINT32 count = 0;
+
+    for (const TOutstanding& outstanding : Posted)
+        count += outstanding.Class == txClass;
+
+    for (const TOutstanding& outstanding : InModule)
+        count += outstanding.Class == txClass;
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Pump
+//
+//  @brief: next message of the highest class with a free slot whenever the
+//          data link would post it at once; a pending command holds back
+//          all messages
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::Pump()
+{
+    // the command waits for the response on the serial link
+    if (InCommand || !Commands.empty())
+        return;
+
+    while (Link.IsReady())
+    {
+        bool sent = false;
+
+        for (UINT8 txClass = 0; txClass < TXSCHED_NUM_CLASSES && !sent; txClass++)
+        {
+            if (Active[txClass].empty())
+                continue;
+
+            if (Config.ClassInFlight[txClass] && GetClassInFlight(txClass) >= Config.ClassInFlight[txClass])
+                continue;
+
+            sent = Dequeue(txClass);
+        }
+
+        if (!sent)
+            return;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Dequeue
+//
+//  @brief: deficit round robin within the class, the flow at the head of
+//          the round sends while its deficit covers its next message
+//
+//------------------------------------------------------------------------------
+
+bool
+TTxScheduler::Dequeue(UINT8 txClass)
+{
+    std::deque<UINT8>& active = Active[txClass];
+
+    while (!active.empty())
+    {
+        UINT8  flowId = active.front();
+        TFlow& flow   = Flows[flowId];
+
+        if (!flow.InRound)
+        {
+            flow.Deficit += flow.Quantum;
+            flow.InRound  = true;
+        }
+
+        TPendingMessage& head = flow.Queue.front();
+
+        if (head.Message.size() > flow.Deficit)
+        {
+            // turn over, the deficit is kept for the next round
+            flow.InRound = false;
+            active.pop_front();
+            active.push_back(flowId);
+            continue;
+        }
+
+        flow.Deficit -= (UINT32)head.Message.size();
+
+        TOutstanding outstanding = { txClass, flowId, (UINT16)head.Message.size(), head.Queued };
+
+        bool accepted = Link.Send(head.Message.data(), (UINT16)head.Message.size());
+
+        flow.Queue.pop_front();
+
+        // an idle flow keeps no credit
+        if (flow.Queue.empty())
+        {
+            flow.Deficit = 0;
+            flow.InRound = false;
+            active.pop_front();
+        }
+
+        if (!accepted)
+        {
+            ClassStats[txClass].Dropped++;
+            return true;
+        }
+
+        Posted.push_back(outstanding);
+        Sync();
+
+        return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Sync
+//
+//  @brief: follow the data link: a posted message was accepted (moves to
+//          the module) or dropped, messages in the module were sent or
+//          given up; both keep their order
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::Sync()
+{
+    while (Posted.size() > Link.GetQueued())
+    {
+        if (InModule.size() < Link.GetInFlight())
+            InModule.push_back(Posted.front());
+        else
+            ClassStats[Posted.front().Class].Dropped++;
+
+        Posted.pop_front();
+    }
+
+    while (InModule.size() > Link.GetInFlight())
+        InModule.pop_front();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageRsp
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::evRadioLink_TxUMessageRsp(UINT8 status)
+{
+    Link.evRadioLink_TxUMessageRsp(status);
+
+    Sync();
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  evRadioLink_TxUMessageInd
+//
+//  @brief: the oldest message in the module went on air
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::evRadioLink_TxUMessageInd(UINT8 status)
+{
+    if (status == DATALINK_STATUS_OK && !InModule.empty() && Link.GetInFlight())
+    {
+        const TOutstanding& sent = InModule.front();
+
+        ClassStats[sent.Class].Sent++;
+        ClassStats[sent.Class].SentBytes += sent.Length;
+        Flows[sent.Flow].SentBytes       += sent.Length;
+
+        Latency[sent.Class].Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(TClock::now() - sent.Queued).count());
+    }
+
+    Link.evRadioLink_TxUMessageInd(status);
+
+    Sync();
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Poll
+//
+//  @brief: timeouts of the data link, commands whose conditions are met
+//
+//------------------------------------------------------------------------------
+
+void
+TTxScheduler::Poll()
+{
+    Link.Poll();
+    Sync();
+
+    while (!Commands.empty() && !InCommand)
+    {
+        const TCommand& command = Commands.front();
+
+        // nothing on the serial link, with drain nothing in the module
+        if (Link.GetQueued() || (command.Drain && !Link.IsIdle()))
+            break;
+
+        UINT32             tag       = command.Tag;
+        TClock::time_point requested = command.Requested;
+
+        Commands.pop_front();
+
+        // responses and indications during the blocking call are tracked,
+        // nothing is posted
+        InCommand = true;
+
+        if (Client)
+            Client->evTxScheduler_Command(tag);
+
+        InCommand = false;
+
+        CommandLatency.Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(TClock::now() - requested).count());
+    }
+
+    Pump();
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatStats
+//
+//------------------------------------------------------------------------------
+
+std::string
+TTxScheduler::FormatStats() const
+{
+    std::ostringstream text;
+
+    text << std::fixed << std::setprecision(1);
+
+    for (int i = 0; i < TXSCHED_NUM_CLASSES; i++)
+    {
+        if (!ClassStats[i].Queued)
+            continue;
+
+        text << ClassNames[i] << "=" << ClassStats[i].Sent << "/" << ClassStats[i].Dropped
+             << " p99=" << Latency[i].Percentile(99) / 1000.0 << " ms ";
+    }
+
+    text << "commands=" << CommandLatency.Count()
+         << " p99=" << CommandLatency.Percentile(99) / 1000.0 << " ms"
+         << " link: " << Link.FormatStats();
+
+    return text.str();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
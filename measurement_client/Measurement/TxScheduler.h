@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+//
+//	File:		TxScheduler.h
+//
+//	Abstract:	Priority Classes and Deficit Round Robin for Radio Messages
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef TXSCHEDULER_H
+#define TXSCHEDULER_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "DataLinkSender.h"
+#include "LatencyHistogram.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+//
+// General Declaration
+//
+//------------------------------------------------------------------------------
+
+// priority classes, a lower number goes first
+#define TXSCHED_CLASS_CONTROL       0
+#define TXSCHED_CLASS_INTERACTIVE   1
+#define TXSCHED_CLASS_BULK          2
+#define TXSCHED_NUM_CLASSES         3
+
+typedef struct
+{
+    // peer and data link (MaxInFlight: Tx queue of the module)
+    TDataLinkConfig     Link;
+
+    // slots of the module Tx queue a class may occupy (0 = all credits):
+    // the module sends in order, a control message waits behind at most
+    // this many bulk messages
+    UINT32  ClassInFlight[TXSCHED_NUM_CLASSES] = { 0, 0, 2 };
+
+    // messages waiting per flow, Send fails beyond (0 = unlimited)
+    UINT32  FlowQueued          = 64;
+}TTxSchedulerConfig;
+
+typedef struct
+{
+    // messages handed to Send, sent on air, dropped (flow queue full, too
+    // long or lost by the data link)
+    UINT64  Queued;
+    UINT64  Sent;
+    UINT64  SentBytes;
+    UINT64  Dropped;
+}TTxClassStats;
+
+//------------------------------------------------------------------------------
+//
+// TTxSchedulerClient Class Declaration
+//
+//------------------------------------------------------------------------------
+
+class TTxSchedulerClient
+{
+    public:
+    virtual             ~TTxSchedulerClient() {}
+
+    // the requested command may run now: no send request is outstanding
+    // (and the module queue is empty if requested), blocking HCI calls
+    // like PingRequest or SetRadioConfiguration are safe
+    virtual void        evTxScheduler_Command(UINT32 /* tag */) {}
+};
+
+//------------------------------------------------------------------------------
+//
+// TTxScheduler Class Declaration
+//
+// Host side Tx scheduler in front of the pipelined data link. Each flow
+// belongs to a priority class and has a queue of its own; the next message
+// is chosen only when the data link would post it at once (late binding),
+// so nothing but the request on the serial link and the module queue is
+// ahead of a control message. Classes are served in strict priority, flows
+// of a class by deficit round robin: a flow sends while its deficit covers
+// the head message and earns its quantum [bytes] per round, so flows share
+// the airtime of their class in proportion to their quanta independent of
+// their message sizes. ClassInFlight keeps bulk classes from filling the
+// module queue, which sends in order.
+//
+// Commands (ping, configuration changes) wait in a queue of their own ahead
+// of all classes; Poll hands them to the client once the serial link is
+// free, with drain also after the module queue ran empty (no message is
+// sent with the old configuration after the change). Latency per class is
+// kept from Send until the sent indication, for commands from the request
+// until they ran, in us.
+//
+// Not registered itself: the HCI client in front calls the data link
+// handlers. Poll runs the commands (never from within the HCI dispatch),
+// all calls from the thread which drives the HCI.
+//
+//------------------------------------------------------------------------------
+
+class TTxScheduler : public TWiMODLRHCIClient
+{
+    public:
+                    TTxScheduler(TWiMODLRHCI& hci);
+
+    void            Configure(const TTxSchedulerConfig& config);
+    void            RegisterClient(TTxSchedulerClient* client) { Client = client; }
+
+    // flow of a class with its quantum per round [bytes], false for an
+    // unknown class or a quantum of 0
+    bool            AddFlow(UINT8 flow, UINT8 txClass, UINT32 quantum = DATALINK_MAX_PAYLOAD_SIZE);
+
+    // queue a message of a flow, false for an unknown flow, a message too
+    // long or a full flow queue
+    bool            Send(UINT8 flow, const UINT8* data, UINT16 length);
+
+    // evTxScheduler_Command(tag) from the next Poll the command may run in
+    void            RequestCommand(UINT32 tag, bool drain = false);
+
+    void            Poll();
+
+    // messages waiting on the host
+    size_t          GetQueued(UINT8 flow) const;
+    size_t          GetPendingCommands() const { return Commands.size(); }
+
+    // drop queued messages and commands, counters start again
+    void            Reset();
+
+    TTxClassStats   GetClassStats(UINT8 txClass) const { return ClassStats[txClass % TXSCHED_NUM_CLASSES]; }
+    UINT64          GetFlowBytes(UINT8 flow) const;
+    const TLatencyHistogram&    GetLatency(UINT8 txClass) const { return Latency[txClass % TXSCHED_NUM_CLASSES]; }
+    const TLatencyHistogram&    GetCommandLatency() const { return CommandLatency; }
+    TDataLinkSender&    GetLink() { return Link; }
+
+    // "control=sent/dropped p99=.. ms ... commands=.. link: .."
+    std::string     FormatStats() const;
+
+    // HCI client interface, called by the registered client
+    void            evRadioLink_TxUMessageRsp(UINT8 status) override;
+    void            evRadioLink_TxUMessageInd(UINT8 status) override;
+
+    private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    typedef struct
+    {
+        std::vector<UINT8>  Message;
+        TClock::time_point  Queued;
+    }TPendingMessage;
+
+    typedef struct
+    {
+        UINT8               Class;
+        UINT32              Quantum;
+        UINT32              Deficit;
+        bool                InRound;
+        UINT64              SentBytes;
+        std::deque<TPendingMessage> Queue;
+    }TFlow;
+
+    // handed to the data link until on air
+    typedef struct
+    {
+        UINT8               Class;
+        UINT8               Flow;
+        UINT16              Length;
+        TClock::time_point  Queued;
+    }TOutstanding;
+
+    typedef struct
+    {
+        UINT32              Tag;
+        bool                Drain;
+        TClock::time_point  Requested;
+    }TCommand;
+
+    void            Pump();
+    bool            Dequeue(UINT8 txClass);
+    void            Sync();
+    UINT32          GetClassInFlight(UINT8 txClass) const;
+
+    TDataLinkSender     Link;
+    TTxSchedulerConfig  Config;
+    TTxSchedulerClient* Client;
+
+    std::map<UINT8, TFlow>  Flows;
+
+    // flows with messages per class, the head has the turn
+    std::deque<UINT8>   Active[TXSCHED_NUM_CLASSES];
+
+    // waiting in the data link for the response, accepted by the module
+    std::deque<TOutstanding>    Posted;
+    std::deque<TOutstanding>    InModule;
+
+    std::deque<TCommand>    Commands;
+    bool                InCommand;
+
+    TTxClassStats       ClassStats[TXSCHED_NUM_CLASSES];
+    TLatencyHistogram   Latency[TXSCHED_NUM_CLASSES];
+    TLatencyHistogram   CommandLatency;
+};
+
+#endif // TXSCHEDULER_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//
+//	File:		UdpSink.cpp
+//
+//	Abstract:	Sample Sink sending Binary Records as UDP Datagrams
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "UdpSink.h"
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+//
+//  TUdpSink - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TUdpSink::TUdpSink()
+{
+    Handle = -1;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~TUdpSink - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+TUdpSink::~TUdpSink()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: connected datagram socket, first resolved address is used
+//
+//------------------------------------------------------------------------------
+
+bool
+TUdpSink::Open(const std::string& host, const std::string& port)
+{
+    struct addrinfo  hints = {};
+    struct addrinfo* result;
+
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0)
+        return false;
+
+    for (struct addrinfo* addr = result; addr; addr = addr->ai_next)
+    {
+        Handle = ::socket(addr->ai_family, addr->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addr->ai_protocol);
+        if (Handle < 0)
+            continue;
+
+        if (::connect(Handle, addr->ai_addr, addr->ai_addrlen) == 0)
+            break;
+
+        ::close(Handle);
+        Handle = -1;
+    }
+
+    ::freeaddrinfo(result);
+
+    Destination = host + ":" + port;
+
+    return Handle >= 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+TUdpSink::Close()
+{
+    if (Handle >= 0)
+    {
+        ::close(Handle);
+        Handle = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  WriteSample
+//
+//------------------------------------------------------------------------------
+
+bool
+TUdpSink::WriteSample(const TRLTSample& /* sample */, const std::string& record)
+{
+    if (Handle < 0)
+        return false;
+
+    // ECONNREFUSED of a previous datagram is reported here as well
+    return ::send(Handle, record.data(), record.size(), MSG_NOSIGNAL) == (ssize_t)record.size();
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+//
+//	File:		UdpSink.h
+//
+//	Abstract:	Sample Sink sending Binary Records as UDP Datagrams
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef UDPSINK_H
+#define UDPSINK_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "SampleSink.h"
+#include <string>
+
+//------------------------------------------------------------------------------
+//
+// TUdpSink Class Declaration
+//
+// One RLT_RECORD_SIZE record per datagram, best effort: a missing or slow
+// receiver never blocks the sink, failed sends are counted as errors.
+//
+//------------------------------------------------------------------------------
+
+class TUdpSink : public TSampleSink
+{
+    public:
+                    TUdpSink();
+                    ~TUdpSink();
+
+    // resolve destination and create socket
+    bool            Open(const std::string& host, const std::string& port);
+    void            Close();
+
+    // sample sink interface
+    std::string     GetName() const override { return "udp:" + Destination; }
+    TSampleFormat   GetFormat() const override { return SAMPLE_FORMAT_RECORD; }
+    bool            WriteSample(const TRLTSample& sample, const std::string& record) override;
+
+    private:
+
+    int             Handle;
+    std::string     Destination;
+};
+
+#endif // UDPSINK_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
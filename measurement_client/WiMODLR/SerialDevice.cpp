@@ -66,7 +66,8 @@ TSerialDevice::Open(std::string& comPort, UINT32 baudRate, int bits, UINT8 parit
     // be non-blocking.
     // See open(2) ("man 2 open") for details.
 
-    std::string portName = std::string("/dev/") + comPort;
+    // relative to /dev, e.g. "ttyUSB0" or "serial/by-id/...", or absolute
+    std::string portName = comPort.compare(0, 1, "/") == 0 ? comPort : std::string("/dev/") + comPort;
     const char* name  = portName.c_str();
     //const char* ptr = "/dev/tty.usbserial-IMST2"; //name.constData();
     const char* ptr = name;
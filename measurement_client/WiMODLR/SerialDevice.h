@@ -56,6 +56,9 @@ public:
     bool        SendData(UINT8* data, int txLength);
     int         ReadData(UINT8* rxBuffer, int bufferSize);
 
+    // file descriptor for external event loops
+    int         GetHandle() const { return ComHandle; }
+
 private:
 
     int     ComHandle;
@@ -22,12 +22,14 @@
 #include "WiMODLRHCI.h"
 #include "CRC16.h"
 #include <chrono>
+#include <thread>
 #include <ios>
 #include <iomanip>
 #include <sstream>
 #include <iostream>
 #include <format>
 #include <fstream>
+#include <cstring>
 
 
 //------------------------------------------------------------------------------
@@ -223,14 +225,6 @@ const TWiMODLRHCI_IDString  WiMODLRHCI_RadioConfig_RadioOptions[] =
     { 0, 0 }
 };
 
-// Global variables
-TWiMODLR_RadioLinkTestStatus last_meas;
-// for keeping track of total count
-long LTxCount = 0;
-long LRxCount = 0;
-long PTxCount = 0;
-long PRxCount = 0;
-
 //------------------------------------------------------------------------------
 //
 //  TWiMODLRHCI - Class Constructor
@@ -240,6 +234,9 @@ long PRxCount = 0;
 
 TWiMODLRHCI::TWiMODLRHCI()
 {
+    // no client registered yet
+    Client = 0;
+
     // register for rx-messages
     ComSlip.RegisterClient(this);
 
@@ -251,6 +248,10 @@ TWiMODLRHCI::TWiMODLRHCI()
 
     // 1000ms timeout for response
     Rx.Timeout = 1000;
+
+    RLTResponseStatus = 0;
+    RLTDiscard = false;
+    RxTimeUs = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -322,6 +323,10 @@ void
 TWiMODLRHCI::Process()
 {
     //std::cout << "Entering Process()\n";
+    // port closed, e.g. adapter unplugged
+    if (SerialDevice.GetHandle() == INVALID_HANDLE_VALUE)
+        return;
+
     // read data from comport
     int numRxBytes = SerialDevice.ReadData(Rx.Buffer, sizeof(Rx.Buffer));
     //std::cout << numRxBytes << std::endl;
@@ -329,12 +334,30 @@ TWiMODLRHCI::Process()
     if (numRxBytes > 0)
     {
         // yes, pass to SLIP Decoder
-        // Complete SLIP messages will be forwared via callback to
-        // callback function "ProcessRxMessage" (see Receiver section)
-        ComSlip.DecodeData(Rx.Buffer, numRxBytes);
+        ProcessRxData(Rx.Buffer, numRxBytes);
     }
 }
 
+//------------------------------------------------------------------------------
+//
+//  ProcessRxData
+//
+//  @brief: handle bytes read by an external event loop
+//
+//------------------------------------------------------------------------------
+
+void
+TWiMODLRHCI::ProcessRxData(UINT8* rxData, int length)
+{
+    // messages completed by these bytes were received now, whenever they
+    // are dispatched
+    RxTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // Complete SLIP messages will be forwared via callback to
+    // callback function "ProcessRxMessage" (see Receiver section)
+    ComSlip.DecodeData(rxData, (UINT16)length);
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 //
@@ -393,13 +416,13 @@ TWiMODLRHCI::GetRadioConfiguration(TWiMODLR_RadioConfig& config, UINT8& status)
     if (result == WiMODLR_RESULT_OK)
     {
         // yes, return response status
-        status = Rx.Message.Payload[0];
+        status = Rx.Response.Payload[0];
 
         // status ok ? -> config valid
         if(status == DEVMGMT_STATUS_OK)
         {
             // set pointer to start of radio configuration field
-            UINT8* ptr = &Rx.Message.Payload[1];
+            UINT8* ptr = &Rx.Response.Payload[1];
 
             // deserialize data
             config.RadioMode        = *ptr++;
@@ -428,6 +451,173 @@ TWiMODLRHCI::GetRadioConfiguration(TWiMODLR_RadioConfig& config, UINT8& status)
     return result;
 }
 
+//------------------------------------------------------------------------------
+//
+//  GetRTC
+//
+//  @brief: get real time clock of the module (U32TimeToString format)
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::GetRTC(UINT32& rtcTime, UINT8& status)
+{
+    // send message and wait for response
+    TWiMODLRResult result = SendHCIMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_RTC_REQ, DEVMGMT_MSG_GET_RTC_RSP);
+
+    // message sent && response received ?
+    if (result == WiMODLR_RESULT_OK)
+    {
+        // yes, return response status
+        status = Rx.Response.Payload[0];
+
+        // status ok ? -> time valid
+        if (status == DEVMGMT_STATUS_OK)
+            rtcTime = NTOH32(&Rx.Response.Payload[1]);
+
+        return WiMODLR_RESULT_OK;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetDeviceInfo
+//
+//  @brief: get module type, addresses and device id
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::GetDeviceInfo(TWiMODLR_DeviceInfo& info, UINT8& status)
+{
+    // send message and wait for response
+    TWiMODLRResult result = SendHCIMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_DEVICEINFO_REQ, DEVMGMT_MSG_GET_DEVICEINFO_RSP);
+
+    // message sent && response received ?
+    if (result == WiMODLR_RESULT_OK)
+    {
+        // yes, return response status
+        status = Rx.Response.Payload[0];
+
+        // status ok ? -> info valid
+        if (status == DEVMGMT_STATUS_OK && Rx.Response.Length >= 1 + 9)
+        {
+            UINT8* ptr = &Rx.Response.Payload[1];
+
+            info.ModuleType     = *ptr++;
+            info.DeviceAddress  = NTOH16(ptr); ptr += 2;
+            info.GroupAddress   = *ptr++;
+            ptr++;  // reserved
+            info.DeviceID       = NTOH32(ptr);
+        }
+        else if (status == DEVMGMT_STATUS_OK)
+        {
+            // short response
+            status = DEVMGMT_STATUS_ERROR;
+        }
+
+        return WiMODLR_RESULT_OK;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetFirmwareInfo
+//
+//  @brief: get firmware version, build count and image name
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::GetFirmwareInfo(TWiMODLR_FirmwareInfo& info, UINT8& status)
+{
+    // send message and wait for response
+    TWiMODLRResult result = SendHCIMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_FW_VERSION_REQ, DEVMGMT_MSG_GET_FW_VERSION_RSP);
+
+    // message sent && response received ?
+    if (result == WiMODLR_RESULT_OK)
+    {
+        // yes, return response status
+        status = Rx.Response.Payload[0];
+
+        // status ok ? -> info valid, image name up to the end or a 0
+        if (status == DEVMGMT_STATUS_OK && Rx.Response.Length >= 1 + 4)
+        {
+            UINT8* ptr = &Rx.Response.Payload[1];
+
+            info.MinorVersion   = *ptr++;
+            info.MajorVersion   = *ptr++;
+            info.BuildCount     = NTOH16(ptr); ptr += 2;
+
+            const char* image = (const char*)ptr;
+            info.Image.assign(image, strnlen(image, Rx.Response.Length - 5));
+        }
+        else if (status == DEVMGMT_STATUS_OK)
+        {
+            // short response
+            status = DEVMGMT_STATUS_ERROR;
+        }
+
+        return WiMODLR_RESULT_OK;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetSystemStatus
+//
+//  @brief: get system ticks, RTC, supply voltage and radio counters
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::GetSystemStatus(TWiMODLR_SystemStatus& systemStatus, UINT8& status)
+{
+    // send message and wait for response
+    TWiMODLRResult result = SendHCIMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_SYSTEM_STATUS_REQ, DEVMGMT_MSG_GET_SYSTEM_STATUS_RSP);
+
+    // message sent && response received ?
+    if (result == WiMODLR_RESULT_OK)
+    {
+        // yes, return response status
+        status = Rx.Response.Payload[0];
+
+        // status ok ? -> status field valid
+        if (status == DEVMGMT_STATUS_OK && Rx.Response.Length >= 1 + 39)
+        {
+            UINT8* ptr = &Rx.Response.Payload[1];
+
+            systemStatus.SysTickResolution  = *ptr++;
+            systemStatus.SysTickCounter     = NTOH32(ptr); ptr += 4;
+            systemStatus.RtcTime            = NTOH32(ptr); ptr += 4;
+            systemStatus.NvmStatus          = NTOH16(ptr); ptr += 2;
+            systemStatus.SupplyVoltage      = NTOH16(ptr); ptr += 2;
+            systemStatus.ExtraStatus        = NTOH16(ptr); ptr += 2;
+            systemStatus.RxPackets          = NTOH32(ptr); ptr += 4;
+            systemStatus.RxAddressMatch     = NTOH32(ptr); ptr += 4;
+            systemStatus.RxCRCError         = NTOH32(ptr); ptr += 4;
+            systemStatus.TxPackets          = NTOH32(ptr); ptr += 4;
+            systemStatus.TxError            = NTOH32(ptr); ptr += 4;
+            systemStatus.TxMediaBusy        = NTOH32(ptr);
+        }
+        else if (status == DEVMGMT_STATUS_OK)
+        {
+            // short response
+            status = DEVMGMT_STATUS_ERROR;
+        }
+
+        return WiMODLR_RESULT_OK;
+    }
+
+    return result;
+}
+
 //------------------------------------------------------------------------------
 //
 //  SetRadioConfiguration
@@ -470,7 +660,7 @@ TWiMODLRHCI::SetRadioConfiguration(TWiMODLR_RadioConfig& config, UINT8 destMemor
     if(result == WiMODLR_RESULT_OK)
     {
         // return status
-        status = Rx.Message.Payload[0];
+        status = Rx.Response.Payload[0];
 
         return WiMODLR_RESULT_OK;
     }
@@ -573,7 +763,7 @@ TWiMODLRHCI::SendURadioMessage(UINT8* txMessage, UINT16 length, UINT8& status)
     if (result == WiMODLR_RESULT_OK)
     {
         // yes, return response status
-        status = Rx.Message.Payload[0];
+        status = Rx.Response.Payload[0];
 
         //ok, HCI response message received
         return WiMODLR_RESULT_OK;
@@ -583,6 +773,20 @@ TWiMODLRHCI::SendURadioMessage(UINT8* txMessage, UINT16 length, UINT8& status)
     return result;
 }
 
+//------------------------------------------------------------------------------
+//
+//  PostURadioMessage
+//
+//  @brief: send unreliable radio message, don't wait for the response
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::PostURadioMessage(UINT8* txMessage, UINT16 length)
+{
+    return PostMessage(DATALINK_SAP_ID, DATALINK_MSG_SEND_URADIO_MSG_REQ, txMessage, length);
+}
+
 //------------------------------------------------------------------------------
 //
 //  ConvertRadioMessage
@@ -660,6 +864,132 @@ TWiMODLRHCI::GetRadioLinkStatusString(UINT8 status)
     return GetStringFromTable(WiMODLRHCI_DataLinkStatusStrings, status);
 }
 
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+//
+//  Radio Link Test Services
+//
+//  @brief: this section includes Radio Link Test services
+//
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  StartRadioLinkTest
+//
+//  @brief: start radio link test, status indications follow
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::StartRadioLinkTest(const TWiMODLR_RadioLinkTestConfig& config, UINT8& status)
+{
+    UINT8 payload[7];
+
+    // set pointer to start of payload
+    UINT8* ptr = &payload[0];
+
+    // serialize data
+    *ptr++ = config.GroupAddress;
+    HTON16(ptr, config.DeviceAddress); ptr += 2;
+    *ptr++ = config.PacketSize;
+    HTON16(ptr, config.NumPackets); ptr += 2;
+    *ptr++ = config.TestMode;
+
+    // send message and wait for response
+    TWiMODLRResult result = SendHCIMessage(RLT_SAP_ID, RLT_MSG_START_REQ, RLT_MSG_START_RSP, payload, sizeof(payload));
+    if (result == WiMODLR_RESULT_OK)
+    {
+        // return status, taken from the response itself
+        status = RLTResponseStatus;
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  StopRadioLinkTest
+//
+//  @brief: stop radio link test
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::StopRadioLinkTest(UINT8& status)
+{
+    // send message and wait for response
+    TWiMODLRResult result = SendHCIMessage(RLT_SAP_ID, RLT_MSG_STOP_REQ, RLT_MSG_STOP_RSP);
+    if (result == WiMODLR_RESULT_OK)
+    {
+        // return status, taken from the response itself
+        status = RLTResponseStatus;
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  PrepareRadioLinkTest
+//
+//  @brief: readiness handshake, replaces a fixed delay before the start
+//
+//------------------------------------------------------------------------------
+
+TWiMODLRResult
+TWiMODLRHCI::PrepareRadioLinkTest(UINT8& stopStatus, int timeoutMs, int pingTimeoutMs, int quietMs)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    int timeout = Rx.Timeout;
+    TWiMODLRResult result = WiMODLR_RESULT_NO_RESPONSE;
+
+    RLTDiscard = true;
+
+    // 1. ping until the module answers, e.g. while it boots
+    Rx.Timeout = pingTimeoutMs;
+    while (result != WiMODLR_RESULT_OK && elapsed() < timeoutMs)
+    {
+        result = PingRequest();
+    }
+    Rx.Timeout = timeout;
+
+    // 2. stop a running test, confirmed by the response
+    if (result == WiMODLR_RESULT_OK)
+    {
+        result = StopRadioLinkTest(stopStatus);
+    }
+
+    // 3. drop indications which were sent before the stop
+    if (result == WiMODLR_RESULT_OK)
+    {
+        auto quiet = std::chrono::steady_clock::now();
+
+        while (elapsed() < timeoutMs
+               && std::chrono::steady_clock::now() - quiet < std::chrono::milliseconds(quietMs))
+        {
+            int numRxBytes = SerialDevice.ReadData(Rx.Buffer, sizeof(Rx.Buffer));
+            if (numRxBytes > 0)
+            {
+                ProcessRxData(Rx.Buffer, numRxBytes);
+                quiet = std::chrono::steady_clock::now();
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    RLTDiscard = false;
+
+    return result;
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 //
@@ -942,8 +1272,10 @@ TWiMODLRHCI::DispatchRxMessage(TWiMODLR_HCIMessage& rxMsg)
             std::cout << "SAPID: " << std::format("{:#x}", rxMsg.SapID) << ", MsgID: " << std::format("{:#x}", rxMsg.MsgID) << std::endl;
             #endif
             
-            // yes
-            Rx.Done = true;
+            // yes, keep a copy: further messages of the same read are
+            // decoded into Rx.Message
+            Rx.Response = rxMsg;
+            Rx.Done     = true;
         }
     }
 
@@ -981,6 +1313,15 @@ TWiMODLRHCI::DispatchDeviceMgmtMessage(TWiMODLR_HCIMessage& rxMsg)
                 // handle ping response here
                 break;
 
+        case    DEVMGMT_MSG_SET_RADIO_CONFIG_RSP:
+        case    DEVMGMT_MSG_GET_RADIO_CONFIG_RSP:
+        case    DEVMGMT_MSG_GET_RTC_RSP:
+        case    DEVMGMT_MSG_GET_DEVICEINFO_RSP:
+        case    DEVMGMT_MSG_GET_FW_VERSION_RSP:
+        case    DEVMGMT_MSG_GET_SYSTEM_STATUS_RSP:
+                // handled by the waiting request
+                break;
+
         default:
                 // handle unsupported MsgIDs here
                 ShowMessage("warning - unsupported DeviceMgmt message received", rxMsg);
@@ -1002,7 +1343,9 @@ TWiMODLRHCI::DispatchRadioLinkMessage(TWiMODLR_HCIMessage& rxMsg)
     switch(rxMsg.MsgID)
     {
         case    DATALINK_MSG_RECV_URADIO_MSG_IND:
+                #ifdef debug
                 ShowMessage("Unreliable RadioLink message received", rxMsg);
+                #endif
                 if (Client)
                 {
                     // notify client
@@ -1010,6 +1353,24 @@ TWiMODLRHCI::DispatchRadioLinkMessage(TWiMODLR_HCIMessage& rxMsg)
                 }
                 break;
 
+        case    DATALINK_MSG_RECV_RAWRADIO_MSG_IND:
+                // sniffer mode: any packet on the channel
+                if (Client)
+                    Client->evRadioLink_RxRawMessage(rxMsg);
+                break;
+
+        case    DATALINK_MSG_SEND_URADIO_MSG_RSP:
+                // also handled by a waiting SendURadioMessage
+                if (Client && rxMsg.Length >= 1)
+                    Client->evRadioLink_TxUMessageRsp(rxMsg.Payload[0]);
+                break;
+
+        case    DATALINK_MSG_SENT_URADIO_MSG_IND:
+                // tx done
+                if (Client && rxMsg.Length >= 1)
+                    Client->evRadioLink_TxUMessageInd(rxMsg.Payload[0]);
+                break;
+
         default:
                 // handle unsupported MsgIDs here
                 ShowMessage("warning - unsupported RadioLink message received", rxMsg);
@@ -1035,18 +1396,24 @@ TWiMODLRHCI::DispatchRadioLinkTestMessage(TWiMODLR_HCIMessage& rxMsg)
     switch(rxMsg.MsgID)
     {
         case    RLT_MSG_START_RSP:
+                RLTResponseStatus = rxMsg.Payload[0];
                 #ifdef debug
                 std::cout << "Radio Link Test Start Response: " << GetStringFromTable(WiMODLRHCI_RadioLinkTestStatusStrings,rxMsg.Payload[0]) << std::endl;
                 #endif
                 break; 
 
         case    RLT_MSG_STOP_RSP:
+                RLTResponseStatus = rxMsg.Payload[0];
                 #ifdef debug
                 std::cout << "Radio Link Test Stop Response: " << GetStringFromTable(WiMODLRHCI_RadioLinkTestStatusStrings,rxMsg.Payload[0]) << std::endl;
                 #endif
                 break;
 
         case    RLT_MSG_STATUS_IND:
+                // indication of a previous test
+                if (RLTDiscard)
+                    break;
+
                 // set pointer to start of radio configuration field
                 UINT8* ptr = &Rx.Message.Payload[0];
 
@@ -1065,36 +1432,47 @@ TWiMODLRHCI::DispatchRadioLinkTestMessage(TWiMODLR_HCIMessage& rxMsg)
                 meas.LocalSNR = *ptr++;
                 meas.PeerSNR = *ptr;
 
-                if(meas.LTxCount == 1)
+                // counters are kept per instance, several radios may be
+                // served by one process
+                if(meas.LTxCount == 1 && RLTLast.LTxCount != 1)
                 {
-                    // measurement reset after 100
-                    LTxCount += meas.LTxCount;
-                    LRxCount += meas.LRxCount;
-                    PTxCount += meas.PTxCount;
-                    PRxCount += meas.PRxCount;
+                    // measurement reset after 100, a repeated first packet
+                    // is no new packet (test stalled)
+                    RLTTotal.LTxCount += meas.LTxCount;
+                    RLTTotal.LRxCount += meas.LRxCount;
+                    RLTTotal.PTxCount += meas.PTxCount;
+                    RLTTotal.PRxCount += meas.PRxCount;
                 }
                 else
                 {
                     // keep track of packet counts, including packet loss
-                    LTxCount += meas.LTxCount - last_meas.LTxCount;
-                    LRxCount += meas.LRxCount - last_meas.LRxCount;
-                    PTxCount += meas.PTxCount - last_meas.PTxCount;
-                    PRxCount += meas.PRxCount - last_meas.PRxCount;
+                    RLTTotal.LTxCount += meas.LTxCount - RLTLast.LTxCount;
+                    RLTTotal.LRxCount += meas.LRxCount - RLTLast.LRxCount;
+                    RLTTotal.PTxCount += meas.PTxCount - RLTLast.PTxCount;
+                    RLTTotal.PRxCount += meas.PRxCount - RLTLast.PRxCount;
                 }
 
 
-                last_meas = meas;
+                RLTLast = meas;
 
-                meas.LTxCount = LTxCount;
-                meas.LRxCount = LRxCount;
-                meas.PTxCount = PTxCount;
-                meas.PRxCount = PRxCount;
+                meas.LTxCount = RLTTotal.LTxCount;
+                meas.LRxCount = RLTTotal.LRxCount;
+                meas.PTxCount = RLTTotal.PTxCount;
+                meas.PRxCount = RLTTotal.PRxCount;
 
                 #ifdef print_res
                 printMesuredData(meas);
                 #endif
 
-                writeDataToFile(filename, meas);
+                if (Client)
+                {
+                    // notify client, client takes care of storage
+                    Client->evRadioLinkTest_StatusInd(meas);
+                }
+                else
+                {
+                    writeDataToFile(filename, meas);
+                }
 
                 break;
     }
@@ -52,14 +52,41 @@ typedef uint16_t        TWiMODLRResult;
 #define WiMODLR_RADIO_CONFIG_RM_ECHO        1
 #define WiMODLR_RADIO_CONFIG_RM_SNIFFER     2
 
+// The names of the modulation, bandwidth and spreading factor values are
+// those of the WiMOD LR Base HCI specification of the iM880 (SX127x,
+// 868 MHz) shipped next to this library. The iM282A of the SK-iM282A
+// (SX1280, 2.4 GHz) uses the same codes for other settings: modulation 1 is
+// FLRC, the LoRa bandwidths are 203.125 / 406.25 / 812.5 / 1625 kHz and
+// SF5 and SF6 exist. The iM282A names below are the ones to use.
+
 #define WiMODLR_RADIO_CONFIG_MOD_LORA       0
 #define WiMODLR_RADIO_CONFIG_MOD_FSK        1
+#define WiMODLR_RADIO_CONFIG_MOD_FLRC       1
 
 #define WiMODLR_RADIO_CONFIG_BW_125kHz      0
 #define WiMODLR_RADIO_CONFIG_BW_250kHz      1
 #define WiMODLR_RADIO_CONFIG_BW_500kHz      2
 
-
+#define WiMODLR_RADIO_CONFIG_BW_203kHz      0
+#define WiMODLR_RADIO_CONFIG_BW_406kHz      1
+#define WiMODLR_RADIO_CONFIG_BW_812kHz      2
+#define WiMODLR_RADIO_CONFIG_BW_1625kHz     3
+
+// FLRC: bit rate in the bandwidth field, coding rate in the error coding
+// field, in the order of the SX1280 data sheet
+#define WiMODLR_RADIO_CONFIG_FLRC_1300kbps  0
+#define WiMODLR_RADIO_CONFIG_FLRC_1040kbps  1
+#define WiMODLR_RADIO_CONFIG_FLRC_650kbps   2
+#define WiMODLR_RADIO_CONFIG_FLRC_520kbps   3
+#define WiMODLR_RADIO_CONFIG_FLRC_325kbps   4
+#define WiMODLR_RADIO_CONFIG_FLRC_260kbps   5
+
+#define WiMODLR_RADIO_CONFIG_FLRC_CR_1_2    0
+#define WiMODLR_RADIO_CONFIG_FLRC_CR_3_4    1
+#define WiMODLR_RADIO_CONFIG_FLRC_CR_1      2
+
+#define WiMODLR_RADIO_CONFIG_SF5            5
+#define WiMODLR_RADIO_CONFIG_SF6            6
 #define WiMODLR_RADIO_CONFIG_SF7            7
 #define WiMODLR_RADIO_CONFIG_SF8            8
 #define WiMODLR_RADIO_CONFIG_SF9            9
@@ -72,6 +99,12 @@ typedef uint16_t        TWiMODLRResult;
 #define WiMODLR_RADIO_CONFIG_EC_4_7         3
 #define WiMODLR_RADIO_CONFIG_EC_4_8         4
 
+#define WiMODLR_RADIO_CONFIG_RX_OFF         0
+#define WiMODLR_RADIO_CONFIG_RX_ON          1
+
+// radio options: received messages with RSSI, SNR and Rx time footer
+#define WiMODLR_RADIO_CONFIG_OPT_EXTENDED   0x01
+
 //------------------------------------------------------------------------------
 //
 // HCI Message Declaration
@@ -161,6 +194,46 @@ typedef struct
     UINT8   RadioOptions;
 }TWiMODLR_RadioConfig;
 
+//------------------------------------------------------------------------------
+//
+// Device Information, Firmware Information and System Status
+//
+// see WiMODLR HCI Specification Chapter 3.1.3, 3.1.4 and 3.1.6
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    UINT8   ModuleType;
+    UINT16  DeviceAddress;
+    UINT8   GroupAddress;
+    UINT32  DeviceID;
+}TWiMODLR_DeviceInfo;
+
+typedef struct
+{
+    UINT8       MinorVersion;
+    UINT8       MajorVersion;
+    UINT16      BuildCount;
+    std::string Image;
+}TWiMODLR_FirmwareInfo;
+
+typedef struct
+{
+    UINT8   SysTickResolution;
+    UINT32  SysTickCounter;
+    UINT32  RtcTime;
+    UINT16  NvmStatus;
+    UINT16  SupplyVoltage;
+    UINT16  ExtraStatus;
+    UINT32  RxPackets;
+    UINT32  RxAddressMatch;
+    UINT32  RxCRCError;
+    UINT32  TxPackets;
+    UINT32  TxError;
+    UINT32  TxMediaBusy;
+}TWiMODLR_SystemStatus;
+
 typedef struct
 {
     UINT8   GroupAddress;
@@ -216,6 +289,17 @@ class TWiMODLRHCIClient
 
     // define handler for received unreliable messages
     virtual void        evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& /* rxMsg */) {}
+
+    // define handler for raw radio packets (sniffer mode)
+    virtual void        evRadioLink_RxRawMessage(const TWiMODLR_HCIMessage& /* rxMsg */) {}
+
+    // define handlers for the response to a send request (accepted into the
+    // Tx queue of the module or rejected) and for the message sent on air
+    virtual void        evRadioLink_TxUMessageRsp(UINT8 /* status */) {}
+    virtual void        evRadioLink_TxUMessageInd(UINT8 /* status */) {}
+
+    // define handler for radio link test status, packet counters accumulated
+    virtual void        evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& /* status */) {}
 };
 
 //------------------------------------------------------------------------------
@@ -237,22 +321,52 @@ class TWiMODLRHCI : public TWiMODLRHCIClient
     bool                Close();
     void                Process();
 
+    // external event loop support: serial handle and received raw bytes
+    int                 GetHandle() const { return SerialDevice.GetHandle(); }
+    void                ProcessRxData(UINT8* rxData, int length);
+
+    // monotonic time (steady clock) [us] at which the bytes of the message
+    // being dispatched were read, before decoding and dispatch
+    INT64               GetRxTimeUs() const { return RxTimeUs; }
+
     // device management commands
     TWiMODLRResult      PingRequest();
     TWiMODLRResult      FactoryReset();
     TWiMODLRResult      GetRadioConfiguration(TWiMODLR_RadioConfig& config, UINT8& status);
     TWiMODLRResult      SetRadioConfiguration(TWiMODLR_RadioConfig& config, UINT8 destMemory, UINT8& status);
+    TWiMODLRResult      GetRTC(UINT32& rtcTime, UINT8& status);
+    TWiMODLRResult      GetDeviceInfo(TWiMODLR_DeviceInfo& info, UINT8& status);
+    TWiMODLRResult      GetFirmwareInfo(TWiMODLR_FirmwareInfo& info, UINT8& status);
+    TWiMODLRResult      GetSystemStatus(TWiMODLR_SystemStatus& systemStatus, UINT8& status);
 
     //void                ConvertRadioConfiguration(TKeyValueList& list, const TWiMODLR_RadioConfig& config);
     const char*         GetDeviceMgmtStatusString(UINT8 status);
 
     // radio link services
     TWiMODLRResult      SendURadioMessage(UINT8* txMessage, UINT16 length, UINT8& status);
+
+    // send request without waiting, response and sent indication are
+    // reported to the client
+    TWiMODLRResult      PostURadioMessage(UINT8* txMessage, UINT16 length);
     //void                ConvertRadioRxMessage(TKeyValueList& list, const TWiMODLR_HCIMessage& rxMsg);
 
 
     const char*         GetRadioLinkStatusString(UINT8 status);
 
+    // radio link test services
+    TWiMODLRResult      StartRadioLinkTest(const TWiMODLR_RadioLinkTestConfig& config, UINT8& status);
+    TWiMODLRResult      StopRadioLinkTest(UINT8& status);
+
+    // readiness handshake before a start: ping until the module answers
+    // (each attempt waits pingTimeoutMs), stop a running test (confirmed by
+    // the stop response, its status is returned), drop indications until
+    // the port is quiet for quietMs; bounded by timeoutMs
+    TWiMODLRResult      PrepareRadioLinkTest(UINT8& stopStatus, int timeoutMs, int pingTimeoutMs = 100, int quietMs = 20);
+
+    // next status indication starts a new counter baseline, the accumulated
+    // counters continue (test restarted after a module reset)
+    void                ResetRadioLinkTestBaseline() { RLTLast = TWiMODLR_RadioLinkTestStatus(); }
+
     // other helper functions
     void                U32TimeToString(std::string& timeString, UINT32 time, bool isoFormat = true);
     UINT32              GetFrequencyFromConfig(UINT32 regConfig);
@@ -279,6 +393,8 @@ class TWiMODLRHCI : public TWiMODLRHCIClient
         UINT8       MsgID;
         // reserve one Rx-Message-Buffer
         TWiMODLR_HCIMessage Message;
+        // copy of the expected response, read by the request functions
+        TWiMODLR_HCIMessage Response;
         // CRC error counter
         int         CRCError;
         // Timeout (~1000ms)
@@ -331,6 +447,20 @@ class TWiMODLRHCI : public TWiMODLRHCIClient
     TSerialDevice       SerialDevice;
 
     TWiMODLRHCIClient*  Client;
+
+    // last radio link test status and accumulated packet counters
+    TWiMODLR_RadioLinkTestStatus RLTLast;
+    TWiMODLR_RadioLinkTestStatus RLTTotal;
+
+    // status of the last radio link test start / stop response, the Rx
+    // buffer may already hold the next indication
+    UINT8               RLTResponseStatus;
+
+    // drop status indications of a previous test (readiness handshake)
+    bool                RLTDiscard;
+
+    // read time of the bytes being decoded
+    INT64               RxTimeUs;
 };
 
 #endif // WIMODLRHCI_H
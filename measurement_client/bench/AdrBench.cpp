@@ -0,0 +1,487 @@
+//------------------------------------------------------------------------------
+//
+//	File:		AdrBench.cpp
+//
+//	Abstract:	Adaptive data rate control against an emulated channel whose
+//              attenuation changes in phases
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      adr_bench [-a <attenuation dB,...>] [-t <phase s>] [-x <time scale>]
+//                        [-r <announcement loss %>] [-y <hysteresis dB>]
+//                        [-w <window>] [-b <legacy|epoll|io_uring>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/SampleFanout.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include "../Measurement/RadioSupervisor.h"
+#include "../Measurement/AdrController.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// radio configuration payload: status + 21 bytes (HCI spec 3.1.5.3)
+#define BENCH_RADIO_CONFIG_SIZE     21
+
+// offset of the bandwidth, followed by SF, coding rate and power
+#define BENCH_RADIO_CONFIG_BW       11
+
+#define BENCH_PACKET_SIZE           15
+
+//------------------------------------------------------------------------------
+//
+//  GetNoiseFloor
+//
+//  @brief: noise power in the bandwidth [dBm]
+//
+//------------------------------------------------------------------------------
+
+static double
+GetNoiseFloor(UINT8 bandwidth)
+{
+    return -174 + 10 * std::log10((double)AIRTIME_GetBandwidthHz(bandwidth)) + ADR_NOISE_FIGURE_DB;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+//
+//  TChannelEmulator
+//
+//  @brief: local and peer module on one channel. Packets get through if
+//          both ends use the same SF / bandwidth / coding rate, the loss
+//          follows the SNR above the demodulation floor. The peer applies
+//          announcements it receives. Exchanges take the time on air
+//          divided by the time scale.
+//
+//------------------------------------------------------------------------------
+
+class TChannelEmulator : public THCIEmulator
+{
+    public:
+
+                TChannelEmulator(UINT32 timeScale, UINT32 announceLoss)
+                {
+                    TimeScale    = timeScale;
+                    AnnounceLoss = announceLoss;
+
+                    std::memset(Radio, 0, sizeof(Radio));
+
+                    // LoRa 203 kHz, SF7, 4/5, 12 dBm on both ends
+                    Radio[BENCH_RADIO_CONFIG_BW]     = WiMODLR_RADIO_CONFIG_BW_203kHz;
+                    Radio[BENCH_RADIO_CONFIG_BW + 1] = WiMODLR_RADIO_CONFIG_SF7;
+                    Radio[BENCH_RADIO_CONFIG_BW + 2] = WiMODLR_RADIO_CONFIG_EC_4_5;
+                    Radio[BENCH_RADIO_CONFIG_BW + 3] = 12;
+
+                    std::memcpy(Peer, &Radio[BENCH_RADIO_CONFIG_BW], sizeof(Peer));
+
+                    Update();
+                }
+
+    // path loss between the modules [dB], applied by the emulator thread
+    void        SetAttenuation(int attenuation) { Attenuation = attenuation; Changed = true; }
+
+    UINT32      GetAnnouncements() const { return Announcements; }
+    UINT32      GetFollowed() const { return Followed; }
+
+    // both modules in the same configuration
+    bool        IsMatched() const { return Matched; }
+
+    protected:
+
+    void        Tick() override
+                {
+                    if (Changed.exchange(false))
+                        Update();
+                }
+
+    bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length) override
+                {
+                    UINT8 response[1 + BENCH_RADIO_CONFIG_SIZE];
+
+                    response[0] = DEVMGMT_STATUS_OK;
+
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_GET_RADIO_CONFIG_REQ)
+                    {
+                        std::memcpy(&response[1], Radio, sizeof(Radio));
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_RADIO_CONFIG_RSP, response, sizeof(response));
+                    }
+
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_SET_RADIO_CONFIG_REQ)
+                    {
+                        if (length < 1 + BENCH_RADIO_CONFIG_SIZE || payload[0] != WiMODLR_STORE_INTO_RAM)
+                            response[0] = DEVMGMT_STATUS_WRONG_PARAMETER;
+                        else
+                        {
+                            std::memcpy(Radio, &payload[1], sizeof(Radio));
+                            Update();
+                        }
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_SET_RADIO_CONFIG_RSP, response, 1);
+                    }
+
+                    if (sapID == DATALINK_SAP_ID && msgID == DATALINK_MSG_SEND_URADIO_MSG_REQ)
+                    {
+                        TWiMODLR_RadioConfig radio = TWiMODLR_RadioConfig();
+                        UINT8                sequence;
+
+                        Announcements++;
+
+                        // heard by the peer: same configuration, no loss
+                        UINT32 random = (UINT32)((Announcements * 2654435761ULL) >> 7) % 100;
+
+                        if (length > DATALINK_RADIO_HEADER_SIZE
+                            && TAdrController::DecodeFrame(&payload[DATALINK_RADIO_HEADER_SIZE], length - DATALINK_RADIO_HEADER_SIZE,
+                                                           sequence, radio)
+                            && !std::memcmp(Peer, &Radio[BENCH_RADIO_CONFIG_BW], 3)
+                            && random >= std::max(AnnounceLoss, AnnounceLinkLoss))
+                        {
+                            Peer[0] = radio.Bandwidth;
+                            Peer[1] = radio.SpreadingFactor;
+                            Peer[2] = radio.ErrorCoding;
+                            Peer[3] = radio.PowerLevel;
+
+                            Followed++;
+                            Update();
+                        }
+
+                        return SendMessage(DATALINK_SAP_ID, DATALINK_MSG_SEND_URADIO_MSG_RSP, response, 1);
+                    }
+
+                    return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+                }
+
+    private:
+
+    void        Update()
+                {
+                    UINT8 bw    = std::min<UINT8>(Radio[BENCH_RADIO_CONFIG_BW], WiMODLR_RADIO_CONFIG_BW_1625kHz);
+                    UINT8 sf    = std::clamp<UINT8>(Radio[BENCH_RADIO_CONFIG_BW + 1], WiMODLR_RADIO_CONFIG_SF5, WiMODLR_RADIO_CONFIG_SF12);
+                    UINT8 ec    = Radio[BENCH_RADIO_CONFIG_BW + 2];
+                    int   power = Radio[BENCH_RADIO_CONFIG_BW + 3];
+
+                    double noise    = GetNoiseFloor(bw);
+                    double uplink   = power - Attenuation;
+                    double downlink = Peer[3] - Attenuation;
+                    double margin   = std::min(uplink, downlink) - noise - (-7.5 - 2.5 * (sf - WiMODLR_RADIO_CONFIG_SF7));
+
+                    bool match = !std::memcmp(Peer, &Radio[BENCH_RADIO_CONFIG_BW], 3);
+
+                    auto loss = [](double margin) { return (UINT32)std::lround(100 / (1 + std::exp(1.5 * (margin + 1)))); };
+
+                    Matched  = match;
+                    LinkLoss = match ? loss(margin) : 100;
+
+                    // announcements: one direction only
+                    AnnounceLinkLoss = loss(uplink - noise - (-7.5 - 2.5 * (sf - WiMODLR_RADIO_CONFIG_SF7)));
+
+                    SetLossRate(LinkLoss);
+
+                    // the reported SNR saturates, the RSSI not below the noise
+                    auto rssi = [&](double level) { return (INT16)std::lround(std::max(level, noise)); };
+                    auto snr  = [&](double level) { return (INT8)std::lround(std::clamp(level - noise, -20.0, 10.0)); };
+
+                    if (match)
+                        SetLinkQuality(rssi(downlink), rssi(uplink), snr(downlink), snr(uplink));
+                    else
+                        SetLinkQuality(rssi(noise), rssi(noise), -20, -20);
+
+                    UINT64 exchangeNs = 2 * AIRTIME_GetLoRaNs(sf, bw, ec, BENCH_PACKET_SIZE);
+
+                    SetStatusInterval((UINT32)std::max<UINT64>(100, exchangeNs / 1000 / TimeScale));
+                }
+
+    UINT8               Radio[BENCH_RADIO_CONFIG_SIZE];
+
+    // bandwidth, SF, coding rate, power of the peer
+    UINT8               Peer[4];
+
+    UINT32              TimeScale;
+    UINT32              AnnounceLoss;
+    UINT32              LinkLoss = 0;
+    UINT32              AnnounceLinkLoss = 0;
+    std::atomic<int>    Attenuation { 100 };
+    std::atomic<bool>   Changed { false };
+    std::atomic<bool>   Matched { true };
+    std::atomic<UINT32> Announcements { 0 };
+    std::atomic<UINT32> Followed { 0 };
+};
+
+//------------------------------------------------------------------------------
+//
+//  TPhaseSink
+//
+//  @brief: counters of the last sample
+//
+//------------------------------------------------------------------------------
+
+class TPhaseSink : public TSampleSink
+{
+    public:
+
+    TWiMODLR_RadioLinkTestStatus    Last;
+    UINT64                          Samples = 0;
+    std::mutex                      Lock;
+
+    std::string     GetName() const override { return "phase"; }
+
+    bool            WriteSample(const TRLTSample& sample, const std::string& /* encoded */) override
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        Last = sample.Status;
+                        Samples++;
+                        return true;
+                    }
+
+    TWiMODLR_RadioLinkTestStatus    GetLast()
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        return Last;
+                    }
+};
+
+//------------------------------------------------------------------------------
+//
+//  GetOracleStep
+//
+//  @brief: fastest step with the margin at max. power
+//
+//------------------------------------------------------------------------------
+
+static size_t
+GetOracleStep(const std::vector<TAdrStep>& ladder, const TAdrConfig& config, int attenuation)
+{
+    double snr = config.MaxPower - attenuation - GetNoiseFloor(WiMODLR_RADIO_CONFIG_BW_203kHz);
+
+    for (size_t i = 0; i < ladder.size(); i++)
+    {
+        if (snr - ladder[i].RequiredSnr >= config.MarginDb)
+            return i;
+    }
+
+    return ladder.size() - 1;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string phases       = "95,105,118,106,116";
+    UINT32      phaseS       = 4;
+    UINT32      timeScale    = 50;
+    UINT32      announceLoss = 0;
+    std::string backendName  = "epoll";
+
+    TAdrConfig config;
+    config.FallbackMs = 300;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-a") && i + 1 < argc)
+            phases = argv[++i];
+        else if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            phaseS = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            timeScale = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+            announceLoss = std::min(100, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-y") && i + 1 < argc)
+            config.HysteresisDb = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc)
+            config.WindowSize = std::max(2, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backendName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-a <attenuation dB,...>] [-t <phase s>] [-x <time scale>]"
+                      << " [-r <announcement loss %>] [-y <hysteresis dB>] [-w <window>]"
+                      << " [-b <legacy|epoll|io_uring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<int> attenuations;
+    std::istringstream values(phases);
+    std::string value;
+
+    while (std::getline(values, value, ','))
+        attenuations.push_back(std::atoi(value.c_str()));
+
+    TChannelEmulator emulator(timeScale, announceLoss);
+    TWiMODLRHCI      hci;
+    TSampleFanout    fanout;
+    TPhaseSink       sink;
+
+    emulator.SetAttenuation(attenuations.empty() ? 100 : attenuations[0]);
+
+    if (!emulator.Open() || !emulator.Start() || !hci.Open(emulator.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return 1;
+    }
+
+    TRadioSupervisor supervisor(hci, fanout);
+    TAdrController   adr(hci, supervisor, fanout);
+
+    hci.RegisterClient(&adr);
+    fanout.AddSink(sink);
+    fanout.Start();
+
+    TWiMODLR_RadioLinkTestConfig test;
+    test.GroupAddress  = 0x10;
+    test.DeviceAddress = 0x2222;
+    test.PacketSize    = BENCH_PACKET_SIZE;
+    test.NumPackets    = 100;
+    test.TestMode      = 1;
+
+    // startup of main.cpp, no stall detection across the time scale
+    TSupervisorConfig supervisorConfig;
+    supervisorConfig.AutoRecover = false;
+
+    supervisor.Start(emulator.GetPortName(), test, supervisorConfig);
+
+    UINT8 status = 0;
+
+    if (hci.PrepareRadioLinkTest(status, supervisorConfig.ReadyTimeoutMs) != WiMODLR_RESULT_OK || !adr.Start(config))
+    {
+        std::cerr << "Error: Could not start ADR" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<TEventBackend> backend;
+    THCIReader reader(hci);
+
+    if (backendName != "legacy")
+    {
+        backend.reset(CreateEventBackend(backendName == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+        if (!backend || !reader.Attach(*backend))
+        {
+            std::cerr << "Error: Could not set up event backend" << std::endl;
+            return 1;
+        }
+    }
+
+    supervisor.SetEventBackend(backend.get(), &reader);
+
+    const std::vector<TAdrStep>& ladder = adr.GetLadder();
+
+    std::cout << std::setw(8) << "atten"
+              << std::setw(8) << "oracle"
+              << std::setw(8) << "step"
+              << std::setw(8) << "power"
+              << std::setw(10) << "switches"
+              << std::setw(8) << "per"
+              << std::setw(12) << "bit/s" << std::endl;
+
+    bool   result   = true;
+    UINT32 switches = 0;
+
+    for (int attenuation : attenuations)
+    {
+        emulator.SetAttenuation(attenuation);
+
+        TWiMODLR_RadioLinkTestStatus first = sink.GetLast();
+
+        auto phaseEnd = std::chrono::steady_clock::now() + std::chrono::seconds(phaseS);
+
+        // main loop of main.cpp
+        while (std::chrono::steady_clock::now() < phaseEnd)
+        {
+            if (backend)
+            {
+                if (backend->Poll(10) < 0)
+                    break;
+            }
+            else
+            {
+                hci.WaitForResponse(RLT_SAP_ID, RLT_MSG_STATUS_IND);
+            }
+
+            supervisor.Poll();
+            adr.Poll();
+            fanout.Poll();
+        }
+
+        TWiMODLR_RadioLinkTestStatus last = sink.GetLast();
+
+        UINT32 sent     = (last.LTxCount - first.LTxCount) + (last.PTxCount - first.PTxCount);
+        UINT32 received = (last.PRxCount - first.PRxCount) + (last.LRxCount - first.LRxCount);
+        double per      = sent ? 1 - (double)std::min(sent, received) / sent : 1;
+
+        // payload of both directions in real time
+        double goodput = received * 8.0 * BENCH_PACKET_SIZE / phaseS / timeScale;
+
+        size_t oracle = GetOracleStep(ladder, config, attenuation);
+        size_t step   = adr.GetStep();
+
+        std::cout << std::fixed
+                  << std::setw(8) << attenuation
+                  << std::setw(8) << oracle + 1
+                  << std::setw(8) << step + 1
+                  << std::setw(8) << (int)adr.GetPower()
+                  << std::setw(10) << adr.GetStats().Switches - switches
+                  << std::setprecision(3) << std::setw(8) << per
+                  << std::setprecision(0) << std::setw(12) << goodput << std::endl;
+
+        switches = adr.GetStats().Switches;
+
+        // at most one step away from the fastest feasible one, the peer
+        // followed
+        if (step + 1 < oracle || step > oracle + 1 || !emulator.IsMatched())
+            result = false;
+    }
+
+
+    adr.Stop();
+    fanout.Stop();
+
+    std::cout << "ladder";
+    for (const TAdrStep& step : ladder)
+        std::cout << " sf" << (int)step.SpreadingFactor << "/" << AIRTIME_GetBandwidthHz(step.Bandwidth) / 1000;
+    std::cout << std::endl;
+
+    std::cout << adr.FormatStats() << ", announcements " << emulator.GetAnnouncements()
+              << " followed " << emulator.GetFollowed() << ", time scale " << timeScale
+              << ", hysteresis " << config.HysteresisDb << " dB" << std::endl;
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    backend.reset();
+    emulator.Close();
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
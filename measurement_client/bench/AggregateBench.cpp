@@ -0,0 +1,370 @@
+//------------------------------------------------------------------------------
+//
+//	File:		AggregateBench.cpp
+//
+//	Abstract:	Messages per second and time on air per message of small
+//              messages, each in a radio message of its own against
+//              aggregated frames
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      aggregate_bench [-g <grid>] [-n <messages>] [-s <message bytes>]
+//                              [-r <messages/s, 0 = saturated>] [-d <flush delay us>]
+//                              [-q <module queue depth>] [-u <tx setup us>] [-x <time scale>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/DataLinkSender.h"
+#include "../Measurement/MessageAggregator.h"
+#include "../Measurement/LatencyHistogram.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define BENCH_GROUP_ADDRESS     0x10
+#define BENCH_SENDER_ADDRESS    0x1111
+#define BENCH_RECEIVER_ADDRESS  0x2222
+
+// radio messages kept queued on the host when saturated
+#define BENCH_HOST_BACKLOG      8
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  TSenderHost
+//
+//  @brief: HCI client of the sending module, the data link of the mode
+//
+//------------------------------------------------------------------------------
+
+class TSenderHost : public TWiMODLRHCIClient
+{
+    public:
+
+    TWiMODLRHCIClient*  Target = 0;
+
+    void        evRadioLink_TxUMessageRsp(UINT8 status) override { Target->evRadioLink_TxUMessageRsp(status); }
+    void        evRadioLink_TxUMessageInd(UINT8 status) override { Target->evRadioLink_TxUMessageInd(status); }
+};
+
+//------------------------------------------------------------------------------
+//
+//  TReceiverHost
+//
+//  @brief: HCI client of the receiving module: time on air of the frames,
+//          latency of the messages by their sequence number
+//
+//------------------------------------------------------------------------------
+
+class TReceiverHost : public TWiMODLRHCIClient, public TAggregatorClient
+{
+    public:
+
+    TMessageAggregator*             Aggregator = 0;
+    TWiMODLR_RadioConfig            Radio;
+    std::vector<TClock::time_point> SendTimes;
+    std::vector<bool>               Seen;
+    UINT64                          Received = 0;
+    UINT64                          Frames = 0;
+    UINT64                          AirtimeNs = 0;
+    TLatencyHistogram               Latency;
+    TClock::time_point              LastRx;
+
+    void        Reset(size_t count)
+                {
+                    SendTimes.assign(count, TClock::time_point());
+                    Seen.assign(count, false);
+                    Received  = 0;
+                    Frames    = 0;
+                    AirtimeNs = 0;
+                    Latency.Reset();
+                }
+
+    void        evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override
+                {
+                    int length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE;
+
+                    if (rxMsg.Payload[0] & 0x01)
+                        length -= DATALINK_MSG_FOOTER_SIZE;
+
+                    if (length < 1)
+                        return;
+
+                    Frames++;
+                    AirtimeNs += AIRTIME_GetTimeOnAirNs(Radio, (UINT8)(length + DATALINK_MSG_HEADER_SIZE));
+
+                    if (Aggregator)
+                        Aggregator->evRadioLink_RxUMessage(rxMsg);
+                    else
+                        evAggregator_Message(&rxMsg.Payload[DATALINK_MSG_HEADER_SIZE], (UINT16)length);
+                }
+
+    void        evAggregator_Message(const UINT8* data, UINT16 length) override
+                {
+                    if (length < 4)
+                        return;
+
+                    UINT32 sequence = NTOH32(data);
+
+                    if (sequence >= Seen.size() || Seen[sequence])
+                        return;
+
+                    LastRx          = TClock::now();
+                    Seen[sequence]  = true;
+                    Received++;
+                    Latency.Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(LastRx - SendTimes[sequence]).count());
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  FormatConfig
+//
+//  @brief: "sf7/125 4/5"
+//
+//------------------------------------------------------------------------------
+
+static std::string
+FormatConfig(const TWiMODLR_RadioConfig& radio)
+{
+    return "sf" + std::to_string(radio.SpreadingFactor) + "/" + std::to_string(AIRTIME_GetBandwidthHz(radio.Bandwidth) / 1000)
+           + " 4/" + std::to_string(std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 4);
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7;bw=203,812";
+    UINT32      count       = 500;
+    UINT32      messageSize = 16;
+    double      rate        = 0;
+    UINT32      delayUs     = 50000;
+    UINT32      queueDepth  = 4;
+    UINT32      setupUs     = 5000;
+    UINT32      timeScale   = 20;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            count = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            messageSize = std::clamp(std::atoi(argv[++i]), 4, AGGREGATE_MAX_MESSAGE_SIZE);
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+            rate = std::max(0.0, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            delayUs = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-q") && i + 1 < argc)
+            queueDepth = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-u") && i + 1 < argc)
+            setupUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            timeScale = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-n <messages>] [-s <message bytes>]"
+                      << " [-r <messages/s, 0 = saturated>] [-d <flush delay us>] [-q <module queue depth>]"
+                      << " [-u <tx setup us>] [-x <time scale>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TSweepPoint> points;
+    std::string error;
+
+    TWiMODLR_RadioConfig base = TWiMODLR_RadioConfig();
+    base.Modulation      = WiMODLR_RADIO_CONFIG_MOD_LORA;
+    base.Bandwidth       = WiMODLR_RADIO_CONFIG_BW_203kHz;
+    base.SpreadingFactor = WiMODLR_RADIO_CONFIG_SF7;
+    base.ErrorCoding     = WiMODLR_RADIO_CONFIG_EC_4_5;
+
+    if (!TSweepCampaign::ParseGrid(grid, base, points, error))
+    {
+        std::cerr << "Grid: " << error << std::endl;
+        return 1;
+    }
+
+    TEmulatedChannel channel(timeScale);
+    THCIEmulator     senderModule;
+    THCIEmulator     receiverModule;
+
+    senderModule.ConnectDataLink(channel, receiverModule);
+    receiverModule.ConnectDataLink(channel, senderModule);
+    senderModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_SENDER_ADDRESS);
+    receiverModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_RECEIVER_ADDRESS);
+    senderModule.SetTxQueueSize(queueDepth);
+    senderModule.SetTxSetupTime(setupUs);
+
+    TWiMODLRHCI senderHCI;
+    TWiMODLRHCI receiverHCI;
+
+    if (!senderModule.Open() || !receiverModule.Open() || !senderModule.Start() || !receiverModule.Start()
+        || !senderHCI.Open(senderModule.GetPortName()) || !receiverHCI.Open(receiverModule.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radios" << std::endl;
+        return 1;
+    }
+
+    TDataLinkSender    single(senderHCI);
+    TMessageAggregator aggregator(senderHCI);
+    TMessageAggregator demultiplexer(receiverHCI);
+    TSenderHost        senderHost;
+    TReceiverHost      receiver;
+
+    demultiplexer.RegisterClient(&receiver);
+    senderHCI.RegisterClient(&senderHost);
+    receiverHCI.RegisterClient(&receiver);
+
+    TDataLinkConfig link;
+    link.GroupAddress  = BENCH_GROUP_ADDRESS;
+    link.DeviceAddress = BENCH_RECEIVER_ADDRESS;
+
+    TAggregatorConfig config;
+    config.Link         = link;
+    config.FlushDelayUs = delayUs / timeScale;
+
+    single.Configure(link);
+    aggregator.Configure(config);
+
+    std::cout << count << " messages of " << messageSize << " bytes, "
+              << (rate > 0 ? std::to_string((int)rate) + " messages/s" : std::string("saturated"))
+              << ", flush delay " << delayUs << " us, module queue " << queueDepth << ", setup " << setupUs
+              << " us, time scale " << timeScale << " (rates and latencies in radio time)" << std::endl
+              << std::setw(12) << "config"
+              << std::setw(8) << "mode"
+              << std::setw(10) << "msgs/s"
+              << std::setw(12) << "airtime ms"
+              << std::setw(11) << "per frame"
+              << std::setw(10) << "p50 ms"
+              << std::setw(10) << "p99 ms" << std::endl;
+
+    bool result = true;
+
+    for (const TSweepPoint& point : points)
+    {
+        senderModule.SetRadio(point.Radio);
+        receiverModule.SetRadio(point.Radio);
+        receiver.Radio = point.Radio;
+
+        double singleRate    = 0;
+        double singleAirtime = 0;
+
+        for (bool aggregated : { false, true })
+        {
+            single.Reset();
+            aggregator.GetLink().Reset();
+            receiver.Reset(count);
+
+            senderHost.Target   = aggregated ? (TWiMODLRHCIClient*)&aggregator : (TWiMODLRHCIClient*)&single;
+            receiver.Aggregator = aggregated ? &demultiplexer : 0;
+
+            std::vector<UINT8> message(messageSize, 0x5A);
+            UINT32             perFrame = (DATALINK_MAX_PAYLOAD_SIZE - AGGREGATE_HEADER_SIZE) / (AGGREGATE_RECORD_HEADER_SIZE + messageSize);
+            TDataLinkSender&   link     = aggregated ? aggregator.GetLink() : single;
+            UINT32             queued   = 0;
+            auto               start    = TClock::now();
+            auto               deadline = start + std::chrono::seconds(120);
+            auto               interval = std::chrono::duration<double, std::micro>(rate > 0 ? 1e6 / (rate * timeScale) : 0);
+
+            struct pollfd fds[2] = { { senderHCI.GetHandle(), POLLIN, 0 }, { receiverHCI.GetHandle(), POLLIN, 0 } };
+
+            while (receiver.Received < count && TClock::now() < deadline)
+            {
+                TClock::time_point now = TClock::now();
+
+                // the open frame fills up while the data link is busy
+                while (queued < count
+                       && (link.GetQueued() < BENCH_HOST_BACKLOG || (aggregated && aggregator.GetPending() < perFrame))
+                       && (rate <= 0 || now - start >= queued * interval))
+                {
+                    HTON32(message.data(), queued);
+                    receiver.SendTimes[queued++] = now;
+
+                    if (aggregated)
+                        aggregator.Send(message.data(), (UINT16)message.size());
+                    else
+                        single.Send(message.data(), (UINT16)message.size());
+                }
+
+                ::poll(fds, 2, 1);
+
+                senderHCI.Process();
+                receiverHCI.Process();
+                single.Poll();
+                aggregator.Poll();
+            }
+
+            if (receiver.Received < count)
+            {
+                std::cerr << "Error: Messages missing, " << link.FormatStats() << std::endl;
+                return 1;
+            }
+
+            double radioS  = std::chrono::duration<double>(receiver.LastRx - start).count() * timeScale;
+            double msgRate = radioS > 0 ? count / radioS : 0;
+            double airtime = receiver.AirtimeNs / 1e6 / count;
+
+            std::cout << std::fixed
+                      << std::setw(12) << FormatConfig(point.Radio)
+                      << std::setw(8) << (aggregated ? "aggr" : "single")
+                      << std::setprecision(1)
+                      << std::setw(10) << msgRate
+                      << std::setprecision(2)
+                      << std::setw(12) << airtime
+                      << std::setprecision(1)
+                      << std::setw(11) << (double)count / receiver.Frames
+                      << std::setw(10) << receiver.Latency.Percentile(50) * timeScale / 1000.0
+                      << std::setw(10) << receiver.Latency.Percentile(99) * timeScale / 1000.0 << std::endl;
+
+            // saturated: more messages per second for less time on air each
+            if (!aggregated)
+            {
+                singleRate    = msgRate;
+                singleAirtime = airtime;
+            }
+            else if (rate <= 0 && (airtime >= singleAirtime || msgRate <= singleRate))
+                result = false;
+        }
+    }
+
+    std::cout << "aggregator " << aggregator.FormatStats() << std::endl;
+
+    senderHCI.Close();
+    receiverHCI.Close();
+    senderModule.Close();
+    receiverModule.Close();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,406 @@
+//------------------------------------------------------------------------------
+//
+//	File:		BulkBench.cpp
+//
+//	Abstract:	Reliable bulk transfer between two emulated modules over a
+//              lossy link, goodput against the time on air of the data:
+//              stop-and-wait, selective repeat (ARQ) and ARQ with forward
+//              error correction
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      bulk_bench [-g <grid>] [-k <KiB>] [-w <window>] [-c <FEC block>]
+//                         [-q <module queue depth>] [-u <tx setup us>] [-l <loss %>]
+//                         [-b <mean burst>] [-t <loss trace CSV>] [-x <time scale>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/BulkTransfer.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define BENCH_GROUP_ADDRESS     0x10
+#define BENCH_SENDER_ADDRESS    0x1111
+#define BENCH_RECEIVER_ADDRESS  0x2222
+
+// windowed goodput against the airtime limit of the data, without loss
+#define BENCH_MIN_EFFICIENCY    0.8
+
+typedef struct
+{
+    const char* Name;
+    UINT32      Window;
+    UINT32      FecBlock;
+}TBenchMode;
+
+//------------------------------------------------------------------------------
+//
+//  TBenchClient
+//
+//  @brief: completion of both ends
+//
+//------------------------------------------------------------------------------
+
+class TBenchClient : public TBulkTransferClient
+{
+    public:
+
+    bool                                    Received = false;
+    bool                                    Done = false;
+    bool                                    Success = false;
+    std::vector<UINT8>                      Data;
+    std::chrono::steady_clock::time_point   ReceivedAt;
+
+    void        Reset()
+                {
+                    Received = false;
+                    Done     = false;
+                    Success  = false;
+                    Data.clear();
+                }
+
+    void        evBulkTransfer_Received(UINT8 /* id */, const std::vector<UINT8>& data) override
+                {
+                    Received   = true;
+                    Data       = data;
+                    ReceivedAt = std::chrono::steady_clock::now();
+                }
+
+    void        evBulkTransfer_Done(UINT8 /* id */, bool success) override
+                {
+                    Done    = true;
+                    Success = success;
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  FormatConfig
+//
+//  @brief: "sf7/125 4/5"
+//
+//------------------------------------------------------------------------------
+
+static std::string
+FormatConfig(const TWiMODLR_RadioConfig& radio)
+{
+    return "sf" + std::to_string(radio.SpreadingFactor) + "/" + std::to_string(AIRTIME_GetBandwidthHz(radio.Bandwidth) / 1000)
+           + " 4/" + std::to_string(std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 4);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: one transfer, until the sender is done
+//
+//------------------------------------------------------------------------------
+
+static bool
+Run(TWiMODLRHCI& senderHCI, TWiMODLRHCI& receiverHCI, TBulkTransfer& sender, TBulkTransfer& receiver,
+    TBenchClient& client, const std::vector<UINT8>& data, double& elapsedS)
+{
+    auto start    = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(120);
+
+    if (!sender.Send(data))
+        return false;
+
+    struct pollfd fds[2] = { { senderHCI.GetHandle(), POLLIN, 0 }, { receiverHCI.GetHandle(), POLLIN, 0 } };
+
+    while (!client.Done && std::chrono::steady_clock::now() < deadline)
+    {
+        ::poll(fds, 2, 1);
+
+        senderHCI.Process();
+        receiverHCI.Process();
+        sender.Poll();
+        receiver.Poll();
+    }
+
+    elapsedS = std::chrono::duration<double>(client.ReceivedAt - start).count();
+
+    return client.Done && client.Success && client.Received && client.Data == data;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7;bw=203,812";
+    UINT32      kib         = 8;
+    UINT32      window      = 16;
+    UINT32      fecBlock    = 8;
+    UINT32      queueDepth  = 4;
+    UINT32      setupUs     = 5000;
+    double      lossPercent = 0;
+    double      meanBurst   = 1;
+    std::string traceFile;
+    UINT32      timeScale   = 20;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-k") && i + 1 < argc)
+            kib = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc)
+            window = std::clamp(std::atoi(argv[++i]), 2, BULK_ACK_BITMAP_BITS + 1);
+        else if (!std::strcmp(argv[i], "-c") && i + 1 < argc)
+            fecBlock = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-q") && i + 1 < argc)
+            queueDepth = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-u") && i + 1 < argc)
+            setupUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-l") && i + 1 < argc)
+            lossPercent = std::clamp(std::atof(argv[++i]), 0.0, 50.0);
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            meanBurst = std::max(1.0, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            traceFile = argv[++i];
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            timeScale = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-k <KiB>] [-w <window>] [-c <FEC block>]"
+                      << " [-q <module queue depth>] [-u <tx setup us>] [-l <loss %>] [-b <mean burst>]"
+                      << " [-t <loss trace CSV>] [-x <time scale>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TSweepPoint> points;
+    std::string error;
+
+    TWiMODLR_RadioConfig base = TWiMODLR_RadioConfig();
+    base.Modulation      = WiMODLR_RADIO_CONFIG_MOD_LORA;
+    base.Bandwidth       = WiMODLR_RADIO_CONFIG_BW_203kHz;
+    base.SpreadingFactor = WiMODLR_RADIO_CONFIG_SF7;
+    base.ErrorCoding     = WiMODLR_RADIO_CONFIG_EC_4_5;
+
+    if (!TSweepCampaign::ParseGrid(grid, base, points, error))
+    {
+        std::cerr << "Grid: " << error << std::endl;
+        return 1;
+    }
+
+    TEmulatedChannel channel(timeScale);
+    THCIEmulator     senderModule;
+    THCIEmulator     receiverModule;
+
+    std::ostringstream lossText;
+
+    lossText << std::fixed << std::setprecision(1);
+
+    if (!traceFile.empty())
+    {
+        std::vector<bool> trace;
+
+        if (!TEmulatedChannel::LoadLossTrace(traceFile, trace))
+        {
+            std::cerr << "Error: No loss trace in " << traceFile << std::endl;
+            return 1;
+        }
+
+        size_t lost   = std::count(trace.begin(), trace.end(), true);
+        size_t bursts = 0;
+
+        for (size_t i = 0; i < trace.size(); i++)
+            bursts += trace[i] && (!i || !trace[i - 1]);
+
+        lossText << traceFile << " (" << trace.size() << " messages, " << 100.0 * lost / trace.size()
+                 << " % lost, mean burst " << (bursts ? (double)lost / bursts : 0.0) << ")";
+
+        channel.SetLossTrace(trace);
+    }
+    else
+    {
+        lossText << lossPercent << " % in bursts of " << meanBurst;
+        channel.SetLossRate(lossPercent, meanBurst);
+    }
+
+    senderModule.ConnectDataLink(channel, receiverModule);
+    receiverModule.ConnectDataLink(channel, senderModule);
+    senderModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_SENDER_ADDRESS);
+    receiverModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_RECEIVER_ADDRESS);
+
+    for (THCIEmulator* module : { &senderModule, &receiverModule })
+    {
+        module->SetTxQueueSize(queueDepth);
+        module->SetTxSetupTime(setupUs);
+    }
+
+    TWiMODLRHCI senderHCI;
+    TWiMODLRHCI receiverHCI;
+
+    if (!senderModule.Open() || !receiverModule.Open() || !senderModule.Start() || !receiverModule.Start()
+        || !senderHCI.Open(senderModule.GetPortName()) || !receiverHCI.Open(receiverModule.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radios" << std::endl;
+        return 1;
+    }
+
+    TBulkTransfer sender(senderHCI);
+    TBulkTransfer receiver(receiverHCI);
+    TBenchClient  client;
+
+    sender.RegisterClient(&client);
+    receiver.RegisterClient(&client);
+    senderHCI.RegisterClient(&sender);
+    receiverHCI.RegisterClient(&receiver);
+
+    std::vector<UINT8> data(kib * 1024);
+    std::mt19937 random(1);
+
+    for (UINT8& byte : data)
+        byte = (UINT8)random();
+
+    std::cout << kib << " KiB, window " << window << ", FEC block " << fecBlock << ", module queue " << queueDepth
+              << ", setup " << setupUs << " us, time scale " << timeScale << " (rates and times in radio time)" << std::endl
+              << "loss " << lossText.str() << std::endl
+              << std::setw(12) << "config"
+              << std::setw(6) << "mode"
+              << std::setw(10) << "ceiling"
+              << std::setw(10) << "goodput"
+              << std::setw(6) << "%"
+              << std::setw(7) << "frags"
+              << std::setw(7) << "parity"
+              << std::setw(7) << "resent"
+              << std::setw(6) << "rec"
+              << std::setw(6) << "rto"
+              << std::setw(6) << "acks"
+              << std::setw(8) << "loss %"
+              << std::setw(10) << "srtt ms" << std::endl;
+
+    std::vector<TBenchMode> modes = { { "s&w", 1, 0 }, { "arq", window, 0 } };
+
+    if (fecBlock)
+        modes.push_back({ "fec", window, fecBlock });
+
+    bool result = true;
+
+    for (const TSweepPoint& point : points)
+    {
+        senderModule.SetRadio(point.Radio);
+        receiverModule.SetRadio(point.Radio);
+
+        // application data against the time on air of full fragments
+        double ceiling = 8.0 * BULK_MAX_FRAGMENT_SIZE * 1e9
+                         / (double)AIRTIME_GetTimeOnAirNs(point.Radio, (UINT8)(BULK_MAX_FRAGMENT_SIZE + BULK_DATA_HEADER_SIZE + DATALINK_MSG_HEADER_SIZE));
+
+        double stopAndWait = 0;
+
+        for (const TBenchMode& mode : modes)
+        {
+            // timers run in host time, radio time passes timeScale faster
+            TBulkConfig config;
+            config.Window       = mode.Window;
+            config.FecBlock     = mode.FecBlock;
+            config.InitialRtoMs = std::max<UINT32>(20, config.InitialRtoMs / timeScale);
+            config.MinRtoMs     = std::max<UINT32>(5, config.MinRtoMs / timeScale);
+            config.MaxRtoMs     = std::max<UINT32>(100, config.MaxRtoMs / timeScale);
+            config.AckDelayMs   = std::max<UINT32>(1, config.AckDelayMs / timeScale);
+
+            // bursts of the emulated channel count messages, a fade does
+            // not end while the sender waits
+            config.MaxTransmissions = 50;
+
+            config.Link.GroupAddress  = BENCH_GROUP_ADDRESS;
+            config.Link.DeviceAddress = BENCH_RECEIVER_ADDRESS;
+            sender.Configure(config);
+
+            config.Link.DeviceAddress = BENCH_SENDER_ADDRESS;
+            receiver.Configure(config);
+
+            client.Reset();
+            channel.ResetLoss();
+
+            TBulkStats before    = sender.GetStats();
+            UINT64     recovered = receiver.GetStats().Recovered;
+            double     elapsedS  = 0;
+
+            if (!Run(senderHCI, receiverHCI, sender, receiver, client, data, elapsedS))
+            {
+                std::cerr << "Error: Transfer failed, " << sender.FormatStats() << std::endl;
+                return 1;
+            }
+
+            TBulkStats stats = sender.GetStats();
+
+            double radioS  = elapsedS * timeScale;
+            double goodput = radioS > 0 ? data.size() * 8.0 / radioS : 0;
+
+            std::cout << std::fixed
+                      << std::setw(12) << FormatConfig(point.Radio)
+                      << std::setw(6) << mode.Name
+                      << std::setprecision(0)
+                      << std::setw(10) << ceiling
+                      << std::setw(10) << goodput
+                      << std::setw(6) << 100 * goodput / ceiling
+                      << std::setw(7) << stats.Fragments - before.Fragments
+                      << std::setw(7) << stats.ParityFragments - before.ParityFragments
+                      << std::setw(7) << stats.Retransmissions - before.Retransmissions
+                      << std::setw(6) << receiver.GetStats().Recovered - recovered
+                      << std::setw(6) << stats.Timeouts - before.Timeouts
+                      << std::setw(6) << stats.AcksReceived - before.AcksReceived
+                      << std::setprecision(1)
+                      << std::setw(8) << sender.GetLossEstimate() * 100
+                      << std::setw(10) << sender.GetSrtt() * timeScale << std::endl;
+
+            // plain ARQ: the window beats stop-and-wait, reaches the limit
+            // without loss; FEC sends no parity then and reaches it as well
+            bool clean = lossPercent == 0 && traceFile.empty();
+
+            if (mode.Window == 1)
+                stopAndWait = goodput;
+            else if (!mode.FecBlock
+                     && (goodput <= stopAndWait || (clean && goodput < BENCH_MIN_EFFICIENCY * ceiling)))
+                result = false;
+            else if (mode.FecBlock && clean
+                     && (goodput < BENCH_MIN_EFFICIENCY * ceiling || stats.ParityFragments != before.ParityFragments))
+                result = false;
+        }
+    }
+
+    std::cout << "sender " << sender.FormatStats() << std::endl
+              << "link " << sender.GetLink().FormatStats() << std::endl;
+
+    senderHCI.Close();
+    receiverHCI.Close();
+    senderModule.Close();
+    receiverModule.Close();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,341 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ClockBench.cpp
+//
+//	Abstract:	Offset and drift estimate of an emulated module RTC against
+//              the true offset, with serial delays and jitter
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      clock_bench [-t <s>] [-i <interval ms>] [-p <drift ppm>]
+//                          [-o <offset ms>] [-d <min. delay us>] [-j <jitter us>]
+//                          [-u <max. uncertainty us>] [-b <legacy|epoll|io_uring>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/ClockSync.h"
+#include "../Measurement/RLTSample.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// lines of the report
+#define BENCH_REPORT_S          5
+
+// required at the end [us], the bounds settle near the shortest round trip
+// which includes the scheduling of emulator and host
+#define BENCH_MAX_UNCERTAINTY   5000
+
+// status indications with a backend [ms]
+#define BENCH_STATUS_INTERVAL_MS    10
+
+//------------------------------------------------------------------------------
+//
+//  TRtcEmulator
+//
+//  @brief: module with an RTC running off the host clock by an offset and
+//          a drift; request and response are delayed by the minimum delay
+//          plus a uniform jitter each, the RTC is read in between
+//
+//------------------------------------------------------------------------------
+
+class TRtcEmulator : public THCIEmulator
+{
+    public:
+
+                TRtcEmulator(INT64 offsetUs, double driftPpm, UINT32 delayUs, UINT32 jitterUs)
+                    : Random(7)
+                {
+                    StartUs  = RLT_GetMonotonicUs();
+                    ModuleUs = RLT_MonotonicToTimeUs(StartUs) + offsetUs;
+                    DriftPpm = driftPpm;
+                    DelayUs  = delayUs;
+                    JitterUs = jitterUs;
+                }
+
+    // RTC - monotonic clock [us]
+    INT64       GetOffsetUs(INT64 monotonicUs) const
+                {
+                    return ModuleUs + (INT64)((monotonicUs - StartUs) * (1 + DriftPpm / 1e6)) - monotonicUs;
+                }
+
+    protected:
+
+    bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length) override
+                {
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_GET_RTC_REQ)
+                    {
+                        Delay();
+
+                        INT64 now = RLT_GetMonotonicUs();
+                        INT64 rtc = now + GetOffsetUs(now);
+
+                        UINT8 response[5];
+
+                        response[0] = DEVMGMT_STATUS_OK;
+                        HTON32(&response[1], CLOCK_SecondsToRtc(rtc / 1000000));
+
+                        Delay();
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_RTC_RSP, response, sizeof(response));
+                    }
+
+                    return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+                }
+
+    private:
+
+    void        Delay()
+                {
+                    UINT32 delay = DelayUs + (JitterUs ? (UINT32)(Random() % JitterUs) : 0);
+
+                    std::this_thread::sleep_for(std::chrono::microseconds(delay));
+                }
+
+    INT64           StartUs;
+    INT64           ModuleUs;
+    double          DriftPpm;
+    UINT32          DelayUs;
+    UINT32          JitterUs;
+    std::mt19937    Random;
+};
+
+//------------------------------------------------------------------------------
+//
+//  TIndicationCounter
+//
+//  @brief: status indications dispatched while the exchanges run
+//
+//------------------------------------------------------------------------------
+
+class TIndicationCounter : public TWiMODLRHCIClient
+{
+    public:
+
+    void        evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& /* status */) override
+                {
+                    Count++;
+                }
+
+    UINT64      Count = 0;
+};
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT32 durationS   = 90;
+    UINT32 intervalMs  = 250;
+    double driftPpm    = 40;
+    INT64  offsetMs    = 3723456;
+    UINT32 delayUs     = 300;
+    UINT32 jitterUs    = 2000;
+    INT64  uncertainUs = BENCH_MAX_UNCERTAINTY;
+
+    std::string backendName = "legacy";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            durationS = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-p") && i + 1 < argc)
+            driftPpm = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "-o") && i + 1 < argc)
+            offsetMs = std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            delayUs = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-j") && i + 1 < argc)
+            jitterUs = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-u") && i + 1 < argc)
+            uncertainUs = std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backendName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-t <s>] [-i <interval ms>] [-p <drift ppm>]"
+                      << " [-o <offset ms>] [-d <min. delay us>] [-j <jitter us>]"
+                      << " [-u <max. uncertainty us>] [-b <legacy|epoll|io_uring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    TRtcEmulator module(offsetMs * 1000, driftPpm, delayUs, jitterUs);
+    TWiMODLRHCI  hci;
+
+    if (!module.Open() || !module.Start() || !hci.Open(module.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return 1;
+    }
+
+    // drift estimated within the run
+    TClockSyncConfig config;
+    config.IntervalMs    = intervalMs;
+    config.MinDriftSpanS = std::min<UINT32>(config.MinDriftSpanS, durationS / 3);
+
+    TClockSync clock(hci);
+    clock.Configure(config);
+
+    // through a backend status indications of a radio link test compete
+    // with the responses for the reads, the reader is detached for each
+    // exchange
+    std::unique_ptr<TEventBackend> backend;
+    THCIReader                     reader(hci);
+    TIndicationCounter             indications;
+
+    hci.RegisterClient(&indications);
+
+    if (backendName != "legacy")
+    {
+        TWiMODLR_RadioLinkTestConfig test;
+        test.GroupAddress  = 0x10;
+        test.DeviceAddress = 0x2222;
+        test.PacketSize    = 15;
+        test.NumPackets    = 100;
+        test.TestMode      = 1;
+
+        UINT8 status = 0;
+
+        module.SetStatusInterval(BENCH_STATUS_INTERVAL_MS * 1000);
+
+        if (hci.StartRadioLinkTest(test, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+        {
+            std::cerr << "Error: Could not start radio link test" << std::endl;
+            return 1;
+        }
+
+        backend.reset(CreateEventBackend(backendName == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+        if (!backend || !reader.Attach(*backend))
+        {
+            std::cerr << "Error: Could not set up event backend" << std::endl;
+            return 1;
+        }
+
+        clock.SetReader(&reader);
+    }
+
+    std::cout << durationS << " s, RTC request every " << intervalMs << " ms, module RTC "
+              << offsetMs << " ms ahead, drift " << driftPpm << " ppm, delay " << delayUs << " + 0.."
+              << jitterUs << " us per direction, " << (backend ? backend->GetName() : "legacy") << std::endl
+              << std::setw(6) << "s"
+              << std::setw(10) << "exchanges"
+              << std::setw(8) << "locked"
+              << std::setw(12) << "error us"
+              << std::setw(14) << "uncertain us"
+              << std::setw(12) << "drift ppm"
+              << std::setw(10) << "min rtt" << std::endl;
+
+    INT64 start   = RLT_GetMonotonicUs();
+    INT64 end     = start + durationS * 1000000ll;
+    INT64 report  = start + BENCH_REPORT_S * 1000000ll;
+    INT64 lockUs  = 0;
+    INT64 maxErr  = 0;
+    bool  bounded = true;
+
+    struct pollfd fds[1] = { { hci.GetHandle(), POLLIN, 0 } };
+
+    for (;;)
+    {
+        INT64 now = RLT_GetMonotonicUs();
+
+        if (now >= end)
+            break;
+
+        if (backend)
+        {
+            if (backend->Poll(std::max(0, clock.GetWaitMs(10))) < 0 || reader.IsClosed())
+            {
+                std::cerr << "Error: Event loop failed" << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            ::poll(fds, 1, std::max(0, clock.GetWaitMs(10)));
+            hci.Process();
+        }
+
+        clock.Poll();
+
+        now = RLT_GetMonotonicUs();
+
+        // the true offset stays within the bounds once locked
+        if (clock.IsLocked())
+        {
+            if (!lockUs)
+                lockUs = now;
+
+            INT64 error = clock.GetOffsetUs(now) - module.GetOffsetUs(now);
+
+            maxErr = std::max(maxErr, std::abs(error));
+
+            if (std::abs(error) > clock.GetUncertaintyUs(now))
+                bounded = false;
+        }
+
+        if (now >= report)
+        {
+            report += BENCH_REPORT_S * 1000000ll;
+
+            TClockSyncStats stats = clock.GetStats();
+
+            std::cout << std::setw(6) << (now - start) / 1000000
+                      << std::setw(10) << stats.Exchanges
+                      << std::setw(8) << (clock.IsLocked() ? "yes" : "no")
+                      << std::setw(12) << (clock.IsLocked() ? clock.GetOffsetUs(now) - module.GetOffsetUs(now) : 0)
+                      << std::setw(14) << clock.GetUncertaintyUs(now)
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(12) << (clock.HasDrift() ? clock.GetDriftPpm() : 0.0)
+                      << std::setw(10) << stats.MinRoundTripUs << std::endl;
+        }
+    }
+
+    INT64 now         = RLT_GetMonotonicUs();
+    INT64 uncertainty = clock.GetUncertaintyUs(now);
+    bool  result      = bounded && lockUs && uncertainty <= uncertainUs && !clock.GetStats().Resyncs
+                        && (!backend || indications.Count);
+
+    std::cout << "lock after " << (lockUs ? (lockUs - start) / 1000 : 0) << " ms, max. error " << maxErr
+              << " us, bounds " << (bounded ? "held" : "violated") << ", " << clock.FormatState() << std::endl;
+
+    if (backend)
+        std::cout << indications.Count << " status indications" << std::endl;
+
+    backend.reset();
+    hci.Close();
+    module.Close();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,367 @@
+//------------------------------------------------------------------------------
+//
+//	File:		DataLinkBench.cpp
+//
+//	Abstract:	Goodput of pipelined unreliable radio messages against the
+//              time on air, stop-and-wait for comparison
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      datalink_bench [-g <grid>] [-n <messages>] [-s <payload bytes>]
+//                             [-q <module queue depth>] [-f <max. in flight>]
+//                             [-u <tx setup us>] [-l <loss %>] [-x <time scale>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/DataLinkSender.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define BENCH_GROUP_ADDRESS     0x10
+#define BENCH_SENDER_ADDRESS    0x1111
+#define BENCH_RECEIVER_ADDRESS  0x2222
+
+// messages kept queued on the host
+#define BENCH_HOST_BACKLOG      16
+
+// pipelined goodput against the airtime limit
+#define BENCH_MIN_EFFICIENCY    0.9
+
+//------------------------------------------------------------------------------
+//
+//  TSenderHost
+//
+//  @brief: HCI client of the sending module
+//
+//------------------------------------------------------------------------------
+
+class TSenderHost : public TWiMODLRHCIClient
+{
+    public:
+
+                TSenderHost(TDataLinkSender& sender) : Sender(sender) {}
+
+    void        evRadioLink_TxUMessageRsp(UINT8 status) override { Sender.evRadioLink_TxUMessageRsp(status); }
+    void        evRadioLink_TxUMessageInd(UINT8 status) override { Sender.evRadioLink_TxUMessageInd(status); }
+
+    private:
+
+    TDataLinkSender&    Sender;
+};
+
+//------------------------------------------------------------------------------
+//
+//  TReceiverHost
+//
+//  @brief: HCI client of the receiving module, counts messages by their
+//          sequence number
+//
+//------------------------------------------------------------------------------
+
+class TReceiverHost : public TWiMODLRHCIClient
+{
+    public:
+
+    UINT64                                  Received = 0;
+    UINT64                                  Bytes = 0;
+    UINT64                                  Reordered = 0;
+    UINT32                                  NextSequence = 0;
+    std::chrono::steady_clock::time_point   LastRx;
+
+    void        Reset()
+                {
+                    Received     = 0;
+                    Bytes        = 0;
+                    Reordered    = 0;
+                    NextSequence = 0;
+                }
+
+    void        evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override
+                {
+                    int length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE;
+
+                    if (rxMsg.Payload[0] & 0x01)
+                        length -= DATALINK_MSG_FOOTER_SIZE;
+
+                    if (length < 4)
+                        return;
+
+                    UINT32 sequence = NTOH32(&rxMsg.Payload[DATALINK_MSG_HEADER_SIZE]);
+
+                    if (sequence < NextSequence)
+                        Reordered++;
+                    else
+                        NextSequence = sequence + 1;
+
+                    Received++;
+                    Bytes += length;
+                    LastRx = std::chrono::steady_clock::now();
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  FormatConfig
+//
+//  @brief: "sf7/125 4/5"
+//
+//------------------------------------------------------------------------------
+
+static std::string
+FormatConfig(const TWiMODLR_RadioConfig& radio)
+{
+    return "sf" + std::to_string(radio.SpreadingFactor) + "/" + std::to_string(AIRTIME_GetBandwidthHz(radio.Bandwidth) / 1000)
+           + " 4/" + std::to_string(std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 4);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: send count messages, wait until each one is received or lost
+//
+//------------------------------------------------------------------------------
+
+static bool
+Run(TWiMODLRHCI& senderHCI, TWiMODLRHCI& receiverHCI, TDataLinkSender& sender, TReceiverHost& receiver,
+    THCIEmulator& emulator, UINT32 count, UINT32 payloadSize, double& elapsedS)
+{
+    std::vector<UINT8> payload(payloadSize, 0x5A);
+
+    UINT64 sentBase = emulator.GetMessagesSent();
+    UINT64 lostBase = emulator.GetMessagesLost();
+    UINT32 queued   = 0;
+
+    auto start    = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(60);
+
+    receiver.LastRx = start;
+
+    struct pollfd fds[2] = { { senderHCI.GetHandle(), POLLIN, 0 }, { receiverHCI.GetHandle(), POLLIN, 0 } };
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        while (queued < count && sender.GetQueued() < BENCH_HOST_BACKLOG)
+        {
+            HTON32(payload.data(), queued++);
+            sender.Send(payload.data(), (UINT16)payload.size());
+        }
+
+        UINT64 done = receiver.Received + emulator.GetMessagesLost() - lostBase;
+
+        if (queued == count && sender.IsIdle() && emulator.GetMessagesSent() - sentBase == count && done >= count)
+        {
+            elapsedS = std::chrono::duration<double>(receiver.LastRx - start).count();
+            return true;
+        }
+
+        ::poll(fds, 2, 1);
+
+        senderHCI.Process();
+        receiverHCI.Process();
+        sender.Poll();
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7,9;bw=203,812";
+    UINT32      count       = 200;
+    UINT32      payloadSize = 32;
+    UINT32      queueDepth  = 4;
+    UINT32      maxInFlight = 8;
+    UINT32      setupUs     = 5000;
+    double      lossPercent = 0;
+    UINT32      timeScale   = 20;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            count = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            payloadSize = std::clamp(std::atoi(argv[++i]), 4, DATALINK_MAX_PAYLOAD_SIZE);
+        else if (!std::strcmp(argv[i], "-q") && i + 1 < argc)
+            queueDepth = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-f") && i + 1 < argc)
+            maxInFlight = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-u") && i + 1 < argc)
+            setupUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-l") && i + 1 < argc)
+            lossPercent = std::clamp(std::atof(argv[++i]), 0.0, 100.0);
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            timeScale = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-n <messages>] [-s <payload bytes>]"
+                      << " [-q <module queue depth>] [-f <max. in flight>] [-u <tx setup us>] [-l <loss %>]"
+                      << " [-x <time scale>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TSweepPoint> points;
+    std::string error;
+
+    TWiMODLR_RadioConfig base = TWiMODLR_RadioConfig();
+    base.Modulation      = WiMODLR_RADIO_CONFIG_MOD_LORA;
+    base.Bandwidth       = WiMODLR_RADIO_CONFIG_BW_203kHz;
+    base.SpreadingFactor = WiMODLR_RADIO_CONFIG_SF7;
+    base.ErrorCoding     = WiMODLR_RADIO_CONFIG_EC_4_5;
+
+    if (!TSweepCampaign::ParseGrid(grid, base, points, error))
+    {
+        std::cerr << "Grid: " << error << std::endl;
+        return 1;
+    }
+
+    TEmulatedChannel channel(timeScale);
+    THCIEmulator     senderModule;
+    THCIEmulator     receiverModule;
+
+    channel.SetLossRate(lossPercent);
+
+    senderModule.ConnectDataLink(channel, receiverModule);
+    receiverModule.ConnectDataLink(channel, senderModule);
+    senderModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_SENDER_ADDRESS);
+    receiverModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_RECEIVER_ADDRESS);
+    senderModule.SetTxQueueSize(queueDepth);
+    senderModule.SetTxSetupTime(setupUs);
+
+    TWiMODLRHCI senderHCI;
+    TWiMODLRHCI receiverHCI;
+
+    if (!senderModule.Open() || !receiverModule.Open() || !senderModule.Start() || !receiverModule.Start()
+        || !senderHCI.Open(senderModule.GetPortName()) || !receiverHCI.Open(receiverModule.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radios" << std::endl;
+        return 1;
+    }
+
+    TDataLinkSender sender(senderHCI);
+    TSenderHost     senderHost(sender);
+    TReceiverHost   receiver;
+
+    senderHCI.RegisterClient(&senderHost);
+    receiverHCI.RegisterClient(&receiver);
+
+    std::cout << count << " messages of " << payloadSize << " bytes, module queue " << queueDepth
+              << ", setup " << setupUs << " us, loss " << lossPercent << " %, time scale " << timeScale
+              << " (rates and latencies in radio time)" << std::endl
+              << std::setw(12) << "config"
+              << std::setw(10) << "in flight"
+              << std::setw(12) << "ceiling"
+              << std::setw(12) << "goodput"
+              << std::setw(7) << "%"
+              << std::setw(9) << "pkts/s"
+              << std::setw(8) << "q_full"
+              << std::setw(10) << "queue p50"
+              << std::setw(10) << "p99 ms" << std::endl;
+
+    bool result = true;
+
+    for (const TSweepPoint& point : points)
+    {
+        senderModule.SetRadio(point.Radio);
+        receiverModule.SetRadio(point.Radio);
+
+        // application payload against its time on air with the header
+        double ceiling = 8.0 * payloadSize * 1e9
+                         / (double)AIRTIME_GetTimeOnAirNs(point.Radio, (UINT8)(payloadSize + DATALINK_MSG_HEADER_SIZE));
+
+        for (UINT32 inFlight : { 1u, maxInFlight })
+        {
+            TDataLinkConfig config;
+            config.GroupAddress  = BENCH_GROUP_ADDRESS;
+            config.DeviceAddress = BENCH_RECEIVER_ADDRESS;
+            config.MaxInFlight   = inFlight;
+
+            sender.Configure(config);
+            sender.Reset();
+            receiver.Reset();
+
+            double elapsedS = 0;
+
+            if (!Run(senderHCI, receiverHCI, sender, receiver, senderModule, count, payloadSize, elapsedS))
+            {
+                std::cerr << "Error: Messages missing, " << sender.FormatStats() << std::endl;
+                return 1;
+            }
+
+            TDataLinkStats stats = sender.GetStats();
+
+            // radio time
+            double radioS  = elapsedS * timeScale;
+            double goodput = radioS > 0 ? receiver.Bytes * 8.0 / radioS : 0;
+
+            const TLatencyHistogram& latency = sender.GetQueueLatency();
+
+            std::cout << std::fixed
+                      << std::setw(12) << FormatConfig(point.Radio)
+                      << std::setw(10) << inFlight
+                      << std::setprecision(0)
+                      << std::setw(12) << ceiling
+                      << std::setw(12) << goodput
+                      << std::setw(7) << 100 * goodput / ceiling
+                      << std::setprecision(1)
+                      << std::setw(9) << (radioS > 0 ? receiver.Received / radioS : 0)
+                      << std::setw(8) << stats.QueueFull
+                      << std::setw(10) << latency.Percentile(50) * timeScale / 1000.0
+                      << std::setw(10) << latency.Percentile(99) * timeScale / 1000.0 << std::endl;
+
+            // every message on air once, no host drops
+            if (stats.Sent != count || stats.Dropped || stats.Rejected || stats.TxErrors || receiver.Reordered)
+                result = false;
+
+            // the pipeline keeps the channel busy and learns the queue depth
+            if (inFlight > 1
+                && (goodput < BENCH_MIN_EFFICIENCY * (1 - lossPercent / 100) * ceiling
+                    || (inFlight > queueDepth && sender.GetCredits() != queueDepth)))
+                result = false;
+        }
+    }
+
+    std::cout << "sender " << sender.FormatStats() << std::endl;
+
+    senderHCI.Close();
+    receiverHCI.Close();
+    senderModule.Close();
+    receiverModule.Close();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
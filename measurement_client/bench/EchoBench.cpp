@@ -0,0 +1,559 @@
+//------------------------------------------------------------------------------
+//
+//	File:		EchoBench.cpp
+//
+//	Abstract:	Round trip time of unreliable radio messages to a peer in
+//              echo mode, host / UART time separated from the time on air
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      echo_bench [-g <grid>] [-n <packets>] [-s <payload bytes>]
+//                         [-u <tx setup us>] [-x <time scale>]
+//                         [-d <local device> -e <echo device>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/DataLinkSender.h"
+#include "../Measurement/LatencyHistogram.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define BENCH_GROUP_ADDRESS     0x10
+#define BENCH_LOCAL_ADDRESS     0x1111
+#define BENCH_ECHO_ADDRESS      0x2222
+
+// radio mode, addresses, modulation, frequency, ..., options
+#define BENCH_RADIO_CONFIG_SIZE 21
+
+// sequence number, send time [us]
+#define BENCH_MESSAGE_HEADER    12
+
+// echoes later than this multiple of the exchange airtime are lost
+#define BENCH_TIMEOUT_FACTOR    4
+#define BENCH_TIMEOUT_MIN_MS    500
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  GetTimeUs
+//
+//  @brief: monotonic time stamp of the messages
+//
+//------------------------------------------------------------------------------
+
+static UINT64
+GetTimeUs()
+{
+    return (UINT64)std::chrono::duration_cast<std::chrono::microseconds>(TClock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+//
+//  TEchoEmulator
+//
+//  @brief: emulated module with a radio configuration in RAM: radio mode,
+//          addresses and the LoRa parameters of the data link
+//
+//------------------------------------------------------------------------------
+
+class TEchoEmulator : public THCIEmulator
+{
+    public:
+
+                TEchoEmulator(UINT16 deviceAddress)
+                {
+                    Radio                 = TWiMODLR_RadioConfig();
+                    Radio.GroupAddress    = BENCH_GROUP_ADDRESS;
+                    Radio.DeviceAddress   = deviceAddress;
+                    Radio.Modulation      = WiMODLR_RADIO_CONFIG_MOD_LORA;
+                    Radio.Bandwidth       = WiMODLR_RADIO_CONFIG_BW_203kHz;
+                    Radio.SpreadingFactor = WiMODLR_RADIO_CONFIG_SF7;
+                    Radio.ErrorCoding     = WiMODLR_RADIO_CONFIG_EC_4_5;
+                    Radio.PowerLevel      = 14;
+                    Radio.RxControl       = WiMODLR_RADIO_CONFIG_RX_ON;
+
+                    Apply();
+                }
+
+    protected:
+
+    bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length) override
+                {
+                    UINT8 response[1 + BENCH_RADIO_CONFIG_SIZE];
+
+                    response[0] = DEVMGMT_STATUS_OK;
+
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_GET_RADIO_CONFIG_REQ)
+                    {
+                        UINT8* ptr = &response[1];
+
+                        *ptr++ = Radio.RadioMode;
+                        *ptr++ = Radio.GroupAddress;
+                        *ptr++ = Radio.TxGroupAddress;
+                        HTON16(ptr, Radio.DeviceAddress); ptr += 2;
+                        HTON16(ptr, Radio.TxDeviceAddress); ptr += 2;
+                        *ptr++ = Radio.Modulation;
+                        HTON24(ptr, Radio.Frequency); ptr += 3;
+                        *ptr++ = Radio.Bandwidth;
+                        *ptr++ = Radio.SpreadingFactor;
+                        *ptr++ = Radio.ErrorCoding;
+                        *ptr++ = Radio.PowerLevel;
+                        *ptr++ = Radio.TxControl;
+                        *ptr++ = Radio.RxControl;
+                        HTON16(ptr, Radio.RxWindowTime); ptr += 2;
+                        *ptr++ = Radio.LEDControl;
+                        *ptr++ = Radio.RadioOptions;
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_RADIO_CONFIG_RSP, response, sizeof(response));
+                    }
+
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_SET_RADIO_CONFIG_REQ)
+                    {
+                        // destination memory, configuration
+                        if (length < 1 + BENCH_RADIO_CONFIG_SIZE || payload[0] != WiMODLR_STORE_INTO_RAM)
+                            response[0] = DEVMGMT_STATUS_WRONG_PARAMETER;
+                        else
+                        {
+                            const UINT8* ptr = &payload[1];
+
+                            Radio.RadioMode       = *ptr++;
+                            Radio.GroupAddress    = *ptr++;
+                            Radio.TxGroupAddress  = *ptr++;
+                            Radio.DeviceAddress   = NTOH16(ptr); ptr += 2;
+                            Radio.TxDeviceAddress = NTOH16(ptr); ptr += 2;
+                            Radio.Modulation      = *ptr++;
+                            Radio.Frequency       = NTOH24(ptr); ptr += 3;
+                            Radio.Bandwidth       = *ptr++;
+                            Radio.SpreadingFactor = *ptr++;
+                            Radio.ErrorCoding     = *ptr++;
+                            Radio.PowerLevel      = *ptr++;
+                            Radio.TxControl       = *ptr++;
+                            Radio.RxControl       = *ptr++;
+                            Radio.RxWindowTime    = NTOH16(ptr); ptr += 2;
+                            Radio.LEDControl      = *ptr++;
+                            Radio.RadioOptions    = *ptr++;
+
+                            Apply();
+                        }
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_SET_RADIO_CONFIG_RSP, response, 1);
+                    }
+
+                    return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+                }
+
+    private:
+
+    void        Apply()
+                {
+                    SetRadio(Radio);
+                    SetAddress(Radio.GroupAddress, Radio.DeviceAddress);
+                }
+
+    TWiMODLR_RadioConfig    Radio;
+};
+
+//------------------------------------------------------------------------------
+//
+//  TEchoHost
+//
+//  @brief: HCI client of the local module, one message at a time: send
+//          response, sent indication and echo of the outstanding message
+//
+//------------------------------------------------------------------------------
+
+class TEchoHost : public TWiMODLRHCIClient
+{
+    public:
+
+    UINT32              Sequence = 0;
+    bool                Outstanding = false;
+    bool                Echoed = false;
+    UINT64              SendUs = 0;
+    UINT64              ResponseUs = 0;
+    UINT64              SentUs = 0;
+    UINT64              EchoUs = 0;
+    UINT64              Rejected = 0;
+    UINT64              Late = 0;
+
+    void        evRadioLink_TxUMessageRsp(UINT8 status) override
+                {
+                    if (!Outstanding || ResponseUs)
+                        return;
+
+                    ResponseUs = GetTimeUs();
+
+                    if (status != DATALINK_STATUS_OK)
+                    {
+                        Rejected++;
+                        Outstanding = false;
+                    }
+                }
+
+    void        evRadioLink_TxUMessageInd(UINT8 status) override
+                {
+                    if (Outstanding && !SentUs && status == DATALINK_STATUS_OK)
+                        SentUs = GetTimeUs();
+                }
+
+    void        evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override
+                {
+                    UINT64 now    = GetTimeUs();
+                    int    length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE;
+
+                    if (rxMsg.Payload[0] & 0x01)
+                        length -= DATALINK_MSG_FOOTER_SIZE;
+
+                    if (length < BENCH_MESSAGE_HEADER)
+                        return;
+
+                    const UINT8* data = &rxMsg.Payload[DATALINK_MSG_HEADER_SIZE];
+
+                    // the time stamp travels with the message
+                    if (!Outstanding || NTOH32(data) != Sequence
+                        || ((UINT64)NTOH32(&data[4]) | ((UINT64)NTOH32(&data[8]) << 32)) != SendUs)
+                    {
+                        Late++;
+                        return;
+                    }
+
+                    EchoUs      = now;
+                    Echoed      = true;
+                    Outstanding = false;
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  TEchoStats
+//
+//  @brief: phases of the round trips of one configuration [us]
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    // send request to echo, to the send response (serial link and module),
+    // to the sent indication (setup, time on air, indication), sent
+    // indication to echo (turnaround in the peer, time on air, indication)
+    TLatencyHistogram   Rtt;
+    TLatencyHistogram   Request;
+    TLatencyHistogram   Out;
+    TLatencyHistogram   Back;
+
+    // round trip without the modelled time on air of both messages
+    TLatencyHistogram   Host;
+
+    UINT32              Sent = 0;
+    UINT32              Lost = 0;
+}TEchoStats;
+
+//------------------------------------------------------------------------------
+//
+//  FormatConfig
+//
+//  @brief: "sf7/125 4/5"
+//
+//------------------------------------------------------------------------------
+
+static std::string
+FormatConfig(const TWiMODLR_RadioConfig& radio)
+{
+    return "sf" + std::to_string(radio.SpreadingFactor) + "/" + std::to_string(AIRTIME_GetBandwidthHz(radio.Bandwidth) / 1000)
+           + " 4/" + std::to_string(std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 4);
+}
+
+//------------------------------------------------------------------------------
+//
+//  Configure
+//
+//  @brief: radio configuration in RAM
+//
+//------------------------------------------------------------------------------
+
+static bool
+Configure(TWiMODLRHCI& hci, TWiMODLR_RadioConfig& radio)
+{
+    UINT8 status = 0;
+
+    return hci.SetRadioConfiguration(radio, WiMODLR_STORE_INTO_RAM, status) == WiMODLR_RESULT_OK && status == DEVMGMT_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7,9;bw=203,812";
+    UINT32      packets     = 50;
+    UINT32      payloadSize = 15;
+    UINT32      setupUs     = 5000;
+    UINT32      timeScale   = 1;
+    std::string localDevice;
+    std::string echoDevice;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            packets = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            payloadSize = std::clamp(std::atoi(argv[++i]), BENCH_MESSAGE_HEADER, DATALINK_MAX_PAYLOAD_SIZE);
+        else if (!std::strcmp(argv[i], "-u") && i + 1 < argc)
+            setupUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            timeScale = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            localDevice = argv[++i];
+        else if (!std::strcmp(argv[i], "-e") && i + 1 < argc)
+            echoDevice = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-n <packets>] [-s <payload bytes>]"
+                      << " [-u <tx setup us>] [-x <time scale>] [-d <local device> -e <echo device>]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (localDevice.empty() != echoDevice.empty())
+    {
+        std::cerr << "Error: -d and -e go together" << std::endl;
+        return 1;
+    }
+
+    // two modules on this host or emulated ones on pseudo terminals
+    bool hardware = !localDevice.empty();
+
+    if (hardware)
+        timeScale = 1;
+
+    TEmulatedChannel channel(timeScale);
+    TEchoEmulator    localModule(BENCH_LOCAL_ADDRESS);
+    TEchoEmulator    echoModule(BENCH_ECHO_ADDRESS);
+
+    if (!hardware)
+    {
+        localModule.ConnectDataLink(channel, echoModule);
+        echoModule.ConnectDataLink(channel, localModule);
+        localModule.SetTxSetupTime(setupUs);
+        echoModule.SetTxSetupTime(setupUs);
+
+        if (!localModule.Open() || !echoModule.Open() || !localModule.Start() || !echoModule.Start())
+        {
+            std::cerr << "Error: Could not set up emulated radios" << std::endl;
+            return 1;
+        }
+
+        localDevice = localModule.GetPortName();
+        echoDevice  = echoModule.GetPortName();
+    }
+
+    TWiMODLRHCI localHCI;
+    TWiMODLRHCI echoHCI;
+    TEchoHost   host;
+
+    if (!localHCI.Open(localDevice) || !echoHCI.Open(echoDevice))
+    {
+        std::cerr << "Error: Could not open " << localDevice << " / " << echoDevice << std::endl;
+        return 1;
+    }
+
+    localHCI.RegisterClient(&host);
+
+    // the current configurations are the base of the grid and restored
+    // at the end
+    TWiMODLR_RadioConfig localBase = TWiMODLR_RadioConfig();
+    TWiMODLR_RadioConfig echoBase  = TWiMODLR_RadioConfig();
+    UINT8                status    = 0;
+
+    if (localHCI.GetRadioConfiguration(localBase, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK
+        || echoHCI.GetRadioConfiguration(echoBase, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not read the radio configurations" << std::endl;
+        return 1;
+    }
+
+    std::vector<TSweepPoint> points;
+    std::string error;
+
+    if (!TSweepCampaign::ParseGrid(grid, localBase, points, error))
+    {
+        std::cerr << "Grid: " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << packets << " messages of " << payloadSize << " bytes per configuration, one at a time to "
+              << (hardware ? echoDevice : std::string("an emulated peer")) << " in echo mode";
+
+    if (!hardware)
+        std::cout << ", setup " << setupUs << " us, time scale " << timeScale;
+
+    std::cout << " (ms; out = until the sent indication, back = from there to the echo,"
+              << " host = round trip without the time on air)" << std::endl
+              << std::setw(12) << "config"
+              << std::setw(9) << "airtime"
+              << std::setw(9) << "rtt p50"
+              << std::setw(9) << "rtt p99"
+              << std::setw(9) << "rtt max"
+              << std::setw(9) << "request"
+              << std::setw(9) << "out"
+              << std::setw(9) << "back"
+              << std::setw(9) << "host"
+              << std::setw(9) << "host p99"
+              << std::setw(6) << "lost" << std::endl;
+
+    std::vector<UINT8> message(DATALINK_RADIO_HEADER_SIZE + payloadSize, 0x5A);
+
+    message[0] = echoBase.GroupAddress;
+    HTON16(&message[1], echoBase.DeviceAddress);
+
+    UINT8* data   = &message[DATALINK_RADIO_HEADER_SIZE];
+    bool   result = true;
+
+    struct pollfd fds[2] = { { localHCI.GetHandle(), POLLIN, 0 }, { echoHCI.GetHandle(), POLLIN, 0 } };
+
+    for (const TSweepPoint& point : points)
+    {
+        TWiMODLR_RadioConfig local = point.Radio;
+        TWiMODLR_RadioConfig echo  = point.Radio;
+
+        local.RadioMode       = WiMODLR_RADIO_CONFIG_RM_STANDARD;
+        local.RxControl       = WiMODLR_RADIO_CONFIG_RX_ON;
+
+        // the grid is based on the local module, the peer keeps its
+        // addresses
+        echo.RadioMode        = WiMODLR_RADIO_CONFIG_RM_ECHO;
+        echo.RxControl        = WiMODLR_RADIO_CONFIG_RX_ON;
+        echo.GroupAddress     = echoBase.GroupAddress;
+        echo.DeviceAddress    = echoBase.DeviceAddress;
+        echo.TxGroupAddress   = echoBase.TxGroupAddress;
+        echo.TxDeviceAddress  = echoBase.TxDeviceAddress;
+
+        if (!Configure(echoHCI, echo) || !Configure(localHCI, local))
+        {
+            std::cerr << "Error: Could not configure " << FormatConfig(point.Radio) << std::endl;
+            result = false;
+            continue;
+        }
+
+        // both messages on air, in wall time of the emulation
+        UINT64 airtimeUs = 2 * AIRTIME_GetTimeOnAirNs(point.Radio, (UINT8)(payloadSize + DATALINK_MSG_HEADER_SIZE)) / 1000 / timeScale;
+        UINT64 timeoutUs = std::max<UINT64>(BENCH_TIMEOUT_FACTOR * airtimeUs, BENCH_TIMEOUT_MIN_MS * 1000);
+
+        TEchoStats stats;
+
+        for (UINT32 i = 0; i < packets; i++)
+        {
+            host.Sequence++;
+            host.SendUs      = GetTimeUs();
+            host.ResponseUs  = 0;
+            host.SentUs      = 0;
+            host.EchoUs      = 0;
+            host.Echoed      = false;
+            host.Outstanding = true;
+
+            HTON32(data, host.Sequence);
+            HTON32(&data[4], (UINT32)host.SendUs);
+            HTON32(&data[8], (UINT32)(host.SendUs >> 32));
+
+            stats.Sent++;
+
+            if (localHCI.PostURadioMessage(message.data(), (UINT16)message.size()) != WiMODLR_RESULT_OK)
+                host.Outstanding = false;
+
+            while (host.Outstanding && GetTimeUs() - host.SendUs < timeoutUs)
+            {
+                ::poll(fds, 2, 1);
+
+                localHCI.Process();
+                echoHCI.Process();
+            }
+
+            host.Outstanding = false;
+
+            if (!host.Echoed || !host.ResponseUs || !host.SentUs)
+            {
+                stats.Lost++;
+                continue;
+            }
+
+            UINT64 rtt = host.EchoUs - host.SendUs;
+
+            stats.Rtt.Add(rtt);
+            stats.Request.Add(host.ResponseUs - host.SendUs);
+            stats.Out.Add(host.SentUs - host.SendUs);
+            stats.Back.Add(host.EchoUs - host.SentUs);
+            stats.Host.Add(rtt > airtimeUs ? rtt - airtimeUs : 0);
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(12) << FormatConfig(point.Radio)
+                  << std::setw(9) << airtimeUs / 1000.0
+                  << std::setw(9) << stats.Rtt.Percentile(50) / 1000.0
+                  << std::setw(9) << stats.Rtt.Percentile(99) / 1000.0
+                  << std::setw(9) << stats.Rtt.Max() / 1000.0
+                  << std::setprecision(2)
+                  << std::setw(9) << stats.Request.Percentile(50) / 1000.0
+                  << std::setprecision(1)
+                  << std::setw(9) << stats.Out.Percentile(50) / 1000.0
+                  << std::setw(9) << stats.Back.Percentile(50) / 1000.0
+                  << std::setw(9) << stats.Host.Percentile(50) / 1000.0
+                  << std::setw(9) << stats.Host.Percentile(99) / 1000.0
+                  << std::setw(6) << stats.Lost << std::endl;
+
+        // most echoes back, never faster than the time on air
+        if (stats.Lost * 10 > stats.Sent || stats.Rtt.Min() < airtimeUs)
+            result = false;
+    }
+
+    if (host.Rejected || host.Late)
+        std::cout << "rejected " << host.Rejected << ", late echoes " << host.Late << std::endl;
+
+    if (!Configure(echoHCI, echoBase) || !Configure(localHCI, localBase))
+    {
+        std::cerr << "Error: Could not restore the radio configurations" << std::endl;
+        result = false;
+    }
+
+    localHCI.Close();
+    echoHCI.Close();
+
+    if (!hardware)
+    {
+        localModule.Close();
+        echoModule.Close();
+    }
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+//
+//	File:		EventBackendBench.cpp
+//
+//	Abstract:	System calls and CPU time per frame of the serial read / log
+//              write path for the legacy polling loop, epoll and io_uring
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      event_bench [-r <radios>] [-n <frames per radio>]
+//                          [-i <interval us>] [-b <legacy|epoll|io_uring|all>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../Measurement/MeasurementLogger.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// give up if frames don't arrive within this time
+#define BENCH_TIMEOUT_S         120
+
+//------------------------------------------------------------------------------
+//
+//  TBenchLogger
+//
+//  @brief: CSV logger counting received status indications
+//
+//------------------------------------------------------------------------------
+
+class TBenchLogger : public TMeasurementLogger
+{
+    public:
+
+    UINT64      Frames = 0;
+
+    void        evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override
+                {
+                    TMeasurementLogger::evRadioLinkTest_StatusInd(status);
+                    Frames++;
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  TRadio
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    THCIEmulator    Emulator;
+    TWiMODLRHCI     HCI;
+    TBenchLogger    Logger;
+}TRadio;
+
+//------------------------------------------------------------------------------
+//
+//  GetThreadCpuUs
+//
+//  @brief: user + system time of the calling thread, emulator threads
+//          are not included
+//
+//------------------------------------------------------------------------------
+
+static INT64
+GetThreadCpuUs()
+{
+    struct rusage usage;
+
+    ::getrusage(RUSAGE_THREAD, &usage);
+
+    return (INT64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+         + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+//------------------------------------------------------------------------------
+//
+//  RunBackend
+//
+//  @brief: receive and log numFrames per radio through the given backend
+//
+//------------------------------------------------------------------------------
+
+static bool
+RunBackend(const std::string& name, int numRadios, UINT64 numFrames, UINT32 intervalUs)
+{
+    std::vector<std::unique_ptr<TRadio>>        radios;
+    std::vector<std::unique_ptr<THCIReader>>    readers;
+
+    for (int i = 0; i < numRadios; i++)
+    {
+        radios.emplace_back(new TRadio);
+        TRadio& radio = *radios.back();
+
+        radio.Emulator.SetStatusInterval(intervalUs);
+        radio.Emulator.SetStatusLimit(numFrames);
+
+        std::string filename = "/tmp/event_bench_" + std::to_string(i) + ".csv";
+        std::remove(filename.c_str());
+
+        if (!radio.Emulator.Open() || !radio.Emulator.Start()
+            || !radio.HCI.Open(radio.Emulator.GetPortName())
+            || !radio.Logger.Open(filename, "event_bench " + name, TBlockFileConfig()))
+        {
+            std::cerr << "Error: Could not set up emulated radio " << i << std::endl;
+            return false;
+        }
+
+        radio.HCI.RegisterClient(&radio.Logger);
+    }
+
+    // start tests, responses are read by the HCI itself
+    UINT8 config[7] = { 0x10, 0x22, 0x22, 15, 100, 0, 1 };
+
+    for (auto& radio : radios)
+        radio->HCI.SendHCIMessage(RLT_SAP_ID, RLT_MSG_START_REQ, RLT_MSG_START_RSP, config, sizeof(config));
+
+    std::unique_ptr<TEventBackend> backend;
+
+    if (name != "legacy")
+    {
+        backend.reset(CreateEventBackend(name == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+        if (!backend)
+            return false;
+
+        for (auto& radio : radios)
+        {
+            readers.emplace_back(new THCIReader(radio->HCI));
+            readers.back()->Attach(*backend);
+            radio->Logger.SetBackend(backend.get());
+        }
+    }
+
+    UINT64 legacyReads = 0;
+    UINT64 received    = 0;
+    UINT64 expected    = numFrames * numRadios;
+
+    // frames already read while waiting for the start responses
+    UINT64 initial     = 0;
+    UINT64 writerStart = 0;
+    for (auto& radio : radios)
+    {
+        initial     += radio->Logger.Frames;
+        writerStart += radio->Logger.GetStorageStats().Syscalls;
+    }
+
+    INT64 startCpu  = GetThreadCpuUs();
+    auto  startTime = std::chrono::steady_clock::now();
+
+    while (received < expected)
+    {
+        if (backend)
+        {
+            if (backend->Poll(100) < 0)
+                return false;
+        }
+        else
+        {
+            // what main.cpp does: non-blocking read in a loop
+            for (auto& radio : radios)
+            {
+                radio->HCI.Process();
+                legacyReads++;
+            }
+        }
+
+        received = 0;
+        for (auto& radio : radios)
+            received += radio->Logger.Frames;
+
+        if (std::chrono::steady_clock::now() - startTime > std::chrono::seconds(BENCH_TIMEOUT_S))
+        {
+            std::cerr << "Error: Timeout, " << received << " of " << expected << " frames" << std::endl;
+            return false;
+        }
+    }
+
+    // log files are completed within the measured interval
+    UINT64 writerSyscalls = 0;
+    for (auto& radio : radios)
+    {
+        radio->Logger.Close();
+        writerSyscalls += radio->Logger.GetStorageStats().Syscalls;
+    }
+    writerSyscalls -= writerStart;
+
+    auto   stopTime = std::chrono::steady_clock::now();
+    INT64  cpuUs    = GetThreadCpuUs() - startCpu;
+
+    UINT64 syscalls = writerSyscalls + legacyReads;
+    if (backend)
+        syscalls += backend->GetStats().Syscalls;
+
+    double wallSec  = std::chrono::duration<double>(stopTime - startTime).count();
+    UINT64 measured = std::max<UINT64>(1, received - initial);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::left << std::setw(10) << (backend ? backend->GetName() : "legacy") << std::right
+              << std::setw(10) << measured
+              << std::setw(14) << (double)syscalls / measured
+              << std::setw(18) << cpuUs / 1000.0 / measured * 1000.0
+              << std::setw(12) << measured / wallSec << std::endl;
+
+    // stop emulators before the HCI closes its side
+    backend.reset();
+    for (auto& radio : radios)
+        radio->Emulator.Close();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    int         numRadios   = 1;
+    UINT64      numFrames   = 20000;
+    UINT32      intervalUs  = 500;
+    std::string backend     = "all";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+            numRadios = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            numFrames = std::strtoull(argv[++i], 0, 10);
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backend = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-r <radios>] [-n <frames per radio>] [-i <interval us>]"
+                      << " [-b <legacy|epoll|io_uring|all>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << numRadios << " emulated radio(s), " << numFrames << " frames each, "
+              << intervalUs << " us interval" << std::endl
+              << std::left << std::setw(10) << "backend" << std::right
+              << std::setw(10) << "frames"
+              << std::setw(14) << "syscalls/fr"
+              << std::setw(18) << "CPU ms/1000 fr"
+              << std::setw(12) << "frames/s" << std::endl;
+
+    std::vector<std::string> backends;
+    if (backend == "all")
+        backends = { "legacy", "epoll", "io_uring" };
+    else
+        backends = { backend };
+
+    for (const std::string& name : backends)
+    {
+        if (!RunBackend(name, numRadios, numFrames, intervalUs))
+            return 1;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,935 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HCIEmulator.cpp
+//
+//	Abstract:	Pseudo Terminal Emulation of a WiMOD LR Radio Module
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+//  Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../WiMODLR/CRC16.h"
+#include "../Measurement/Airtime.h"
+#include "../Measurement/RLTSample.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define EMU_SLIP_END            0xC0
+#define EMU_SLIP_ESC            0xDB
+#define EMU_SLIP_ESC_END        0xDC
+#define EMU_SLIP_ESC_ESC        0xDD
+
+// radio link test status field size
+#define EMU_RLT_STATUS_SIZE     15
+
+// default Tx queue depth of the data link
+#define EMU_TX_QUEUE_SIZE       4
+
+//------------------------------------------------------------------------------
+//
+//  TEmulatedChannel - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+TEmulatedChannel::TEmulatedChannel(UINT32 timeScale, UINT32 seed)
+    : TimeScale(std::max<UINT32>(1, timeScale))
+    , LossPercent(0)
+    , MeanBurst(1)
+    , Bad(false)
+    , TracePosition(0)
+    , BusyUntil(TClock::now())
+    , Seed(seed)
+    , Random(seed)
+{
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetTimeScale
+//
+//------------------------------------------------------------------------------
+
+void
+TEmulatedChannel::SetTimeScale(UINT32 timeScale)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    TimeScale = std::max<UINT32>(1, timeScale);
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetLossRate
+//
+//------------------------------------------------------------------------------
+
+void
+TEmulatedChannel::SetLossRate(double percent, double meanBurst)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    LossPercent = std::clamp(percent, 0.0, 100.0);
+    MeanBurst   = std::max(1.0, meanBurst);
+    Trace.clear();
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetLossTrace
+//
+//------------------------------------------------------------------------------
+
+void
+TEmulatedChannel::SetLossTrace(const std::vector<bool>& trace)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    Trace         = trace;
+    TracePosition = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  LoadLossTrace
+//
+//  @brief: counter differences of consecutive rows, a restarted test
+//          (counters going back) starts a new baseline
+//
+//------------------------------------------------------------------------------
+
+bool
+TEmulatedChannel::LoadLossTrace(const std::string& fileName, std::vector<bool>& trace)
+{
+    std::ifstream file(fileName);
+
+    if (!file)
+        return false;
+
+    std::string line;
+    TRLTSample  sample;
+    bool        first = true;
+    UINT32      lastTx = 0;
+    UINT32      lastRx = 0;
+
+    trace.clear();
+
+    while (std::getline(file, line))
+    {
+        if (!RLT_ParseCsvRow(line, sample))
+            continue;
+
+        UINT32 tx = sample.Status.LTxCount;
+        UINT32 rx = sample.Status.PRxCount;
+
+        if (!first && tx >= lastTx && rx >= lastRx)
+        {
+            UINT32 sent     = tx - lastTx;
+            UINT32 received = std::min(rx - lastRx, sent);
+
+            trace.insert(trace.end(), received, false);
+            trace.insert(trace.end(), sent - received, true);
+        }
+
+        first  = false;
+        lastTx = tx;
+        lastRx = rx;
+    }
+
+    return !trace.empty();
+}
+
+//------------------------------------------------------------------------------
+//
+//  ResetLoss
+//
+//------------------------------------------------------------------------------
+
+void
+TEmulatedChannel::ResetLoss()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    Random.seed(Seed);
+    Bad           = false;
+    TracePosition = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Reserve
+//
+//------------------------------------------------------------------------------
+
+TEmulatedChannel::TClock::time_point
+TEmulatedChannel::Reserve(UINT64 airtimeNs, TClock::time_point earliest, UINT64 setupNs)
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    earliest += std::chrono::nanoseconds(setupNs / TimeScale);
+
+    BusyUntil = std::max(BusyUntil, earliest) + std::chrono::nanoseconds(airtimeNs / TimeScale);
+
+    return BusyUntil;
+}
+
+//------------------------------------------------------------------------------
+//
+//  IsLost
+//
+//------------------------------------------------------------------------------
+
+bool
+TEmulatedChannel::IsLost()
+{
+    std::lock_guard<std::mutex> lock(Lock);
+
+    if (!Trace.empty())
+    {
+        bool lost = Trace[TracePosition];
+
+        TracePosition = (TracePosition + 1) % Trace.size();
+        return lost;
+    }
+
+    if (MeanBurst <= 1)
+        return std::uniform_real_distribution<double>(0, 100)(Random) < LossPercent;
+
+    // leave the bad state after MeanBurst messages on average, enter it
+    // such that LossPercent of the messages are in it
+    double loss      = std::min(LossPercent / 100, 0.99);
+    double leaveBad  = 1 / MeanBurst;
+    double enterBad  = loss * leaveBad / (1 - loss);
+
+    Bad = std::uniform_real_distribution<double>(0, 1)(Random) < (Bad ? 1 - leaveBad : enterBad);
+
+    return Bad;
+}
+
+//------------------------------------------------------------------------------
+//
+//  THCIEmulator - Class Constructor
+//
+//------------------------------------------------------------------------------
+
+THCIEmulator::THCIEmulator()
+{
+    Master              = -1;
+    Running             = false;
+    RxLength            = 0;
+    RxEscape            = false;
+    TestRunning         = false;
+    TxFrozen            = false;
+    StatusSent          = 0;
+    StatusIntervalUs    = 1000;
+    StatusLimit         = 0;
+    LossPercent         = 0;
+    HasLinkQuality      = false;
+    LocalRssi           = 0;
+    PeerRssi            = 0;
+    LocalSnr            = 0;
+    PeerSnr             = 0;
+    NumPackets          = 100;
+    TxCount             = 0;
+    PeerRxCount         = 0;
+    RxCount             = 0;
+    WakePipe[0]         = -1;
+    WakePipe[1]         = -1;
+    Channel             = 0;
+    Peer                = 0;
+    TxQueueSize         = EMU_TX_QUEUE_SIZE;
+    GroupAddress        = 0x10;
+    DeviceAddress       = 0x1111;
+    TxSetupUs           = 0;
+    Transmitting        = false;
+    MessagesSent        = 0;
+    MessagesLost        = 0;
+
+    Radio                   = TWiMODLR_RadioConfig();
+    Radio.Modulation        = WiMODLR_RADIO_CONFIG_MOD_LORA;
+    Radio.Bandwidth         = WiMODLR_RADIO_CONFIG_BW_203kHz;
+    Radio.SpreadingFactor   = WiMODLR_RADIO_CONFIG_SF7;
+    Radio.ErrorCoding       = WiMODLR_RADIO_CONFIG_EC_4_5;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ~THCIEmulator - Class Destructor
+//
+//------------------------------------------------------------------------------
+
+THCIEmulator::~THCIEmulator()
+{
+    Close();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Open
+//
+//  @brief: create pseudo terminal pair
+//
+//------------------------------------------------------------------------------
+
+bool
+THCIEmulator::Open()
+{
+    Master = ::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (Master < 0)
+        return false;
+
+    if (::grantpt(Master) != 0 || ::unlockpt(Master) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    const char* name = ::ptsname(Master);
+    if (!name || std::strncmp(name, "/dev/", 5) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    // TSerialDevice prepends "/dev/"
+    PortName = name + 5;
+
+    if (::pipe2(WakePipe, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Close
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::Close()
+{
+    Stop();
+
+    if (Master >= 0)
+    {
+        ::close(Master);
+        Master = -1;
+    }
+
+    for (int& fd : WakePipe)
+    {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Start
+//
+//------------------------------------------------------------------------------
+
+bool
+THCIEmulator::Start()
+{
+    if (Master < 0 || Running)
+        return false;
+
+    Running = true;
+    Thread  = std::thread(&THCIEmulator::Run, this);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Stop
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::Stop()
+{
+    Running = false;
+
+    if (Thread.joinable())
+        Thread.join();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Run
+//
+//  @brief: emulator thread, serve requests and send status indications
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::Run()
+{
+    auto nextStatus = std::chrono::steady_clock::now();
+
+    while (Running)
+    {
+        bool statusDue = TestRunning && (!StatusLimit || StatusSent < StatusLimit);
+
+        // wait for requests until next indication or the end of a
+        // transmission is due, at most 10ms
+        auto now  = std::chrono::steady_clock::now();
+        auto wake = now + std::chrono::milliseconds(10);
+
+        if (statusDue)
+            wake = std::min(wake, nextStatus);
+
+        if (Channel)
+        {
+            std::lock_guard<std::mutex> lock(DataLinkLock);
+
+            if (Transmitting)
+                wake = std::min(wake, TxEnd);
+        }
+
+        INT64 waitNs = std::max<INT64>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(wake - now).count());
+
+        struct timespec timeout = { (time_t)(waitNs / 1000000000), (long)(waitNs % 1000000000) };
+        struct pollfd   fds[2]  = { { Master, POLLIN, 0 }, { WakePipe[0], POLLIN, 0 } };
+
+        if (::ppoll(fds, 2, &timeout, 0) > 0)
+        {
+            UINT8 buffer[512];
+
+            if (fds[0].revents & POLLIN)
+            {
+                ssize_t length = ::read(Master, buffer, sizeof(buffer));
+                if (length > 0)
+                    Decode(buffer, (int)length);
+            }
+
+            if (fds[1].revents & POLLIN)
+                while (::read(WakePipe[0], buffer, sizeof(buffer)) > 0);
+        }
+
+        Tick();
+
+        if (Channel)
+            ProcessDataLink();
+
+        if (!statusDue)
+            continue;
+
+        // catch up in a burst if indications are overdue
+        now = std::chrono::steady_clock::now();
+        while (TestRunning && now >= nextStatus && (!StatusLimit || StatusSent < StatusLimit) && Running)
+        {
+            SendStatusIndication();
+
+            nextStatus += std::chrono::microseconds(StatusIntervalUs);
+
+            if (!StatusIntervalUs)
+                nextStatus = now;
+        }
+
+        if (nextStatus < now - std::chrono::seconds(1))
+            nextStatus = now;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  Decode
+//
+//  @brief: SLIP decoder, complete frames are CRC checked and dispatched
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::Decode(const UINT8* data, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        UINT8 rxByte = data[i];
+
+        if (rxByte == EMU_SLIP_END)
+        {
+            // frame: SapID, MsgID, payload, CRC16
+            if (RxLength >= WIMODLR_HCI_MSG_HEADER_SIZE + WIMODLR_HCI_MSG_FCS_SIZE
+                && CRC16_Check(RxFrame, RxLength, CRC16_INIT_VALUE))
+            {
+                HandleMessage(RxFrame[0], RxFrame[1], &RxFrame[2],
+                              RxLength - WIMODLR_HCI_MSG_HEADER_SIZE - WIMODLR_HCI_MSG_FCS_SIZE);
+            }
+
+            RxLength = 0;
+            RxEscape = false;
+            continue;
+        }
+
+        if (rxByte == EMU_SLIP_ESC)
+        {
+            RxEscape = true;
+            continue;
+        }
+
+        if (RxEscape)
+        {
+            rxByte   = rxByte == EMU_SLIP_ESC_END ? EMU_SLIP_END : EMU_SLIP_ESC;
+            RxEscape = false;
+        }
+
+        if (RxLength < sizeof(RxFrame))
+            RxFrame[RxLength++] = rxByte;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  HandleMessage
+//
+//  @brief: default services of the emulated module
+//
+//------------------------------------------------------------------------------
+
+bool
+THCIEmulator::HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length)
+{
+    UINT8 status = 0;
+
+    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_PING_REQ)
+        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_PING_RSP, &status, 1);
+
+    if (sapID == RLT_SAP_ID && msgID == RLT_MSG_START_REQ)
+    {
+        // group, device address, packet size, number of packets, mode
+        if (length >= 7)
+            NumPackets = std::max<UINT16>(1, NTOH16(&payload[4]));
+
+        TxCount     = 0;
+        PeerRxCount = 0;
+        RxCount     = 0;
+        TxFrozen    = false;
+
+        SendMessage(RLT_SAP_ID, RLT_MSG_START_RSP, &status, 1);
+
+        TestRunning = true;
+        return true;
+    }
+
+    if (sapID == RLT_SAP_ID && msgID == RLT_MSG_STOP_REQ)
+    {
+        TestRunning = false;
+        return SendMessage(RLT_SAP_ID, RLT_MSG_STOP_RSP, &status, 1);
+    }
+
+    if (sapID == DATALINK_SAP_ID && msgID == DATALINK_MSG_SEND_URADIO_MSG_REQ && Channel)
+        return HandleDataLink(payload, length);
+
+    // unknown request, report "command not supported"
+    status = DEVMGMT_STATUS_CMD_NOT_SUPPORTED;
+    SendMessage(sapID, msgID + 1, &status, 1);
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+//
+//  ConnectDataLink
+//
+//  @brief: before Start, the peer is connected the other way round
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::ConnectDataLink(TEmulatedChannel& channel, THCIEmulator& peer)
+{
+    Channel = &channel;
+    Peer    = &peer;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetRadio
+//
+//  @brief: configuration for the time on air of the following messages
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::SetRadio(const TWiMODLR_RadioConfig& radio)
+{
+    std::lock_guard<std::mutex> lock(DataLinkLock);
+
+    Radio = radio;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetAddress
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::SetAddress(UINT8 groupAddress, UINT16 deviceAddress)
+{
+    std::lock_guard<std::mutex> lock(DataLinkLock);
+
+    GroupAddress  = groupAddress;
+    DeviceAddress = deviceAddress;
+}
+
+//------------------------------------------------------------------------------
+//
+//  HandleDataLink
+//
+//  @brief: send request, destination address and payload
+//
+//------------------------------------------------------------------------------
+
+bool
+THCIEmulator::HandleDataLink(const UINT8* payload, UINT16 length)
+{
+    UINT8 status = DATALINK_STATUS_OK;
+
+    if (length < DATALINK_RADIO_HEADER_SIZE
+        || length - DATALINK_RADIO_HEADER_SIZE + DATALINK_MSG_HEADER_SIZE > 255)
+        status = DATALINK_STATUS_MSGLENGTH_ERROR;
+    else
+    {
+        std::lock_guard<std::mutex> lock(DataLinkLock);
+
+        // the message on air still occupies its slot
+        if (TxQueue.size() >= TxQueueSize)
+            status = DATALINK_STATUS_QUEUE_FULL;
+        else
+        {
+            // an idle radio starts after the setup time
+            if (TxQueue.empty())
+                TxAccepted = std::chrono::steady_clock::now();
+
+            TxQueue.emplace_back(payload, payload + length);
+        }
+    }
+
+    return SendMessage(DATALINK_SAP_ID, DATALINK_MSG_SEND_URADIO_MSG_RSP, &status, 1);
+}
+
+//------------------------------------------------------------------------------
+//
+//  ProcessDataLink
+//
+//  @brief: end of a transmission (sent indication, delivery to the peer),
+//          start of the next one, indications for received messages
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::ProcessDataLink()
+{
+    std::vector<std::vector<UINT8>> inbox;
+    std::vector<UINT8>              sent;
+    bool                            done = false;
+    bool                            echo;
+    UINT8                           srcGroup;
+    UINT16                          srcDevice;
+
+    {
+        std::lock_guard<std::mutex> lock(DataLinkLock);
+
+        inbox.swap(Inbox);
+
+        auto now = std::chrono::steady_clock::now();
+
+        if (Transmitting && now >= TxEnd)
+        {
+            sent = std::move(TxQueue.front());
+            TxQueue.pop_front();
+
+            Transmitting = false;
+            done         = true;
+        }
+
+        if (!Transmitting && !TxQueue.empty())
+        {
+            // radio payload and message header on air
+            UINT8 size = (UINT8)(TxQueue.front().size() - DATALINK_RADIO_HEADER_SIZE + DATALINK_MSG_HEADER_SIZE);
+
+            // queued behind the previous message: back to back
+            if (done)
+                TxEnd = Channel->Reserve(AIRTIME_GetTimeOnAirNs(Radio, size), TxEnd);
+            else
+                TxEnd = Channel->Reserve(AIRTIME_GetTimeOnAirNs(Radio, size), TxAccepted, TxSetupUs * 1000ull);
+
+            Transmitting = true;
+        }
+
+        srcGroup  = GroupAddress;
+        srcDevice = DeviceAddress;
+        echo      = Radio.RadioMode == WiMODLR_RADIO_CONFIG_RM_ECHO;
+    }
+
+    if (done)
+    {
+        if (Peer && !Channel->IsLost())
+            Peer->Receive(sent.data(), (UINT16)sent.size(), srcGroup, srcDevice);
+        else
+            MessagesLost++;
+
+        MessagesSent++;
+
+        // echoes are sent without the host
+        if (!echo)
+        {
+            UINT8 status = DATALINK_STATUS_OK;
+            SendMessage(DATALINK_SAP_ID, DATALINK_MSG_SENT_URADIO_MSG_IND, &status, 1);
+        }
+    }
+
+    for (const std::vector<UINT8>& message : inbox)
+        SendMessage(DATALINK_SAP_ID, DATALINK_MSG_RECV_URADIO_MSG_IND, message.data(), (UINT16)message.size());
+}
+
+//------------------------------------------------------------------------------
+//
+//  Receive
+//
+//  @brief: message of the peer for this address or broadcast, indicated by
+//          the emulator thread; in echo mode sent back to the source
+//          instead (dropped if the Tx queue is full)
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::Receive(const UINT8* message, UINT16 length, UINT8 srcGroup, UINT16 srcDevice)
+{
+    if (length < DATALINK_RADIO_HEADER_SIZE)
+        return;
+
+    UINT8  dstGroup  = message[0];
+    UINT16 dstDevice = NTOH16(&message[1]);
+
+    {
+        std::lock_guard<std::mutex> lock(DataLinkLock);
+
+        if ((dstGroup != GroupAddress && dstGroup != 0xFF) || (dstDevice != DeviceAddress && dstDevice != 0xFFFF))
+            return;
+
+        if (Radio.RadioMode == WiMODLR_RADIO_CONFIG_RM_ECHO)
+        {
+            if (TxQueue.size() >= TxQueueSize)
+                return;
+
+            // destination, payload; the radio starts after the setup time
+            std::vector<UINT8> echo(message, message + length);
+
+            echo[0] = srcGroup;
+            HTON16(&echo[1], srcDevice);
+
+            if (TxQueue.empty())
+                TxAccepted = std::chrono::steady_clock::now();
+
+            TxQueue.push_back(std::move(echo));
+        }
+        else
+        {
+            // format, destination, source, payload
+            std::vector<UINT8> indication(DATALINK_MSG_HEADER_SIZE + length - DATALINK_RADIO_HEADER_SIZE);
+
+            indication[0] = 0;
+            indication[1] = dstGroup;
+            HTON16(&indication[2], dstDevice);
+            indication[4] = srcGroup;
+            HTON16(&indication[5], srcDevice);
+            std::copy(message + DATALINK_RADIO_HEADER_SIZE, message + length, indication.begin() + DATALINK_MSG_HEADER_SIZE);
+
+            Inbox.push_back(std::move(indication));
+        }
+    }
+
+    UINT8 wake = 1;
+    if (::write(WakePipe[1], &wake, 1) < 0)
+    {
+        // pipe full, the thread wakes up anyway
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendStatusIndication
+//
+//  @brief: one test packet exchange, counters restart after NumPackets
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::SendStatusIndication()
+{
+    UINT8 testStatus = 0;
+
+    // deterministic pseudo random loss on both directions
+    UINT64 sequence = StatusSent;
+    UINT32 random   = (UINT32)((sequence * 2654435761ULL) >> 7) % 100;
+
+    // a frozen test reports the previous counters
+    if (!TxFrozen)
+    {
+        if (TxCount >= NumPackets)
+        {
+            TxCount     = 0;
+            PeerRxCount = 0;
+            RxCount     = 0;
+        }
+
+        if (!TxCount)
+            testStatus = 1;
+
+        TxCount++;
+
+        if (random >= LossPercent)
+        {
+            PeerRxCount++;
+
+            if (((random * 7) % 100) >= LossPercent)
+                RxCount++;
+        }
+    }
+
+    UINT8  payload[EMU_RLT_STATUS_SIZE];
+    UINT8* ptr = payload;
+
+    *ptr++ = testStatus;
+    HTON16(ptr, TxCount);       ptr += 2;
+    HTON16(ptr, RxCount);       ptr += 2;
+    HTON16(ptr, PeerRxCount);   ptr += 2;
+    HTON16(ptr, PeerRxCount);   ptr += 2;
+
+    if (HasLinkQuality)
+    {
+        int jitter = (int)(random % 3) - 1;
+
+        HTON16(ptr, (UINT16)(INT16)(LocalRssi + jitter)); ptr += 2;
+        HTON16(ptr, (UINT16)(INT16)(PeerRssi - jitter)); ptr += 2;
+        *ptr++ = (UINT8)(INT8)(LocalSnr - jitter);
+        *ptr++ = (UINT8)(INT8)(PeerSnr + jitter);
+    }
+    else
+    {
+        HTON16(ptr, (UINT16)(INT16)(-60 - (INT16)(sequence % 8))); ptr += 2;
+        HTON16(ptr, (UINT16)(INT16)(-62 - (INT16)(sequence % 5))); ptr += 2;
+        *ptr++ = (UINT8)(INT8)(10 - (INT8)(sequence % 3));
+        *ptr++ = (UINT8)(INT8)(9 - (INT8)(sequence % 4));
+    }
+
+    SendMessage(RLT_SAP_ID, RLT_MSG_STATUS_IND, payload, sizeof(payload));
+
+    StatusSent++;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SetLinkQuality
+//
+//  @brief: called from the emulator thread (Tick, HandleMessage)
+//
+//------------------------------------------------------------------------------
+
+void
+THCIEmulator::SetLinkQuality(INT16 localRssi, INT16 peerRssi, INT8 localSnr, INT8 peerSnr)
+{
+    LocalRssi      = localRssi;
+    PeerRssi       = peerRssi;
+    LocalSnr       = localSnr;
+    PeerSnr        = peerSnr;
+    HasLinkQuality = true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendMessage
+//
+//------------------------------------------------------------------------------
+
+bool
+THCIEmulator::SendMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length)
+{
+    UINT8 message[WIMODLR_HCI_RX_MESSAGE_SIZE];
+    UINT8 frame[2 * WIMODLR_HCI_RX_MESSAGE_SIZE + 2];
+
+    if (length > WIMODLR_HCI_MSG_PAYLOAD_SIZE)
+        return false;
+
+    message[0] = sapID;
+    message[1] = msgID;
+    if (length)
+        std::memcpy(&message[2], payload, length);
+
+    UINT16 crc16 = ~CRC16_Calc(message, length + WIMODLR_HCI_MSG_HEADER_SIZE, CRC16_INIT_VALUE);
+
+    UINT16 size = length + WIMODLR_HCI_MSG_HEADER_SIZE;
+    message[size++] = LOBYTE(crc16);
+    message[size++] = HIBYTE(crc16);
+
+    // SLIP encoding
+    int frameLength = 0;
+
+    frame[frameLength++] = EMU_SLIP_END;
+    for (UINT16 i = 0; i < size; i++)
+    {
+        if (message[i] == EMU_SLIP_END)
+        {
+            frame[frameLength++] = EMU_SLIP_ESC;
+            frame[frameLength++] = EMU_SLIP_ESC_END;
+        }
+        else if (message[i] == EMU_SLIP_ESC)
+        {
+            frame[frameLength++] = EMU_SLIP_ESC;
+            frame[frameLength++] = EMU_SLIP_ESC_ESC;
+        }
+        else
+            frame[frameLength++] = message[i];
+    }
+    frame[frameLength++] = EMU_SLIP_END;
+
+    std::lock_guard<std::mutex> lock(TxLock);
+
+    const UINT8* ptr = frame;
+    while (frameLength > 0)
+    {
+        ssize_t written = ::write(Master, ptr, frameLength);
+        if (written <= 0)
+            return false;
+
+        ptr         += written;
+        frameLength -= (int)written;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HCIEmulator.h
+//
+//	Abstract:	Pseudo Terminal Emulation of a WiMOD LR Radio Module
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//------------------------------------------------------------------------------
+
+#ifndef HCIEMULATOR_H
+#define HCIEMULATOR_H
+
+//------------------------------------------------------------------------------
+//
+// Include Files
+//
+//------------------------------------------------------------------------------
+
+#include "../WiMODLR/WMDefs.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+//------------------------------------------------------------------------------
+//
+// TEmulatedChannel Class Declaration
+//
+// Shared medium of emulated modules: one transmission at a time in the
+// order of the reservations, each message is lost with the configured
+// probability. Times on air (Airtime.h) are divided by the time scale.
+// Bursty loss follows a two state (Gilbert) model: every message in the
+// bad state is lost, the mean stay there is the burst length. A recorded
+// loss trace replaces both and is replayed message by message.
+//
+//------------------------------------------------------------------------------
+
+class TEmulatedChannel
+{
+    public:
+    typedef std::chrono::steady_clock TClock;
+
+                        TEmulatedChannel(UINT32 timeScale = 1, UINT32 seed = 1);
+
+    void                SetTimeScale(UINT32 timeScale);
+    UINT32              GetTimeScale() const { return TimeScale; }
+
+    // message loss in percent, in bursts of the mean length [messages]
+    void                SetLossRate(double percent, double meanBurst = 1);
+
+    // replay of a loss pattern (true = lost), cyclic
+    void                SetLossTrace(const std::vector<bool>& trace);
+
+    // uplink losses (local Tx, peer Rx) of a radio link test CSV file in
+    // message order, the losses of a status interval at its end; false if
+    // the file holds no counters
+    static bool         LoadLossTrace(const std::string& fileName, std::vector<bool>& trace);
+
+    // restart seed, state and trace position: runs see the same losses
+    void                ResetLoss();
+
+    // medium busy for the time on air from the end of the previous
+    // transmission or the earliest start, returns the end of this one;
+    // the setup time before the earliest start is scaled as well
+    TClock::time_point  Reserve(UINT64 airtimeNs, TClock::time_point earliest, UINT64 setupNs = 0);
+
+    // draw the fate of the next message
+    bool                IsLost();
+
+    private:
+
+    std::mutex          Lock;
+    UINT32              TimeScale;
+    double              LossPercent;
+    double              MeanBurst;
+    bool                Bad;
+    std::vector<bool>   Trace;
+    size_t              TracePosition;
+    TClock::time_point  BusyUntil;
+    UINT32              Seed;
+    std::mt19937        Random;
+};
+
+//------------------------------------------------------------------------------
+//
+// THCIEmulator Class Declaration
+//
+// Opens a pty pair, the slave side is opened by TWiMODLRHCI like a USB tty.
+// A thread answers HCI requests on the master side: ping, radio link test
+// start / stop, and sends radio link test status indications while a test
+// is running; with a connected data link unreliable radio messages (send
+// response, sent indication, reception by the peer emulator). Benchmarks
+// derive from it to emulate further services.
+//
+//------------------------------------------------------------------------------
+
+class THCIEmulator
+{
+    public:
+                        THCIEmulator();
+    virtual             ~THCIEmulator();
+
+    // create pty, slave name relative to /dev (e.g. "pts/3")
+    bool                Open();
+    void                Close();
+    std::string&        GetPortName() { return PortName; }
+
+    // status indication interval [us] (0 = as fast as possible) and limit
+    // (0 = endless) of a radio link test
+    void                SetStatusInterval(UINT32 intervalUs) { StatusIntervalUs = intervalUs; }
+    void                SetStatusLimit(UINT64 limit) { StatusLimit = limit; }
+
+    // emulated peer packet loss in percent
+    void                SetLossRate(UINT32 percent) { LossPercent = percent; }
+
+    // reported RSSI [dBm] and SNR [dB] of both ends instead of a fixed
+    // pattern, jitter of +-1 dB
+    void                SetLinkQuality(INT16 localRssi, INT16 peerRssi, INT8 localSnr, INT8 peerSnr);
+
+    // data link emulation: unreliable messages wait in a Tx queue of the
+    // given depth, go on air through the channel with the time on air of
+    // the radio configuration and are received by the connected emulator;
+    // with the echo radio mode received messages are sent back
+    void                ConnectDataLink(TEmulatedChannel& channel, THCIEmulator& peer);
+    void                SetRadio(const TWiMODLR_RadioConfig& radio);
+    void                SetTxQueueSize(UINT32 size) { TxQueueSize = size; }
+
+    // radio time from a request to the start on air if the radio was idle:
+    // serial transfer, processing, radio wake-up [us]
+    void                SetTxSetupTime(UINT32 setupUs) { TxSetupUs = setupUs; }
+    void                SetAddress(UINT8 groupAddress, UINT16 deviceAddress);
+
+    // called from the thread of the sending emulator
+    void                Receive(const UINT8* message, UINT16 length, UINT8 srcGroup, UINT16 srcDevice);
+
+    UINT64              GetMessagesSent() const { return MessagesSent; }
+    UINT64              GetMessagesLost() const { return MessagesLost; }
+
+    bool                Start();
+    void                Stop();
+
+    UINT64              GetStatusSent() const { return StatusSent; }
+    bool                IsTestRunning() const { return TestRunning; }
+
+    protected:
+
+    // handle CRC checked request, returns false for unknown messages
+    virtual bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length);
+
+    // called from the emulator thread between requests
+    virtual void        Tick() {}
+
+    // SLIP encode and send HCI message to the host
+    bool                SendMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload = 0, UINT16 length = 0);
+
+    // emit next radio link test status indication
+    void                SendStatusIndication();
+
+    // fault injection: end the test without notice (firmware stall), keep
+    // reporting without transmitting (frozen until the next start request)
+    void                SetTestRunning(bool running) { TestRunning = running; }
+    void                SetTxFrozen(bool frozen) { TxFrozen = frozen; }
+
+    private:
+
+    void                Run();
+    void                Decode(const UINT8* data, int length);
+    bool                HandleDataLink(const UINT8* payload, UINT16 length);
+    void                ProcessDataLink();
+
+    int                 Master;
+    std::string         PortName;
+
+    // wakes the emulator thread for messages of the peer
+    int                 WakePipe[2];
+
+    std::thread         Thread;
+    std::atomic<bool>   Running;
+    std::mutex          TxLock;
+
+    // SLIP decoder state
+    UINT8               RxFrame[WIMODLR_HCI_RX_MESSAGE_SIZE];
+    UINT16              RxLength;
+    bool                RxEscape;
+
+    // radio link test emulation
+    std::atomic<bool>   TestRunning;
+    std::atomic<bool>   TxFrozen;
+    std::atomic<UINT64> StatusSent;
+    UINT32              StatusIntervalUs;
+    UINT64              StatusLimit;
+    UINT32              LossPercent;
+    bool                HasLinkQuality;
+    INT16               LocalRssi;
+    INT16               PeerRssi;
+    INT8                LocalSnr;
+    INT8                PeerSnr;
+    UINT16              NumPackets;
+    UINT16              TxCount;
+    UINT16              PeerRxCount;
+    UINT16              RxCount;
+
+    // data link emulation, the lock protects the queues and the radio
+    TEmulatedChannel*   Channel;
+    THCIEmulator*       Peer;
+    std::mutex          DataLinkLock;
+    TWiMODLR_RadioConfig    Radio;
+    UINT32              TxQueueSize;
+    UINT8               GroupAddress;
+    UINT16              DeviceAddress;
+    std::deque<std::vector<UINT8>>  TxQueue;
+    UINT32              TxSetupUs;
+    bool                Transmitting;
+    TEmulatedChannel::TClock::time_point    TxAccepted;
+    TEmulatedChannel::TClock::time_point    TxEnd;
+    std::vector<std::vector<UINT8>> Inbox;
+    std::atomic<UINT64> MessagesSent;
+    std::atomic<UINT64> MessagesLost;
+};
+
+#endif // HCIEMULATOR_H
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,465 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HealthBench.cpp
+//
+//	Abstract:	Health poller interleaved with a radio link test: gaps of
+//              the status indications with and without it, detection of
+//              an injected module reset and lost responses
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      health_bench [-t <s per phase>] [-s <status interval ms>]
+//                           [-i <health interval ms>] [-d <down time ms>]
+//                           [-o <health file>]
+//                           [-b <legacy|epoll|io_uring|all>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/HealthMonitor.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include "../Measurement/ClockSync.h"
+#include "../Measurement/SampleFanout.h"
+#include "../Measurement/LatencyHistogram.h"
+#include "../Measurement/RLTSample.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// system tick of the emulated module [ms]
+#define BENCH_TICK_MS               5
+
+// allowed increase of the p99 indication gap by the poller [status
+// intervals], a request must not hold the indications back
+#define BENCH_MAX_EXTRA_GAP         0.5
+
+// HCI response timeout [ms]
+#define BENCH_REQUEST_TIMEOUT_MS    1000
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  THealthEmulator
+//
+//  @brief: module answering device, firmware and system status requests;
+//          a reset restarts uptime and counters and drops management
+//          requests for the down time, the radio link test is kept running
+//          so its indications can be watched during the lost requests
+//
+//------------------------------------------------------------------------------
+
+class THealthEmulator : public THCIEmulator
+{
+    public:
+
+                THealthEmulator()
+                {
+                    Boot = TClock::now();
+                }
+
+    void        Reset(UINT32 downMs)
+                {
+                    std::lock_guard<std::mutex> lock(BootLock);
+
+                    Boot       = TClock::now() + std::chrono::milliseconds(downMs);
+                    StatusBase = GetStatusSent();
+                }
+
+    protected:
+
+    bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length) override
+                {
+                    if (sapID != DEVMGMT_SAP_ID)
+                        return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+
+                    std::lock_guard<std::mutex> lock(BootLock);
+
+                    // requests are lost while the module boots
+                    auto now = TClock::now();
+
+                    if (now < Boot)
+                        return true;
+
+                    if (msgID == DEVMGMT_MSG_GET_DEVICEINFO_REQ)
+                    {
+                        UINT8 response[1 + 9] = { DEVMGMT_STATUS_OK, 0x98 };
+
+                        HTON16(&response[2], 0x2222);
+                        response[4] = 0x10;
+                        HTON32(&response[6], 0x01234567);
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_DEVICEINFO_RSP, response, sizeof(response));
+                    }
+
+                    if (msgID == DEVMGMT_MSG_GET_FW_VERSION_REQ)
+                    {
+                        const char image[] = "WiMOD_LR_Base_IM880B";
+                        UINT8      response[1 + 4 + sizeof(image) - 1] = { DEVMGMT_STATUS_OK, 10, 1 };
+
+                        HTON16(&response[3], 36);
+                        std::memcpy(&response[5], image, sizeof(image) - 1);
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_FW_VERSION_RSP, response, sizeof(response));
+                    }
+
+                    if (msgID == DEVMGMT_MSG_GET_SYSTEM_STATUS_REQ)
+                    {
+                        UINT8  response[1 + 39] = { DEVMGMT_STATUS_OK, BENCH_TICK_MS };
+                        UINT32 ticks = (UINT32)(std::chrono::duration_cast<std::chrono::milliseconds>(now - Boot).count()
+                                                / BENCH_TICK_MS);
+                        UINT32 sent  = (UINT32)(GetStatusSent() - StatusBase);
+
+                        HTON32(&response[2], ticks);
+                        HTON32(&response[6], CLOCK_SecondsToRtc(RLT_GetTimeUs() / 1000000));
+                        HTON16(&response[12], 3300);
+                        HTON32(&response[16], sent);
+                        HTON32(&response[20], sent);
+                        HTON32(&response[28], sent);
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_SYSTEM_STATUS_RSP, response, sizeof(response));
+                    }
+
+                    return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+                }
+
+    private:
+
+    std::mutex          BootLock;
+    TClock::time_point  Boot;
+    UINT64              StatusBase = 0;
+};
+
+//------------------------------------------------------------------------------
+//
+//  TGapSink
+//
+//  @brief: gaps between the read times of consecutive indications and the
+//          health comments
+//
+//------------------------------------------------------------------------------
+
+class TGapSink : public TSampleSink
+{
+    public:
+
+    std::string     GetName() const override { return "gaps"; }
+
+    bool            WriteSample(const TRLTSample& sample, const std::string& /* encoded */) override
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        if (LastUs)
+                            Gaps.Add((UINT64)std::max<INT64>(0, sample.TimeUs - LastUs));
+
+                        LastUs = sample.TimeUs;
+                        return true;
+                    }
+
+    void            WriteComment(const std::string& comment) override
+                    {
+                        if (!comment.compare(0, 7, "health "))
+                            Comments++;
+                    }
+
+    // histogram of the phase, next phase starts empty
+    TLatencyHistogram   TakeGaps()
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        TLatencyHistogram gaps = Gaps;
+
+                        Gaps.Reset();
+                        LastUs = 0;
+                        return gaps;
+                    }
+
+    std::atomic<UINT64> Comments { 0 };
+
+    private:
+
+    std::mutex          Lock;
+    TLatencyHistogram   Gaps;
+    INT64               LastUs = 0;
+};
+
+//------------------------------------------------------------------------------
+//
+//  Bench
+//
+//  @brief: both phases on a fresh emulated module with the serial reads of
+//          the given backend
+//
+//------------------------------------------------------------------------------
+
+static bool
+Bench(const std::string& backendName, UINT32 phaseS, UINT32 statusMs, UINT32 intervalMs, UINT32 downMs,
+      const std::string& fileName)
+{
+    THealthEmulator emulator;
+    TWiMODLRHCI     hci;
+    TSampleFanout   fanout;
+    TGapSink        sink;
+
+    emulator.SetStatusInterval(statusMs * 1000);
+
+    if (!emulator.Open() || !emulator.Start() || !hci.Open(emulator.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return false;
+    }
+
+    fanout.SetReceiveClock(&hci);
+    fanout.AddSink(sink);
+    fanout.Start();
+    hci.RegisterClient(&fanout);
+
+    TWiMODLR_RadioLinkTestConfig test;
+    test.GroupAddress  = 0x10;
+    test.DeviceAddress = 0x2222;
+    test.PacketSize    = 15;
+    test.NumPackets    = 100;
+    test.TestMode      = 1;
+
+    UINT8 status = 0;
+
+    if (hci.StartRadioLinkTest(test, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not start radio link test" << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<TEventBackend> backend;
+    THCIReader                     reader(hci);
+
+    if (backendName != "legacy")
+    {
+        backend.reset(CreateEventBackend(backendName == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+
+        if (!backend || !reader.Attach(*backend))
+        {
+            std::cerr << "Error: Could not set up " << backendName << " backend" << std::endl;
+            return false;
+        }
+    }
+
+    THealthConfig config;
+    config.IntervalMs = intervalMs;
+
+    THealthMonitor monitor(hci, &fanout);
+    monitor.SetReader(&reader);
+
+    // main loop of main.cpp for the given time, optionally with the poller
+    // and a reset half way; the phase is extended until the reset can be
+    // seen (down time and two request timeouts)
+    bool failed = false;
+
+    auto run = [&](bool poll, bool reset)
+    {
+        auto start = TClock::now();
+        auto end   = start + std::chrono::seconds(phaseS);
+        bool done  = !reset;
+
+        sink.TakeGaps();
+
+        while (TClock::now() < end && !failed)
+        {
+            if (!backend)
+                hci.WaitForResponse(RLT_SAP_ID, RLT_MSG_STATUS_IND);
+            else if (backend->Poll(poll ? monitor.GetWaitMs(10) : 10) < 0 || reader.IsClosed())
+            {
+                std::cerr << "Error: Event loop failed" << std::endl;
+                failed = true;
+            }
+
+            if (!done && TClock::now() >= start + std::chrono::seconds(phaseS) / 2)
+            {
+                emulator.Reset(downMs);
+                end  = std::max(end, TClock::now() + std::chrono::milliseconds(downMs + 2 * BENCH_REQUEST_TIMEOUT_MS));
+                done = true;
+            }
+
+            if (poll)
+                monitor.Poll();
+            fanout.Poll();
+        }
+
+        return sink.TakeGaps();
+    };
+
+    std::cout << backendName << ": " << phaseS << " s per phase, status indication every " << statusMs
+              << " ms, system status every " << intervalMs << " ms, reset with " << downMs << " ms down time"
+              << std::endl;
+
+    TLatencyHistogram baseline = run(false, false);
+
+    // the writer appends to an existing file
+    std::remove(fileName.c_str());
+
+    if (!monitor.Open(fileName, TBlockFileConfig(), config))
+    {
+        std::cerr << "Error: Could not open " << fileName << std::endl;
+        return false;
+    }
+
+    TLatencyHistogram polled = run(true, true);
+
+    monitor.Close();
+    fanout.Stop();
+
+    std::cout << std::left << std::setw(10) << "poller" << std::right << "indication gaps" << std::endl
+              << std::left << std::setw(10) << "off" << std::right << baseline.Summary() << std::endl
+              << std::left << std::setw(10) << "on" << std::right << polled.Summary() << std::endl
+              << monitor.FormatStats() << ", sink comments " << sink.Comments << std::endl;
+
+    // the file: header, comments, one row per answered request with an
+    // uptime that goes back exactly once
+    std::ifstream file(fileName);
+    std::string   line;
+    UINT64        rows      = 0;
+    UINT64        comments  = 0;
+    UINT64        backwards = 0;
+    UINT64        bad       = 0;
+    UINT64        uptime    = 0;
+
+    std::getline(file, line);
+    bool header = line == HEALTH_CSV_HEADER;
+
+    while (std::getline(file, line))
+    {
+        if (!line.compare(0, 2, "# "))
+        {
+            comments++;
+            continue;
+        }
+
+        std::istringstream columns(line);
+        std::string        column;
+        int                count = 0;
+        UINT64             value = 0;
+
+        while (std::getline(columns, column, ','))
+        {
+            if (++count == 2)
+                value = std::strtoull(column.c_str(), 0, 10);
+        }
+
+        if (count != 13)
+        {
+            bad++;
+            continue;
+        }
+
+        if (rows && value < uptime)
+            backwards++;
+
+        uptime = value;
+        rows++;
+    }
+
+    std::cout << "health file " << fileName << ": " << rows << " rows, " << comments << " comments, "
+              << backwards << " resets, " << bad << " bad rows" << std::endl;
+
+    THealthStats stats = monitor.GetStats();
+
+    bool result = !failed && header && !bad && rows
+                  && stats.Resets == 1 && backwards == 1
+                  && (!downMs || (stats.Failed && sink.Comments >= 3))
+                  && polled.Percentile(99) <= baseline.Percentile(99) + BENCH_MAX_EXTRA_GAP * statusMs * 1000;
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    backend.reset();
+
+    hci.Close();
+    emulator.Close();
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT32      phaseS      = 10;
+    UINT32      statusMs    = 10;
+    UINT32      intervalMs  = 100;
+    UINT32      downMs      = 1500;
+    std::string fileName    = "/tmp/health_bench.csv";
+    std::string backendName = "all";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            phaseS = std::max(2, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            statusMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            downMs = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-o") && i + 1 < argc)
+            fileName = argv[++i];
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backendName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-t <s per phase>] [-s <status interval ms>]"
+                      << " [-i <health interval ms>] [-d <down time ms>] [-o <health file>]"
+                      << " [-b <legacy|epoll|io_uring|all>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> backends;
+
+    if (backendName == "all")
+        backends = { "legacy", "epoll", "io_uring" };
+    else
+        backends = { backendName };
+
+    bool result = true;
+
+    for (const std::string& name : backends)
+    {
+        if (name != "legacy" && name != "epoll" && name != "io_uring")
+        {
+            std::cerr << "Error: Unknown backend " << name << std::endl;
+            return 1;
+        }
+
+        result = Bench(name, phaseS, statusMs, intervalMs, downMs, fileName) && result;
+    }
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
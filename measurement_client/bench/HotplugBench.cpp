@@ -0,0 +1,331 @@
+//------------------------------------------------------------------------------
+//
+//	File:		HotplugBench.cpp
+//
+//	Abstract:	Time from replugging an emulated USB adapter to the first
+//              sample of the restarted radio link test
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      hotplug_bench [-n <replugs>] [-o <unplugged ms>] [-i <interval ms>]
+//                            [-d <directory>] [-b <legacy|epoll|io_uring>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/SampleFanout.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include "../Measurement/DeviceWatcher.h"
+#include "../Measurement/RadioSupervisor.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// give up if the adapter is not reattached within this time
+#define BENCH_TIMEOUT_S         30
+
+// undisturbed operation before each unplug
+#define BENCH_SETTLE_MS         500
+
+// by-id name of the emulated adapter
+#define BENCH_LINK_NAME         "usb-Emulated_WiMOD_LR-if00-port0"
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  TCheckSink
+//
+//  @brief: counts samples, Tx counter jumps and gap markers
+//
+//------------------------------------------------------------------------------
+
+class TCheckSink : public TSampleSink
+{
+    public:
+
+    std::atomic<UINT64> Samples { 0 };
+    std::atomic<UINT64> Gaps { 0 };
+    std::atomic<UINT64> Violations { 0 };
+    std::atomic<UINT32> LTxCount { 0 };
+
+    std::string     GetName() const override { return "check"; }
+
+    bool            WriteSample(const TRLTSample& sample, const std::string& /* encoded */) override
+                    {
+                        if (Samples && sample.Status.LTxCount - LTxCount > 1)
+                            Violations++;
+
+                        LTxCount = sample.Status.LTxCount;
+                        Samples++;
+                        return true;
+                    }
+
+    void            WriteComment(const std::string& comment) override
+                    {
+                        if (!comment.compare(0, 4, "gap "))
+                            Gaps++;
+                    }
+};
+
+//------------------------------------------------------------------------------
+//
+//  Plug
+//
+//  @brief: new pty (new device number) behind the by-id link
+//
+//------------------------------------------------------------------------------
+
+static bool
+Plug(std::unique_ptr<THCIEmulator>& emulator, const std::string& link, UINT32 intervalMs)
+{
+    emulator.reset(new THCIEmulator);
+    emulator->SetStatusInterval(intervalMs * 1000);
+
+    // udev creates a temporary link and renames it
+    std::string temporary = link + ".tmp";
+
+    return emulator->Open() && emulator->Start()
+           && ::symlink(("/dev/" + emulator->GetPortName()).c_str(), temporary.c_str()) == 0
+           && ::rename(temporary.c_str(), link.c_str()) == 0;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT32      numReplugs  = 5;
+    UINT32      offMs       = 500;
+    UINT32      intervalMs  = 10;
+    std::string directory   = "/tmp/hotplug_bench";
+    std::string backendName = "epoll";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            numReplugs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-o") && i + 1 < argc)
+            offMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            directory = argv[++i];
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backendName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-n <replugs>] [-o <unplugged ms>] [-i <interval ms>]"
+                      << " [-d <directory>] [-b <legacy|epoll|io_uring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // stands in for /dev/serial/by-id, the link directory disappears with
+    // the last adapter like the one created by udev
+    std::string byId = directory + "/by-id";
+    std::string link = byId + "/" + BENCH_LINK_NAME;
+
+    ::mkdir(directory.c_str(), 0755);
+    ::unlink(link.c_str());
+    ::rmdir(byId.c_str());
+
+    std::unique_ptr<THCIEmulator> emulator;
+
+    TWiMODLRHCI     hci;
+    TSampleFanout   fanout;
+    TCheckSink      sink;
+    TDeviceWatcher  watcher;
+
+    if (::mkdir(byId.c_str(), 0755) != 0 || !Plug(emulator, link, intervalMs) || !hci.Open(link))
+    {
+        std::cerr << "Error: Could not set up emulated adapter in " << directory << std::endl;
+        return 1;
+    }
+
+    TRadioSupervisor supervisor(hci, fanout);
+
+    hci.RegisterClient(&supervisor);
+    fanout.AddSink(sink);
+    fanout.Start();
+
+    TWiMODLR_RadioLinkTestConfig test;
+    test.GroupAddress  = 0x10;
+    test.DeviceAddress = 0x2222;
+    test.PacketSize    = 15;
+    test.NumPackets    = 100;
+    test.TestMode      = 1;
+
+    UINT8 status = 0;
+
+    if (hci.StartRadioLinkTest(test, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not start radio link test" << std::endl;
+        return 1;
+    }
+
+    supervisor.Start(link, test);
+
+    if (!watcher.Open())
+    {
+        std::cerr << "Error: Could not set up inotify" << std::endl;
+        return 1;
+    }
+
+    watcher.AddDevice(link, &supervisor);
+
+    std::unique_ptr<TEventBackend> backend;
+    THCIReader reader(hci);
+
+    if (backendName != "legacy")
+    {
+        backend.reset(CreateEventBackend(backendName == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+        if (!backend || !reader.Attach(*backend) || !watcher.Attach(*backend))
+        {
+            std::cerr << "Error: Could not set up event backend" << std::endl;
+            return 1;
+        }
+    }
+
+    supervisor.SetEventBackend(backend.get(), &reader);
+
+    // main loop of main.cpp until the time is over or a condition is met
+    auto run = [&](TClock::time_point until, auto done) -> bool
+    {
+        while (TClock::now() < until)
+        {
+            if (backend)
+            {
+                if (backend->Poll(1000) < 0)
+                    return false;
+            }
+            else
+            {
+                hci.WaitForResponse(RLT_SAP_ID, RLT_MSG_STATUS_IND);
+                watcher.Process();
+            }
+
+            supervisor.Poll();
+            fanout.Poll();
+
+            if (done())
+                return true;
+        }
+
+        return false;
+    };
+
+    std::cout << numReplugs << " replugs, " << offMs << " ms unplugged, " << intervalMs << " ms interval, "
+              << (backend ? backend->GetName() : "legacy") << std::endl
+              << std::setw(8) << "replug"
+              << std::setw(14) << "detect ms"
+              << std::setw(16) << "reattach ms" << std::endl;
+
+    bool   result      = true;
+    double totalMs     = 0;
+    double maxMs       = 0;
+    double totalDetect = 0;
+
+    for (UINT32 i = 0; i < numReplugs && result; i++)
+    {
+        UINT64 samples = sink.Samples;
+        run(TClock::now() + std::chrono::milliseconds(BENCH_SETTLE_MS), [] { return false; });
+        result = sink.Samples > samples;
+
+        TSupervisorStats stats = supervisor.GetStats();
+
+        // unplug: link removed, pty hangs up
+        auto unplugged = TClock::now();
+        ::unlink(link.c_str());
+        ::rmdir(byId.c_str());
+        emulator->Close();
+
+        result = result && run(unplugged + std::chrono::seconds(BENCH_TIMEOUT_S),
+                               [&] { return supervisor.GetStats().Stalls > stats.Stalls; });
+
+        double detectMs = std::chrono::duration<double, std::milli>(TClock::now() - unplugged).count();
+
+        // adapter stays away for a while
+        run(unplugged + std::chrono::milliseconds(offMs), [] { return false; });
+
+        auto plugged = TClock::now();
+
+        result = result && ::mkdir(byId.c_str(), 0755) == 0 && Plug(emulator, link, intervalMs)
+                 && run(plugged + std::chrono::seconds(BENCH_TIMEOUT_S),
+                        [&] { return supervisor.GetStats().Recoveries > stats.Recoveries; });
+
+        if (!result)
+        {
+            std::cerr << "Error: Adapter not reattached" << std::endl;
+            break;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(TClock::now() - plugged).count();
+
+        totalMs     += ms;
+        totalDetect += detectMs;
+        maxMs        = std::max(maxMs, ms);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(8) << i + 1
+                  << std::setw(14) << detectMs
+                  << std::setw(16) << ms << std::endl;
+    }
+
+    // deliver the remaining samples
+    run(TClock::now() + std::chrono::milliseconds(100), [] { return false; });
+
+    fanout.Stop();
+
+    TSupervisorStats stats = supervisor.GetStats();
+
+    if (result)
+    {
+        std::cout << std::fixed << std::setprecision(1)
+                  << "mean detect " << totalDetect / numReplugs << " ms, mean reattach " << totalMs / numReplugs
+                  << " ms, max reattach " << maxMs << " ms" << std::endl;
+    }
+
+    std::cout << supervisor.FormatStats() << std::endl
+              << "samples " << sink.Samples << ", gap markers " << sink.Gaps
+              << ", counter violations " << sink.Violations << std::endl;
+
+    if (sink.Gaps != stats.Recoveries || sink.Violations)
+        result = false;
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    backend.reset();
+    emulator.reset();
+
+    ::unlink(link.c_str());
+    ::rmdir(byId.c_str());
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
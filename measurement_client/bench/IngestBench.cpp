@@ -0,0 +1,492 @@
+//------------------------------------------------------------------------------
+//
+//	File:		IngestBench.cpp
+//
+//	Abstract:	Load generator for the collector, simulates many publishing
+//              nodes over loopback and reports sustained samples/s and the
+//              latency from sending a frame until its durable ACK
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      ingest_bench [-n <nodes>] [-t <threads>] [-d <seconds>]
+//                           [-r <samples/s per node, 0 = max>] [-b <batch>]
+//                           [-w <window>] [-x <duplicate %>] [-R <reactors>]
+//                           [-s <store dir>] [-a] [-c <host:port>]
+//
+//------------------------------------------------------------------------------
+
+#include "../Measurement/IngestServer.h"
+#include "../Measurement/RLTCodec.h"
+#include "../Measurement/LatencyHistogram.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  TSimNode
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    int                 Handle;
+    TPublishParser      Parser;
+    UINT64              First;
+    UINT64              Next;
+    UINT64              Acked;
+    UINT64              Frames;
+    // end sequence and send time of the frames awaiting their ACK
+    std::deque<std::pair<UINT64, TClock::time_point>> InFlight;
+}TSimNode;
+
+typedef struct
+{
+    std::string         Host;
+    std::string         Port;
+    UINT32              Rate;
+    UINT32              Batch;
+    UINT32              Window;
+    UINT32              DuplicatePercent;
+    TClock::time_point  Start;
+    TClock::time_point  End;
+    std::vector<UINT8>  Block;
+}TLoadConfig;
+
+typedef struct
+{
+    UINT64              Sent;
+    UINT64              Resent;
+    UINT64              Acked;
+    UINT64              Errors;
+    TLatencyHistogram   Latency;
+}TLoadResult;
+
+//------------------------------------------------------------------------------
+//
+//  Connect
+//
+//  @brief: connect, send HELLO and wait for RESUME
+//
+//------------------------------------------------------------------------------
+
+static bool
+Connect(const TLoadConfig& config, const std::string& name, TSimNode& node)
+{
+    struct addrinfo  hints = {};
+    struct addrinfo* list  = 0;
+
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (::getaddrinfo(config.Host.c_str(), config.Port.c_str(), &hints, &list) != 0)
+        return false;
+
+    node.Handle = ::socket(list->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    bool result = node.Handle >= 0 && ::connect(node.Handle, list->ai_addr, list->ai_addrlen) == 0;
+    ::freeaddrinfo(list);
+
+    if (!result)
+        return false;
+
+    int one = 1;
+    ::setsockopt(node.Handle, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::vector<UINT8> hello;
+    Publish_AppendMessage(hello, PUBLISH_MSG_HELLO, (const UINT8*)name.data(), name.size());
+
+    if (!Publish_SendAll(node.Handle, hello.data(), hello.size()))
+        return false;
+
+    UINT8        type;
+    const UINT8* body;
+    size_t       length;
+
+    while (!node.Parser.Next(type, body, length))
+    {
+        UINT8   buffer[256];
+        ssize_t received = ::recv(node.Handle, buffer, sizeof(buffer), 0);
+        if (received <= 0 || node.Parser.HasError())
+            return false;
+
+        node.Parser.Append(buffer, received);
+    }
+
+    if (type != PUBLISH_MSG_RESUME || length != 8)
+        return false;
+
+    node.First = node.Next = node.Acked = Publish_Get64(body);
+    node.Frames = 0;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  SendFrame
+//
+//------------------------------------------------------------------------------
+
+static bool
+SendFrame(const TLoadConfig& config, TSimNode& node, UINT64 sequence, std::vector<UINT8>& message)
+{
+    std::vector<UINT8> body(8 + config.Block.size());
+
+    Publish_Put64(body.data(), sequence);
+    std::memcpy(body.data() + 8, config.Block.data(), config.Block.size());
+
+    message.clear();
+    Publish_AppendMessage(message, PUBLISH_MSG_DATA, body.data(), body.size());
+
+    return Publish_SendAll(node.Handle, message.data(), message.size());
+}
+
+//------------------------------------------------------------------------------
+//
+//  Receive
+//
+//  @brief: process ACKs of one node
+//
+//------------------------------------------------------------------------------
+
+static bool
+Receive(TSimNode& node, TLoadResult& result)
+{
+    UINT8   buffer[4096];
+    ssize_t received = ::recv(node.Handle, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+    if (received < 0 && (errno == EAGAIN || errno == EINTR))
+        return true;
+    if (received <= 0)
+        return false;
+
+    node.Parser.Append(buffer, received);
+
+    UINT8        type;
+    const UINT8* body;
+    size_t       length;
+    auto         now = TClock::now();
+
+    while (node.Parser.Next(type, body, length))
+    {
+        if (type != PUBLISH_MSG_ACK || length != 8)
+            return false;
+
+        UINT64 acked = Publish_Get64(body);
+
+        while (!node.InFlight.empty() && node.InFlight.front().first <= acked)
+        {
+            result.Latency.Add(std::chrono::duration_cast<std::chrono::microseconds>(now - node.InFlight.front().second).count());
+            node.InFlight.pop_front();
+        }
+
+        if (acked > node.Acked)
+        {
+            result.Acked += acked - node.Acked;
+            node.Acked    = acked;
+        }
+    }
+
+    return !node.Parser.HasError();
+}
+
+//------------------------------------------------------------------------------
+//
+//  RunNodes
+//
+//  @brief: one load thread serving its share of the nodes
+//
+//------------------------------------------------------------------------------
+
+static void
+RunNodes(const TLoadConfig& config, UINT32 firstNode, UINT32 numNodes, TLoadResult& result)
+{
+    std::vector<TSimNode>      nodes(numNodes);
+    std::vector<struct pollfd> fds(numNodes);
+    std::vector<UINT8>         message;
+
+    for (UINT32 i = 0; i < numNodes; i++)
+    {
+        if (!Connect(config, "bench-node-" + std::to_string(firstNode + i), nodes[i]))
+        {
+            result.Errors++;
+            if (nodes[i].Handle >= 0)
+                ::close(nodes[i].Handle);
+            nodes[i].Handle = -1;
+        }
+        fds[i] = { nodes[i].Handle, POLLIN, 0 };
+    }
+
+    UINT32 seed = 12345 + firstNode;
+    bool   done = false;
+
+    while (!done)
+    {
+        auto now     = TClock::now();
+        bool sending = now < config.End;
+        done         = now > config.End + std::chrono::seconds(10);
+
+        double elapsed = std::chrono::duration<double>(now - config.Start).count();
+        UINT64 due     = config.Rate ? (UINT64)(elapsed * config.Rate / config.Batch) : ~0ULL;
+        bool   pending = false;
+
+        for (UINT32 i = 0; i < numNodes; i++)
+        {
+            TSimNode& node = nodes[i];
+            if (node.Handle < 0)
+                continue;
+
+            while (sending && node.InFlight.size() < config.Window && node.Frames < due)
+            {
+                if (!SendFrame(config, node, node.Next, message))
+                {
+                    result.Errors++;
+                    break;
+                }
+
+                node.Next += config.Batch;
+                node.Frames++;
+                node.InFlight.push_back(std::make_pair(node.Next, TClock::now()));
+                result.Sent += config.Batch;
+
+                // a publisher resending after a lost ACK
+                seed = seed * 1103515245 + 12345;
+                if ((seed >> 16) % 100 < config.DuplicatePercent)
+                {
+                    if (!SendFrame(config, node, node.Next - config.Batch, message))
+                        result.Errors++;
+                    result.Resent += config.Batch;
+                }
+            }
+
+            pending = pending || node.Acked < node.Next;
+        }
+
+        if (!sending && !pending)
+            break;
+
+        if (::poll(fds.data(), fds.size(), 1) <= 0)
+            continue;
+
+        for (UINT32 i = 0; i < numNodes; i++)
+        {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            if (!Receive(nodes[i], result))
+            {
+                result.Errors++;
+                ::close(nodes[i].Handle);
+                nodes[i].Handle = fds[i].fd = -1;
+            }
+        }
+    }
+
+    for (TSimNode& node : nodes)
+        if (node.Handle >= 0)
+            ::close(node.Handle);
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT32      numNodes    = 64;
+    UINT32      numThreads  = 4;
+    UINT32      seconds     = 10;
+    UINT32      reactors    = 0;
+    bool        sync        = true;
+    std::string directory   = "/tmp/ingest_bench";
+    std::string collector;
+
+    TLoadConfig config;
+
+    config.Rate             = 0;
+    config.Batch            = 64;
+    config.Window           = 8;
+    config.DuplicatePercent = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            numNodes = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            numThreads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            seconds = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+            config.Rate = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            config.Batch = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc)
+            config.Window = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            config.DuplicatePercent = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-R") && i + 1 < argc)
+            reactors = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            directory = argv[++i];
+        else if (!std::strcmp(argv[i], "-a"))
+            sync = false;
+        else if (!std::strcmp(argv[i], "-c") && i + 1 < argc)
+            collector = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-n <nodes>] [-t <threads>] [-d <seconds>] [-r <samples/s per node, 0 = max>]"
+                      << " [-b <batch>] [-w <window>] [-x <duplicate %>] [-R <reactors>] [-s <store dir>] [-a] [-c <host:port>]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    config.Batch  = std::min<UINT32>(std::max<UINT32>(config.Batch, 1), RLT_BLOCK_MAX_SAMPLES);
+    config.Window = std::max<UINT32>(config.Window, 1);
+    numThreads    = std::min(std::max<UINT32>(numThreads, 1), std::max<UINT32>(numNodes, 1));
+
+    // one frame of typical samples, sent by every node
+    std::vector<TRLTSample> samples(config.Batch);
+    INT64                   now = RLT_GetTimeUs();
+
+    for (UINT32 i = 0; i < config.Batch; i++)
+    {
+        samples[i].TimeUs           = now + i * 1000;
+        samples[i].Status.LTxCount  = i;
+        samples[i].Status.PTxCount  = i;
+        samples[i].Status.LocalRSSI = -60 - (INT16)(i % 7);
+        samples[i].Status.PeerRSSI  = -62 - (INT16)(i % 5);
+    }
+
+    if (!TRLTBlockEncoder::EncodeBlock(samples.data(), config.Batch, config.Block))
+        return 1;
+
+    // in-process collector on a fresh store unless an external one is given
+    TIngestStore  store;
+    TIngestServer server;
+
+    if (collector.empty())
+    {
+        std::string command = "rm -rf '" + directory + "'";
+        if (std::system(command.c_str()) != 0 || !store.Open(directory, sync) || !server.Start(store, 0, reactors))
+        {
+            std::cerr << "Error: Could not start collector" << std::endl;
+            return 1;
+        }
+
+        config.Host = "127.0.0.1";
+        config.Port = std::to_string(server.GetPort());
+    }
+    else
+    {
+        size_t colon = collector.rfind(':');
+
+        config.Host = collector.substr(0, colon);
+        config.Port = colon == std::string::npos ? PUBLISH_DEFAULT_PORT : collector.substr(colon + 1);
+    }
+
+    config.Start = TClock::now();
+    config.End   = config.Start + std::chrono::seconds(seconds);
+
+    std::vector<TLoadResult> results(numThreads);
+    std::vector<std::thread> threads;
+
+    for (UINT32 t = 0; t < numThreads; t++)
+    {
+        UINT32 first = (UINT64)numNodes * t / numThreads;
+        UINT32 last  = (UINT64)numNodes * (t + 1) / numThreads;
+
+        results[t] = TLoadResult();
+        threads.emplace_back(RunNodes, std::cref(config), first, last - first, std::ref(results[t]));
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double wallSec = std::chrono::duration<double>(TClock::now() - config.Start).count();
+
+    TLoadResult total = TLoadResult();
+
+    for (const TLoadResult& result : results)
+    {
+        total.Sent   += result.Sent;
+        total.Resent += result.Resent;
+        total.Acked  += result.Acked;
+        total.Errors += result.Errors;
+        total.Latency.Merge(result.Latency);
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << numNodes << " nodes, " << numThreads << " load threads, batch " << config.Batch
+              << ", window " << config.Window << ", "
+              << (config.Rate ? std::to_string(config.Rate) + " samples/s per node" : std::string("max. rate"))
+              << ", " << config.DuplicatePercent << "% duplicate frames" << std::endl
+              << "sent=" << total.Sent << " resent=" << total.Resent << " acked=" << total.Acked
+              << " errors=" << total.Errors << std::endl
+              << total.Acked / wallSec << " samples/s sustained, " << total.Acked / wallSec / std::max<UINT32>(numNodes, 1)
+              << " per node" << std::endl
+              << "ack latency " << total.Latency.Summary() << std::endl;
+
+    bool ok = !total.Errors && total.Acked == total.Sent;
+
+    if (collector.empty())
+    {
+        TIngestServerStats stats    = server.GetStats();
+        size_t             reactors = server.GetNumReactors();
+        server.Stop();
+
+        std::cout << "collector: " << reactors << " reactors, sync=" << (sync ? "on" : "off")
+                  << " stored=" << stats.Store.Samples
+                  << " duplicates=" << stats.Store.Duplicates
+                  << " gaps=" << stats.Store.Gaps
+                  << " invalid=" << stats.Store.Invalid
+                  << " syncs=" << stats.Store.Syncs
+                  << " MiB=" << stats.Store.Bytes / 1048576.0 << std::endl;
+
+        ok = ok && stats.Store.Samples == total.Sent && stats.Store.Duplicates == total.Resent
+                && !stats.Store.Gaps && !stats.Store.Invalid && !stats.Store.WriteErrors;
+
+        // the reopened store must resume every node at its last sample
+        TIngestStore reopened;
+        UINT64       recovered = 0;
+
+        reopened.Open(directory, sync);
+        for (UINT32 i = 0; i < numNodes; i++)
+        {
+            std::shared_ptr<TIngestNode> node = reopened.GetNode("bench-node-" + std::to_string(i));
+            recovered += node ? node->GetNext() : 0;
+        }
+
+        std::cout << "recovered sequences=" << recovered << std::endl;
+        ok = ok && recovered == total.Sent;
+    }
+
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+
+    return ok ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
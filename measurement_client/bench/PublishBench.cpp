@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------------
+//
+//	File:		PublishBench.cpp
+//
+//	Abstract:	End to end test of the store-and-forward publisher against a
+//              loopback collector with connection drops, a collector outage
+//              and a publisher restart
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      publish_bench [-n <samples>] [-i <interval us>] [-b <batch>]
+//                            [-l <flush latency ms>] [-d <drop every n frames>]
+//                            [-o <outage ms>] [-s <spool dir>]
+//
+//------------------------------------------------------------------------------
+
+#include "../Measurement/TcpPublisher.h"
+#include "../Measurement/RLTCodec.h"
+#include "../Measurement/LatencyHistogram.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//------------------------------------------------------------------------------
+//
+//  TLoopbackCollector
+//
+//  @brief: minimal collector, one connection at a time; every DropEvery
+//          frames the connection is closed after storing a frame but before
+//          acknowledging it, so the publisher must resume without resending
+//
+//------------------------------------------------------------------------------
+
+class TLoopbackCollector
+{
+    public:
+
+    UINT32              DropEvery = 0;
+
+    std::atomic<UINT64> Received;
+    std::atomic<UINT64> Duplicates;
+    std::atomic<UINT64> Gaps;
+    std::atomic<UINT64> Frames;
+    std::atomic<UINT64> Drops;
+    std::atomic<bool>   Offline;
+
+    std::mutex          Lock;
+    TLatencyHistogram   Latency;
+
+                        TLoopbackCollector()
+                        {
+                            Received = Duplicates = Gaps = Frames = Drops = 0;
+                            Offline  = false;
+                            Running  = false;
+                            Next     = 0;
+                            Listener = -1;
+                        }
+
+    bool                Start()
+                        {
+                            Listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+                            struct sockaddr_in addr = {};
+                            addr.sin_family      = AF_INET;
+                            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+                            socklen_t size = sizeof(addr);
+                            if (Listener < 0
+                                || ::bind(Listener, (struct sockaddr*)&addr, sizeof(addr)) != 0
+                                || ::listen(Listener, 4) != 0
+                                || ::getsockname(Listener, (struct sockaddr*)&addr, &size) != 0)
+                                return false;
+
+                            Port    = ntohs(addr.sin_port);
+                            Running = true;
+                            Thread  = std::thread(&TLoopbackCollector::Run, this);
+                            return true;
+                        }
+
+    void                Stop()
+                        {
+                            Running = false;
+                            if (Thread.joinable())
+                                Thread.join();
+                            ::close(Listener);
+                        }
+
+    UINT16              GetPort() const { return Port; }
+    UINT64              GetNext() const { return Next; }
+
+    private:
+
+    void                Run()
+                        {
+                            while (Running)
+                            {
+                                struct pollfd fds = { Listener, POLLIN, 0 };
+                                if (::poll(&fds, 1, 50) != 1)
+                                    continue;
+
+                                int handle = ::accept4(Listener, 0, 0, SOCK_CLOEXEC);
+                                if (handle < 0)
+                                    continue;
+
+                                // outage: refuse service
+                                if (!Offline)
+                                    Serve(handle);
+
+                                ::close(handle);
+                            }
+                        }
+
+    void                Serve(int handle)
+                        {
+                            TPublishParser     parser;
+                            std::vector<UINT8> reply;
+
+                            while (Running && !Offline)
+                            {
+                                struct pollfd fds = { handle, POLLIN, 0 };
+                                if (::poll(&fds, 1, 50) != 1)
+                                    continue;
+
+                                UINT8   buffer[65536];
+                                ssize_t length = ::recv(handle, buffer, sizeof(buffer), 0);
+                                if (length <= 0)
+                                    return;
+
+                                parser.Append(buffer, length);
+
+                                UINT8        type;
+                                const UINT8* body;
+                                size_t       bodyLength;
+
+                                while (parser.Next(type, body, bodyLength))
+                                {
+                                    reply.clear();
+
+                                    if (type == PUBLISH_MSG_HELLO)
+                                        Publish_AppendSequence(reply, PUBLISH_MSG_RESUME, Next);
+                                    else if (type == PUBLISH_MSG_DATA && bodyLength > 8)
+                                    {
+                                        Store(Publish_Get64(body), body + 8, bodyLength - 8);
+
+                                        if (DropEvery && !(Frames % DropEvery))
+                                        {
+                                            Drops++;
+                                            return;
+                                        }
+                                        Publish_AppendSequence(reply, PUBLISH_MSG_ACK, Next);
+                                    }
+
+                                    if (!reply.empty() && !Publish_SendAll(handle, reply.data(), reply.size()))
+                                        return;
+                                }
+
+                                if (parser.HasError())
+                                    return;
+                            }
+                        }
+
+    void                Store(UINT64 sequence, const UINT8* block, size_t length)
+                        {
+                            std::vector<TRLTSample> samples;
+
+                            if (!TRLTBlockDecoder::DecodeBlock(block, length, samples))
+                                return;
+
+                            INT64 now = RLT_GetTimeUs();
+
+                            std::lock_guard<std::mutex> lock(Lock);
+
+                            Frames++;
+                            for (const TRLTSample& sample : samples)
+                            {
+                                if (sequence < Next)
+                                    Duplicates++;
+                                else
+                                {
+                                    Gaps += sequence - Next;
+                                    Next  = sequence + 1;
+                                    Received++;
+                                    Latency.Add((UINT64)std::max<INT64>(0, now - sample.TimeUs));
+                                }
+                                sequence++;
+                            }
+                        }
+
+    int                 Listener;
+    UINT16              Port;
+    std::thread         Thread;
+    std::atomic<bool>   Running;
+    std::atomic<UINT64> Next;
+};
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT64      numSamples  = 20000;
+    UINT32      intervalUs  = 100;
+    UINT32      dropEvery   = 50;
+    UINT32      outageMs    = 1000;
+
+    TPublisherConfig config;
+
+    config.Host             = "127.0.0.1";
+    config.Node             = "publish_bench";
+    config.SpoolDir         = "/tmp/publish_bench_spool";
+    config.FlushLatencyMs   = 100;
+    config.ReconnectMinMs   = 20;
+    config.ReconnectMaxMs   = 200;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            numSamples = std::strtoull(argv[++i], 0, 10);
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            config.BatchSamples = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-l") && i + 1 < argc)
+            config.FlushLatencyMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            dropEvery = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-o") && i + 1 < argc)
+            outageMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            config.SpoolDir = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-n <samples>] [-i <interval us>] [-b <batch>] [-l <flush latency ms>]"
+                      << " [-d <drop every n frames>] [-o <outage ms>] [-s <spool dir>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // start with an empty spool
+    std::string command = "rm -rf '" + config.SpoolDir + "'";
+    if (std::system(command.c_str()) != 0)
+        return 1;
+
+    TLoopbackCollector collector;
+    collector.DropEvery = dropEvery;
+
+    if (!collector.Start())
+    {
+        std::cerr << "Error: Could not start loopback collector" << std::endl;
+        return 1;
+    }
+
+    config.Port = std::to_string(collector.GetPort());
+
+    std::unique_ptr<TTcpPublisher> publisher(new TTcpPublisher);
+    if (!publisher->Open(config))
+    {
+        std::cerr << "Error: Could not open publisher" << std::endl;
+        return 1;
+    }
+
+    UINT64 spoolPeak  = 0;
+    UINT64 connects   = 0;
+    UINT64 wireBytes  = 0;
+    UINT64 frames     = 0;
+
+    auto start  = std::chrono::steady_clock::now();
+    auto next   = start;
+    auto outage = start;
+
+    TRLTSample sample;
+
+    for (UINT64 n = 1; n <= numSamples; n++)
+    {
+        // collector outage in the first third
+        if (n == numSamples / 3 && outageMs)
+        {
+            collector.Offline = true;
+            outage            = std::chrono::steady_clock::now();
+        }
+        if (collector.Offline && std::chrono::steady_clock::now() - outage > std::chrono::milliseconds(outageMs))
+            collector.Offline = false;
+
+        // publisher restart with unacknowledged samples in the spool
+        if (n == 2 * numSamples / 3)
+        {
+            TPublisherStats stats = publisher->GetStats();
+
+            connects  += stats.Connects;
+            wireBytes += stats.BytesSent;
+            frames    += stats.FramesSent;
+
+            publisher.reset(new TTcpPublisher);
+            if (!publisher->Open(config))
+            {
+                std::cerr << "Error: Could not reopen publisher" << std::endl;
+                return 1;
+            }
+        }
+
+        next += std::chrono::microseconds(intervalUs);
+        while (std::chrono::steady_clock::now() < next)
+            std::this_thread::sleep_for(std::chrono::microseconds(std::min<UINT32>(intervalUs, 50)));
+
+        sample.TimeUs           = RLT_GetTimeUs();
+        sample.Status.LTxCount  = (UINT32)n;
+        sample.Status.PTxCount  = (UINT32)n;
+        sample.Status.LocalRSSI = -60 - (INT16)(n % 7);
+
+        // what the sink thread of the fan-out does
+        publisher->WriteSample(sample, std::string());
+        publisher->Poll();
+
+        spoolPeak = std::max(spoolPeak, publisher->GetStats().SpoolSize);
+    }
+
+    collector.Offline = false;
+
+    TPublisherStats stats = publisher->GetStats();
+    publisher->Close(10000);
+
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    stats      = publisher->GetStats();
+    connects  += stats.Connects;
+    wireBytes += stats.BytesSent;
+    frames    += stats.FramesSent;
+
+    collector.Stop();
+
+    bool ok = collector.Received == numSamples && !collector.Duplicates && !collector.Gaps;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << numSamples << " samples, batch " << config.BatchSamples << ", flush latency "
+              << config.FlushLatencyMs << " ms, " << intervalUs << " us interval" << std::endl
+              << "collector: received=" << collector.Received
+              << " duplicates=" << collector.Duplicates
+              << " gaps=" << collector.Gaps
+              << " frames=" << collector.Frames
+              << " dropped connections=" << collector.Drops << std::endl
+              << "publisher: connects=" << connects
+              << " frames sent=" << frames
+              << " wire bytes/sample=" << (double)wireBytes / std::max<UINT64>(1, numSamples)
+              << " spool peak=" << spoolPeak / 1024.0 << " KiB"
+              << " acked=" << stats.Acknowledged << "/" << stats.NextSequence << std::endl
+              << "delivery latency " << collector.Latency.Summary() << std::endl
+              << numSamples / wallSec << " samples/s, " << (ok ? "OK" : "FAILED") << std::endl;
+
+    return ok ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RLTCodecBench.cpp
+//
+//	Abstract:	Compression ratio and throughput of the RLT block codec
+//              against the CSV measurement files
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      rltcodec_bench [-b <samples per block>] <csv file> ...
+//
+//------------------------------------------------------------------------------
+
+#include "../Measurement/RLTSample.h"
+#include "../Measurement/RLTCodec.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+//------------------------------------------------------------------------------
+//
+//  ReadCsv
+//
+//  @brief: parse all data rows of a measurement file
+//
+//------------------------------------------------------------------------------
+
+static bool
+ReadCsv(const char* filename, std::vector<TRLTSample>& samples, size_t& fileSize)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open " << filename << std::endl;
+        return false;
+    }
+
+    std::stringstream content;
+    content << file.rdbuf();
+
+    std::string text = content.str();
+    fileSize = text.size();
+
+    std::istringstream lines(text);
+    std::string        line;
+    TRLTSample         sample;
+
+    while (std::getline(lines, line))
+    {
+        // tolerate CRLF line ends
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (RLT_ParseCsvRow(line, sample))
+            samples.push_back(sample);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  IsEqual
+//
+//------------------------------------------------------------------------------
+
+static bool
+IsEqual(const TRLTSample& a, const TRLTSample& b)
+{
+    return a.TimeUs == b.TimeUs
+        && a.Status.TestStatus == b.Status.TestStatus
+        && a.Status.LTxCount == b.Status.LTxCount
+        && a.Status.LRxCount == b.Status.LRxCount
+        && a.Status.PTxCount == b.Status.PTxCount
+        && a.Status.PRxCount == b.Status.PRxCount
+        && a.Status.LocalRSSI == b.Status.LocalRSSI
+        && a.Status.PeerRSSI == b.Status.PeerRSSI
+        && a.Status.LocalSNR == b.Status.LocalSNR
+        && a.Status.PeerSNR == b.Status.PeerSNR;
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    int blockSamples = RLT_BLOCK_DEFAULT_SAMPLES;
+    int first        = 1;
+
+    if (argc > 2 && std::strcmp(argv[1], "-b") == 0)
+    {
+        blockSamples = std::atoi(argv[2]);
+        first        = 3;
+    }
+
+    if (first >= argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-b <samples per block>] <csv file> ..." << std::endl;
+        return 1;
+    }
+
+    for (int arg = first; arg < argc; arg++)
+    {
+        std::vector<TRLTSample> samples;
+        size_t                  csvSize = 0;
+
+        if (!ReadCsv(argv[arg], samples, csvSize) || samples.empty())
+            continue;
+
+        // encode
+        std::vector<UINT8> segment;
+        segment.reserve(csvSize / 4);
+
+        auto start = std::chrono::steady_clock::now();
+
+        TRLTBlockEncoder encoder(blockSamples);
+        for (const TRLTSample& sample : samples)
+        {
+            if (encoder.Add(sample))
+                encoder.Flush(segment);
+        }
+        encoder.Flush(segment);
+
+        auto encoded = std::chrono::steady_clock::now();
+
+        // decode
+        std::vector<TRLTSample> decoded;
+        decoded.reserve(samples.size());
+
+        size_t numBlocks = TRLTBlockDecoder::DecodeSegment(segment.data(), segment.size(), decoded);
+
+        auto stop = std::chrono::steady_clock::now();
+
+        // verify round trip
+        bool ok = decoded.size() == samples.size();
+        for (size_t i = 0; ok && i < samples.size(); i++)
+            ok = IsEqual(samples[i], decoded[i]);
+
+        // seek test: middle of the campaign
+        std::vector<TRLTSeekPoint> index;
+        TRLTBlockDecoder::BuildIndex(segment.data(), segment.size(), index);
+        INT64  middle = samples[samples.size() / 2].TimeUs;
+        size_t block  = TRLTBlockDecoder::Seek(index, middle);
+        ok = ok && block < index.size() && index[block].Info.FirstTimeUs <= middle;
+
+        double encodeSec = std::chrono::duration<double>(encoded - start).count();
+        double decodeSec = std::chrono::duration<double>(stop - encoded).count();
+        double csvMB     = csvSize / 1e6;
+        double duration  = (samples.back().TimeUs - samples.front().TimeUs) / 1e6;
+        double perSample = (double)segment.size() / samples.size();
+
+        std::cout << argv[arg] << std::endl
+                  << std::fixed << std::setprecision(2)
+                  << "  samples:        " << samples.size() << " in " << numBlocks << " blocks" << std::endl
+                  << "  csv size:       " << csvSize << " bytes (" << (double)csvSize / samples.size() << " bytes/sample)" << std::endl
+                  << "  encoded size:   " << segment.size() << " bytes (" << perSample << " bytes/sample)" << std::endl
+                  << "  ratio:          " << (double)csvSize / segment.size() << " : 1" << std::endl
+                  << "  encode:         " << csvMB / encodeSec << " MB/s (csv equivalent)" << std::endl
+                  << "  decode:         " << csvMB / decodeSec << " MB/s (csv equivalent)" << std::endl;
+
+        // storage projection at the recorded sample rate
+        if (duration > 0)
+        {
+            double bytesPerDay = segment.size() / duration * 86400.0;
+            std::cout << "  bytes per day:  " << bytesPerDay << " (" << 1e9 / bytesPerDay << " days per GB)" << std::endl;
+        }
+
+        std::cout << "  round trip:     " << (ok ? "ok" : "FAILED") << std::endl;
+
+        if (!ok)
+            return 1;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,336 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RecoveryBench.cpp
+//
+//	Abstract:	Time to recover from injected radio module faults with the
+//              stall supervisor, counter continuity and gap markers
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      recovery_bench [-f <faults per type>] [-i <interval ms>]
+//                             [-d <reset down time ms>] [-m <min timeout ms>]
+//                             [-b <legacy|epoll|io_uring>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/SampleFanout.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include "../Measurement/RadioSupervisor.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// give up if a fault is not recovered within this time
+#define BENCH_TIMEOUT_S         60
+
+// undisturbed operation before each fault
+#define BENCH_SETTLE_MS         1000
+
+typedef std::chrono::steady_clock TClock;
+
+typedef enum
+{
+    // test ends without notice, the module still answers
+    FAULT_STALL = 0,
+    // indications continue, Tx counter frozen
+    FAULT_FREEZE,
+    // module reset, no answers for the down time, test state lost
+    FAULT_RESET,
+    FAULT_NUM
+}TFault;
+
+static const char* FaultNames[FAULT_NUM] = { "stall", "ltx-freeze", "reset" };
+
+//------------------------------------------------------------------------------
+//
+//  TFaultyEmulator
+//
+//  @brief: emulated module with injectable faults
+//
+//------------------------------------------------------------------------------
+
+class TFaultyEmulator : public THCIEmulator
+{
+    public:
+
+    void        Inject(TFault fault, UINT32 downMs)
+                {
+                    if (fault == FAULT_FREEZE)
+                    {
+                        SetTxFrozen(true);
+                        return;
+                    }
+
+                    if (fault == FAULT_RESET)
+                        DownUntil = (TClock::now() + std::chrono::milliseconds(downMs)).time_since_epoch().count();
+
+                    SetTestRunning(false);
+                }
+
+    protected:
+
+    bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length) override
+                {
+                    // requests are lost while the module boots
+                    if (TClock::now().time_since_epoch().count() < DownUntil)
+                        return true;
+
+                    return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+                }
+
+    private:
+
+    std::atomic<TClock::rep>    DownUntil { 0 };
+};
+
+//------------------------------------------------------------------------------
+//
+//  TCheckSink
+//
+//  @brief: checks that the accumulated Tx counter never jumps or decreases
+//          and counts gap markers
+//
+//------------------------------------------------------------------------------
+
+class TCheckSink : public TSampleSink
+{
+    public:
+
+    std::atomic<UINT64> Samples { 0 };
+    std::atomic<UINT64> Gaps { 0 };
+    std::atomic<UINT64> Violations { 0 };
+    std::atomic<UINT32> LTxCount { 0 };
+
+    std::string     GetName() const override { return "check"; }
+
+    bool            WriteSample(const TRLTSample& sample, const std::string& /* encoded */) override
+                    {
+                        // one new packet per indication, none while frozen
+                        UINT32 delta = sample.Status.LTxCount - LTxCount;
+
+                        if (Samples && delta > 1)
+                            Violations++;
+
+                        LTxCount = sample.Status.LTxCount;
+                        Samples++;
+                        return true;
+                    }
+
+    void            WriteComment(const std::string& comment) override
+                    {
+                        if (!comment.compare(0, 4, "gap "))
+                            Gaps++;
+                    }
+};
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT32      numFaults   = 3;
+    UINT32      intervalMs  = 10;
+    UINT32      downMs      = 3000;
+    UINT32      minTimeout  = TSupervisorConfig().MinTimeoutMs;
+    std::string backendName = "epoll";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-f") && i + 1 < argc)
+            numFaults = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-d") && i + 1 < argc)
+            downMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-m") && i + 1 < argc)
+            minTimeout = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backendName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-f <faults per type>] [-i <interval ms>] [-d <reset down time ms>]"
+                      << " [-m <min timeout ms>] [-b <legacy|epoll|io_uring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    TFaultyEmulator emulator;
+    TWiMODLRHCI     hci;
+    TSampleFanout   fanout;
+    TCheckSink      sink;
+
+    emulator.SetStatusInterval(intervalMs * 1000);
+
+    if (!emulator.Open() || !emulator.Start() || !hci.Open(emulator.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return 1;
+    }
+
+    TRadioSupervisor supervisor(hci, fanout);
+
+    hci.RegisterClient(&supervisor);
+    fanout.AddSink(sink);
+    fanout.Start();
+
+    TWiMODLR_RadioLinkTestConfig test;
+    test.GroupAddress  = 0x10;
+    test.DeviceAddress = 0x2222;
+    test.PacketSize    = 15;
+    test.NumPackets    = 100;
+    test.TestMode      = 1;
+
+    TSupervisorConfig config;
+    config.MinTimeoutMs = minTimeout;
+
+    // startup of main.cpp
+    supervisor.Start(emulator.GetPortName(), test, config);
+
+    UINT8 status = 0;
+
+    if (hci.PrepareRadioLinkTest(status, config.ReadyTimeoutMs) != WiMODLR_RESULT_OK
+        || hci.StartRadioLinkTest(test, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not start radio link test" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<TEventBackend> backend;
+    THCIReader reader(hci);
+
+    if (backendName != "legacy")
+    {
+        backend.reset(CreateEventBackend(backendName == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+        if (!backend || !reader.Attach(*backend))
+        {
+            std::cerr << "Error: Could not set up event backend" << std::endl;
+            return 1;
+        }
+    }
+
+    supervisor.SetEventBackend(backend.get(), &reader);
+
+    // main loop of main.cpp, run for the given time or until recovered
+    auto run = [&](TClock::time_point until, UINT64 recoveries) -> bool
+    {
+        while (TClock::now() < until)
+        {
+            if (backend)
+            {
+                if (backend->Poll(10) < 0)
+                    return false;
+            }
+            else
+            {
+                hci.WaitForResponse(RLT_SAP_ID, RLT_MSG_STATUS_IND);
+            }
+
+            supervisor.Poll();
+            fanout.Poll();
+
+            if (recoveries && supervisor.GetStats().Recoveries >= recoveries)
+                return true;
+        }
+
+        return !recoveries;
+    };
+
+    std::cout << "interval " << intervalMs << " ms, min. timeout " << minTimeout << " ms, reset down time "
+              << downMs << " ms, " << (backend ? backend->GetName() : "legacy") << std::endl
+              << std::left << std::setw(12) << "fault" << std::right
+              << std::setw(8) << "faults"
+              << std::setw(16) << "mean MTTR ms"
+              << std::setw(15) << "max MTTR ms"
+              << std::setw(17) << "mean detect ms" << std::endl;
+
+    bool result = true;
+
+    for (int fault = 0; fault < FAULT_NUM && result; fault++)
+    {
+        double totalMs  = 0;
+        double maxMs    = 0;
+        double detectMs = 0;
+
+        for (UINT32 i = 0; i < numFaults && result; i++)
+        {
+            // establish the indication rate
+            result = run(TClock::now() + std::chrono::milliseconds(BENCH_SETTLE_MS), 0);
+
+            UINT64 recoveries = supervisor.GetStats().Recoveries;
+            auto   injected   = TClock::now();
+
+            emulator.Inject((TFault)fault, downMs);
+
+            if (result && !run(injected + std::chrono::seconds(BENCH_TIMEOUT_S), recoveries + 1))
+            {
+                std::cerr << "Error: " << FaultNames[fault] << " fault not recovered" << std::endl;
+                result = false;
+            }
+
+            // injection until first sample of the restarted test
+            double ms = std::chrono::duration<double, std::milli>(TClock::now() - injected).count();
+
+            totalMs  += ms;
+            maxMs     = std::max(maxMs, ms);
+            detectMs += ms - supervisor.GetStats().LastRecoveryMs;
+        }
+
+        if (result)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                      << std::left << std::setw(12) << FaultNames[fault] << std::right
+                      << std::setw(8) << numFaults
+                      << std::setw(16) << totalMs / numFaults
+                      << std::setw(15) << maxMs
+                      << std::setw(17) << detectMs / numFaults << std::endl;
+        }
+    }
+
+    // deliver the remaining samples
+    result = result && run(TClock::now() + std::chrono::milliseconds(100), 0);
+
+    fanout.Stop();
+
+    TSupervisorStats stats = supervisor.GetStats();
+
+    std::cout << supervisor.FormatStats() << std::endl
+              << "first sample after " << stats.FirstSampleMs << " ms, samples " << sink.Samples << ", gap markers " << sink.Gaps
+              << ", counter violations " << sink.Violations << std::endl;
+
+    if (sink.Gaps != stats.Recoveries || sink.Violations)
+        result = false;
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    // stop emulator before the HCI closes its side
+    backend.reset();
+    emulator.Close();
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
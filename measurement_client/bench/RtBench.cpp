@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------
+//
+//	File:		RtBench.cpp
+//
+//	Abstract:	Wakeup jitter and status indication gaps of the serial
+//              reader under CPU and memory load, with the default
+//              scheduling and in real-time mode
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      rt_bench [-t <s per phase>] [-l <load processes>]
+//                       [-p <probe period us>] [-s <status interval ms>]
+//                       [-c <core>] [-r <priority>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/Realtime.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include "../Measurement/SampleFanout.h"
+#include "../Measurement/LatencyHistogram.h"
+#include "../Measurement/RLTSample.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// memory touched by each load process per round [KiB], page faults and
+// cache misses like the plotting processes
+#define BENCH_LOAD_KIB          4096
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  TFifoEmulator
+//
+//  @brief: the emulated module stands in for hardware of its own, its
+//          thread runs above the load and below the reader, so the gaps
+//          show the reader side
+//
+//------------------------------------------------------------------------------
+
+class TFifoEmulator : public THCIEmulator
+{
+    public:
+
+                TFifoEmulator(int priority) : Priority(priority) {}
+
+    protected:
+
+    void        Tick() override
+                {
+                    if (Priority)
+                        RT_SetThread(-1, Priority);
+                    Priority = 0;
+                }
+
+    private:
+
+    int         Priority;
+};
+
+//------------------------------------------------------------------------------
+//
+//  TGapSink
+//
+//  @brief: deviation of the read time gaps of consecutive indications from
+//          the status interval
+//
+//------------------------------------------------------------------------------
+
+class TGapSink : public TSampleSink
+{
+    public:
+
+                    TGapSink(UINT32 intervalUs) : IntervalUs(intervalUs) {}
+
+    std::string     GetName() const override { return "gaps"; }
+
+    bool            WriteSample(const TRLTSample& sample, const std::string& /* encoded */) override
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        if (LastUs)
+                            Deviations.Add((UINT64)std::abs(sample.TimeUs - LastUs - (INT64)IntervalUs));
+
+                        LastUs = sample.TimeUs;
+                        return true;
+                    }
+
+    // histogram of the phase, next phase starts empty
+    TLatencyHistogram   TakeDeviations()
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        TLatencyHistogram deviations = Deviations;
+
+                        Deviations.Reset();
+                        LastUs = 0;
+                        return deviations;
+                    }
+
+    private:
+
+    UINT32              IntervalUs;
+    std::mutex          Lock;
+    TLatencyHistogram   Deviations;
+    INT64               LastUs = 0;
+};
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT32 phaseS   = 5;
+    int    loads    = 2 * std::max(1, (int)std::thread::hardware_concurrency());
+    UINT32 periodUs = 1000;
+    UINT32 statusMs = 10;
+    int    cpu      = RT_GetIsolatedCpu();
+    int    priority = RT_DEFAULT_PRIORITY;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            phaseS = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-l") && i + 1 < argc)
+            loads = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-p") && i + 1 < argc)
+            periodUs = std::max(50, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            statusMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-c") && i + 1 < argc)
+            cpu = std::max(-1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+            priority = std::clamp(std::atoi(argv[++i]), 2, 98);
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-t <s per phase>] [-l <load processes>] [-p <probe period us>]"
+                      << " [-s <status interval ms>] [-c <core>] [-r <priority>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // load processes with the default scheduling, forked before any thread
+    std::vector<pid_t> loadProcesses;
+
+    for (int i = 0; i < loads; i++)
+    {
+        pid_t pid = ::fork();
+
+        if (!pid)
+        {
+            for (;;)
+            {
+                std::vector<UINT8> memory(BENCH_LOAD_KIB * 1024);
+
+                for (size_t j = 0; j < memory.size(); j += 64)
+                    memory[j] = (UINT8)(j * 31);
+            }
+        }
+
+        if (pid > 0)
+            loadProcesses.push_back(pid);
+    }
+
+    TFifoEmulator   emulator(priority - 1);
+    TWiMODLRHCI     hci;
+    TSampleFanout   fanout;
+    TGapSink        sink(statusMs * 1000);
+
+    emulator.SetStatusInterval(statusMs * 1000);
+
+    if (!emulator.Open() || !emulator.Start() || !hci.Open(emulator.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return 1;
+    }
+
+    fanout.SetReceiveClock(&hci);
+    fanout.AddSink(sink);
+    fanout.Start();
+    hci.RegisterClient(&fanout);
+
+    TWiMODLR_RadioLinkTestConfig test;
+    test.GroupAddress  = 0x10;
+    test.DeviceAddress = 0x2222;
+    test.PacketSize    = 15;
+    test.NumPackets    = 100;
+    test.TestMode      = 1;
+
+    UINT8 status = 0;
+
+    if (hci.StartRadioLinkTest(test, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+    {
+        std::cerr << "Error: Could not start radio link test" << std::endl;
+        return 1;
+    }
+
+    // the reader sleeps in the backend until data arrives, the legacy loop
+    // polls and would hold the core in real-time mode
+    std::unique_ptr<TEventBackend> backend(CreateEventBackend(EVENT_BACKEND_EPOLL));
+    THCIReader                     reader(hci);
+
+    if (!backend || !reader.Attach(*backend))
+    {
+        std::cerr << "Error: Could not set up event backend" << std::endl;
+        return 1;
+    }
+
+    // backend loop of main.cpp with the probe next to it
+    auto run = [&](const TRealtimeConfig& config, TLatencyHistogram& wakeups)
+    {
+        TJitterProbe probe;
+        auto         end = TClock::now() + std::chrono::seconds(phaseS);
+
+        sink.TakeDeviations();
+        probe.Start(config);
+
+        while (TClock::now() < end)
+        {
+            backend->Poll(100);
+            fanout.Poll();
+        }
+
+        probe.Stop();
+        wakeups = probe.GetTotal();
+
+        return sink.TakeDeviations();
+    };
+
+    TRealtimeConfig config;
+    config.JitterIntervalUs = periodUs;
+    config.ReportS          = 0;
+
+    std::cout << phaseS << " s per phase, " << loads << " load processes, probe every " << periodUs
+              << " us, status indication every " << statusMs << " ms" << std::endl;
+
+    TLatencyHistogram defaultWakeups;
+    TLatencyHistogram defaultGaps = run(config, defaultWakeups);
+
+    config.Cpu        = cpu;
+    config.Priority   = priority;
+    config.LockMemory = true;
+
+    bool entered = RT_Enter(config);
+
+    TLatencyHistogram rtWakeups;
+    TLatencyHistogram rtGaps = run(config, rtWakeups);
+
+    for (pid_t pid : loadProcesses)
+    {
+        ::kill(pid, SIGKILL);
+        ::waitpid(pid, 0, 0);
+    }
+
+    fanout.Stop();
+
+    std::cout << "real-time mode " << RT_FormatConfig(config) << (entered ? "" : " (not permitted)") << std::endl
+              << std::left << std::setw(10) << "mode" << std::setw(8) << "" << std::right << "delay" << std::endl
+              << std::left << std::setw(10) << "default" << std::setw(8) << "wakeup" << std::right
+              << defaultWakeups.Summary() << std::endl
+              << std::left << std::setw(10) << "" << std::setw(8) << "gap" << std::right
+              << defaultGaps.Summary() << std::endl
+              << std::left << std::setw(10) << "realtime" << std::setw(8) << "wakeup" << std::right
+              << rtWakeups.Summary() << std::endl
+              << std::left << std::setw(10) << "" << std::setw(8) << "gap" << std::right
+              << rtGaps.Summary() << std::endl;
+
+    // without the privileges both phases ran with the default scheduling,
+    // there is nothing to compare
+    bool result = defaultWakeups.Count() && rtWakeups.Count() && defaultGaps.Count() && rtGaps.Count()
+                  && (!entered || rtWakeups.Percentile(99) <= defaultWakeups.Percentile(99));
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    backend.reset();
+    hci.Close();
+    emulator.Close();
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
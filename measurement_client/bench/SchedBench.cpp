@@ -0,0 +1,465 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SchedBench.cpp
+//
+//	Abstract:	Latency of control messages and commands next to saturating
+//              bulk flows, one FIFO data link against the Tx scheduler
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      sched_bench [-g <grid>] [-t <radio s>] [-s <bulk payload bytes>]
+//                          [-w <weight of bulk flow 1>] [-c <control interval ms>]
+//                          [-p <command interval ms>] [-b <bulk in flight>]
+//                          [-q <module queue depth>] [-u <tx setup us>] [-x <time scale>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/DataLinkSender.h"
+#include "../Measurement/TxScheduler.h"
+#include "../Measurement/LatencyHistogram.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define BENCH_GROUP_ADDRESS     0x10
+#define BENCH_SENDER_ADDRESS    0x1111
+#define BENCH_RECEIVER_ADDRESS  0x2222
+
+// flows: control messages, two bulk flows (the second with half the
+// payload per message)
+#define BENCH_FLOW_CONTROL      0
+#define BENCH_FLOW_BULK1        1
+#define BENCH_FLOW_BULK2        2
+#define BENCH_NUM_FLOWS         3
+
+// flow id and sequence number
+#define BENCH_MESSAGE_HEADER    5
+#define BENCH_CONTROL_SIZE      8
+
+// bulk messages kept queued on the host per flow
+#define BENCH_HOST_BACKLOG      8
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  TSenderHost
+//
+//  @brief: HCI client of the sending module, the data link of the mode;
+//          commands of the scheduler are pings
+//
+//------------------------------------------------------------------------------
+
+class TSenderHost : public TWiMODLRHCIClient, public TTxSchedulerClient
+{
+    public:
+
+    TWiMODLRHCI*        HCI = 0;
+    TWiMODLRHCIClient*  Target = 0;
+    UINT64              Failed = 0;
+
+    void        evRadioLink_TxUMessageRsp(UINT8 status) override { Target->evRadioLink_TxUMessageRsp(status); }
+    void        evRadioLink_TxUMessageInd(UINT8 status) override { Target->evRadioLink_TxUMessageInd(status); }
+
+    void        evTxScheduler_Command(UINT32 /* tag */) override
+                {
+                    if (HCI->PingRequest() != WiMODLR_RESULT_OK)
+                        Failed++;
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  TReceiverHost
+//
+//  @brief: HCI client of the receiving module: latency per flow by the
+//          sequence numbers, payload per flow
+//
+//------------------------------------------------------------------------------
+
+class TReceiverHost : public TWiMODLRHCIClient
+{
+    public:
+
+    std::vector<TClock::time_point> SendTimes[BENCH_NUM_FLOWS];
+    TLatencyHistogram               Latency[BENCH_NUM_FLOWS];
+    UINT64                          Bytes[BENCH_NUM_FLOWS];
+    TClock::time_point              End;
+
+    void        Reset()
+                {
+                    for (int i = 0; i < BENCH_NUM_FLOWS; i++)
+                    {
+                        SendTimes[i].clear();
+                        Latency[i].Reset();
+                        Bytes[i] = 0;
+                    }
+                }
+
+    void        evRadioLink_RxUMessage(const TWiMODLR_HCIMessage& rxMsg) override
+                {
+                    int length = rxMsg.Length - DATALINK_MSG_HEADER_SIZE;
+
+                    if (rxMsg.Payload[0] & 0x01)
+                        length -= DATALINK_MSG_FOOTER_SIZE;
+
+                    if (length < BENCH_MESSAGE_HEADER)
+                        return;
+
+                    const UINT8* data     = &rxMsg.Payload[DATALINK_MSG_HEADER_SIZE];
+                    UINT8        flow     = data[0];
+                    UINT32       sequence = NTOH32(&data[1]);
+
+                    if (flow >= BENCH_NUM_FLOWS || sequence >= SendTimes[flow].size())
+                        return;
+
+                    TClock::time_point now = TClock::now();
+
+                    // payload counted within the run, latency also while
+                    // the queues drain
+                    if (now < End)
+                        Bytes[flow] += length;
+
+                    Latency[flow].Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(now - SendTimes[flow][sequence]).count());
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  FormatConfig
+//
+//  @brief: "sf7/125 4/5"
+//
+//------------------------------------------------------------------------------
+
+static std::string
+FormatConfig(const TWiMODLR_RadioConfig& radio)
+{
+    return "sf" + std::to_string(radio.SpreadingFactor) + "/" + std::to_string(AIRTIME_GetBandwidthHz(radio.Bandwidth) / 1000)
+           + " 4/" + std::to_string(std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 4);
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7;bw=203,812";
+    UINT32      radioS      = 60;
+    UINT32      bulkSize    = DATALINK_MAX_PAYLOAD_SIZE;
+    UINT32      weight      = 2;
+    UINT32      controlMs   = 1000;
+    UINT32      commandMs   = 5000;
+    UINT32      bulkFlight  = 2;
+    UINT32      queueDepth  = 8;
+    UINT32      setupUs     = 5000;
+    UINT32      timeScale   = 20;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-t") && i + 1 < argc)
+            radioS = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            bulkSize = std::clamp(std::atoi(argv[++i]), 2 * BENCH_MESSAGE_HEADER, DATALINK_MAX_PAYLOAD_SIZE);
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc)
+            weight = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-c") && i + 1 < argc)
+            controlMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-p") && i + 1 < argc)
+            commandMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            bulkFlight = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-q") && i + 1 < argc)
+            queueDepth = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-u") && i + 1 < argc)
+            setupUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            timeScale = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-t <radio s>] [-s <bulk payload bytes>]"
+                      << " [-w <weight of bulk flow 1>] [-c <control interval ms>] [-p <command interval ms>]"
+                      << " [-b <bulk in flight>] [-q <module queue depth>] [-u <tx setup us>] [-x <time scale>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TSweepPoint> points;
+    std::string error;
+
+    TWiMODLR_RadioConfig base = TWiMODLR_RadioConfig();
+    base.Modulation      = WiMODLR_RADIO_CONFIG_MOD_LORA;
+    base.Bandwidth       = WiMODLR_RADIO_CONFIG_BW_203kHz;
+    base.SpreadingFactor = WiMODLR_RADIO_CONFIG_SF7;
+    base.ErrorCoding     = WiMODLR_RADIO_CONFIG_EC_4_5;
+
+    if (!TSweepCampaign::ParseGrid(grid, base, points, error))
+    {
+        std::cerr << "Grid: " << error << std::endl;
+        return 1;
+    }
+
+    TEmulatedChannel channel(timeScale);
+    THCIEmulator     senderModule;
+    THCIEmulator     receiverModule;
+
+    senderModule.ConnectDataLink(channel, receiverModule);
+    receiverModule.ConnectDataLink(channel, senderModule);
+    senderModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_SENDER_ADDRESS);
+    receiverModule.SetAddress(BENCH_GROUP_ADDRESS, BENCH_RECEIVER_ADDRESS);
+    senderModule.SetTxQueueSize(queueDepth);
+    senderModule.SetTxSetupTime(setupUs);
+
+    TWiMODLRHCI senderHCI;
+    TWiMODLRHCI receiverHCI;
+
+    if (!senderModule.Open() || !receiverModule.Open() || !senderModule.Start() || !receiverModule.Start()
+        || !senderHCI.Open(senderModule.GetPortName()) || !receiverHCI.Open(receiverModule.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radios" << std::endl;
+        return 1;
+    }
+
+    TDataLinkSender fifo(senderHCI);
+    TTxScheduler    scheduler(senderHCI);
+    TSenderHost     senderHost;
+    TReceiverHost   receiver;
+
+    senderHost.HCI = &senderHCI;
+    senderHCI.RegisterClient(&senderHost);
+    receiverHCI.RegisterClient(&receiver);
+    scheduler.RegisterClient(&senderHost);
+
+    TDataLinkConfig link;
+    link.GroupAddress  = BENCH_GROUP_ADDRESS;
+    link.DeviceAddress = BENCH_RECEIVER_ADDRESS;
+    link.MaxInFlight   = queueDepth;
+
+    TTxSchedulerConfig config;
+    config.Link = link;
+    config.ClassInFlight[TXSCHED_CLASS_BULK] = bulkFlight;
+
+    fifo.Configure(link);
+    scheduler.Configure(config);
+
+    // both bulk flows share their class by bytes, the second one sends
+    // messages of half the size
+    UINT32 messageSize[BENCH_NUM_FLOWS] = { BENCH_CONTROL_SIZE, bulkSize, bulkSize / 2 };
+
+    scheduler.AddFlow(BENCH_FLOW_CONTROL, TXSCHED_CLASS_CONTROL);
+    scheduler.AddFlow(BENCH_FLOW_BULK1, TXSCHED_CLASS_BULK, weight * DATALINK_MAX_PAYLOAD_SIZE);
+    scheduler.AddFlow(BENCH_FLOW_BULK2, TXSCHED_CLASS_BULK, DATALINK_MAX_PAYLOAD_SIZE);
+
+    std::cout << radioS << " s saturated by two bulk flows (" << bulkSize << " and " << bulkSize / 2
+              << " bytes, weight " << weight << ":1), control message every " << controlMs << " ms, ping after drain every "
+              << commandMs << " ms, module queue " << queueDepth << ", bulk in flight " << bulkFlight << ", setup " << setupUs
+              << " us, time scale " << timeScale << " (rates and latencies in radio time)" << std::endl
+              << std::setw(12) << "config"
+              << std::setw(7) << "mode"
+              << std::setw(10) << "bulk B/s"
+              << std::setw(8) << "share"
+              << std::setw(11) << "ctrl p50"
+              << std::setw(11) << "ctrl p99"
+              << std::setw(11) << "bulk p50"
+              << std::setw(10) << "cmd p50"
+              << std::setw(10) << "cmd p99" << std::endl;
+
+    bool result = true;
+
+    for (const TSweepPoint& point : points)
+    {
+        senderModule.SetRadio(point.Radio);
+        receiverModule.SetRadio(point.Radio);
+
+        double fifoGoodput    = 0;
+        double fifoControlP99 = 0;
+        double fifoCommandP99 = 0;
+
+        for (bool scheduled : { false, true })
+        {
+            fifo.Reset();
+            scheduler.Reset();
+            receiver.Reset();
+
+            senderHost.Target = scheduled ? (TWiMODLRHCIClient*)&scheduler : (TWiMODLRHCIClient*)&fifo;
+            senderHost.Failed = 0;
+
+            TLatencyHistogram  fifoCommands;
+            TClock::time_point commandRequested;
+            bool               commandPending = false;
+            UINT32             controlSent    = 0;
+            UINT32             commandsSent   = 0;
+            UINT32             nextBulk       = BENCH_FLOW_BULK1;
+            auto               scale          = [&](UINT32 ms) { return std::chrono::microseconds((UINT64)ms * 1000 / timeScale); };
+            auto               start          = TClock::now();
+            auto               end            = start + scale(radioS * 1000);
+
+            receiver.End = end;
+
+            std::vector<UINT8> message(DATALINK_MAX_PAYLOAD_SIZE, 0x5A);
+
+            auto send = [&](UINT8 flow, TClock::time_point now)
+                        {
+                            message[0] = flow;
+                            HTON32(&message[1], (UINT32)receiver.SendTimes[flow].size());
+                            receiver.SendTimes[flow].push_back(now);
+
+                            if (scheduled)
+                                scheduler.Send(flow, message.data(), (UINT16)messageSize[flow]);
+                            else
+                                fifo.Send(message.data(), (UINT16)messageSize[flow]);
+                        };
+
+            struct pollfd fds[2] = { { senderHCI.GetHandle(), POLLIN, 0 }, { receiverHCI.GetHandle(), POLLIN, 0 } };
+
+            for (;;)
+            {
+                TClock::time_point now = TClock::now();
+
+                // afterwards until all queues drained, the next run starts
+                // with an empty module
+                if (now >= end)
+                {
+                    bool idle = scheduled ? scheduler.GetLink().IsIdle() && !scheduler.GetPendingCommands()
+                                            && !scheduler.GetQueued(BENCH_FLOW_CONTROL) && !scheduler.GetQueued(BENCH_FLOW_BULK1)
+                                            && !scheduler.GetQueued(BENCH_FLOW_BULK2)
+                                          : fifo.IsIdle() && !commandPending;
+
+                    if (idle)
+                        break;
+                }
+                else if (now - start >= controlSent * scale(controlMs))
+                {
+                    send(BENCH_FLOW_CONTROL, now);
+                    controlSent++;
+                }
+
+                if (now < end && now - start >= (commandsSent + 1) * scale(commandMs))
+                {
+                    commandsSent++;
+
+                    if (scheduled)
+                        scheduler.RequestCommand(commandsSent, true);
+                    else
+                    {
+                        commandPending   = true;
+                        commandRequested = now;
+                    }
+                }
+
+                // FIFO: the ping waits for everything queued before it
+                if (commandPending && fifo.IsIdle())
+                {
+                    if (senderHCI.PingRequest() != WiMODLR_RESULT_OK)
+                        senderHost.Failed++;
+
+                    fifoCommands.Add((UINT64)std::chrono::duration_cast<std::chrono::microseconds>(TClock::now() - commandRequested).count());
+                    commandPending = false;
+                }
+
+                // saturating bulk, alternating in FIFO
+                if (now >= end)
+                    ;
+                else if (scheduled)
+                {
+                    for (UINT8 flow : { BENCH_FLOW_BULK1, BENCH_FLOW_BULK2 })
+                        while (scheduler.GetQueued(flow) < BENCH_HOST_BACKLOG)
+                            send(flow, now);
+                }
+                else if (!commandPending)
+                {
+                    while (fifo.GetQueued() < 2 * BENCH_HOST_BACKLOG)
+                    {
+                        send((UINT8)nextBulk, now);
+                        nextBulk = nextBulk == BENCH_FLOW_BULK1 ? BENCH_FLOW_BULK2 : BENCH_FLOW_BULK1;
+                    }
+                }
+
+                ::poll(fds, 2, 1);
+
+                senderHCI.Process();
+                receiverHCI.Process();
+                fifo.Poll();
+                scheduler.Poll();
+            }
+
+            const TLatencyHistogram& commands = scheduled ? scheduler.GetCommandLatency() : fifoCommands;
+
+            double goodput    = (receiver.Bytes[BENCH_FLOW_BULK1] + receiver.Bytes[BENCH_FLOW_BULK2]) / (double)radioS;
+            double share      = receiver.Bytes[BENCH_FLOW_BULK2] ? (double)receiver.Bytes[BENCH_FLOW_BULK1] / receiver.Bytes[BENCH_FLOW_BULK2] : 0;
+            double controlP99 = receiver.Latency[BENCH_FLOW_CONTROL].Percentile(99) * timeScale / 1000.0;
+            double commandP99 = commands.Percentile(99) * timeScale / 1000.0;
+
+            std::cout << std::fixed
+                      << std::setw(12) << FormatConfig(point.Radio)
+                      << std::setw(7) << (scheduled ? "sched" : "fifo")
+                      << std::setprecision(0)
+                      << std::setw(10) << goodput
+                      << std::setprecision(2)
+                      << std::setw(8) << share
+                      << std::setprecision(0)
+                      << std::setw(11) << receiver.Latency[BENCH_FLOW_CONTROL].Percentile(50) * timeScale / 1000.0
+                      << std::setw(11) << controlP99
+                      << std::setw(11) << std::max(receiver.Latency[BENCH_FLOW_BULK1].Percentile(50), receiver.Latency[BENCH_FLOW_BULK2].Percentile(50)) * timeScale / 1000.0
+                      << std::setw(10) << commands.Percentile(50) * timeScale / 1000.0
+                      << std::setw(10) << commandP99 << std::endl;
+
+            if (!receiver.Latency[BENCH_FLOW_CONTROL].Count() || !commands.Count() || senderHost.Failed)
+            {
+                std::cerr << "Error: Control messages or commands missing" << std::endl;
+                result = false;
+            }
+
+            // scheduled: control latency at most half, nearly the same
+            // bulk goodput, bulk bytes shared by weight
+            if (!scheduled)
+            {
+                fifoGoodput    = goodput;
+                fifoControlP99 = controlP99;
+                fifoCommandP99 = commandP99;
+            }
+            else if (controlP99 * 2 > fifoControlP99 || commandP99 >= fifoCommandP99 || goodput < 0.9 * fifoGoodput
+                     || std::abs(share - weight) > 0.1 * weight)
+                result = false;
+        }
+    }
+
+    std::cout << "scheduler " << scheduler.FormatStats() << std::endl;
+
+    senderHCI.Close();
+    receiverHCI.Close();
+    senderModule.Close();
+    receiverModule.Close();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
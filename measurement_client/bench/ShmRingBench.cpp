@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+//
+//	File:		ShmRingBench.cpp
+//
+//	Abstract:	Writer cost, reader latency and loss of the shared memory
+//              sample ring with concurrent readers
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      shmring_bench [-n <samples>] [-r <readers>] [-i <interval us>]
+//                            [-s <slots>]
+//
+//------------------------------------------------------------------------------
+
+#include "../Measurement/ShmRing.h"
+#include "../Measurement/LatencyHistogram.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+//
+//  TReaderResult
+//
+//------------------------------------------------------------------------------
+
+typedef struct
+{
+    UINT64              Received = 0;
+    UINT64              Lost = 0;
+    UINT64              OutOfOrder = 0;
+    TLatencyHistogram   Latency;
+}TReaderResult;
+
+//------------------------------------------------------------------------------
+//
+//  RunReader
+//
+//  @brief: follow the ring until the writer is done, time stamps carry
+//          the write time
+//
+//------------------------------------------------------------------------------
+
+static void
+RunReader(const std::string& name, const std::atomic<bool>& done, TReaderResult& result)
+{
+    TShmRingReader reader;
+
+    if (!reader.Open(name))
+        return;
+
+    TRLTSample sample;
+    UINT32     lastTx = 0;
+
+    while (true)
+    {
+        if (!reader.Wait(sample, 10))
+        {
+            if (done && !reader.GetBacklog())
+                break;
+            continue;
+        }
+
+        INT64 now = RLT_GetTimeUs();
+
+        result.Received++;
+        result.Latency.Add((UINT64)std::max<INT64>(0, now - sample.TimeUs));
+
+        // the bench writes consecutive counters
+        if (sample.Status.LTxCount <= lastTx && result.Received > 1)
+            result.OutOfOrder++;
+        lastTx = sample.Status.LTxCount;
+    }
+
+    result.Lost = reader.GetLost();
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    UINT64  numSamples  = 1000000;
+    int     numReaders  = 2;
+    UINT32  intervalUs  = 0;
+    UINT32  numSlots    = SHM_RING_DEFAULT_SLOTS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            numSamples = std::strtoull(argv[++i], 0, 10);
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+            numReaders = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalUs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            numSlots = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-n <samples>] [-r <readers>] [-i <interval us>] [-s <slots>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::string    name = "rlt_shmring_bench_" + std::to_string(::getpid());
+    TShmRingWriter writer;
+
+    if (!writer.Open(name, numSlots))
+    {
+        std::cerr << "Error: Could not create /dev/shm/" << name << std::endl;
+        return 1;
+    }
+
+    std::atomic<bool>           done(false);
+    std::vector<TReaderResult>  results(numReaders);
+    std::vector<std::thread>    readers;
+
+    for (int i = 0; i < numReaders; i++)
+        readers.emplace_back(RunReader, name, std::cref(done), std::ref(results[i]));
+
+    // let readers attach before the first sample
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    TRLTSample sample;
+    std::string record;
+    UINT64     writeNs = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto next  = start;
+
+    for (UINT64 n = 1; n <= numSamples; n++)
+    {
+        if (intervalUs)
+        {
+            next += std::chrono::microseconds(intervalUs);
+            while (std::chrono::steady_clock::now() < next)
+                ;
+        }
+
+        sample.TimeUs           = RLT_GetTimeUs();
+        sample.Status.LTxCount  = (UINT32)n;
+        sample.Status.PTxCount  = (UINT32)n;
+
+        // encoding is done once by the fan-out, not part of the writer cost
+        record = EncodeSample(SAMPLE_FORMAT_RECORD, sample);
+
+        auto t0 = std::chrono::steady_clock::now();
+        writer.WriteSample(sample, record);
+        writeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    writer.Close();
+
+    std::cout << numSamples << " samples, " << numReaders << " reader(s), " << numSlots << " slots, "
+              << intervalUs << " us interval" << std::endl
+              << std::fixed << std::setprecision(1)
+              << "writer: " << (double)writeNs / std::max<UINT64>(1, numSamples) << " ns/sample, "
+              << numSamples / wallSec << " samples/s" << std::endl;
+
+    for (int i = 0; i < numReaders; i++)
+    {
+        std::cout << "reader " << i << ": received=" << results[i].Received
+                  << " lost=" << results[i].Lost
+                  << " out of order=" << results[i].OutOfOrder
+                  << " latency " << results[i].Latency.Summary() << std::endl;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
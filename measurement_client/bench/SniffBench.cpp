@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SniffBench.cpp
+//
+//	Abstract:	Sniffer capture at a multiple of the maximum packet rate on
+//              air, every record checked against the emulated packets
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      sniff_bench [-g <grid>] [-n <packets>] [-s <payload bytes>]
+//                          [-x <rate factor>] [-o <capture file>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/DataLinkSender.h"
+#include "../Measurement/SnifferCapture.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/Airtime.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/resource.h>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+#define BENCH_GROUP_ADDRESS     0x10
+#define BENCH_SENDER_ADDRESS    0x1111
+#define BENCH_RECEIVER_ADDRESS  0x2222
+
+// UART of the module: 115200 baud, 8N1
+#define BENCH_UART_BYTES_PER_S  11520
+
+// SapID, MsgID, CRC16 and the SLIP end of an HCI message
+#define BENCH_HCI_OVERHEAD      5
+
+typedef std::chrono::steady_clock TClock;
+
+//------------------------------------------------------------------------------
+//
+//  TSnifferEmulator
+//
+//  @brief: module in sniffer mode which hears a packet every interval,
+//          alternately indicated as unreliable message and as raw packet,
+//          with extended output; metadata follow the sequence number
+//
+//------------------------------------------------------------------------------
+
+class TSnifferEmulator : public THCIEmulator
+{
+    public:
+
+    void        Begin(UINT32 count, UINT32 size, UINT64 intervalNs)
+                {
+                    Size     = size;
+                    Interval = std::chrono::nanoseconds(intervalNs);
+                    Next     = TClock::now();
+                    Emitted  = 0;
+                    Count    = count;
+                }
+
+    UINT32      GetEmitted() const { return Emitted; }
+
+    static INT16    GetRssi(UINT32 sequence) { return (INT16)(-40 - (INT16)(sequence % 80)); }
+    static INT8     GetSnr(UINT32 sequence) { return (INT8)((INT32)(sequence % 20) - 5); }
+
+    protected:
+
+    void        Tick() override
+                {
+                    TClock::time_point now = TClock::now();
+
+                    while (Emitted < Count && now >= Next)
+                    {
+                        Emit(Emitted);
+
+                        Emitted++;
+                        Next += Interval;
+                    }
+                }
+
+    private:
+
+    void        Emit(UINT32 sequence)
+                {
+                    bool  raw = sequence & 1;
+                    UINT8 indication[WIMODLR_HCI_MSG_PAYLOAD_SIZE];
+                    UINT8* ptr = indication;
+
+                    *ptr++ = 0x01;
+
+                    if (!raw)
+                    {
+                        *ptr++ = BENCH_GROUP_ADDRESS;
+                        HTON16(ptr, BENCH_RECEIVER_ADDRESS); ptr += 2;
+                        *ptr++ = BENCH_GROUP_ADDRESS;
+                        HTON16(ptr, BENCH_SENDER_ADDRESS); ptr += 2;
+                    }
+
+                    HTON32(ptr, sequence);
+                    std::memset(ptr + 4, (UINT8)sequence, Size - 4);
+                    ptr += Size;
+
+                    HTON16(ptr, (UINT16)GetRssi(sequence)); ptr += 2;
+                    *ptr++ = (UINT8)GetSnr(sequence);
+                    HTON32(ptr, sequence); ptr += 4;
+
+                    SendMessage(DATALINK_SAP_ID, raw ? DATALINK_MSG_RECV_RAWRADIO_MSG_IND : DATALINK_MSG_RECV_URADIO_MSG_IND,
+                                indication, (UINT16)(ptr - indication));
+                }
+
+    UINT32              Size = 0;
+    std::chrono::nanoseconds    Interval;
+    TClock::time_point  Next;
+    std::atomic<UINT32> Emitted { 0 };
+    std::atomic<UINT32> Count { 0 };
+};
+
+//------------------------------------------------------------------------------
+//
+//  CheckCapture
+//
+//  @brief: every packet once, in order, with its metadata; returns the
+//          number of good records
+//
+//------------------------------------------------------------------------------
+
+static UINT32
+CheckCapture(const std::string& fileName, UINT32 size)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    std::vector<UINT8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    TSnifferRecord record;
+    UINT32         good   = 0;
+    INT64          lastUs = 0;
+    size_t         offset = 0;
+
+    while (size_t length = SNIFF_DecodeRecord(data.data() + offset, data.size() - offset, record))
+    {
+        offset += length;
+
+        bool   raw    = record.Type == SNIFF_TYPE_RAW;
+        size_t header = raw ? 0 : SNIFF_ADDRESS_SIZE;
+
+        if (record.Frame.size() != header + size)
+            break;
+
+        UINT32 sequence = NTOH32(&record.Frame[header]);
+
+        if (sequence != good || raw != (bool)(sequence & 1) || !(record.Flags & SNIFF_FLAG_EXTENDED)
+            || record.Rssi != TSnifferEmulator::GetRssi(sequence) || record.Snr != TSnifferEmulator::GetSnr(sequence)
+            || record.RxTime != sequence || record.TimeUs < lastUs
+            || (!raw && NTOH16(&record.Frame[4]) != BENCH_SENDER_ADDRESS))
+            break;
+
+        lastUs = record.TimeUs;
+        good++;
+    }
+
+    return good;
+}
+
+//------------------------------------------------------------------------------
+//
+//  GetCpuUs
+//
+//  @brief: user and system time of the process
+//
+//------------------------------------------------------------------------------
+
+static UINT64
+GetCpuUs()
+{
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+
+    return (UINT64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+//------------------------------------------------------------------------------
+//
+//  FormatConfig
+//
+//  @brief: "sf7/125 4/5"
+//
+//------------------------------------------------------------------------------
+
+static std::string
+FormatConfig(const TWiMODLR_RadioConfig& radio)
+{
+    return "sf" + std::to_string(radio.SpreadingFactor) + "/" + std::to_string(AIRTIME_GetBandwidthHz(radio.Bandwidth) / 1000)
+           + " 4/" + std::to_string(std::max<int>(radio.ErrorCoding, WiMODLR_RADIO_CONFIG_EC_4_5) + 4);
+}
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7;bw=203,812";
+    UINT32      count       = 2000;
+    UINT32      size        = 10;
+    UINT32      factor      = 20;
+    std::string fileName    = "/tmp/sniff_bench.snf";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            count = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            size = std::clamp(std::atoi(argv[++i]), 4, DATALINK_MAX_PAYLOAD_SIZE);
+        else if (!std::strcmp(argv[i], "-x") && i + 1 < argc)
+            factor = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-o") && i + 1 < argc)
+            fileName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-n <packets>] [-s <payload bytes>]"
+                      << " [-x <rate factor>] [-o <capture file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TSweepPoint> points;
+    std::string error;
+
+    TWiMODLR_RadioConfig base = TWiMODLR_RadioConfig();
+    base.Modulation      = WiMODLR_RADIO_CONFIG_MOD_LORA;
+    base.Bandwidth       = WiMODLR_RADIO_CONFIG_BW_203kHz;
+    base.SpreadingFactor = WiMODLR_RADIO_CONFIG_SF7;
+    base.ErrorCoding     = WiMODLR_RADIO_CONFIG_EC_4_5;
+
+    if (!TSweepCampaign::ParseGrid(grid, base, points, error))
+    {
+        std::cerr << "Grid: " << error << std::endl;
+        return 1;
+    }
+
+    TSnifferEmulator module;
+    TWiMODLRHCI      hci;
+
+    if (!module.Open() || !module.Start() || !hci.Open(module.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return 1;
+    }
+
+    std::cout << count << " packets of " << size << " bytes per configuration at " << factor
+              << " times the maximum rate on air, capture " << fileName << std::endl
+              << std::setw(12) << "config"
+              << std::setw(11) << "limit/s"
+              << std::setw(10) << "uart %"
+              << std::setw(12) << "offered/s"
+              << std::setw(13) << "captured/s"
+              << std::setw(9) << "good"
+              << std::setw(9) << "dropped"
+              << std::setw(11) << "cpu us/p"
+              << std::setw(8) << "queue" << std::endl;
+
+    bool result = true;
+
+    for (const TSweepPoint& point : points)
+    {
+        // indication of a message: format, addresses, payload, footer
+        UINT64 airtimeNs  = AIRTIME_GetTimeOnAirNs(point.Radio, (UINT8)std::min<UINT32>(255, size + DATALINK_MSG_HEADER_SIZE));
+        double limit      = 1e9 / airtimeNs;
+        double uartLoad   = limit * (BENCH_HCI_OVERHEAD + DATALINK_MSG_HEADER_SIZE + size + DATALINK_MSG_FOOTER_SIZE) / BENCH_UART_BYTES_PER_S;
+
+        std::remove(fileName.c_str());
+
+        TSnifferCapture capture;
+
+        if (!capture.Open(fileName))
+        {
+            std::cerr << "Error: Could not open capture file " << fileName << std::endl;
+            return 1;
+        }
+
+        hci.RegisterClient(&capture);
+
+        UINT64 cpuStart = GetCpuUs();
+        auto   start    = TClock::now();
+        auto   deadline = start + std::chrono::nanoseconds(airtimeNs * count / factor) + std::chrono::seconds(10);
+
+        module.Begin(count, size, airtimeNs / factor);
+
+        struct pollfd fds[1] = { { hci.GetHandle(), POLLIN, 0 } };
+        TClock::time_point last = start;
+
+        for (;;)
+        {
+            TSnifferStats stats = capture.GetStats();
+
+            if (stats.Messages + stats.RawPackets + stats.Malformed >= count || TClock::now() >= deadline)
+                break;
+
+            ::poll(fds, 1, 1);
+
+            if (fds[0].revents & POLLIN)
+                last = TClock::now();
+
+            hci.Process();
+        }
+
+        double seconds = std::chrono::duration<double>(last - start).count();
+        UINT64 cpuUs   = GetCpuUs() - cpuStart;
+
+        capture.Close();
+        hci.RegisterClient(0);
+
+        TSnifferStats stats = capture.GetStats();
+        TQueueStats   queue = capture.GetQueueStats();
+        UINT32        good  = CheckCapture(fileName, size);
+        double        rate  = seconds > 0 ? (stats.Messages + stats.RawPackets) / seconds : 0.0;
+
+        std::cout << std::fixed
+                  << std::setw(12) << FormatConfig(point.Radio)
+                  << std::setprecision(1)
+                  << std::setw(11) << limit
+                  << std::setw(10) << uartLoad * 100
+                  << std::setw(12) << limit * factor
+                  << std::setw(13) << rate
+                  << std::setw(9) << good
+                  << std::setw(9) << stats.Dropped + stats.Malformed + (count - std::min<UINT64>(count, stats.Messages + stats.RawPackets))
+                  << std::setw(11) << (double)cpuUs / count
+                  << std::setw(8) << queue.HighWater << std::endl;
+
+        // every packet once with its metadata, the rate kept up
+        if (good != count || stats.Dropped || stats.Malformed || module.GetEmitted() != count || rate < 0.9 * limit * factor)
+        {
+            std::cerr << "Error: Capture incomplete, " << capture.FormatStats() << std::endl;
+            result = false;
+        }
+    }
+
+    std::remove(fileName.c_str());
+
+    hci.Close();
+    module.Close();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
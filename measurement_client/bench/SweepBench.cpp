@@ -0,0 +1,530 @@
+//------------------------------------------------------------------------------
+//
+//	File:		SweepBench.cpp
+//
+//	Abstract:	Dead time of radio reconfigurations in a sweep campaign,
+//              tagging of the samples with their configuration, early stop
+//              by PER confidence intervals and their coverage, a peer which
+//              follows the announced configurations
+//
+//	Version:	0.1
+//
+//	Date:		19.10.2026
+//
+//  Usage:      sweep_bench [-g <grid>] [-s <segment s>] [-i <interval ms>]
+//                          [-c <configure ms>] [-l <loss % at SF7>]
+//                          [-w <max. interval width>] [-m <wilson|clopper-pearson>]
+//                          [-b <legacy|epoll|io_uring>]
+//
+//------------------------------------------------------------------------------
+
+#include "HCIEmulator.h"
+#include "../WiMODLR/WiMODLRHCI.h"
+#include "../WiMODLR/WiMODLRHCI_IDs.h"
+#include "../Measurement/SampleFanout.h"
+#include "../Measurement/EventBackend.h"
+#include "../Measurement/HCIReader.h"
+#include "../Measurement/RadioSupervisor.h"
+#include "../Measurement/SweepCampaign.h"
+#include "../Measurement/AdrController.h"
+#include "../Measurement/PerInterval.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+//
+//  Defines
+//
+//------------------------------------------------------------------------------
+
+// radio configuration payload: status + 21 bytes (HCI spec 3.1.5.3)
+#define BENCH_RADIO_CONFIG_SIZE     21
+
+// offset of the spreading factor, after the bandwidth and followed by
+// coding rate and power
+#define BENCH_RADIO_CONFIG_SF       12
+#define BENCH_RADIO_CONFIG_BW       11
+
+// binomial experiments per error rate of the coverage check
+#define BENCH_COVERAGE_RUNS         4000
+#define BENCH_COVERAGE_TRIALS       500
+
+//------------------------------------------------------------------------------
+//
+//  TConfigEmulator
+//
+//  @brief: emulated module with a radio configuration in RAM, the
+//          indication interval doubles with every SF step like the airtime,
+//          the packet loss halves; the peer applies the announcements it
+//          receives, without a match every packet is lost
+//
+//------------------------------------------------------------------------------
+
+class TConfigEmulator : public THCIEmulator
+{
+    public:
+
+                TConfigEmulator(UINT32 intervalMs, UINT32 configureMs, UINT32 lossPercent)
+                {
+                    IntervalMs  = intervalMs;
+                    ConfigureMs = configureMs;
+                    LossPercent = lossPercent;
+
+                    std::memset(Radio, 0, sizeof(Radio));
+
+                    // LoRa 203 kHz, SF7, 4/5, 14 dBm
+                    Radio[BENCH_RADIO_CONFIG_SF]     = WiMODLR_RADIO_CONFIG_SF7;
+                    Radio[BENCH_RADIO_CONFIG_SF + 1] = WiMODLR_RADIO_CONFIG_EC_4_5;
+                    Radio[BENCH_RADIO_CONFIG_SF + 2] = 14;
+
+                    std::memcpy(Peer, &Radio[BENCH_RADIO_CONFIG_BW], sizeof(Peer));
+
+                    SetStatusInterval(IntervalMs * 1000);
+                    SetLossRate(LossPercent);
+                }
+
+    UINT32      GetWrites() const { return Writes; }
+    UINT32      GetFollowed() const { return Followed; }
+
+    // peer in the configuration of the module
+    bool        IsMatched() const
+                {
+                    std::lock_guard<std::mutex> lock(PeerLock);
+
+                    return !std::memcmp(Peer, &Radio[BENCH_RADIO_CONFIG_BW], sizeof(Peer));
+                }
+
+    protected:
+
+    bool        HandleMessage(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length) override
+                {
+                    UINT8 response[1 + BENCH_RADIO_CONFIG_SIZE];
+
+                    response[0] = DEVMGMT_STATUS_OK;
+
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_GET_RADIO_CONFIG_REQ)
+                    {
+                        std::memcpy(&response[1], Radio, sizeof(Radio));
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_GET_RADIO_CONFIG_RSP, response, sizeof(response));
+                    }
+
+                    // announcement heard by the peer: group, device address, frame
+                    if (sapID == DATALINK_SAP_ID && msgID == DATALINK_MSG_SEND_URADIO_MSG_REQ)
+                    {
+                        TWiMODLR_RadioConfig radio = TWiMODLR_RadioConfig();
+                        UINT8                sequence;
+
+                        if (length > DATALINK_RADIO_HEADER_SIZE && IsMatched()
+                            && TAdrController::DecodeFrame(&payload[DATALINK_RADIO_HEADER_SIZE],
+                                                           length - DATALINK_RADIO_HEADER_SIZE, sequence, radio))
+                        {
+                            std::lock_guard<std::mutex> lock(PeerLock);
+
+                            if (Peer[0] != radio.Bandwidth || Peer[1] != radio.SpreadingFactor || Peer[2] != radio.ErrorCoding)
+                                Followed++;
+
+                            Peer[0] = radio.Bandwidth;
+                            Peer[1] = radio.SpreadingFactor;
+                            Peer[2] = radio.ErrorCoding;
+                        }
+
+                        return SendMessage(DATALINK_SAP_ID, DATALINK_MSG_SEND_URADIO_MSG_RSP, response, 1);
+                    }
+
+                    if (sapID == DEVMGMT_SAP_ID && msgID == DEVMGMT_MSG_SET_RADIO_CONFIG_REQ)
+                    {
+                        // destination memory, configuration
+                        if (length < 1 + BENCH_RADIO_CONFIG_SIZE || payload[0] != WiMODLR_STORE_INTO_RAM)
+                            response[0] = DEVMGMT_STATUS_WRONG_PARAMETER;
+                        else
+                        {
+                            {
+                                std::lock_guard<std::mutex> lock(PeerLock);
+
+                                std::memcpy(Radio, &payload[1], sizeof(Radio));
+                            }
+
+                            UINT8 sf = std::clamp<UINT8>(Radio[BENCH_RADIO_CONFIG_SF], WiMODLR_RADIO_CONFIG_SF7, WiMODLR_RADIO_CONFIG_SF12);
+                            SetStatusInterval((IntervalMs * 1000) << (sf - WiMODLR_RADIO_CONFIG_SF7));
+                            SetLossRate(IsMatched() ? LossPercent >> (sf - WiMODLR_RADIO_CONFIG_SF7) : 100);
+
+                            // radio set up by the firmware
+                            std::this_thread::sleep_for(std::chrono::milliseconds(ConfigureMs));
+
+                            Writes++;
+                        }
+
+                        return SendMessage(DEVMGMT_SAP_ID, DEVMGMT_MSG_SET_RADIO_CONFIG_RSP, response, 1);
+                    }
+
+                    return THCIEmulator::HandleMessage(sapID, msgID, payload, length);
+                }
+
+    private:
+
+    UINT8               Radio[BENCH_RADIO_CONFIG_SIZE];
+
+    // bandwidth, SF and coding rate of the peer
+    UINT8               Peer[3];
+    mutable std::mutex  PeerLock;
+    std::atomic<UINT32> Followed { 0 };
+
+    UINT32              IntervalMs;
+    UINT32              ConfigureMs;
+    UINT32              LossPercent;
+    std::atomic<UINT32> Writes { 0 };
+};
+
+//------------------------------------------------------------------------------
+//
+//  TCheckSink
+//
+//  @brief: samples per configuration id, ids must not go back; points
+//          ended by the PER intervals
+//
+//------------------------------------------------------------------------------
+
+class TCheckSink : public TSampleSink
+{
+    public:
+
+    std::vector<UINT64> Samples;
+    std::vector<bool>   Early;
+    UINT64              Untagged = 0;
+    UINT64              Violations = 0;
+    UINT16              LastId = 0;
+    std::mutex          Lock;
+
+    std::string     GetName() const override { return "check"; }
+
+    bool            WriteSample(const TRLTSample& sample, const std::string& /* encoded */) override
+                    {
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        if (!sample.ConfigId)
+                        {
+                            Untagged++;
+                            return true;
+                        }
+
+                        if (sample.ConfigId < LastId)
+                            Violations++;
+
+                        if (Samples.size() < sample.ConfigId)
+                            Samples.resize(sample.ConfigId, 0);
+
+                        Samples[sample.ConfigId - 1]++;
+                        LastId = sample.ConfigId;
+                        return true;
+                    }
+
+    void            WriteComment(const std::string& comment) override
+                    {
+                        // "sweep end config=<id> converged ..."
+                        int id = 0;
+
+                        if (std::sscanf(comment.c_str(), "sweep end config=%d", &id) != 1 || id <= 0)
+                            return;
+
+                        std::lock_guard<std::mutex> lock(Lock);
+
+                        if ((int)Early.size() < id)
+                            Early.resize(id, false);
+
+                        Early[id - 1] = comment.find(" converged ") != std::string::npos;
+                    }
+};
+
+//------------------------------------------------------------------------------
+//
+//  CheckCoverage
+//
+//  @brief: share of binomial experiments whose interval contains the true
+//          error rate, the nominal confidence is 0.95
+//
+//------------------------------------------------------------------------------
+
+static bool
+CheckCoverage(TPerIntervalMethod method)
+{
+    static const double rates[] = { 0.002, 0.01, 0.05, 0.2 };
+
+    std::mt19937_64 random(1);
+
+    bool   result = true;
+    double minCoverage = 1;
+    double totalWidth  = 0;
+
+    for (double rate : rates)
+    {
+        std::binomial_distribution<UINT64> errors(BENCH_COVERAGE_TRIALS, rate);
+
+        UINT32 covered = 0;
+
+        for (int run = 0; run < BENCH_COVERAGE_RUNS; run++)
+        {
+            TPerEstimate estimate = TPerEstimate();
+
+            estimate.Trials = BENCH_COVERAGE_TRIALS;
+            estimate.Errors = errors(random);
+
+            PER_GetInterval(method, 0.95, estimate);
+
+            covered    += estimate.Lower <= rate && rate <= estimate.Upper;
+            totalWidth += estimate.Upper - estimate.Lower;
+        }
+
+        double coverage = (double)covered / BENCH_COVERAGE_RUNS;
+
+        minCoverage = std::min(minCoverage, coverage);
+
+        // exact intervals never undercover, Wilson only slightly
+        if (coverage < (method == PER_INTERVAL_CLOPPER_PEARSON ? 0.94 : 0.90))
+            result = false;
+    }
+
+    std::cout << std::fixed << std::setprecision(3)
+              << std::left << std::setw(16) << PER_MethodName(method) << std::right
+              << " min. coverage " << minCoverage
+              << ", mean width " << std::setprecision(4) << totalWidth / (BENCH_COVERAGE_RUNS * 4)
+              << " (n=" << BENCH_COVERAGE_TRIALS << ")" << std::endl;
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+//  TDeadTimeCampaign
+//
+//  @brief: records the dead time of every switch
+//
+//------------------------------------------------------------------------------
+
+class TDeadTimeCampaign : public TSweepCampaign
+{
+    public:
+
+                TDeadTimeCampaign(TWiMODLRHCI& hci, TRadioSupervisor& supervisor, TSampleFanout& fanout)
+                    : TSweepCampaign(hci, supervisor, fanout) {}
+
+    std::vector<UINT64> DeadMs;
+
+    void        evRadioLinkTest_StatusInd(const TWiMODLR_RadioLinkTestStatus& status) override
+                {
+                    UINT32 switches = GetStats().Switches;
+
+                    TSweepCampaign::evRadioLinkTest_StatusInd(status);
+
+                    if (GetStats().Switches != switches)
+                        DeadMs.push_back(GetStats().LastDeadMs);
+                }
+};
+
+//------------------------------------------------------------------------------
+//
+//  main
+//
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string grid        = "sf=7,8,9;power=14,20";
+    UINT32      intervalMs  = 10;
+    UINT32      configureMs = 5;
+    UINT32      lossPercent = 20;
+    std::string backendName = "epoll";
+
+    TSweepConfig config;
+    config.SegmentS = 3;
+    config.MaxWidth = 0.1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-g") && i + 1 < argc)
+            grid = argv[++i];
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            config.SegmentS = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc)
+            intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-c") && i + 1 < argc)
+            configureMs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-l") && i + 1 < argc)
+            lossPercent = std::min(100, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc)
+            config.MaxWidth = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "-m") && i + 1 < argc && PER_MethodFromName(argv[i + 1], config.Method))
+            i++;
+        else if (!std::strcmp(argv[i], "-b") && i + 1 < argc)
+            backendName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-g <grid>] [-s <segment s>] [-i <interval ms>]"
+                      << " [-c <configure ms>] [-l <loss % at SF7>] [-w <max. interval width>]"
+                      << " [-m <wilson|clopper-pearson>] [-b <legacy|epoll|io_uring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    bool result = CheckCoverage(PER_INTERVAL_WILSON);
+    result      = CheckCoverage(PER_INTERVAL_CLOPPER_PEARSON) && result;
+
+    TConfigEmulator emulator(intervalMs, configureMs, lossPercent);
+    TWiMODLRHCI     hci;
+    TSampleFanout   fanout;
+    TCheckSink      sink;
+
+    if (!emulator.Open() || !emulator.Start() || !hci.Open(emulator.GetPortName()))
+    {
+        std::cerr << "Error: Could not set up emulated radio" << std::endl;
+        return 1;
+    }
+
+    TRadioSupervisor  supervisor(hci, fanout);
+    TDeadTimeCampaign campaign(hci, supervisor, fanout);
+
+    hci.RegisterClient(&campaign);
+    fanout.AddSink(sink);
+    fanout.Start();
+
+    TWiMODLR_RadioLinkTestConfig test;
+    test.GroupAddress  = 0x10;
+    test.DeviceAddress = 0x2222;
+    test.PacketSize    = 15;
+    test.NumPackets    = 100;
+    test.TestMode      = 1;
+
+    // startup of main.cpp
+    supervisor.Start(emulator.GetPortName(), test);
+
+    UINT8                    status = 0;
+    TWiMODLR_RadioConfig     base;
+    std::vector<TSweepPoint> points;
+    std::string              error;
+
+    if (hci.PrepareRadioLinkTest(status, TSupervisorConfig().ReadyTimeoutMs) != WiMODLR_RESULT_OK
+        || hci.GetRadioConfiguration(base, status) != WiMODLR_RESULT_OK
+        || !TSweepCampaign::ParseGrid(grid, base, points, error)
+        || !campaign.Start(grid, config))
+    {
+        std::cerr << "Error: Could not start sweep campaign" << std::endl;
+        return 1;
+    }
+
+    // one write per point and the restore; with announcements a switch to
+    // more power is announced at that power, the peer follows every change
+    // of SF, bandwidth or coding rate
+    bool   announce = config.AnnounceRepeats && !TSweepCampaign::IsLocalGrid(points);
+    UINT32 writes   = (UINT32)points.size() + 1;
+    UINT32 follows  = 0;
+
+    for (size_t i = 0; announce && i <= points.size(); i++)
+    {
+        const TWiMODLR_RadioConfig& from = i ? points[i - 1].Radio : base;
+        const TWiMODLR_RadioConfig& to   = i < points.size() ? points[i].Radio : base;
+
+        writes  += to.PowerLevel > from.PowerLevel;
+        follows += to.SpreadingFactor != from.SpreadingFactor || to.Bandwidth != from.Bandwidth
+                   || to.ErrorCoding != from.ErrorCoding;
+    }
+
+    std::unique_ptr<TEventBackend> backend;
+    THCIReader reader(hci);
+
+    if (backendName != "legacy")
+    {
+        backend.reset(CreateEventBackend(backendName == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL));
+        if (!backend || !reader.Attach(*backend))
+        {
+            std::cerr << "Error: Could not set up event backend" << std::endl;
+            return 1;
+        }
+    }
+
+    supervisor.SetEventBackend(backend.get(), &reader);
+
+    auto started = std::chrono::steady_clock::now();
+
+    // main loop of main.cpp
+    while (!campaign.IsDone())
+    {
+        if (backend)
+        {
+            if (backend->Poll(10) < 0)
+                break;
+        }
+        else
+        {
+            hci.WaitForResponse(RLT_SAP_ID, RLT_MSG_STATUS_IND);
+        }
+
+        supervisor.Poll();
+        campaign.Poll();
+        fanout.Poll();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    fanout.Stop();
+
+    TSweepStats stats = campaign.GetStats();
+
+    std::cout << grid << ", " << config.SegmentS << " s segments, " << intervalMs << " ms interval and "
+              << lossPercent << "% loss at SF7, " << configureMs << " ms configure, ";
+
+    if (config.MaxWidth > 0)
+        std::cout << PER_MethodName(config.Method) << " width " << config.MaxWidth << ", ";
+
+    std::cout << (backend ? backend->GetName() : "legacy") << std::endl
+              << std::setw(8) << "config"
+              << std::setw(10) << "samples"
+              << std::setw(10) << "dead ms"
+              << std::setw(8) << "early" << std::endl;
+
+    for (size_t i = 0; i < sink.Samples.size(); i++)
+    {
+        std::cout << std::setw(8) << i + 1
+                  << std::setw(10) << sink.Samples[i];
+
+        // no dead time before the first configuration
+        if (i && i - 1 < campaign.DeadMs.size())
+            std::cout << std::setw(10) << campaign.DeadMs[i - 1];
+        else
+            std::cout << std::setw(10) << "-";
+
+        std::cout << std::setw(8) << (i < sink.Early.size() && sink.Early[i] ? "yes" : "no") << std::endl;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << campaign.FormatStats() << ", " << seconds << " s total ("
+              << stats.Points * config.SegmentS << " s fixed), " << emulator.GetWrites() << " RAM writes" << std::endl
+              << "untagged samples " << sink.Untagged << ", id violations " << sink.Violations
+              << ", peer followed " << emulator.GetFollowed() << "/" << follows << (emulator.IsMatched() ? "" : ", mismatch")
+              << std::endl;
+
+    result = result && stats.Points == sink.Samples.size() && !stats.Failures && !sink.Untagged && !sink.Violations
+                  && std::find(sink.Samples.begin(), sink.Samples.end(), 0) == sink.Samples.end()
+                  && emulator.GetWrites() == writes && emulator.GetFollowed() == follows && emulator.IsMatched();
+
+    std::cout << (result ? "OK" : "FAILED") << std::endl;
+
+    backend.reset();
+    emulator.Close();
+
+    return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,112 @@
+// central collector for the tcp sink of many measurement nodes
+
+#include "Measurement/IngestServer.h"
+#include "Measurement/IngestStore.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <signal.h>
+
+// stats interval [s]
+#define COLLECTOR_STATS_INTERVAL_S  60
+
+static std::atomic<bool> running(true);
+
+static void stopHandler(int)
+{
+    running = false;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string directory = "/home/david/collector";
+    UINT16 port = (UINT16)std::atoi(PUBLISH_DEFAULT_PORT);
+    UINT32 reactors = 0;
+    bool sync = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "--port") && i + 1 < argc)
+        {
+            port = (UINT16)std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--dir") && i + 1 < argc)
+        {
+            directory = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--reactors") && i + 1 < argc)
+        {
+            // 0 = one per core
+            reactors = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--no-sync"))
+        {
+            // acknowledge without fdatasync, samples may be lost on power failure
+            sync = false;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--port <port>] [--dir <directory>] [--reactors <n>] [--no-sync]" << std::endl;
+            return 1;
+        }
+    }
+
+    TIngestStore store;
+    if (!store.Open(directory, sync))
+    {
+        std::cerr << "Error: Could not open " << directory << std::endl;
+        return 1;
+    }
+
+    TIngestServer server;
+    if (!server.Start(store, port, reactors))
+    {
+        std::cerr << "Error: Could not listen on port " << port << std::endl;
+        return 1;
+    }
+
+    signal(SIGINT, stopHandler);
+    signal(SIGTERM, stopHandler);
+
+    std::cout << "Collecting to " << directory << " on port " << server.GetPort()
+              << " with " << server.GetNumReactors() << " reactors" << std::endl;
+
+    TIngestServerStats last = TIngestServerStats();
+    auto lastTime = std::chrono::steady_clock::now();
+
+    while (running)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastTime < std::chrono::seconds(COLLECTOR_STATS_INTERVAL_S) && running)
+            continue;
+
+        TIngestServerStats stats = server.GetStats();
+        double seconds = std::chrono::duration<double>(now - lastTime).count();
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "nodes=" << store.GetNumNodes()
+                  << " connections=" << stats.Connections
+                  << " samples/s=" << (stats.Store.Samples - last.Store.Samples) / seconds
+                  << " KiB/s=" << (stats.Store.Bytes - last.Store.Bytes) / seconds / 1024.0
+                  << " samples=" << stats.Store.Samples
+                  << " duplicates=" << stats.Store.Duplicates
+                  << " gaps=" << stats.Store.Gaps
+                  << " invalid=" << stats.Store.Invalid
+                  << " write errors=" << stats.Store.WriteErrors
+                  << " rejected=" << stats.Rejected << std::endl;
+
+        last = stats;
+        lastTime = now;
+    }
+
+    server.Stop();
+
+    return 0;
+}
@@ -4,6 +4,24 @@
 #include "WiMODLR/WiMODLRHCI_IDs.h"
 #include "WiMODLR/WiMODLRHCI.h"
 #include "WiMODLR/WMDefs.h"
+#include "Measurement/MeasurementLogger.h"
+#include "Measurement/EventBackend.h"
+#include "Measurement/HCIReader.h"
+#include "Measurement/SampleFanout.h"
+#include "Measurement/BinaryLogSink.h"
+#include "Measurement/StdoutSink.h"
+#include "Measurement/UdpSink.h"
+#include "Measurement/ShmRing.h"
+#include "Measurement/TcpPublisher.h"
+#include "Measurement/RadioSupervisor.h"
+#include "Measurement/DeviceWatcher.h"
+#include "Measurement/SweepCampaign.h"
+#include "Measurement/AdrController.h"
+#include "Measurement/SnifferCapture.h"
+#include "Measurement/Airtime.h"
+#include "Measurement/ClockSync.h"
+#include "Measurement/HealthMonitor.h"
+#include "Measurement/Realtime.h"
 #include <iostream>
 #include <format>
 #include <signal.h>
@@ -14,15 +32,375 @@
 #include <sstream>
 #include <thread>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <unistd.h>
 
-int main()
+// upper bound of the readiness handshake before the test is started [ms]
+#define RLT_READY_TIMEOUT   10000
+
+// radio payload of the test packets [bytes]
+#define RLT_PACKET_SIZE     15
+
+// set by SIGINT / SIGTERM: the main loop ends and the sinks are closed, so
+// buffered rows reach the files
+static volatile sig_atomic_t StopRequested = 0;
+
+static void
+OnStopSignal(int)
+{
+    StopRequested = 1;
+}
+
+int main(int argc, char* argv[])
 {
+    // storage options
+    TBlockFileConfig storageConfig;
+
+    // event backend for the main loop, legacy polling loop by default
+    bool useBackend = false;
+    bool legacyBackend = false;
+    TEventBackendType backendType = EVENT_BACKEND_EPOLL;
+
+    // output sinks, CSV file only by default
+    std::vector<std::string> sinkSpecs;
+
+    // queue between HCI and each sink
+    UINT32 queueSize = SAMPLE_QUEUE_DEFAULT_SIZE;
+    UINT32 coalesceMs = SAMPLE_QUEUE_COALESCE_MS;
+    TQueuePolicy queuePolicy = QUEUE_POLICY_BLOCK;
+
+    // store-and-forward publisher, only used with a tcp sink
+    TPublisherConfig publisherConfig;
+    publisherConfig.SpoolDir = "/home/david/spool";
+
+    // stall detection and automatic restart of the radio link test
+    TSupervisorConfig supervisorConfig;
+    bool supervise = true;
+
+    // radio parameter sweep, one test segment per grid point
+    std::string sweepGrid;
+    TSweepConfig sweepConfig;
+
+    // adaptive data rate, the peer host runs with --adr-follow
+    bool adr = false;
+    bool adrFollow = false;
+    TAdrConfig adrConfig;
+
+    // sniffer mode: every packet on the channel into a capture file, no test
+    std::string sniffFile;
+
+    // offset and drift of the module RTC from periodic RTC requests
+    bool clockSync = false;
+    TClockSyncConfig clockConfig;
+
+    // system status of the module as time series next to the CSV file
+    THealthConfig healthConfig;
+
+    // real-time mode of the serial reader; --jitter alone measures the
+    // wakeup latency of the default scheduling
+    bool realtime = false;
+    bool rtCpuSet = false;
+    bool jitterSet = false;
+    TRealtimeConfig rtConfig;
+
+    // test packets, --airtime prints the time on air table and exits
+    int packetSize = RLT_PACKET_SIZE;
+    bool printAirtime = false;
+
+    // serial port relative to /dev, "auto" = first adapter in /dev/serial/by-id
+    std::string device = DEVICE_AUTO;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "--block-size") && i + 1 < argc)
+        {
+            // coalescing block size in KiB
+            storageConfig.BlockSize = std::atoi(argv[++i]) * 1024;
+        }
+        else if (!std::strcmp(argv[i], "--prealloc") && i + 1 < argc)
+        {
+            // preallocation chunk in MiB, 0 = off
+            storageConfig.PreallocateSize = std::atoi(argv[++i]) * 1024 * 1024;
+        }
+        else if (!std::strcmp(argv[i], "--flush-ms") && i + 1 < argc)
+        {
+            storageConfig.FlushIntervalMs = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--direct-io"))
+        {
+            storageConfig.DirectIO = true;
+        }
+        else if (!std::strcmp(argv[i], "--backend") && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+
+            useBackend    = name != "legacy";
+            legacyBackend = !useBackend;
+            backendType   = name == "io_uring" ? EVENT_BACKEND_URING : EVENT_BACKEND_EPOLL;
+
+            if (name != "legacy" && name != "epoll" && name != "io_uring")
+            {
+                std::cerr << "Unknown backend " << name << std::endl;
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--queue") && i + 1 < argc)
+        {
+            if (!QueuePolicyFromName(argv[++i], queuePolicy))
+            {
+                std::cerr << "Unknown queue policy " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--queue-size") && i + 1 < argc)
+        {
+            queueSize = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--coalesce-ms") && i + 1 < argc)
+        {
+            coalesceMs = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--node") && i + 1 < argc)
+        {
+            publisherConfig.Node = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--spool") && i + 1 < argc)
+        {
+            publisherConfig.SpoolDir = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--batch") && i + 1 < argc)
+        {
+            // samples per published frame
+            publisherConfig.BatchSamples = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--flush-latency") && i + 1 < argc)
+        {
+            publisherConfig.FlushLatencyMs = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--stall-timeout") && i + 1 < argc)
+        {
+            // upper bound of the adaptive stall timeout in ms, 0 = off
+            supervisorConfig.MaxTimeoutMs = std::atoi(argv[++i]);
+            supervise = supervisorConfig.MaxTimeoutMs != 0;
+            supervisorConfig.MinTimeoutMs = std::min(supervisorConfig.MinTimeoutMs, supervisorConfig.MaxTimeoutMs);
+        }
+        else if (!std::strcmp(argv[i], "--device") && i + 1 < argc)
+        {
+            device = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--sweep") && i + 1 < argc)
+        {
+            // check the grid before the module is touched
+            std::vector<TSweepPoint> points;
+            std::string error;
+
+            sweepGrid = argv[++i];
+            if (!TSweepCampaign::ParseGrid(sweepGrid, TWiMODLR_RadioConfig(), points, error))
+            {
+                std::cerr << "Sweep grid: " << error << std::endl;
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--sweep-segment") && i + 1 < argc)
+        {
+            sweepConfig.SegmentS = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--sweep-ci") && i + 1 < argc)
+        {
+            // max. width of the PER confidence intervals, 0 = fixed segments
+            sweepConfig.MaxWidth = std::atof(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--sweep-ci-method") && i + 1 < argc)
+        {
+            if (!PER_MethodFromName(argv[++i], sweepConfig.Method))
+            {
+                std::cerr << "Unknown interval method " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--sweep-min-packets") && i + 1 < argc)
+        {
+            sweepConfig.MinPackets = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--sweep-announce") && i + 1 < argc)
+        {
+            // announcements per switch to a peer running --adr-follow,
+            // 0 = the peer is configured by hand
+            sweepConfig.AnnounceRepeats = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--adr") && i + 1 < argc)
+        {
+            // max. PER of either direction
+            adr = true;
+            adrConfig.TargetPer = std::clamp(std::atof(argv[++i]), 0.0, 1.0);
+        }
+        else if (!std::strcmp(argv[i], "--adr-margin") && i + 1 < argc)
+        {
+            adrConfig.MarginDb = std::atof(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--adr-hysteresis") && i + 1 < argc)
+        {
+            adrConfig.HysteresisDb = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--adr-follow"))
+        {
+            adrFollow = true;
+        }
+        else if (!std::strcmp(argv[i], "--sniff") && i + 1 < argc)
+        {
+            sniffFile = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--clock-sync") && i + 1 < argc)
+        {
+            clockSync = true;
+            clockConfig.IntervalMs = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--health") && i + 1 < argc)
+        {
+            // 0 = off
+            healthConfig.IntervalMs = std::max(0, std::atoi(argv[++i])) * 1000;
+        }
+        else if (!std::strcmp(argv[i], "--rt"))
+        {
+            realtime = true;
+        }
+        else if (!std::strcmp(argv[i], "--rt-cpu") && i + 1 < argc)
+        {
+            // -1 = no pinning
+            realtime = true;
+            rtCpuSet = true;
+            rtConfig.Cpu = std::max(-1, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--rt-priority") && i + 1 < argc)
+        {
+            realtime = true;
+            rtConfig.Priority = std::clamp(std::atoi(argv[++i]), 1, 99);
+        }
+        else if (!std::strcmp(argv[i], "--jitter") && i + 1 < argc)
+        {
+            // 0 = off
+            jitterSet = true;
+            rtConfig.JitterIntervalUs = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--packet-size") && i + 1 < argc)
+        {
+            packetSize = std::clamp(std::atoi(argv[++i]), 1, 255);
+        }
+        else if (!std::strcmp(argv[i], "--airtime"))
+        {
+            printAirtime = true;
+        }
+        else if (!std::strcmp(argv[i], "--sink") && i + 1 < argc)
+        {
+            std::string spec = argv[++i];
+
+            if (spec != "csv" && spec != "stdout" && spec != "binary"
+                && spec.compare(0, 7, "binary:") != 0
+                && spec != "shm" && spec.compare(0, 4, "shm:") != 0
+                && (spec.compare(0, 4, "udp:") != 0 || spec.rfind(':') <= 4)
+                && (spec.compare(0, 4, "tcp:") != 0 || spec.size() <= 4))
+            {
+                std::cerr << "Unknown sink " << spec << std::endl;
+                return 1;
+            }
+            sinkSpecs.push_back(spec);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--block-size <KiB>] [--prealloc <MiB>] [--flush-ms <ms>] [--direct-io]"
+                      << " [--backend <legacy|epoll|io_uring>]"
+                      << " [--queue <block|drop-oldest|coalesce>] [--queue-size <n>] [--coalesce-ms <ms>]"
+                      << " [--sink <csv|binary[:<file>]|stdout|shm[:<name>]|udp:<host>:<port>|tcp:<host>[:<port>]>]..."
+                      << " [--node <name>] [--spool <dir>] [--batch <n>] [--flush-latency <ms>]"
+                      << " [--stall-timeout <ms>] [--device <port|auto>]"
+                      << " [--sweep <sf=..;bw=..;cr=..;power=..>] [--sweep-segment <s>]"
+                      << " [--sweep-ci <width>] [--sweep-ci-method <wilson|clopper-pearson>] [--sweep-min-packets <n>]"
+                      << " [--sweep-announce <repeats, peer runs --adr-follow>]"
+                      << " [--adr <target per>] [--adr-margin <dB>] [--adr-hysteresis <dB>] [--adr-follow]"
+                      << " [--sniff <capture file>] [--clock-sync <interval ms>] [--health <interval s>]"
+                      << " [--rt] [--rt-cpu <core>] [--rt-priority <1..99>] [--jitter <period us>]"
+                      << " [--packet-size <bytes>] [--airtime]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    if (printAirtime)
+    {
+        AIRTIME_PrintTable(std::cout, (UINT8)packetSize);
+        return 0;
+    }
+
+    // both change the radio configuration
+    if ((adr || adrFollow) && !sweepGrid.empty())
+    {
+        std::cerr << "--adr and --sweep exclude each other" << std::endl;
+        return 1;
+    }
+
+    if (!sniffFile.empty() && (adr || adrFollow || !sweepGrid.empty()))
+    {
+        std::cerr << "--sniff excludes --adr and --sweep" << std::endl;
+        return 1;
+    }
+
+    // an early stop moves the following segments, a peer configured by
+    // hand could not keep up
+    if (!sweepGrid.empty() && sweepConfig.MaxWidth > 0 && !sweepConfig.AnnounceRepeats)
+    {
+        std::vector<TSweepPoint> points;
+        std::string error;
+
+        TSweepCampaign::ParseGrid(sweepGrid, TWiMODLR_RadioConfig(), points, error);
+
+        if (!TSweepCampaign::IsLocalGrid(points))
+        {
+            std::cerr << "--sweep-ci with --sweep-announce 0 needs a grid of local parameters (power)" << std::endl;
+            return 1;
+        }
+    }
+
+    if (sinkSpecs.empty())
+        sinkSpecs.push_back("csv");
+
+    // isolated core, FIFO priority below the interrupt threads, locked
+    // memory and the jitter probe unless given otherwise; the legacy loops
+    // poll the serial port and would never give the core away
+    if (realtime)
+    {
+        if (legacyBackend || !sniffFile.empty() || adrFollow)
+        {
+            std::cerr << "--rt needs the event backend, excludes --backend legacy, --sniff and --adr-follow" << std::endl;
+            return 1;
+        }
+
+        useBackend = true;
+        if (!rtCpuSet)
+            rtConfig.Cpu = RT_GetIsolatedCpu();
+        if (!rtConfig.Priority)
+            rtConfig.Priority = RT_DEFAULT_PRIORITY;
+        if (!jitterSet)
+            rtConfig.JitterIntervalUs = RT_DEFAULT_JITTER_US;
+        rtConfig.LockMemory = true;
+    }
 
     // interface init
     TWiMODLRHCI radioIF = TWiMODLRHCI();
 
-    // select port
-    std::string comPort = "ttyUSB0";  // hardcoded cause linux always gave it this path because its the only usb plugged in in my case
+    // select port, the by-id name stays the same when the adapter
+    // re-enumerates; without one fall back to the usual name
+    std::string comPort = device;
+    if (device == DEVICE_AUTO)
+    {
+        std::vector<std::string> ports;
+        comPort = TDeviceWatcher::GetComPorts(ports) ? ports.front() : "ttyUSB0";
+    }
+    std::cout << "Serial port: " << comPort << std::endl;
+
     if(!radioIF.Open(comPort))
     {
         std:: cout << "Error opening device!\n";
@@ -45,22 +423,139 @@ int main()
     // append extension
     filename += ".csv";
 
-    // create and open CSV file
-    std::ofstream csvFile(filename);
-    if (!csvFile.is_open()) {
-        std::cerr << "Error: Could not create file " << filename << std::endl;
-        return 1;
+    radioIF.filename = filename;
+
+    // measurement data is time stamped, encoded once per format and queued
+    // to every sink, each sink is served by its own thread
+    TSampleFanout fanout;
+
+    // samples carry the time their frame was read from the serial port
+    fanout.SetReceiveClock(&radioIF);
+
+    TMeasurementLogger logger;
+    TBinaryLogSink binaryLog;
+    TStdoutSink stdoutSink;
+    TShmRingWriter shmRing;
+    std::vector<std::unique_ptr<TUdpSink>> udpSinks;
+    TTcpPublisher publisher;
+
+    for (const std::string& spec : sinkSpecs)
+    {
+        bool result = true;
+
+        if (spec == "csv")
+        {
+            // create CSV file with header and a comment, rows are coalesced
+            // into aligned blocks to reduce SD card wear
+            // a campaign tags every row with its configuration id, ADR with
+            // its ladder step
+            if (adr)
+                result = logger.Open(filename, std::format("adr per={}", adrConfig.TargetPer)
+                                     + "  position: ", storageConfig, RLT_CSV_HEADER_CONFIG);
+            else if (sweepGrid.empty())
+                result = logger.Open(filename, "BW=  SF=  CR=  position: ", storageConfig);
+            else
+                result = logger.Open(filename, "sweep " + sweepGrid + " segment=" + std::to_string(sweepConfig.SegmentS)
+                                     + " s  position: ", storageConfig, RLT_CSV_HEADER_CONFIG);
+
+            result = result
+                     && fanout.AddSink(logger, queueSize, queuePolicy, coalesceMs);
+        }
+        else if (spec.compare(0, 6, "binary") == 0)
+        {
+            // compressed RLT blocks, next to the CSV file by default
+            std::string binaryName = spec.size() > 7 ? spec.substr(7) : filename.substr(0, filename.size() - 4) + ".rltb";
+
+            result = binaryLog.Open(binaryName, storageConfig)
+                     && fanout.AddSink(binaryLog, queueSize, queuePolicy, coalesceMs);
+        }
+        else if (spec == "stdout")
+        {
+            result = fanout.AddSink(stdoutSink, queueSize, queuePolicy, coalesceMs);
+        }
+        else if (spec.compare(0, 3, "shm") == 0)
+        {
+            // live ring in /dev/shm for local readers (ShmRing.h)
+            result = shmRing.Open(spec.size() > 4 ? spec.substr(4) : SHM_RING_DEFAULT_NAME)
+                     && fanout.AddSink(shmRing, queueSize, queuePolicy, coalesceMs);
+        }
+        else if (spec.compare(0, 4, "tcp:") == 0)
+        {
+            // tcp:<host>[:<port>], samples are spooled until the collector
+            // acknowledges them
+            size_t colon = spec.find(':', 4);
+
+            publisherConfig.Host = spec.substr(4, colon == std::string::npos ? colon : colon - 4);
+            if (colon != std::string::npos)
+                publisherConfig.Port = spec.substr(colon + 1);
+
+            if (publisherConfig.Node.empty())
+            {
+                char hostname[256] = {};
+                ::gethostname(hostname, sizeof(hostname) - 1);
+                publisherConfig.Node = hostname;
+            }
+
+            result = publisher.Open(publisherConfig)
+                     && fanout.AddSink(publisher, queueSize, queuePolicy, coalesceMs);
+        }
+        else
+        {
+            // udp:<host>:<port>
+            size_t colon = spec.rfind(':');
+
+            udpSinks.emplace_back(new TUdpSink);
+            result = udpSinks.back()->Open(spec.substr(4, colon - 4), spec.substr(colon + 1))
+                     && fanout.AddSink(*udpSinks.back(), queueSize, queuePolicy, coalesceMs);
+        }
+
+        if (!result)
+        {
+            std::cerr << "Error: Could not open sink " << spec << std::endl;
+            return 1;
+        }
     }
 
-    radioIF.filename = filename;
+    // serial reads and log writes through one event backend, the serial
+    // handle is attached once the test is started. Log writes go through it
+    // only if it submits them asynchronously (io_uring): epoll would run the
+    // pwrites of the sink threads on the serial reader thread, where a
+    // storage stall delays the reads again.
+    TEventBackend* backend = 0;
+    THCIReader reader(radioIF);
+
+    if (useBackend)
+    {
+        backend = CreateEventBackend(backendType);
+        if (!backend)
+        {
+            std::cerr << "Error: Could not set up event backend" << std::endl;
+            return 1;
+        }
+
+        if (backend->HasAsyncWrites())
+        {
+            logger.SetBackend(backend);
+            binaryLog.SetBackend(backend);
+        }
+
+        std::cout << "Event backend: " << backend->GetName() << std::endl;
+    }
 
-    // write header to CSV file
-    csvFile << "Time,Local Tx Count,Local Rx Count,Peer Tx Count,Peer Rx Count,Local RSSI [dBm],Peer RSSI [dBm],Local SNR [dB],Peer SNR [dB]" << std::endl;
+    // the supervisor watches the indications on their way to the fan-out
+    TRadioSupervisor supervisor(radioIF, fanout);
 
-    // write a coment to the CSV file
-    csvFile << "# BW=  SF=  CR=  position: " << std::endl;
+    // a campaign or the ADR controller sits in front of the supervisor
+    TSweepCampaign campaign(radioIF, supervisor, fanout);
+    TAdrController adrController(radioIF, supervisor, fanout);
 
-    csvFile.close();
+    if (adr || adrFollow)
+        radioIF.RegisterClient(&adrController);
+    else if (sweepGrid.empty())
+        radioIF.RegisterClient(&supervisor);
+    else
+        radioIF.RegisterClient(&campaign);
+    fanout.Start();
 
     // create static link in filesystem to newest measurement - easier to point to
     std::string command = "ln -s -f " + filename + " /home/david/latest_meas";
@@ -70,45 +565,257 @@ int main()
     TWiMODLR_RadioLinkTestConfig conf;
     conf.GroupAddress = 0x10;
     conf.DeviceAddress = 0x2222;
-    conf.PacketSize = 15;
+    conf.PacketSize = (UINT8)packetSize;
     conf.NumPackets = 100;
     conf.TestMode = 1;  // infinite loop
 
-    // generate payload
-    UINT8 payload[7];
-    UINT8* ptr = &payload[0];
+    UINT8 status = 0;
 
-    *ptr++ = conf.GroupAddress;
-    HTON16(ptr, conf.DeviceAddress); ptr += 2;
-    *ptr++ = conf.PacketSize;
-    HTON16(ptr, conf.NumPackets); ptr += 2;
-    *ptr++ = conf.TestMode;
+    // reports the time to the first sample, recovers stalls if enabled
+    supervisorConfig.AutoRecover = supervise;
+    supervisor.Start(comPort, conf, supervisorConfig);
 
-    #ifdef debug
-    std::cout << "RLT config payload: ";
-    for(int i = 0; i < 7; i++)
+    // stop any measurement if running and wait until the module answers,
+    // stale indications of the old test are dropped
+    auto handshake = std::chrono::steady_clock::now();
+
+    if (radioIF.PrepareRadioLinkTest(status, RLT_READY_TIMEOUT) == WiMODLR_RESULT_OK)
+        std::cout << "Module ready after "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - handshake).count()
+                  << " ms" << std::endl;
+    else
+        std::cerr << "Warning: Module not ready after " << RLT_READY_TIMEOUT << " ms" << std::endl;
+
+    // the reading thread enters real-time mode right before its loop, the
+    // sink and publisher threads started so far keep the default scheduling
+    TJitterProbe jitter(&fanout);
+
+    auto enterRealtime = [&]()
+    {
+        if (realtime)
+        {
+            RT_Enter(rtConfig);
+            std::cout << "Realtime: " << RT_FormatConfig(rtConfig) << std::endl;
+        }
+
+        if (rtConfig.JitterIntervalUs)
+            jitter.Start(rtConfig);
+    };
+
+    // blocking reads and waits return on the signal, a second one
+    // terminates at once
+    struct sigaction stopAction = {};
+    stopAction.sa_handler = OnStopSignal;
+    stopAction.sa_flags   = SA_RESETHAND;
+    sigemptyset(&stopAction.sa_mask);
+    sigaction(SIGINT, &stopAction, 0);
+    sigaction(SIGTERM, &stopAction, 0);
+
+    // peer host: no test of its own, announced configurations are applied
+    // until the process is stopped
+    if (adrFollow)
     {
-        std::cout << std::format("{:#x}",payload[i]);
-        std::cout << " ";
+        supervisor.Stop();
+
+        if (!adrController.StartFollower())
+            return 1;
+
+        enterRealtime();
+
+        while (!StopRequested)
+        {
+            radioIF.WaitForResponse(DATALINK_SAP_ID, DATALINK_MSG_RECV_URADIO_MSG_IND);
+            adrController.Poll();
+            jitter.Poll();
+        }
+
+        jitter.Stop();
+        return 0;
     }
-    std::cout << "\n\n";
-    #endif
 
-    // stop any measurement if running
-    radioIF.SendHCIMessage(RLT_SAP_ID, RLT_MSG_STOP_REQ,RLT_MSG_STOP_RSP,nullptr,0);
-    
-    // wait for 10s before starting measurement
-    std::this_thread::sleep_for(std::chrono::milliseconds(10000));
+    // sniffer: the module reports every packet it hears, until the process
+    // is stopped
+    if (!sniffFile.empty())
+    {
+        supervisor.Stop();
+
+        TSnifferCapture      capture;
+        TWiMODLR_RadioConfig radio;
+
+        if (radioIF.GetRadioConfiguration(radio, status) != WiMODLR_RESULT_OK || status != DEVMGMT_STATUS_OK)
+        {
+            std::cerr << "Error: Could not read the radio configuration" << std::endl;
+            return 1;
+        }
+
+        TSnifferCapture::SetSnifferMode(radio);
+
+        if (radioIF.SetRadioConfiguration(radio, WiMODLR_STORE_INTO_RAM, status) != WiMODLR_RESULT_OK
+            || status != DEVMGMT_STATUS_OK)
+        {
+            std::cerr << "Error: Sniffer mode not set, status " << (int)status << std::endl;
+            return 1;
+        }
+
+        if (!capture.Open(sniffFile, storageConfig, SNIFF_DEFAULT_QUEUE, queuePolicy))
+        {
+            std::cerr << "Error: Could not open capture file " << sniffFile << std::endl;
+            return 1;
+        }
+
+        radioIF.RegisterClient(&capture);
+
+        std::cout << "Sniffer: " << TSweepCampaign::FormatRadio(radio) << " -> " << sniffFile << std::endl;
+
+        enterRealtime();
+
+        auto report = std::chrono::steady_clock::now();
+
+        while (!StopRequested)
+        {
+            radioIF.WaitForResponse(DATALINK_SAP_ID, DATALINK_MSG_RECV_RAWRADIO_MSG_IND);
+            jitter.Poll();
+
+            if (std::chrono::steady_clock::now() - report >= std::chrono::seconds(60))
+            {
+                report = std::chrono::steady_clock::now();
+                std::cout << "Sniffer: " << capture.FormatStats() << std::endl;
+            }
+        }
+
+        jitter.Stop();
+        capture.Close();
+        std::cout << "Sniffer: " << capture.FormatStats() << std::endl;
+        return 0;
+    }
 
     // start measurement
-    radioIF.SendHCIMessage(RLT_SAP_ID, RLT_MSG_START_REQ,RLT_MSG_START_RSP,payload,7);
+    if (adr)
+    {
+        if (!adrController.Start(adrConfig))
+            return 1;
+    }
+    else if (!sweepGrid.empty())
+    {
+        if (!campaign.Start(sweepGrid, sweepConfig))
+            return 1;
+    }
+    else
+    {
+        // measured rates can be compared with the airtime limit
+        TWiMODLR_RadioConfig radio;
+
+        if (radioIF.GetRadioConfiguration(radio, status) == WiMODLR_RESULT_OK && status == DEVMGMT_STATUS_OK)
+        {
+            std::string text = TSweepCampaign::FormatRadio(radio) + " " + AIRTIME_Format(radio, conf.PacketSize);
+
+            std::cout << "Radio: " << text << std::endl;
+            fanout.PublishComment("radio " + text);
+        }
+
+        if (radioIF.StartRadioLinkTest(conf, status) != WiMODLR_RESULT_OK || status != RLT_STATUS_OK)
+            std::cerr << "Warning: Radio link test not started, status " << (int)status << std::endl;
+    }
+
+    // hotplug events of the adapter go to the supervisor
+    TDeviceWatcher watcher;
+
+    if (supervise)
+    {
+        if (!watcher.Open())
+            std::cerr << "Warning: No hotplug detection" << std::endl;
+        else
+            watcher.AddDevice(comPort, &supervisor);
+    }
+
+    if (backend && (!reader.Attach(*backend) || (watcher.GetHandle() >= 0 && !watcher.Attach(*backend))))
+    {
+        std::cerr << "Error: Could not set up event backend" << std::endl;
+        return 1;
+    }
+
+    supervisor.SetEventBackend(backend, &reader);
+
+    // RTC requests between the indications, the offset goes to the sinks
+    // as comment
+    TClockSync clock(radioIF, &fanout);
+    clock.Configure(clockConfig);
+    clock.SetReader(&reader);
+
+    // system status between the indications, resets and lost responses are
+    // also reported to the sinks
+    THealthMonitor health(radioIF, &fanout);
+    health.SetReader(&reader);
+
+    if (healthConfig.IntervalMs)
+    {
+        std::string healthName = filename.substr(0, filename.size() - 4) + ".health.csv";
+
+        if (!health.Open(healthName, storageConfig, healthConfig))
+            std::cerr << "Warning: Could not open health file " << healthName << std::endl;
+    }
+
+    enterRealtime();
+
+    // main loop until stopped, a sweep campaign ends after its last segment
+    while (!StopRequested && (sweepGrid.empty() || !campaign.IsDone())) {
+        if (backend)
+        {
+            // sleeps until data arrives, status indications are dispatched
+            // to the sinks from within Poll
+            // a hangup is recovered by the supervisor if enabled
+            int waitMs = health.GetWaitMs(clockSync ? clock.GetWaitMs(1000) : 1000);
+
+            if (backend->Poll(waitMs) < 0 || (reader.IsClosed() && !supervise))
+            {
+                std::cerr << "Error: Event loop failed" << std::endl;
+                fanout.Stop();
+                publisher.Close();
+                logger.Close();
+                binaryLog.Close();
+                health.Close();
+                jitter.Stop();
+                return 1;
+            }
+            supervisor.Poll();
+            campaign.Poll();
+            adrController.Poll();
+            if (clockSync)
+                clock.Poll();
+            health.Poll();
+            jitter.Poll();
+            fanout.Poll();
+            continue;
+        }
 
-    // main loop
-    while (true) {
         // wait for measurement data from radio, log it
         radioIF.WaitForResponse(RLT_SAP_ID,RLT_MSG_STATUS_IND);
+        watcher.Process();
+        supervisor.Poll();
+        campaign.Poll();
+        adrController.Poll();
+        if (clockSync)
+            clock.Poll();
+        health.Poll();
+        jitter.Poll();
+        fanout.Poll();
     }
 
+    // stopped during a campaign: the configuration found at the start is
+    // restored
+    if (!sweepGrid.empty() && !campaign.IsDone())
+        campaign.Stop();
+
+    fanout.Stop();
+    publisher.Close();
+    logger.Close();
+    binaryLog.Close();
+    health.Close();
+    jitter.Stop();
+
+    if (jitter.GetTotal().Count())
+        std::cout << "Realtime: jitter " << jitter.GetTotal().Summary() << std::endl;
+
     return 0;
 }
 